@@ -1,11 +1,18 @@
 @echo off
-REM Loop through all .vert and .frag files in the current directory
+REM Loop through all .vert, .frag and .comp files in the current directory, and validate what glslang makes
 for %%f in (*.vert *.frag *.comp) do (
-    glslangValidator -V %%f -o %%f.spv
+    glslangValidator -V %%f -o %%f.spv && spirv-val --target-env vulkan1.0 %%f.spv
     if errorlevel 1 (
         echo error
     ) else (
         echo success
     )
 )
+REM Bindless descriptors are only used on Vulkan 1.2 devices
+glslangValidator -V --target-env vulkan1.2 pbr_bindless.frag -o pbr_bindless.frag.spv && spirv-val --target-env vulkan1.2 pbr_bindless.frag.spv
+if errorlevel 1 (
+    echo error
+) else (
+    echo success
+)
 pause
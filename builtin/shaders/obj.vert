@@ -10,10 +10,23 @@ layout (set = 0, binding = 0) uniform PerSceneData
 	mat4 projectionMatrix;
 } sceneData;
 
-layout (set = 1, binding = 0) uniform PerObjDataDynamic
+struct PerObjectData
 {
 	mat4 modelMatrix;
-} objData;
+	mat4 normalMatrix;
+};
+
+// indexed by game object
+layout (std430, set = 1, binding = 0) readonly buffer ObjectDataBuffer 
+{
+	PerObjectData objects[];
+} objectData;
+
+// game object of each instance, a draw covers the range from firstInstance
+layout (std430, set = 1, binding = 1) readonly buffer InstanceDataBuffer 
+{
+	uint objectIndices[];
+} instanceData;
 
 layout (location = 0) out vec3 outNormal;
 layout (location = 1) out vec3 outPosition;
@@ -25,7 +38,8 @@ out gl_PerVertex
 
 void main() 
 {
-	mat3 normalMatrix = transpose(inverse(mat3(objData.modelMatrix)));
+	PerObjectData objData = objectData.objects[instanceData.objectIndices[gl_InstanceIndex]];
+	mat3 normalMatrix = mat3(objData.normalMatrix);
 	vec3 normal = normalize(normalMatrix * inNormal);
 
 	outNormal   = normal;
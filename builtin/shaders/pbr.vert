@@ -16,10 +16,23 @@ layout (set = 0, binding = 1) uniform DirectionalLightData
 	mat4 projectionMatrix;
 } lightData;
 
-layout (set = 2, binding = 0) uniform PerObjDataDynamic 
+struct PerObjectData
 {
 	mat4 modelMatrix;
-} objData;
+	mat4 normalMatrix;
+};
+
+// indexed by game object
+layout (std430, set = 2, binding = 0) readonly buffer ObjectDataBuffer 
+{
+	PerObjectData objects[];
+} objectData;
+
+// game object of each instance, a draw covers the range from firstInstance
+layout (std430, set = 2, binding = 1) readonly buffer InstanceDataBuffer 
+{
+	uint objectIndices[];
+} instanceData;
 
 layout (location = 0) out vec3 outPosition;
 layout (location = 1) out vec3 outNormal;
@@ -28,7 +41,8 @@ layout (location = 3) out vec4 outShadowCoord;
 
 void main() 
 {
-	mat3 normalMatrix = transpose(inverse(mat3(objData.modelMatrix)));
+	PerObjectData objData = objectData.objects[instanceData.objectIndices[gl_InstanceIndex]];
+	mat3 normalMatrix = mat3(objData.normalMatrix);
 
 	vec4 worldPos = objData.modelMatrix * vec4(inPosition.xyz, 1.0);
 	gl_Position = sceneData.projectionMatrix * sceneData.viewMatrix * worldPos;
@@ -0,0 +1,192 @@
+#version 450
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout (location = 0) in vec3 inPosition;
+layout (location = 1) in vec3 inNormal;
+layout (location = 2) in vec2 inUV0;
+layout (location = 3) in vec4 inShadowCoord;
+
+layout (set = 1, binding = 0) uniform LightData 
+{
+	vec3 pos[4];
+	vec3 color[4];
+    vec3 camPos;
+} lights;
+
+layout (set = 1, binding = 1) uniform samplerCube irradianceMap;
+
+// slots of the material, holding indices into bindlessTextures
+const uint ALBEDO_SLOT    = 0;
+const uint NORMAL_SLOT    = 1;
+const uint METALLIC_SLOT  = 2;
+const uint ROUGHNESS_SLOT = 3;
+const uint AO_SLOT        = 4;
+
+layout (set = 3, binding = 0) uniform TextureIndices
+{
+	uvec4 indices[2];
+} textureIndices;
+
+layout (set = 3, binding = 1) uniform sampler2D shadowMap;
+
+// shared by all materials, see BindlessDescriptorTable
+layout (set = 4, binding = 0) uniform sampler2D bindlessTextures[];
+
+vec4 sampleSlot(uint slot, vec2 uv)
+{
+    uint index = textureIndices.indices[slot / 4][slot % 4];
+    return texture(bindlessTextures[nonuniformEXT(index)], uv);
+}
+
+layout (location = 0) out vec4 outFragColor;
+
+const float PI = 3.14159265359;
+// ----------------------------------------------------------------------------
+// Easy trick to get tangent-normals to world-space to keep PBR code simplified.
+// Don't worry if you don't get what's going on; you generally want to do normal 
+// mapping the usual way for performance anyways; I do plan make a note of this 
+// technique somewhere later in the normal mapping tutorial.
+vec3 getNormalFromMap()
+{
+    vec3 tangentNormal = sampleSlot(NORMAL_SLOT, inUV0).xyz * 2.0 - 1.0;
+
+    vec3 Q1  = dFdx(inPosition);
+    vec3 Q2  = dFdy(inPosition);
+    vec2 st1 = dFdx(inUV0);
+    vec2 st2 = dFdy(inUV0);
+
+    vec3 N   = normalize(inNormal);
+    vec3 T  = normalize(Q1*st2.t - Q2*st1.t);
+    vec3 B  = -normalize(cross(N, T));
+    mat3 TBN = mat3(T, B, N);
+
+    return normalize(TBN * tangentNormal);
+}
+// ----------------------------------------------------------------------------
+float DistributionGGX(vec3 N, vec3 H, float roughness)
+{
+    float a = roughness*roughness;
+    float a2 = a*a;
+    float NdotH = max(dot(N, H), 0.0);
+    float NdotH2 = NdotH*NdotH;
+
+    float nom   = a2;
+    float denom = (NdotH2 * (a2 - 1.0) + 1.0);
+    denom = PI * denom * denom;
+
+    return nom / denom;
+}
+// ----------------------------------------------------------------------------
+float GeometrySchlickGGX(float NdotV, float roughness)
+{
+    float r = (roughness + 1.0);
+    float k = (r*r) / 8.0;
+
+    float nom   = NdotV;
+    float denom = NdotV * (1.0 - k) + k;
+
+    return nom / denom;
+}
+// ----------------------------------------------------------------------------
+float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
+{
+    float NdotV = max(dot(N, V), 0.0);
+    float NdotL = max(dot(N, L), 0.0);
+    float ggx2 = GeometrySchlickGGX(NdotV, roughness);
+    float ggx1 = GeometrySchlickGGX(NdotL, roughness);
+
+    return ggx1 * ggx2;
+}
+// ----------------------------------------------------------------------------
+vec3 fresnelSchlick(float cosTheta, vec3 F0)
+{
+    return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
+}
+// ----------------------------------------------------------------------------
+void main()
+{		
+    vec3 albedo     = pow(sampleSlot(ALBEDO_SLOT, inUV0).rgb, vec3(2.2));
+    float metallic  = sampleSlot(METALLIC_SLOT, inUV0).r;
+    float roughness = sampleSlot(ROUGHNESS_SLOT, inUV0).r;
+    float ao        = sampleSlot(AO_SLOT, inUV0).r;
+
+    vec3 N = getNormalFromMap();
+    vec3 V = normalize(lights.camPos - inPosition);
+
+    // calculate reflectance at normal incidence; if dia-electric (like plastic) use F0 
+    // of 0.04 and if it's a metal, use the albedo color as F0 (metallic workflow)    
+    vec3 F0 = vec3(0.04); 
+    F0 = mix(F0, albedo, metallic);
+
+    // reflectance equation
+    vec3 Lo = vec3(0.0);
+    for(int i = 0; i < 4; ++i) 
+    {
+        // calculate per-light radiance
+        vec3 L = normalize(lights.pos[i] - inPosition);
+        vec3 H = normalize(V + L);
+        float distance = length(lights.pos[i] - inPosition);
+        float attenuation = 1.0 / (distance * distance);
+        vec3 radiance = lights.color[i] * attenuation;
+
+        // Cook-Torrance BRDF
+        float NDF = DistributionGGX(N, H, roughness);   
+        float G   = GeometrySmith(N, V, L, roughness);      
+        vec3 F    = fresnelSchlick(max(dot(H, V), 0.0), F0);
+           
+        vec3 numerator    = NDF * G * F; 
+        float denominator = 4.0 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.0001; // + 0.0001 to prevent divide by zero
+        vec3 specular = numerator / denominator;
+        
+        // kS is equal to Fresnel
+        vec3 kS = F;
+        // for energy conservation, the diffuse and specular light can't
+        // be above 1.0 (unless the surface emits light); to preserve this
+        // relationship the diffuse component (kD) should equal 1.0 - kS.
+        vec3 kD = vec3(1.0) - kS;
+        // multiply kD by the inverse metalness such that only non-metals 
+        // have diffuse lighting, or a linear blend if partly metal (pure metals
+        // have no diffuse light).
+        kD *= 1.0 - metallic;	  
+
+        // scale light by NdotL
+        float NdotL = max(dot(N, L), 0.0);        
+
+        // add to outgoing radiance Lo
+        Lo += (kD * albedo / PI + specular) * radiance * NdotL;  // note that we already multiplied the BRDF by the Fresnel (kS) so we won't multiply by kS again
+    }   
+    
+    // ambient lighting (we now use IBL as the ambient term)
+    vec3 kS = fresnelSchlick(max(dot(N, V), 0.0), F0);
+    vec3 kD = 1.0 - kS;
+    kD *= 1.0 - metallic;	  
+    vec3 irradiance = texture(irradianceMap, N).rgb;
+    vec3 diffuse      = irradiance * albedo;
+    vec3 ambient = (kD * diffuse) * ao;
+
+    vec3 color = ambient + Lo;
+
+    // shadow
+    vec3 ShadowCoord = inShadowCoord.xyz / inShadowCoord.w;
+	// [-1, 1] -> [0, 1]
+	ShadowCoord.xy = ShadowCoord.xy * 0.5 + 0.5;
+	// flip y
+	ShadowCoord.y = 1.0 - ShadowCoord.y;
+    float depth0  = ShadowCoord.z - 0.0001; // light
+    float depth1  = texture(shadowMap, ShadowCoord.xy).r; // eye
+    float shadow  = 1.0;
+
+    if (depth0 >= depth1) {
+        shadow = 0.0;
+    }
+
+    color *= shadow;
+
+    // HDR tonemapping
+    color = color / (color + vec3(1.0));
+    // gamma correct
+    color = pow(color, vec3(1.0/2.2)); 
+
+    outFragColor = vec4(color, 1.0);
+}
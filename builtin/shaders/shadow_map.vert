@@ -10,12 +10,26 @@ layout (set = 0, binding = 0) uniform DirectionalLightData
 	mat4 projectionMatrix;
 } lightData;
 
-layout (set = 1, binding = 0) uniform PerObjDataDynamic 
+struct PerObjectData
 {
 	mat4 modelMatrix;
-} objData;
+	mat4 normalMatrix;
+};
+
+// indexed by game object
+layout (std430, set = 1, binding = 0) readonly buffer ObjectDataBuffer 
+{
+	PerObjectData objects[];
+} objectData;
+
+// game object of each instance, a draw covers the range from firstInstance
+layout (std430, set = 1, binding = 1) readonly buffer InstanceDataBuffer 
+{
+	uint objectIndices[];
+} instanceData;
 
 void main() 
 {
-	gl_Position = lightData.projectionMatrix * lightData.viewMatrix * objData.modelMatrix * vec4(inPosition.xyz, 1.0);
+	mat4 modelMatrix = objectData.objects[instanceData.objectIndices[gl_InstanceIndex]].modelMatrix;
+	gl_Position = lightData.projectionMatrix * lightData.viewMatrix * modelMatrix * vec4(inPosition.xyz, 1.0);
 }
\ No newline at end of file
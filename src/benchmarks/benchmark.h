@@ -0,0 +1,41 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace Meow
+{
+    /**
+     * @brief Best time of several runs in nanoseconds, so that one preempted run doesn't skew the result.
+     */
+    template<typename Func>
+    double MeasureBestNanoseconds(uint32_t run_count, Func&& func)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (uint32_t run = 0; run < run_count; ++run)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            func();
+            auto end = std::chrono::steady_clock::now();
+
+            best = std::min(best, std::chrono::duration<double, std::nano>(end - begin).count());
+        }
+        return best;
+    }
+
+    /**
+     * @brief Keep a value alive, so that the compiler can't drop the work computing it.
+     */
+    template<typename T>
+    void DoNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const T* sink;
+        sink = &value;
+#endif
+    }
+} // namespace Meow
@@ -0,0 +1,123 @@
+#include "benchmark.h"
+
+#include "function/components/light/directional_light_component.h"
+#include "function/components/transform/transform_3d_component.hpp"
+#include "function/object/game_object.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    /**
+     * @brief Components without generated type id, which are only found by scanning.
+     */
+    class HealthComponent : public Component
+    {};
+
+    class ScriptComponent : public Component
+    {};
+
+    /**
+     * @brief Exposes the lookup GameObject had before type ids: a scan comparing type names, then a dynamic cast.
+     */
+    class ScanLookupGameObject : public GameObject
+    {
+    public:
+        using GameObject::GameObject;
+
+        template<typename TComponent>
+        std::shared_ptr<TComponent> TryGetComponentByScan(const std::string& component_type_name)
+        {
+            for (auto& refl_component : m_refl_components)
+            {
+                if (refl_component.type_name == component_type_name)
+                {
+                    return std::dynamic_pointer_cast<TComponent>(refl_component.shared_ptr);
+                }
+            }
+
+            return std::shared_ptr<TComponent>(nullptr);
+        }
+    };
+
+    std::vector<std::shared_ptr<ScanLookupGameObject>> CreateGameObjects(size_t count)
+    {
+        std::vector<std::shared_ptr<ScanLookupGameObject>> gameobjects;
+        gameobjects.reserve(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto gameobject = std::make_shared<ScanLookupGameObject>(UUID(i + 1));
+
+            // the light is added last, so the scan walks every component before finding it
+            TryAddComponent(gameobject, "Transform3DComponent", std::make_shared<Transform3DComponent>());
+            TryAddComponent(gameobject, "HealthComponent", std::make_shared<HealthComponent>());
+            TryAddComponent(gameobject, "ScriptComponent", std::make_shared<ScriptComponent>());
+            TryAddComponent(gameobject, "DirectionalLightComponent", std::make_shared<DirectionalLightComponent>());
+
+            gameobjects.push_back(std::move(gameobject));
+        }
+
+        return gameobjects;
+    }
+} // namespace
+
+/**
+ * @brief Per-lookup cost of finding the transform and the light of every game object, by name scan and by type id.
+ */
+int main()
+{
+    constexpr uint32_t k_run_count = 5;
+
+    std::printf("%10s %18s %18s %10s\n", "objects", "scan ns/lookup", "type id ns/lookup", "speedup");
+
+    for (size_t object_count : {1000, 10000, 100000})
+    {
+        auto   gameobjects  = CreateGameObjects(object_count);
+        double lookup_count = static_cast<double>(object_count) * 2;
+
+        size_t scan_found = 0;
+        double scan_ns    = MeasureBestNanoseconds(k_run_count, [&]() {
+            scan_found = 0;
+            for (const auto& gameobject : gameobjects)
+            {
+                scan_found += gameobject->TryGetComponentByScan<Transform3DComponent>("Transform3DComponent") != nullptr;
+                scan_found += gameobject->TryGetComponentByScan<DirectionalLightComponent>(
+                                  "DirectionalLightComponent") != nullptr;
+            }
+            DoNotOptimize(scan_found);
+        });
+
+        size_t type_id_found = 0;
+        double type_id_ns    = MeasureBestNanoseconds(k_run_count, [&]() {
+            type_id_found = 0;
+            for (const auto& gameobject : gameobjects)
+            {
+                type_id_found += gameobject->TryGetComponent<Transform3DComponent>() != nullptr;
+                type_id_found += gameobject->TryGetComponent<DirectionalLightComponent>() != nullptr;
+            }
+            DoNotOptimize(type_id_found);
+        });
+
+        if (scan_found != object_count * 2 || type_id_found != object_count * 2)
+        {
+            std::printf("lookups missed components: scan found %zu, type id found %zu of %zu\n",
+                        scan_found,
+                        type_id_found,
+                        object_count * 2);
+            return 1;
+        }
+
+        std::printf("%10zu %18.2f %18.2f %9.1fx\n",
+                    object_count,
+                    scan_ns / lookup_count,
+                    type_id_ns / lookup_count,
+                    scan_ns / type_id_ns);
+    }
+
+    return 0;
+}
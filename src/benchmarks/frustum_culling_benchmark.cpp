@@ -0,0 +1,130 @@
+#include "benchmark.h"
+
+#include "core/math/frustum.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    /**
+     * @brief The test Frustum::checkIfInside had before the batch API: a box is outside when all 8 corners are behind
+     * one plane, which is 48 plane distances for a visible box.
+     */
+    bool CheckCornersInside(const std::array<glm::vec4, 6>& planes, const BoundingBox& box)
+    {
+        for (const glm::vec4& plane : planes)
+        {
+            int out = 0;
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                glm::vec3 point((corner & 1) ? box.max.x : box.min.x,
+                                (corner & 2) ? box.max.y : box.min.y,
+                                (corner & 4) ? box.max.z : box.min.z);
+                out += glm::dot(glm::vec3(plane), point) + plane.w < 0.0f ? 1 : 0;
+            }
+
+            if (out == 8)
+                return false;
+        }
+        return true;
+    }
+} // namespace
+
+/**
+ * @brief Cost per box of culling random boxes around the camera, by corners, by p-vertex per box and in batch.
+ */
+int main()
+{
+    constexpr uint32_t k_run_count = 5;
+
+    Frustum frustum;
+    frustum.updatePlanes(
+        glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    std::array<glm::vec4, 6> planes = frustum.GetPlaneEquations();
+
+    std::printf("%10s %16s %16s %16s %10s %10s\n",
+                "boxes",
+                "corners ns/box",
+                "p-vertex ns/box",
+                "batch ns/box",
+                "speedup",
+                "visible");
+
+    for (size_t box_count : {10000, 100000, 1000000})
+    {
+        std::mt19937                          engine(42);
+        std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> extent(0.5f, 5.0f);
+
+        std::vector<BoundingBox> boxes;
+        BoundingBoxColumns       columns;
+        for (size_t i = 0; i < box_count; ++i)
+        {
+            glm::vec3 center(position(engine), position(engine), position(engine));
+            glm::vec3 extents(extent(engine), extent(engine), extent(engine));
+            boxes.emplace_back(center - extents, center + extents);
+            columns.PushBack(boxes.back());
+        }
+
+        size_t corners_visible = 0;
+        double corners_ns      = MeasureBestNanoseconds(k_run_count, [&]() {
+            corners_visible = 0;
+            for (const BoundingBox& box : boxes)
+            {
+                corners_visible += CheckCornersInside(planes, box);
+            }
+            DoNotOptimize(corners_visible);
+        });
+
+        size_t p_vertex_visible = 0;
+        double p_vertex_ns      = MeasureBestNanoseconds(k_run_count, [&]() {
+            p_vertex_visible = 0;
+            for (BoundingBox& box : boxes)
+            {
+                p_vertex_visible += frustum.checkIfInside(&box);
+            }
+            DoNotOptimize(p_vertex_visible);
+        });
+
+        std::vector<uint8_t> visibilities;
+        double               batch_ns = MeasureBestNanoseconds(k_run_count, [&]() {
+            frustum.CheckIfInside(columns, visibilities);
+            DoNotOptimize(visibilities.data());
+        });
+
+        // the tests must agree box by box, a faster kernel is worthless otherwise
+        size_t batch_visible = 0;
+        for (size_t i = 0; i < box_count; ++i)
+        {
+            if (visibilities[i] != CheckCornersInside(planes, boxes[i]))
+            {
+                std::printf("batch test disagrees with the corner test at box %zu\n", i);
+                return 1;
+            }
+            batch_visible += visibilities[i];
+        }
+
+        if (p_vertex_visible != corners_visible)
+        {
+            std::printf("p-vertex test found %zu visible boxes, the corner test %zu\n",
+                        p_vertex_visible,
+                        corners_visible);
+            return 1;
+        }
+
+        double count = static_cast<double>(box_count);
+        std::printf("%10zu %16.2f %16.2f %16.2f %9.1fx %10zu\n",
+                    box_count,
+                    corners_ns / count,
+                    p_vertex_ns / count,
+                    batch_ns / count,
+                    corners_ns / batch_ns,
+                    batch_visible);
+    }
+
+    return 0;
+}
@@ -2,7 +2,9 @@
 
 #include "utils/code_gen_utils.h"
 
+#include <algorithm>
 #include <iomanip>
+#include <unordered_set>
 
 namespace Meow
 {
@@ -130,6 +132,8 @@ namespace Meow
 
         output_source_file << "} // namespace Meow" << std::endl;
         output_source_file.close();
+
+        GenerateComponentTypeIDHeaderFile(class_results);
     }
 
     void CodeGenerator::End()
@@ -181,4 +185,106 @@ namespace Meow
                       << output_path.string() + "/" + gen_header_file_name + ".gen.h" << std::endl;
         }
     }
+
+    void CodeGenerator::GenerateComponentTypeIDHeaderFile(const std::vector<ClassParseResult>& class_results)
+    {
+        static const std::string component_base_name = "Component";
+
+        // collect every class deriving from Component, directly or indirectly
+
+        std::unordered_set<std::string> component_name_set = {component_base_name};
+
+        bool has_new_component = true;
+        while (has_new_component)
+        {
+            has_new_component = false;
+            for (const auto& class_result : class_results)
+            {
+                if (component_name_set.find(class_result.class_name) != component_name_set.end())
+                    continue;
+
+                for (const auto& base_class_name : class_result.base_class_names)
+                {
+                    if (component_name_set.find(base_class_name) != component_name_set.end())
+                    {
+                        component_name_set.insert(class_result.class_name);
+                        has_new_component = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // sort by name so that ids don't depend on file traversal order
+
+        std::vector<const ClassParseResult*> component_results;
+        for (const auto& class_result : class_results)
+        {
+            if (class_result.class_name != component_base_name &&
+                component_name_set.find(class_result.class_name) != component_name_set.end())
+            {
+                component_results.push_back(&class_result);
+            }
+        }
+
+        std::sort(component_results.begin(),
+                  component_results.end(),
+                  [](const ClassParseResult* a, const ClassParseResult* b) { return a->class_name < b->class_name; });
+
+        std::stringstream gen_header_stream;
+
+        gen_header_stream << "#pragma once" << std::endl;
+        gen_header_stream << std::endl;
+        gen_header_stream << "#include \"function/object/component_type_id.h\"" << std::endl;
+        gen_header_stream << std::endl;
+        gen_header_stream << "namespace Meow" << std::endl;
+        gen_header_stream << "{" << std::endl;
+
+        for (const auto* component_result : component_results)
+        {
+            gen_header_stream << "    " << (component_result->is_struct ? "struct " : "class ")
+                              << component_result->class_name << ";" << std::endl;
+        }
+
+        for (size_t i = 0; i < component_results.size(); ++i)
+        {
+            gen_header_stream << std::endl;
+            gen_header_stream << "    template<>" << std::endl;
+            gen_header_stream << "    struct ComponentTypeTraits<" << component_results[i]->class_name << ">"
+                              << std::endl;
+            gen_header_stream << "    {" << std::endl;
+            gen_header_stream << "        static constexpr ComponentTypeID id   = " << i << ";" << std::endl;
+            gen_header_stream << "        static constexpr const char*     name = "
+                              << std::quoted(component_results[i]->class_name) << ";" << std::endl;
+            gen_header_stream << "    };" << std::endl;
+        }
+
+        gen_header_stream << std::endl;
+        gen_header_stream << "    inline constexpr ComponentTypeID k_component_type_count = " << component_results.size()
+                          << ";" << std::endl;
+        gen_header_stream << std::endl;
+        gen_header_stream << "    static_assert(k_component_type_count <= k_max_component_types, "
+                          << "\"Too many component types for ComponentMask\");" << std::endl;
+        gen_header_stream << std::endl;
+        gen_header_stream << "    inline constexpr const char* k_component_type_names[] = {";
+        for (size_t i = 0; i < component_results.size(); ++i)
+        {
+            gen_header_stream << (i == 0 ? "" : ", ") << std::quoted(component_results[i]->class_name);
+        }
+        gen_header_stream << "};" << std::endl;
+        gen_header_stream << "} // namespace Meow" << std::endl;
+
+        std::string   gen_header_file_path = output_path.string() + "/component_type_id.gen.h";
+        std::ofstream output_header_file(gen_header_file_path);
+        if (output_header_file.is_open())
+        {
+            output_header_file << gen_header_stream.str();
+            output_header_file.close();
+            std::cout << "[CodeGenerator] Generated: " << gen_header_file_path << std::endl;
+        }
+        else
+        {
+            std::cerr << "[CodeGenerator] Fail to write: " << gen_header_file_path << std::endl;
+        }
+    }
 } // namespace Meow
\ No newline at end of file
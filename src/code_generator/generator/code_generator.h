@@ -26,6 +26,8 @@ namespace Meow
     private:
         void GenerateEnumReflHeaderFile(const EnumParseResult& enum_result);
 
+        void GenerateComponentTypeIDHeaderFile(const std::vector<ClassParseResult>& class_results);
+
         bool              is_recording = false;
         fs::path          src_path;
         fs::path          output_path;
@@ -11,6 +11,8 @@ namespace Meow
     struct ClassParseResult
     {
         std::string                    class_name;
+        bool                           is_struct = false;
+        std::vector<std::string>       base_class_names;
         std::vector<FieldParseResult>  field_results;
         std::vector<MethodParseResult> method_results;
     };
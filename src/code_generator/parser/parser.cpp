@@ -132,14 +132,43 @@ namespace Meow
 
         ClassParseResult class_result;
         class_result.class_name = class_name;
+        class_result.is_struct  = clang_getCursorKind(class_cursor) == CXCursor_StructDecl;
+
+        struct ClassParseContext
+        {
+            ClassParseResult* class_result;
+            CXCursor          class_cursor;
+        };
+
+        ClassParseContext class_parse_context {&class_result, class_cursor};
 
         clang_visitChildren(
             class_cursor,
             [](CXCursor c, CXCursor parent, CXClientData client_data) {
-                if (clang_getCursorKind(c) == CXCursor_AnnotateAttr)
+                ClassParseContext* context_ptr  = static_cast<ClassParseContext*>(client_data);
+                ClassParseResult*  class_result = context_ptr->class_result;
+
+                // only direct bases, not bases of nested classes
+                if (clang_getCursorKind(c) == CXCursor_CXXBaseSpecifier)
                 {
-                    ClassParseResult* class_result = static_cast<ClassParseResult*>(client_data);
+                    if (clang_equalCursors(parent, context_ptr->class_cursor))
+                    {
+                        std::string base_name =
+                            CodeGenUtils::to_string(clang_getTypeSpelling(clang_getCursorType(c)));
 
+                        // strip namespace, such as Meow::Component
+                        size_t namespace_end = base_name.rfind("::");
+                        if (namespace_end != std::string::npos)
+                            base_name = base_name.substr(namespace_end + 2);
+
+                        class_result->base_class_names.push_back(base_name);
+                    }
+
+                    return CXChildVisit_Continue;
+                }
+
+                if (clang_getCursorKind(c) == CXCursor_AnnotateAttr)
+                {
                     std::vector<std::string> annotations =
                         CodeGenUtils::split(CodeGenUtils::to_string(clang_getCursorSpelling(c)), ';');
                     if (annotations.size() == 0)
@@ -173,7 +202,7 @@ namespace Meow
 
                 return CXChildVisit_Recurse;
             },
-            &class_result);
+            &class_parse_context);
 
         class_results.push_back(class_result);
 
@@ -241,6 +270,8 @@ namespace Meow
         for (const auto& res : class_results)
         {
             ss << "Class: " << res.class_name << "\n";
+            for (const auto& b : res.base_class_names)
+                ss << "  Base: " << b << "\n";
             for (const auto& f : res.field_results)
                 ss << "  Field: " << f.field_type_name << " " << f.field_name << "\n";
             for (const auto& m : res.method_results)
@@ -60,8 +60,8 @@ namespace Meow
             if (!camera_ptr)
                 MEOW_ERROR("shared ptr is invalid!");
 
-            transform_ptr->position = glm::vec3(0.0f, 10.0f, -6.0f);
-            transform_ptr->rotation = glm::quat(glm::vec3(-100.0f, 0.0f, 0.0f));
+            transform_ptr->SetPosition(glm::vec3(0.0f, 10.0f, -6.0f));
+            transform_ptr->SetRotation(glm::quat(glm::vec3(-100.0f, 0.0f, 0.0f)));
 
             camera_ptr->camera_mode  = CameraMode::Free;
             camera_ptr->aspect_ratio = static_cast<float>(m_surface_data.extent.width) / m_surface_data.extent.height;
@@ -74,8 +74,8 @@ namespace Meow
                 current_gameobject, "DirectionalLightComponent", std::make_shared<DirectionalLightComponent>());
             auto directional_light_transform =
                 TryAddComponent(current_gameobject, "Transform3DComponent", std::make_shared<Transform3DComponent>());
-            directional_light_transform->position = glm::vec3(0.0f, 30.0f, -50.0f);
-            directional_light_transform->rotation = glm::quat(glm::vec3(-100.0f, 0.0f, 0.0f));
+            directional_light_transform->SetPosition(glm::vec3(0.0f, 30.0f, -50.0f));
+            directional_light_transform->SetRotation(glm::quat(glm::vec3(-100.0f, 0.0f, 0.0f)));
         }
 
         GeometryFactory geometry_factory;
@@ -186,12 +186,12 @@ namespace Meow
             current_gameobject->SetName("Cube");
             auto transform_ptr =
                 TryAddComponent(current_gameobject, "Transform3DComponent", std::make_shared<Transform3DComponent>());
-            transform_ptr->position = glm::vec3(0.0f, 0.0f, 10.0f);
+            transform_ptr->SetPosition(glm::vec3(0.0f, 0.0f, 10.0f));
 
             auto current_gameobject_model_component =
                 TryAddComponent(current_gameobject, "ModelComponent", std::make_shared<ModelComponent>());
-            auto model_shared_ptr =
-                std::make_shared<Model>(cube_vertices, cube_indices, m_render_pass_ptr->input_vertex_attributes);
+            auto model_handle = g_runtime_context.resource_system->LoadModel(
+                cube_vertices, cube_indices, m_render_pass_ptr->input_vertex_attributes);
 
             // TODO: hard code render pass cast
             current_gameobject_model_component->material_id = m_forward_pass.GetForwardMatID();
@@ -218,11 +218,13 @@ namespace Meow
                 }
             }
 
-            if (model_shared_ptr)
+            if (model_handle.IsValid())
             {
-                g_runtime_context.resource_system->Register(model_shared_ptr);
-                current_gameobject_model_component->model = model_shared_ptr;
+                current_gameobject_model_component->SetModel(model_handle);
             }
+
+            // the component holds its own reference
+            g_runtime_context.resource_system->Release(model_handle);
         }
 
         geometry_factory.SetPlane();
@@ -243,22 +245,24 @@ namespace Meow
             current_gameobject->SetName("Plane");
             auto transform_ptr =
                 TryAddComponent(current_gameobject, "Transform3DComponent", std::make_shared<Transform3DComponent>());
-            transform_ptr->position = glm::vec3(0.0f, -10.0f, 10.0f);
-            transform_ptr->scale    = glm::vec3(20.0f, 20.0f, 20.0f);
+            transform_ptr->SetPosition(glm::vec3(0.0f, -10.0f, 10.0f));
+            transform_ptr->SetScale(glm::vec3(20.0f, 20.0f, 20.0f));
 
             auto current_gameobject_model_component =
                 TryAddComponent(current_gameobject, "ModelComponent", std::make_shared<ModelComponent>());
-            auto model_shared_ptr =
-                std::make_shared<Model>(plane_vertices, plane_indices, m_render_pass_ptr->input_vertex_attributes);
+            auto model_handle = g_runtime_context.resource_system->LoadModel(
+                plane_vertices, plane_indices, m_render_pass_ptr->input_vertex_attributes);
 
             // TODO: hard code render pass cast
             current_gameobject_model_component->material_id = m_forward_pass.GetForwardMatID();
 
-            if (model_shared_ptr)
+            if (model_handle.IsValid())
             {
-                g_runtime_context.resource_system->Register(model_shared_ptr);
-                current_gameobject_model_component->model = model_shared_ptr;
+                current_gameobject_model_component->SetModel(model_handle);
             }
+
+            // the component holds its own reference
+            g_runtime_context.resource_system->Release(model_handle);
         }
 
         {
@@ -277,22 +281,24 @@ namespace Meow
             current_gameobject->SetName("Plane for test");
             auto transform_ptr =
                 TryAddComponent(current_gameobject, "Transform3DComponent", std::make_shared<Transform3DComponent>());
-            transform_ptr->position = glm::vec3(0.0f, 0.0f, 0.0f);
-            transform_ptr->scale    = glm::vec3(20.0f, 20.0f, 20.0f);
+            transform_ptr->SetPosition(glm::vec3(0.0f, 0.0f, 0.0f));
+            transform_ptr->SetScale(glm::vec3(20.0f, 20.0f, 20.0f));
 
             auto current_gameobject_model_component =
                 TryAddComponent(current_gameobject, "ModelComponent", std::make_shared<ModelComponent>());
-            auto model_shared_ptr =
-                std::make_shared<Model>(plane_vertices, plane_indices, m_render_pass_ptr->input_vertex_attributes);
+            auto model_handle = g_runtime_context.resource_system->LoadModel(
+                plane_vertices, plane_indices, m_render_pass_ptr->input_vertex_attributes);
 
             // TODO: hard code render pass cast
             current_gameobject_model_component->material_id = m_forward_pass.GetForwardMatID();
 
-            if (model_shared_ptr)
+            if (model_handle.IsValid())
             {
-                g_runtime_context.resource_system->Register(model_shared_ptr);
-                current_gameobject_model_component->model = model_shared_ptr;
+                current_gameobject_model_component->SetModel(model_handle);
             }
+
+            // the component holds its own reference
+            g_runtime_context.resource_system->Release(model_handle);
         }
     }
 
@@ -342,6 +348,15 @@ namespace Meow
         auto& compute_finished_semaphore = frame_data.compute_finished_semaphore;
         auto& compute_in_flight_fence    = frame_data.compute_in_flight_fence;
 
+        // per frame buffers of this slot are rewritten below, so both submissions that last read them must be done
+        while (vk::Result::eTimeout ==
+               logical_device.waitForFences(
+                   {*compute_in_flight_fence, *graphics_in_flight_fence}, VK_TRUE, k_fence_timeout))
+            ;
+
+        g_runtime_context.render_system->GetDynamicUniformAllocator().BeginFrame(m_frame_index);
+        g_runtime_context.render_system->GetObjectDataBuffer().BeginFrame(m_frame_index);
+
         m_shadow_map_pass.UpdateUniformBuffer(m_frame_index);
         m_shadow_coord_to_color_pass.UpdateUniformBuffer(m_frame_index);
         m_render_pass_ptr->UpdateUniformBuffer(m_frame_index);
@@ -350,11 +365,6 @@ namespace Meow
 
         // ------------------- compute -------------------
 
-        while (vk::Result::eTimeout ==
-               logical_device.waitForFences({*compute_in_flight_fence}, VK_TRUE, k_fence_timeout))
-            ;
-        logical_device.resetFences({*compute_in_flight_fence});
-
         compute_command_buffer.reset();
         compute_command_buffer.begin({});
 
@@ -362,18 +372,18 @@ namespace Meow
 
         compute_command_buffer.end();
 
+        // uploads are ordered before the frame by submitting them first
+        g_runtime_context.render_system->GetUploadManager().Flush();
+
         {
+            logical_device.resetFences({*compute_in_flight_fence});
+
             vk::SubmitInfo submit_info({}, {}, *compute_command_buffer, *compute_finished_semaphore);
             compute_queue.submit(submit_info, *compute_in_flight_fence);
         }
 
         // ------------------- render -------------------
 
-        while (vk::Result::eTimeout ==
-               logical_device.waitForFences({*graphics_in_flight_fence}, VK_TRUE, k_fence_timeout))
-            ;
-        logical_device.resetFences({*graphics_in_flight_fence});
-
         auto [result, image_index] =
             SwapchainNextImageWrapper(m_swapchain_data.swap_chain, k_fence_timeout, *present_finished_semaphore);
         if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR || m_framebuffer_resized)
@@ -388,32 +398,19 @@ namespace Meow
         command_buffer.reset();
         command_buffer.begin({});
 
-        m_shadow_map_pass.Start(command_buffer, m_surface_data.extent, image_index);
-        m_shadow_map_pass.RecordGraphicsCommand(command_buffer, m_frame_index);
-        m_shadow_map_pass.End(command_buffer);
-
-        m_depth_to_color_pass.Start(command_buffer, m_surface_data.extent, image_index);
-        m_depth_to_color_pass.RecordGraphicsCommand(command_buffer, m_frame_index);
-        m_depth_to_color_pass.End(command_buffer);
-
-        m_shadow_coord_to_color_pass.Start(command_buffer, m_surface_data.extent, image_index);
-        m_shadow_coord_to_color_pass.RecordGraphicsCommand(command_buffer, m_frame_index);
-        m_shadow_coord_to_color_pass.End(command_buffer);
-
-        m_render_pass_ptr->Start(command_buffer, m_surface_data.extent, image_index);
-        m_render_pass_ptr->RecordGraphicsCommand(command_buffer, m_frame_index);
-        m_render_pass_ptr->End(command_buffer);
-
-        m_compute_particle_pass.Start(command_buffer, m_surface_data.extent, image_index);
-        m_compute_particle_pass.RecordGraphicsCommand(command_buffer, m_frame_index);
-        m_compute_particle_pass.End(command_buffer);
-
-        m_imgui_pass.Start(command_buffer, m_surface_data.extent, image_index);
-        m_imgui_pass.RecordGraphicsCommand(command_buffer, m_frame_index);
-        m_imgui_pass.End(command_buffer);
+        RecordRenderPasses(command_buffer,
+                           {&m_shadow_map_pass,
+                            &m_depth_to_color_pass,
+                            &m_shadow_coord_to_color_pass,
+                            m_render_pass_ptr,
+                            &m_compute_particle_pass,
+                            &m_imgui_pass},
+                           image_index);
 
         command_buffer.end();
 
+        g_runtime_context.render_system->GetUploadManager().Flush();
+
         {
             std::array<const vk::PipelineStageFlags, 2> wait_destination_stage_masks {
                 vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eVertexInput};
@@ -421,6 +418,9 @@ namespace Meow
                                                                 *compute_finished_semaphore};
             vk::SubmitInfo                     submit_info(
                 wait_semaphores, wait_destination_stage_masks, *command_buffer, *render_finished_semaphore);
+
+            // reset only now, so that returning early above leaves the fence signaled for the next wait
+            logical_device.resetFences({*graphics_in_flight_fence});
             graphics_queue.submit(submit_info, *graphics_in_flight_fence);
         }
 
@@ -472,6 +472,10 @@ namespace Meow
             });
         });
 
+        m_imgui_pass.OnGPUCullingEnabledChanged().connect([&](bool enabled) {
+            m_wait_until_next_tick_signal.connect([&, enabled]() { m_forward_pass.SetGPUCullingEnabled(enabled); });
+        });
+
         m_imgui_pass.OnPassChanged().connect([&](int cur_render_pass) {
             // switch render pass
             if (cur_render_pass == 0)
@@ -486,8 +490,7 @@ namespace Meow
                 auto opaque_object_ptr = opaque_objects[i].lock();
                 if (opaque_object_ptr)
                 {
-                    auto current_gameobject_model_component =
-                        opaque_object_ptr->TryGetComponent<ModelComponent>("ModelComponent");
+                    auto current_gameobject_model_component = opaque_object_ptr->TryGetComponent<ModelComponent>();
 
                     if (cur_render_pass == 1)
                         current_gameobject_model_component->material_id = m_forward_pass.GetForwardMatID();
@@ -569,6 +572,7 @@ namespace Meow
         init_info.Device                    = *logical_device;
         init_info.QueueFamily               = graphics_queue_family_index;
         init_info.Queue                     = *graphics_queue;
+        init_info.PipelineCache             = *g_runtime_context.render_system->GetPipelineCache().GetPipelineCache();
         init_info.DescriptorPool            = *m_imgui_descriptor_pool;
         init_info.Subpass                   = 0;
         init_info.MinImageCount             = k_max_frames_in_flight;
@@ -613,8 +617,7 @@ namespace Meow
         if (!current_gameobject)
             return;
 
-        std::shared_ptr<Camera3DComponent> camera_ptr =
-            current_gameobject->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+        std::shared_ptr<Camera3DComponent> camera_ptr = current_gameobject->TryGetComponent<Camera3DComponent>();
 
         camera_ptr->aspect_ratio = static_cast<float>(m_surface_data.extent.width) / m_surface_data.extent.height;
     }
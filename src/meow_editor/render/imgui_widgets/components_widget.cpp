@@ -11,52 +11,54 @@ namespace Meow
     ComponentsWidget::ComponentsWidget()
     {
         m_editor_ui_creator["TreeNodePush"] =
-            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) {
+            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) -> bool {
                 ImGui::PushID(value_ptr);
 
                 ImGuiTreeNodeFlags flag = ImGuiTreeNodeFlags_DefaultOpen;
                 node_states.push(ImGui::TreeNodeEx(name.c_str(), flag));
 
                 ImGui::PopID();
+                return false;
             };
 
         m_editor_ui_creator["TreeNodePop"] =
-            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) {
+            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) -> bool {
                 if (node_states.empty())
                 {
                     MEOW_ERROR("Tree node structure is wrong!");
-                    return;
+                    return false;
                 }
 
                 if (node_states.top())
                     ImGui::TreePop();
                 node_states.pop();
+                return false;
             };
 
         m_editor_ui_creator["glm::vec3"] =
-            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) {
+            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) -> bool {
                 if (node_states.empty())
                 {
                     MEOW_ERROR("Tree node structure is wrong!");
-                    return;
+                    return false;
                 }
 
                 if (!node_states.top())
-                    return;
+                    return false;
 
-                DrawVecControl(name, *static_cast<glm::vec3*>(value_ptr));
+                return DrawVecControl(name, *static_cast<glm::vec3*>(value_ptr));
             };
 
         m_editor_ui_creator["glm::quat"] =
-            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) {
+            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) -> bool {
                 if (node_states.empty())
                 {
                     MEOW_ERROR("Tree node structure is wrong!");
-                    return;
+                    return false;
                 }
 
                 if (!node_states.top())
-                    return;
+                    return false;
 
                 glm::quat& rotation = *static_cast<glm::quat*>(value_ptr);
                 glm::vec3  euler    = glm::eulerAngles(rotation);
@@ -66,86 +68,95 @@ namespace Meow
                 degrees_val.y = glm::degrees(euler.y); // roll
                 degrees_val.z = glm::degrees(euler.z); // yaw
 
-                DrawVecControl(name, degrees_val);
+                // converting to euler angles and back isn't exact, so only write back what has been edited
+                if (!DrawVecControl(name, degrees_val))
+                    return false;
 
                 euler.x = glm::radians(degrees_val.x);
                 euler.y = glm::radians(degrees_val.y);
                 euler.z = glm::radians(degrees_val.z);
 
                 rotation = glm::quat(euler);
+                return true;
             };
 
-        m_editor_ui_creator["bool"] = [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) {
-            if (node_states.empty())
-            {
-                MEOW_ERROR("Tree node structure is wrong!");
-                return;
-            }
+        m_editor_ui_creator["bool"] =
+            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) -> bool {
+                if (node_states.empty())
+                {
+                    MEOW_ERROR("Tree node structure is wrong!");
+                    return false;
+                }
 
-            if (!node_states.top())
-                return;
+                if (!node_states.top())
+                    return false;
 
-            ImGui::PushID(value_ptr);
+                ImGui::PushID(value_ptr);
 
-            ImGui::Text("%s", name.c_str());
-            ImGui::SameLine();
-            ImGui::Checkbox(name.c_str(), static_cast<bool*>(value_ptr));
+                ImGui::Text("%s", name.c_str());
+                ImGui::SameLine();
+                bool changed = ImGui::Checkbox(name.c_str(), static_cast<bool*>(value_ptr));
 
-            ImGui::PopID();
-        };
+                ImGui::PopID();
+                return changed;
+            };
 
-        m_editor_ui_creator["int"] = [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) {
-            if (node_states.empty())
-            {
-                MEOW_ERROR("Tree node structure is wrong!");
-                return;
-            }
+        m_editor_ui_creator["int"] =
+            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) -> bool {
+                if (node_states.empty())
+                {
+                    MEOW_ERROR("Tree node structure is wrong!");
+                    return false;
+                }
 
-            if (!node_states.top())
-                return;
+                if (!node_states.top())
+                    return false;
 
-            ImGui::PushID(value_ptr);
+                ImGui::PushID(value_ptr);
 
-            ImGui::Text("%s", name.c_str());
-            ImGui::SameLine();
-            ImGui::PushItemWidth(-FLT_MIN); // disable showing label for input
-            ImGui::InputInt(name.c_str(), static_cast<int*>(value_ptr));
-            ImGui::PopItemWidth();
+                ImGui::Text("%s", name.c_str());
+                ImGui::SameLine();
+                ImGui::PushItemWidth(-FLT_MIN); // disable showing label for input
+                bool changed = ImGui::InputInt(name.c_str(), static_cast<int*>(value_ptr));
+                ImGui::PopItemWidth();
 
-            ImGui::PopID();
-        };
+                ImGui::PopID();
+                return changed;
+            };
 
-        m_editor_ui_creator["float"] = [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) {
-            if (node_states.empty())
-            {
-                MEOW_ERROR("Tree node structure is wrong!");
-                return;
-            }
+        m_editor_ui_creator["float"] =
+            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) -> bool {
+                if (node_states.empty())
+                {
+                    MEOW_ERROR("Tree node structure is wrong!");
+                    return false;
+                }
 
-            if (!node_states.top())
-                return;
+                if (!node_states.top())
+                    return false;
 
-            ImGui::PushID(value_ptr);
+                ImGui::PushID(value_ptr);
 
-            ImGui::Text("%s", name.c_str());
-            ImGui::SameLine();
-            ImGui::PushItemWidth(-FLT_MIN); // disable showing label for input
-            ImGui::InputFloat(name.c_str(), static_cast<float*>(value_ptr));
-            ImGui::PopItemWidth();
+                ImGui::Text("%s", name.c_str());
+                ImGui::SameLine();
+                ImGui::PushItemWidth(-FLT_MIN); // disable showing label for input
+                bool changed = ImGui::InputFloat(name.c_str(), static_cast<float*>(value_ptr));
+                ImGui::PopItemWidth();
 
-            ImGui::PopID();
-        };
+                ImGui::PopID();
+                return changed;
+            };
 
         m_editor_ui_creator["std::string"] =
-            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) {
+            [&](std::stack<bool>& node_states, const std::string& name, void* value_ptr) -> bool {
                 if (node_states.empty())
                 {
                     MEOW_ERROR("Tree node structure is wrong!");
-                    return;
+                    return false;
                 }
 
                 if (!node_states.top())
-                    return;
+                    return false;
 
                 ImGui::PushID(value_ptr);
 
@@ -154,6 +165,7 @@ namespace Meow
                 ImGui::Text("%s", (*static_cast<std::string*>(value_ptr)).c_str());
 
                 ImGui::PopID();
+                return false;
             };
     }
 
@@ -181,11 +193,13 @@ namespace Meow
         const std::vector<reflect::FieldAccessor>& field_accessors = type_desc.GetFields();
         for (const reflect::FieldAccessor& field_accessor : field_accessors)
         {
-            if (m_editor_ui_creator.find(field_accessor.type_name()) != m_editor_ui_creator.end())
-            {
-                m_editor_ui_creator[field_accessor.type_name()](
-                    m_node_states, field_accessor.name(), field_accessor.get(comp_ptr.shared_ptr.get()));
-            }
+            if (m_editor_ui_creator.find(field_accessor.type_name()) == m_editor_ui_creator.end())
+                continue;
+
+            // widgets edit the field in place, setting it again lets the component know it changed
+            void* value_ptr = field_accessor.get(comp_ptr.shared_ptr.get());
+            if (m_editor_ui_creator[field_accessor.type_name()](m_node_states, field_accessor.name(), value_ptr))
+                field_accessor.set(comp_ptr.shared_ptr.get(), value_ptr);
         }
 
         const std::vector<reflect::ArrayAccessor>& array_accessors = type_desc.GetArrays();
@@ -203,11 +217,13 @@ namespace Meow
         }
     }
 
-    void
+    bool
     ComponentsWidget::DrawVecControl(const std::string& label, glm::vec3& values, float reset_value, float column_width)
     {
         FUNCTION_TIMER();
 
+        bool changed = false;
+
         ImGui::PushID(&values);
 
         ImGui::Columns(2);
@@ -228,11 +244,14 @@ namespace Meow
         ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4 {0.9f, 0.2f, 0.2f, 1.0f});
         ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4 {0.8f, 0.1f, 0.15f, 1.0f});
         if (ImGui::Button("X", buttonSize))
+        {
             values.x = reset_value;
+            changed  = true;
+        }
         ImGui::PopStyleColor(3);
 
         ImGui::SameLine();
-        ImGui::DragFloat("##X", &values.x, 0.1f, 0.0f, 0.0f, "%.2f");
+        changed |= ImGui::DragFloat("##X", &values.x, 0.1f, 0.0f, 0.0f, "%.2f");
 
         ImGui::SameLine();
 
@@ -240,11 +259,14 @@ namespace Meow
         ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4 {0.3f, 0.55f, 0.3f, 1.0f});
         ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4 {0.2f, 0.45f, 0.2f, 1.0f});
         if (ImGui::Button("Y", buttonSize))
+        {
             values.y = reset_value;
+            changed  = true;
+        }
         ImGui::PopStyleColor(3);
 
         ImGui::SameLine();
-        ImGui::DragFloat("##Y", &values.y, 0.1f, 0.0f, 0.0f, "%.2f");
+        changed |= ImGui::DragFloat("##Y", &values.y, 0.1f, 0.0f, 0.0f, "%.2f");
 
         ImGui::SameLine();
 
@@ -252,16 +274,21 @@ namespace Meow
         ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4 {0.2f, 0.35f, 0.9f, 1.0f});
         ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4 {0.1f, 0.25f, 0.8f, 1.0f});
         if (ImGui::Button("Z", buttonSize))
+        {
             values.z = reset_value;
+            changed  = true;
+        }
         ImGui::PopStyleColor(3);
 
         ImGui::SameLine();
-        ImGui::DragFloat("##Z", &values.z, 0.1f, 0.0f, 0.0f, "%.2f");
+        changed |= ImGui::DragFloat("##Z", &values.z, 0.1f, 0.0f, 0.0f, "%.2f");
 
         ImGui::PopItemWidth();
         ImGui::PopStyleVar();
 
         ImGui::Columns(1);
         ImGui::PopID();
+
+        return changed;
     }
 } // namespace Meow
\ No newline at end of file
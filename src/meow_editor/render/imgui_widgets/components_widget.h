@@ -20,12 +20,17 @@ namespace Meow
 
     private:
         void CreateLeafNodeUI(const reflect::refl_shared_ptr<Component> comp_ptr);
-        void DrawVecControl(const std::string& label,
+
+        /**
+         * @brief Returns whether any value has been edited.
+         */
+        bool DrawVecControl(const std::string& label,
                             glm::vec3&         values,
                             float              reset_value  = 0.0f,
                             float              column_width = 100.0f);
 
-        std::unordered_map<std::string, std::function<void(std::stack<bool>&, const std::string&, void*)>>
+        // widget creators return whether they edited the value
+        std::unordered_map<std::string, std::function<bool(std::stack<bool>&, const std::string&, void*)>>
                          m_editor_ui_creator;
         std::stack<bool> m_node_states;
     };
@@ -4,24 +4,24 @@
 
 namespace Meow
 {
-    void GameObjectsWidget::Draw(const std::unordered_map<UUID, std::shared_ptr<GameObject>>& gameobject_map)
+    void GameObjectsWidget::Draw(const SlotMap<std::shared_ptr<GameObject>>& gameobjects)
     {
         ImGuiWindow* window = ImGui::GetCurrentWindow();
         if (window->SkipItems)
             return;
 
-        ImGui::PushID(&gameobject_map);
+        ImGui::PushID(&gameobjects);
 
         if (ImGui::TreeNodeEx("GameObject", ImGuiTreeNodeFlags_DefaultOpen))
         {
-            for (const auto& pair : gameobject_map)
+            for (const auto& gameobject : gameobjects)
             {
-                ImGui::PushID(&pair);
+                ImGui::PushID(gameobject.get());
 
-                ImGui::SetNextItemOpen(m_selected_go_id == pair.first ? true : false);
-                if (ImGui::TreeNodeEx(pair.second->GetName().c_str(), 0))
+                ImGui::SetNextItemOpen(m_selected_go_id == gameobject->GetID() ? true : false);
+                if (ImGui::TreeNodeEx(gameobject->GetName().c_str(), 0))
                 {
-                    m_selected_go_id = pair.first;
+                    m_selected_go_id = gameobject->GetID();
 
                     ImGui::TreePop();
                 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "meow_runtime/core/base/slot_map.hpp"
 #include "meow_runtime/function/object/game_object.h"
 
 #include <imgui.h>
@@ -10,7 +11,7 @@ namespace Meow
     class GameObjectsWidget
     {
     public:
-        void Draw(const std::unordered_map<UUID, std::shared_ptr<GameObject>>& gameobject_map);
+        void Draw(const SlotMap<std::shared_ptr<GameObject>>& gameobjects);
 
         const UUID GetSelectedID() const { return m_selected_go_id; }
 
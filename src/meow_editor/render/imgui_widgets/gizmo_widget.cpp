@@ -36,9 +36,8 @@ namespace Meow
         {
             std::shared_ptr<Level> level = g_runtime_context.level_system->GetCurrentActiveLevel().lock();
 
-            const auto& all_gameobjects_map     = level->GetAllGameObjects();
-            auto        current_gameobject_iter = all_gameobjects_map.find(id);
-            if (current_gameobject_iter != all_gameobjects_map.end())
+            GameObject* current_gameobject = level->GetGameObject(level->GetGameObjectHandle(id));
+            if (current_gameobject)
             {
                 float windowWidth  = (float)ImGui::GetWindowWidth();
                 float windowHeight = (float)ImGui::GetWindowHeight();
@@ -49,9 +48,9 @@ namespace Meow
 
                 std::shared_ptr<GameObject> main_camera = level->GetGameObjectByID(level->GetMainCameraID()).lock();
                 std::shared_ptr<Transform3DComponent> main_camera_transfrom_component =
-                    main_camera->TryGetComponent<Transform3DComponent>("Transform3DComponent");
+                    main_camera->TryGetComponent<Transform3DComponent>();
                 std::shared_ptr<Camera3DComponent> main_camera_component =
-                    main_camera->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+                    main_camera->TryGetComponent<Camera3DComponent>();
 
                 if (!main_camera)
                     MEOW_ERROR("shared ptr is invalid!");
@@ -72,8 +71,7 @@ namespace Meow
                                          main_camera_component->near_plane,
                                          main_camera_component->far_plane);
 
-                auto gameobject_transform_component =
-                    current_gameobject_iter->second->TryGetComponent<Transform3DComponent>("Transform3DComponent");
+                auto gameobject_transform_component = current_gameobject->TryGetComponent<Transform3DComponent>();
                 if (!gameobject_transform_component)
                     MEOW_ERROR("shared ptr is invalid!");
                 glm::mat4 gameobject_transform = gameobject_transform_component->GetTransform();
@@ -100,9 +98,9 @@ namespace Meow
                     glm::vec3 position, rotation, scale;
                     Math::DecomposeTransform(gameobject_transform, position, rotation, scale);
 
-                    gameobject_transform_component->position = position;
-                    gameobject_transform_component->rotation = rotation;
-                    gameobject_transform_component->scale    = scale;
+                    gameobject_transform_component->SetPosition(position);
+                    gameobject_transform_component->SetRotation(rotation);
+                    gameobject_transform_component->SetScale(scale);
                 }
             }
         }
@@ -0,0 +1,69 @@
+#include "memory_statistics_widget.h"
+
+#include <imgui.h>
+
+#include <cstdio>
+#include <string>
+
+namespace Meow
+{
+    namespace
+    {
+        void DrawRow(const char* name, const std::string& value)
+        {
+            ImGui::Columns(2, "locations");
+            ImGui::Text("%s", name);
+            ImGui::NextColumn();
+            ImGui::Text("%s", value.c_str());
+            ImGui::Columns();
+        }
+
+        std::string ToMegabytes(vk::DeviceSize size)
+        {
+            char text[32];
+            snprintf(text, sizeof(text), "%.1f MB", static_cast<double>(size) / (1024.0 * 1024.0));
+            return text;
+        }
+    } // namespace
+
+    void MemoryStatisticsWidget::Draw(const DeviceMemoryStatistics& stat)
+    {
+        ImGuiTreeNodeFlags flag = ImGuiTreeNodeFlags_DefaultOpen;
+
+        ImGui::PushID(&stat);
+
+        if (ImGui::TreeNodeEx("Device Memory", flag))
+        {
+            DrawRow("Memory objects",
+                    std::to_string(stat.device_memory_count) + " / " + std::to_string(stat.max_device_memory_count));
+            DrawRow("Budget source", stat.budget_supported ? "VK_EXT_memory_budget" : "Heap size");
+
+            for (size_t i = 0; i < stat.heaps.size(); ++i)
+            {
+                const DeviceMemoryStatistics::Heap& heap = stat.heaps[i];
+
+                ImGui::PushID(static_cast<int>(i));
+
+                std::string heap_name = "Heap " + std::to_string(i);
+                if (ImGui::TreeNodeEx(heap_name.c_str(), flag))
+                {
+                    DrawRow("Usage / Budget", ToMegabytes(heap.usage) + " / " + ToMegabytes(heap.budget));
+                    DrawRow("Heap size", ToMegabytes(heap.size));
+                    DrawRow("Blocks", std::to_string(heap.block_count) + ", " + ToMegabytes(heap.block_size));
+                    DrawRow("Placed in blocks",
+                            std::to_string(heap.allocation_count) + ", " + ToMegabytes(heap.block_used_size));
+                    DrawRow("Dedicated",
+                            std::to_string(heap.dedicated_count) + ", " + ToMegabytes(heap.dedicated_size));
+
+                    ImGui::TreePop();
+                }
+
+                ImGui::PopID();
+            }
+
+            ImGui::TreePop();
+        }
+
+        ImGui::PopID();
+    }
+} // namespace Meow
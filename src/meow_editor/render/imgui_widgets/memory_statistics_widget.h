@@ -0,0 +1,12 @@
+#pragma once
+
+#include "meow_runtime/function/render/allocator/device_memory_allocator.h"
+
+namespace Meow
+{
+    class MemoryStatisticsWidget
+    {
+    public:
+        static void Draw(const DeviceMemoryStatistics& stat);
+    };
+} // namespace Meow
@@ -35,12 +35,19 @@ namespace Meow
 
         void Start(const vk::raii::CommandBuffer& command_buffer, vk::Extent2D extent, uint32_t image_index) override;
 
-        void RecordGraphicsCommand(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) override;
+        // pipeline statistics and timestamp queries are recorded around the draws, so the pass records inline
+        bool RecordSecondaryCommands(vk::Extent2D extent, uint32_t frame_index) override { return false; }
 
         void AfterPresent() override;
 
         friend void swap(DeferredPassEditor& lhs, DeferredPassEditor& rhs);
 
+    protected:
+        // one query per entry of m_pass_names
+        void RecordGBufferSubpass(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) override;
+
+        void RecordLightingSubpass(const vk::raii::CommandBuffer& command_buffer) override;
+
     private:
         BuiltinRenderStat m_render_stat[2];
     };
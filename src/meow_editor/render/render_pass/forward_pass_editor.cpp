@@ -196,19 +196,19 @@ namespace Meow
     {
         FUNCTION_TIMER();
 
-        m_opaque_material->BindPipeline(command_buffer);
+        m_opaque_material->BindPipeline(command_buffer, m_state_cache);
 
         BeginQuery(command_buffer);
-        RenderOpaqueMeshes(command_buffer);
+        RenderOpaqueMeshes(command_buffer, frame_index);
         EndQuery(command_buffer);
 
-        m_skybox_material->BindPipeline(command_buffer);
+        m_skybox_material->BindPipeline(command_buffer, m_state_cache);
 
         BeginQuery(command_buffer);
         RenderSkybox(command_buffer);
         EndQuery(command_buffer);
 
-        m_translucent_material->BindPipeline(command_buffer);
+        m_translucent_material->BindPipeline(command_buffer, m_state_cache);
         RenderTranslucentMeshes(command_buffer);
     }
 
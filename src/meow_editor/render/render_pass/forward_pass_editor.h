@@ -38,6 +38,9 @@ namespace Meow
 
         void RecordGraphicsCommand(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) override;
 
+        // pipeline statistics and timestamp queries are recorded around the draws, so the pass records inline
+        bool RecordSecondaryCommands(vk::Extent2D extent, uint32_t frame_index) override { return false; }
+
         void AfterPresent() override;
 
         friend void swap(ForwardPassEditor& lhs, ForwardPassEditor& rhs);
@@ -5,6 +5,7 @@
 #include "function/render/utils/vulkan_debug_utils.h"
 #include "global/editor_context.h"
 #include "meow_runtime/function/global/runtime_context.h"
+#include "render/imgui_widgets/memory_statistics_widget.h"
 #include "render/imgui_widgets/pipeline_statistics_widget.h"
 
 #include <ImGuizmo.h>
@@ -144,15 +145,12 @@ namespace Meow
 
         ImGui::End();
 
-        const auto& all_gameobjects_map = level->GetAllGameObjects();
+        GameObject* main_camera = level->GetGameObject(level->GetGameObjectHandle(level->GetMainCameraID()));
 
         ImGui::Begin("Scene");
-        const auto camera_id = level->GetMainCameraID();
-        auto       it        = all_gameobjects_map.find(camera_id);
-        if (it != all_gameobjects_map.end())
+        if (main_camera)
         {
-            const auto main_camera           = it->second;
-            const auto main_camera_component = main_camera->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+            const auto main_camera_component = main_camera->TryGetComponent<Camera3DComponent>();
             if (main_camera_component)
             {
                 auto   aspect_ratio = main_camera_component->aspect_ratio; // width / height
@@ -213,10 +211,9 @@ namespace Meow
         {
             ImGui::Begin("Shadow Coord");
 
-            if (it != all_gameobjects_map.end())
+            if (main_camera)
             {
-                const auto main_camera           = it->second;
-                const auto main_camera_component = main_camera->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+                const auto main_camera_component = main_camera->TryGetComponent<Camera3DComponent>();
                 if (main_camera_component)
                 {
                     auto   aspect_ratio = main_camera_component->aspect_ratio; // width / height
@@ -243,10 +240,9 @@ namespace Meow
         {
             ImGui::Begin("Shadow Depth");
 
-            if (it != all_gameobjects_map.end())
+            if (main_camera)
             {
-                const auto main_camera           = it->second;
-                const auto main_camera_component = main_camera->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+                const auto main_camera_component = main_camera->TryGetComponent<Camera3DComponent>();
                 if (main_camera_component)
                 {
                     auto   aspect_ratio = main_camera_component->aspect_ratio; // width / height
@@ -280,18 +276,23 @@ namespace Meow
         {
             m_on_msaa_enabled_changed(m_msaa_enabled);
         }
+        if (ImGui::Checkbox("GPU Culling Enabled", &m_gpu_culling_enabled))
+        {
+            m_on_gpu_culling_enabled_changed(m_gpu_culling_enabled);
+        }
         ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
         ImGui::End();
 
         ImGui::Begin("GameObject");
-        m_gameobjects_widget.Draw(all_gameobjects_map);
+        m_gameobjects_widget.Draw(level->GetAllGameObjects());
         ImGui::End();
 
-        auto current_gameobject_iter = all_gameobjects_map.find(m_gameobjects_widget.GetSelectedID());
-        if (current_gameobject_iter != all_gameobjects_map.end())
+        std::shared_ptr<GameObject> selected_gameobject =
+            level->GetGameObjectByID(m_gameobjects_widget.GetSelectedID()).lock();
+        if (selected_gameobject)
         {
             ImGui::Begin("Component");
-            m_components_widget.CreateGameObjectUI(current_gameobject_iter->second);
+            m_components_widget.CreateGameObjectUI(selected_gameobject);
             ImGui::End();
         }
 
@@ -305,6 +306,8 @@ namespace Meow
 
         PipelineStatisticsWidget::Draw(g_editor_context.profile_system->GetPipelineStat());
 
+        MemoryStatisticsWidget::Draw(g_runtime_context.render_system->GetDeviceMemoryAllocator().GetStatistics());
+
         ImGui::End();
 
         RenderPassBase::Start(command_buffer, extent, image_index);
@@ -42,6 +42,7 @@ namespace Meow
         void RecordGraphicsCommand(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) override;
 
         Signal<bool>& OnMSAAEnabledChanged() { return m_on_msaa_enabled_changed; }
+        Signal<bool>& OnGPUCullingEnabledChanged() { return m_on_gpu_culling_enabled_changed; }
         Signal<int>&  OnPassChanged() { return m_on_pass_changed; }
 
         friend void swap(ImGuiPass& lhs, ImGuiPass& rhs);
@@ -56,6 +57,9 @@ namespace Meow
         bool         m_msaa_enabled = true;
         Signal<bool> m_on_msaa_enabled_changed;
 
+        bool         m_gpu_culling_enabled = false;
+        Signal<bool> m_on_gpu_culling_enabled_changed;
+
         int                      m_cur_render_pass   = 1;
         std::vector<const char*> m_render_pass_names = {"Deferred", "Forward"};
         Signal<int>              m_on_pass_changed;
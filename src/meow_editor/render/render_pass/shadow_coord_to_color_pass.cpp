@@ -229,9 +229,9 @@ namespace Meow
 
         std::shared_ptr<GameObject>           main_camera = level->GetGameObjectByID(level->GetMainCameraID()).lock();
         std::shared_ptr<Transform3DComponent> main_camera_transfrom_component =
-            main_camera->TryGetComponent<Transform3DComponent>("Transform3DComponent");
+            main_camera->TryGetComponent<Transform3DComponent>();
         std::shared_ptr<Camera3DComponent> main_camera_component =
-            main_camera->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+            main_camera->TryGetComponent<Camera3DComponent>();
 
         if (!main_camera)
             MEOW_ERROR("shared ptr is invalid!");
@@ -260,15 +260,14 @@ namespace Meow
 
         // light
 
-        const auto& all_gameobjects_map = level->GetAllGameObjects();
-        for (auto& kv : all_gameobjects_map)
+        for (GameObject* gameobject : level->GetDirectionalLights())
         {
             std::shared_ptr<DirectionalLightComponent> directional_light_comp_ptr =
-                kv.second->TryGetComponent<DirectionalLightComponent>("DirectionalLightComponent");
+                gameobject->TryGetComponent<DirectionalLightComponent>();
             if (directional_light_comp_ptr)
             {
                 std::shared_ptr<Transform3DComponent> directional_light_transform =
-                    kv.second->TryGetComponent<Transform3DComponent>("Transform3DComponent");
+                    gameobject->TryGetComponent<Transform3DComponent>();
 
                 if (!directional_light_transform)
                 {
@@ -301,27 +300,13 @@ namespace Meow
             const auto& visibles_opaque = *visibles_opaque_ptr;
             for (const auto& visible : visibles_opaque)
             {
-                std::shared_ptr<GameObject>           current_gameobject = visible.lock();
-                std::shared_ptr<Transform3DComponent> current_gameobject_transfrom_component =
-                    current_gameobject->TryGetComponent<Transform3DComponent>("Transform3DComponent");
-                std::shared_ptr<ModelComponent> current_gameobject_model_component =
-                    current_gameobject->TryGetComponent<ModelComponent>("ModelComponent");
-
-                if (!current_gameobject_transfrom_component || !current_gameobject_model_component)
+                auto* model_resource = visible.model;
+                if (!model_resource)
                     continue;
 
-#ifdef MEOW_DEBUG
-                if (!current_gameobject)
-                    MEOW_ERROR("shared ptr is invalid!");
-                if (!current_gameobject_transfrom_component)
-                    MEOW_ERROR("shared ptr is invalid!");
-                if (!current_gameobject_model_component)
-                    MEOW_ERROR("shared ptr is invalid!");
-#endif
+                auto model = visible.transform;
 
-                auto model = current_gameobject_transfrom_component->GetTransform();
-
-                for (uint32_t i = 0; i < current_gameobject_model_component->model.lock()->meshes.size(); ++i)
+                for (uint32_t i = 0; i < model_resource->meshes.size(); ++i)
                 {
                     m_shadow_coord_to_color_material->BeginPopulatingDynamicUniformBufferPerObject();
                     m_shadow_coord_to_color_material->PopulateDynamicUniformBuffer(
@@ -369,16 +354,7 @@ namespace Meow
             const auto& visibles_opaque = *visibles_opaque_ptr;
             for (const auto& visible : visibles_opaque)
             {
-                std::shared_ptr<GameObject> current_gameobject = visible.lock();
-                if (!current_gameobject)
-                    continue;
-
-                std::shared_ptr<ModelComponent> current_gameobject_model_component =
-                    current_gameobject->TryGetComponent<ModelComponent>("ModelComponent");
-                if (!current_gameobject_model_component)
-                    continue;
-
-                auto model_resource = current_gameobject_model_component->model.lock();
+                auto* model_resource = visible.model;
                 if (!model_resource)
                     continue;
 
@@ -56,8 +56,8 @@ namespace Meow
             if (!camera_ptr)
                 MEOW_ERROR("shared ptr is invalid!");
 
-            transform_ptr->position = glm::vec3(0.0f, 10.0f, -6.0f);
-            transform_ptr->rotation = glm::quat(glm::vec3(-100.0f, 0.0f, 0.0f));
+            transform_ptr->SetPosition(glm::vec3(0.0f, 10.0f, -6.0f));
+            transform_ptr->SetRotation(glm::quat(glm::vec3(-100.0f, 0.0f, 0.0f)));
 
             camera_ptr->camera_mode  = CameraMode::Free;
             camera_ptr->aspect_ratio = static_cast<float>(m_surface_data.extent.width) / m_surface_data.extent.height;
@@ -70,8 +70,8 @@ namespace Meow
                 current_gameobject, "DirectionalLightComponent", std::make_shared<DirectionalLightComponent>());
             auto directional_light_transform =
                 TryAddComponent(current_gameobject, "Transform3DComponent", std::make_shared<Transform3DComponent>());
-            directional_light_transform->position = glm::vec3(0.0f, 10.0f, -6.0f);
-            directional_light_transform->rotation = glm::quat(glm::vec3(-100.0f, 0.0f, 0.0f));
+            directional_light_transform->SetPosition(glm::vec3(0.0f, 10.0f, -6.0f));
+            directional_light_transform->SetRotation(glm::quat(glm::vec3(-100.0f, 0.0f, 0.0f)));
         }
 
         GeometryFactory geometry_factory;
@@ -84,6 +84,11 @@ namespace Meow
             std::vector<float> sphere_vertices =
                 geometry_factory.GetVertices(m_render_pass_ptr->input_vertex_attributes);
             std::vector<uint32_t> sphere_indices = geometry_factory.GetIndices();
+
+            // spheres share one model, so that they are drawn as instances of the same mesh
+            auto model_handle = g_runtime_context.resource_system->LoadModel(
+                sphere_vertices, sphere_indices, m_render_pass_ptr->input_vertex_attributes);
+
             for (std::size_t row = 0; row < row_number; ++row)
             {
                 for (std::size_t col = 0; col < column_number; ++col)
@@ -99,26 +104,26 @@ namespace Meow
                     current_gameobject->SetName("Sphere " + std::to_string(row * column_number + col));
                     auto transform_ptr = TryAddComponent(
                         current_gameobject, "Transform3DComponent", std::make_shared<Transform3DComponent>());
-                    transform_ptr->position = glm::vec3(
+                    transform_ptr->SetPosition(glm::vec3(
                         static_cast<float>(col) * spacing - static_cast<float>(column_number) / 2.0f * spacing,
                         static_cast<float>(row) * spacing - static_cast<float>(row_number) / 2.0f * spacing,
-                        0.0f);
+                        0.0f));
 
                     auto current_gameobject_model_component =
                         TryAddComponent(current_gameobject, "ModelComponent", std::make_shared<ModelComponent>());
-                    auto model_shared_ptr = std::make_shared<Model>(
-                        sphere_vertices, sphere_indices, m_render_pass_ptr->input_vertex_attributes);
 
                     // TODO: hard code render pass cast
                     current_gameobject_model_component->material_id = m_forward_pass.GetForwardMatID();
 
-                    if (model_shared_ptr)
+                    if (model_handle.IsValid())
                     {
-                        g_runtime_context.resource_system->Register(model_shared_ptr);
-                        current_gameobject_model_component->model = model_shared_ptr;
+                        current_gameobject_model_component->SetModel(model_handle);
                     }
                 }
             }
+
+            // the components hold their own references
+            g_runtime_context.resource_system->Release(model_handle);
         }
 
         {
@@ -128,6 +133,11 @@ namespace Meow
             std::vector<float> sphere_vertices =
                 geometry_factory.GetVertices(m_render_pass_ptr->input_vertex_attributes);
             std::vector<uint32_t> sphere_indices = geometry_factory.GetIndices();
+
+            // spheres share one model, so that they are drawn as instances of the same mesh
+            auto model_handle = g_runtime_context.resource_system->LoadModel(
+                sphere_vertices, sphere_indices, m_render_pass_ptr->input_vertex_attributes);
+
             for (std::size_t row = 0; row < row_number; ++row)
             {
                 for (std::size_t col = 0; col < column_number; ++col)
@@ -143,26 +153,26 @@ namespace Meow
                     current_gameobject->SetName("Sphere Translucent" + std::to_string(row * column_number + col));
                     auto transform_ptr = TryAddComponent(
                         current_gameobject, "Transform3DComponent", std::make_shared<Transform3DComponent>());
-                    transform_ptr->position = glm::vec3(
+                    transform_ptr->SetPosition(glm::vec3(
                         static_cast<float>(col) * spacing - static_cast<float>(column_number) / 2.0f * spacing,
                         static_cast<float>(row) * spacing - static_cast<float>(row_number) / 2.0f * spacing,
-                        -5.0f);
+                        -5.0f));
 
                     auto current_gameobject_model_component =
                         TryAddComponent(current_gameobject, "ModelComponent", std::make_shared<ModelComponent>());
-                    auto model_shared_ptr = std::make_shared<Model>(
-                        sphere_vertices, sphere_indices, m_render_pass_ptr->input_vertex_attributes);
 
                     // TODO: hard code render pass cast
                     current_gameobject_model_component->material_id = m_forward_pass.GetTranslucentMatID();
 
-                    if (model_shared_ptr)
+                    if (model_handle.IsValid())
                     {
-                        g_runtime_context.resource_system->Register(model_shared_ptr);
-                        current_gameobject_model_component->model = model_shared_ptr;
+                        current_gameobject_model_component->SetModel(model_handle);
                     }
                 }
             }
+
+            // the components hold their own references
+            g_runtime_context.resource_system->Release(model_handle);
         }
 
         geometry_factory.SetCube();
@@ -182,21 +192,23 @@ namespace Meow
             current_gameobject->SetName("Cube");
             auto transform_ptr =
                 TryAddComponent(current_gameobject, "Transform3DComponent", std::make_shared<Transform3DComponent>());
-            transform_ptr->position = glm::vec3(0.0f, 0.0f, 10.0f);
+            transform_ptr->SetPosition(glm::vec3(0.0f, 0.0f, 10.0f));
 
             auto current_gameobject_model_component =
                 TryAddComponent(current_gameobject, "ModelComponent", std::make_shared<ModelComponent>());
-            auto model_shared_ptr =
-                std::make_shared<Model>(cube_vertices, cube_indices, m_render_pass_ptr->input_vertex_attributes);
+            auto model_handle = g_runtime_context.resource_system->LoadModel(
+                cube_vertices, cube_indices, m_render_pass_ptr->input_vertex_attributes);
 
             // TODO: hard code render pass cast
             current_gameobject_model_component->material_id = m_forward_pass.GetForwardMatID();
 
-            if (model_shared_ptr)
+            if (model_handle.IsValid())
             {
-                g_runtime_context.resource_system->Register(model_shared_ptr);
-                current_gameobject_model_component->model = model_shared_ptr;
+                current_gameobject_model_component->SetModel(model_handle);
             }
+
+            // the component holds its own reference
+            g_runtime_context.resource_system->Release(model_handle);
         }
 
         geometry_factory.SetPlane();
@@ -217,22 +229,24 @@ namespace Meow
             current_gameobject->SetName("Plane");
             auto transform_ptr =
                 TryAddComponent(current_gameobject, "Transform3DComponent", std::make_shared<Transform3DComponent>());
-            transform_ptr->position = glm::vec3(0.0f, -10.0f, 10.0f);
-            transform_ptr->scale    = glm::vec3(20.0f, 20.0f, 20.0f);
+            transform_ptr->SetPosition(glm::vec3(0.0f, -10.0f, 10.0f));
+            transform_ptr->SetScale(glm::vec3(20.0f, 20.0f, 20.0f));
 
             auto current_gameobject_model_component =
                 TryAddComponent(current_gameobject, "ModelComponent", std::make_shared<ModelComponent>());
-            auto model_shared_ptr =
-                std::make_shared<Model>(plane_vertices, plane_indices, m_render_pass_ptr->input_vertex_attributes);
+            auto model_handle = g_runtime_context.resource_system->LoadModel(
+                plane_vertices, plane_indices, m_render_pass_ptr->input_vertex_attributes);
 
             // TODO: hard code render pass cast
             current_gameobject_model_component->material_id = m_forward_pass.GetForwardMatID();
 
-            if (model_shared_ptr)
+            if (model_handle.IsValid())
             {
-                g_runtime_context.resource_system->Register(model_shared_ptr);
-                current_gameobject_model_component->model = model_shared_ptr;
+                current_gameobject_model_component->SetModel(model_handle);
             }
+
+            // the component holds its own reference
+            g_runtime_context.resource_system->Release(model_handle);
         }
     }
 
@@ -268,16 +282,19 @@ namespace Meow
         auto&                   in_flight_fence            = frame_data.graphics_in_flight_fence;
         const auto              k_max_frames_in_flight     = g_runtime_context.render_system->GetMaxFramesInFlight();
 
+        // per frame buffers of this slot are rewritten below, so the submission that last read them must be done
+        while (vk::Result::eTimeout == logical_device.waitForFences({*in_flight_fence}, VK_TRUE, k_fence_timeout))
+            ;
+
+        g_runtime_context.render_system->GetDynamicUniformAllocator().BeginFrame(m_frame_index);
+        g_runtime_context.render_system->GetObjectDataBuffer().BeginFrame(m_frame_index);
+
         m_shadow_map_pass.UpdateUniformBuffer(m_frame_index);
         m_render_pass_ptr->UpdateUniformBuffer(m_frame_index);
         m_forward_pass.PopulateDirectionalLightData(m_shadow_map_pass.GetShadowMap(), m_frame_index);
 
         // ------------------- render -------------------
 
-        while (vk::Result::eTimeout == logical_device.waitForFences({*in_flight_fence}, VK_TRUE, k_fence_timeout))
-            ;
-        logical_device.resetFences({*in_flight_fence});
-
         auto [result, image_index] =
             SwapchainNextImageWrapper(m_swapchain_data.swap_chain, k_fence_timeout, *present_finished_semaphore);
         if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR || m_framebuffer_resized)
@@ -292,19 +309,19 @@ namespace Meow
         command_buffer.reset();
         command_buffer.begin({});
 
-        m_shadow_map_pass.Start(command_buffer, m_surface_data.extent, image_index);
-        m_shadow_map_pass.RecordGraphicsCommand(command_buffer, m_frame_index);
-        m_shadow_map_pass.End(command_buffer);
-
-        m_render_pass_ptr->Start(command_buffer, m_surface_data.extent, image_index);
-        m_render_pass_ptr->RecordGraphicsCommand(command_buffer, m_frame_index);
-        m_render_pass_ptr->End(command_buffer);
+        RecordRenderPasses(command_buffer, {&m_shadow_map_pass, m_render_pass_ptr}, image_index);
 
         command_buffer.end();
 
+        // uploads are ordered before the frame by submitting them first
+        g_runtime_context.render_system->GetUploadManager().Flush();
+
         vk::PipelineStageFlags wait_destination_stage_mask(vk::PipelineStageFlagBits::eColorAttachmentOutput);
         vk::SubmitInfo         submit_info(
             *present_finished_semaphore, wait_destination_stage_mask, *command_buffer, *render_finished_semaphore);
+
+        // reset only now, so that returning early above leaves the fence signaled for the next wait
+        logical_device.resetFences({*in_flight_fence});
         graphics_queue.submit(submit_info, *in_flight_fence);
 
         vk::PresentInfoKHR present_info(*render_finished_semaphore, *m_swapchain_data.swap_chain, image_index);
@@ -366,8 +383,7 @@ namespace Meow
         if (!current_gameobject)
             return;
 
-        std::shared_ptr<Camera3DComponent> camera_ptr =
-            current_gameobject->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+        std::shared_ptr<Camera3DComponent> camera_ptr = current_gameobject->TryGetComponent<Camera3DComponent>();
 
         camera_ptr->aspect_ratio = static_cast<float>(m_surface_data.extent.width) / m_surface_data.extent.height;
     }
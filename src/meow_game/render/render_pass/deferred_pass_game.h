@@ -31,7 +31,5 @@ namespace Meow
         ~DeferredPassGame() override = default;
 
         void Start(const vk::raii::CommandBuffer& command_buffer, vk::Extent2D extent, uint32_t image_index) override;
-
-        void RecordGraphicsCommand(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) override;
     };
 } // namespace Meow
@@ -181,15 +181,15 @@ namespace Meow
     {
         FUNCTION_TIMER();
 
-        m_opaque_material->BindPipeline(command_buffer);
+        m_opaque_material->BindPipeline(command_buffer, m_state_cache);
 
-        RenderOpaqueMeshes(command_buffer);
+        RenderOpaqueMeshes(command_buffer, frame_index);
 
-        m_skybox_material->BindPipeline(command_buffer);
+        m_skybox_material->BindPipeline(command_buffer, m_state_cache);
 
         RenderSkybox(command_buffer);
 
-        m_translucent_material->BindPipeline(command_buffer);
+        m_translucent_material->BindPipeline(command_buffer, m_state_cache);
         RenderTranslucentMeshes(command_buffer);
     }
 } // namespace Meow
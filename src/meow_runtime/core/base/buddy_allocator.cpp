@@ -0,0 +1,94 @@
+#include "buddy_allocator.h"
+
+#include "pch.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace Meow
+{
+    BuddyAllocator::BuddyAllocator(uint64_t size, uint64_t min_block_size)
+        : m_size(size)
+        , m_min_block_size(min_block_size)
+    {
+        assert(std::has_single_bit(size) && std::has_single_bit(min_block_size) && min_block_size <= size);
+
+        uint32_t level_count = std::countr_zero(size) - std::countr_zero(min_block_size) + 1;
+        m_free_blocks.resize(level_count);
+        m_free_blocks[0].insert(0);
+    }
+
+    uint64_t BuddyAllocator::Allocate(uint64_t size, uint64_t alignment)
+    {
+        if (size == 0 || size > m_size || alignment > m_size)
+            return k_invalid_offset;
+
+        uint64_t block_size = std::max({std::bit_ceil(size), std::bit_ceil(alignment), m_min_block_size});
+        uint32_t level      = std::countr_zero(m_size) - std::countr_zero(block_size);
+
+        // smallest free block that is large enough
+        int32_t found_level = static_cast<int32_t>(level);
+        while (found_level >= 0 && m_free_blocks[found_level].empty())
+        {
+            --found_level;
+        }
+        if (found_level < 0)
+            return k_invalid_offset;
+
+        std::set<uint64_t>& free_blocks = m_free_blocks[found_level];
+        uint64_t            offset      = *free_blocks.begin();
+        free_blocks.erase(free_blocks.begin());
+
+        // keep the lower half of each split, and free the upper half
+        for (uint32_t split_level = found_level + 1; split_level <= level; ++split_level)
+        {
+            m_free_blocks[split_level].insert(offset + GetBlockSize(split_level));
+        }
+
+        m_allocated_levels.emplace(offset, level);
+        m_allocated_size += block_size;
+
+        return offset;
+    }
+
+    void BuddyAllocator::Free(uint64_t offset)
+    {
+        auto it = m_allocated_levels.find(offset);
+        if (it == m_allocated_levels.end())
+        {
+            assert(false && "Freeing an offset that is not allocated");
+            return;
+        }
+
+        uint32_t level = it->second;
+        m_allocated_levels.erase(it);
+        m_allocated_size -= GetBlockSize(level);
+
+        while (level > 0)
+        {
+            uint64_t buddy_offset = offset ^ GetBlockSize(level);
+
+            auto buddy = m_free_blocks[level].find(buddy_offset);
+            if (buddy == m_free_blocks[level].end())
+                break;
+
+            m_free_blocks[level].erase(buddy);
+            offset = std::min(offset, buddy_offset);
+            --level;
+        }
+
+        m_free_blocks[level].insert(offset);
+    }
+
+    uint64_t BuddyAllocator::GetLargestFreeBlockSize() const
+    {
+        for (uint32_t level = 0; level < m_free_blocks.size(); ++level)
+        {
+            if (!m_free_blocks[level].empty())
+                return GetBlockSize(level);
+        }
+
+        return 0;
+    }
+} // namespace Meow
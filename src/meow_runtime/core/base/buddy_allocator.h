@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Placement of ranges inside a fixed-size region, by splitting it into halves down to the requested size.
+     *
+     * Every range is a block whose size is a power of two and whose offset is a multiple of its size, so any
+     * alignment up to the block size holds without padding, and freeing merges a block with its buddy at once. It
+     * owns no memory: offsets are applied to whatever the region is, e.g. a block of device memory.
+     */
+    class BuddyAllocator
+    {
+    public:
+        static constexpr uint64_t k_invalid_offset = std::numeric_limits<uint64_t>::max();
+
+        /**
+         * @brief Both sizes must be powers of two.
+         */
+        BuddyAllocator(uint64_t size, uint64_t min_block_size);
+
+        /**
+         * @brief Returns the offset of a range of at least size bytes aligned to alignment, which must be a power of
+         * two, or k_invalid_offset if no free block is large enough.
+         */
+        uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+        void Free(uint64_t offset);
+
+        uint64_t GetSize() const { return m_size; }
+
+        /**
+         * @brief Bytes of allocated blocks, including what rounding sizes up to powers of two adds.
+         */
+        uint64_t GetAllocatedSize() const { return m_allocated_size; }
+
+        uint32_t GetAllocationCount() const { return static_cast<uint32_t>(m_allocated_levels.size()); }
+
+        uint64_t GetLargestFreeBlockSize() const;
+
+        bool IsEmpty() const { return m_allocated_levels.empty(); }
+
+    private:
+        uint64_t GetBlockSize(uint32_t level) const { return m_size >> level; }
+
+        uint64_t m_size           = 0;
+        uint64_t m_min_block_size = 0;
+        uint64_t m_allocated_size = 0;
+
+        // level 0 is the whole region, and blocks halve at each level; sets keep low offsets first
+        std::vector<std::set<uint64_t>>        m_free_blocks;
+        std::unordered_map<uint64_t, uint32_t> m_allocated_levels;
+    };
+} // namespace Meow
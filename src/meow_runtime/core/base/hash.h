@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Meow
+{
+    constexpr uint64_t k_fnv_offset_basis = 14695981039346656037ull;
+    constexpr uint64_t k_fnv_prime        = 1099511628211ull;
+
+    /**
+     * @brief 64-bit FNV-1a of raw bytes. Pass the previous result as seed to hash several payloads in a row.
+     *
+     * Not collision free, equal hashes should be confirmed by comparing payloads.
+     */
+    inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = k_fnv_offset_basis)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= k_fnv_prime;
+        }
+        return hash;
+    }
+} // namespace Meow
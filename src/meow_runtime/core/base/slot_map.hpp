@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Weak reference into a SlotMap. It becomes invalid once the value it points to is removed.
+     */
+    struct SlotHandle
+    {
+        static constexpr uint32_t k_invalid_index = static_cast<uint32_t>(-1);
+
+        uint32_t index      = k_invalid_index;
+        uint32_t generation = 0;
+
+        bool IsValid() const { return index != k_invalid_index; }
+
+        bool operator==(const SlotHandle& rhs) const = default;
+    };
+
+    /**
+     * @brief Values are stored densely for iteration, and addressed by generational handles.
+     *
+     * Inserting, removing and validating a handle are O(1). Removing moves the last value into the hole, so dense
+     * order is not stable.
+     */
+    template<typename T>
+    class SlotMap
+    {
+    public:
+        SlotHandle Insert(T value)
+        {
+            uint32_t slot_index;
+            if (m_free_head != SlotHandle::k_invalid_index)
+            {
+                slot_index  = m_free_head;
+                m_free_head = m_slots[slot_index].dense_index;
+            }
+            else
+            {
+                slot_index = static_cast<uint32_t>(m_slots.size());
+                m_slots.push_back({SlotHandle::k_invalid_index, 1});
+            }
+
+            m_slots[slot_index].dense_index = static_cast<uint32_t>(m_values.size());
+            m_values.push_back(std::move(value));
+            m_dense_to_slot.push_back(slot_index);
+
+            return {slot_index, m_slots[slot_index].generation};
+        }
+
+        bool Remove(SlotHandle handle)
+        {
+            if (!Contains(handle))
+                return false;
+
+            Slot&    slot        = m_slots[handle.index];
+            uint32_t dense_index = slot.dense_index;
+            uint32_t last_index  = static_cast<uint32_t>(m_values.size() - 1);
+
+            if (dense_index != last_index)
+            {
+                m_values[dense_index]                             = std::move(m_values[last_index]);
+                m_dense_to_slot[dense_index]                      = m_dense_to_slot[last_index];
+                m_slots[m_dense_to_slot[dense_index]].dense_index = dense_index;
+            }
+            m_values.pop_back();
+            m_dense_to_slot.pop_back();
+
+            // bump generation so that old handles fail validation, and push slot to free list
+            slot.generation++;
+            slot.dense_index = m_free_head;
+            m_free_head      = handle.index;
+
+            return true;
+        }
+
+        bool Contains(SlotHandle handle) const
+        {
+            return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+        }
+
+        T* Get(SlotHandle handle)
+        {
+            return Contains(handle) ? &m_values[m_slots[handle.index].dense_index] : nullptr;
+        }
+
+        const T* Get(SlotHandle handle) const
+        {
+            return Contains(handle) ? &m_values[m_slots[handle.index].dense_index] : nullptr;
+        }
+
+        /**
+         * @brief Handle of the value at a dense index, used when iterating.
+         */
+        SlotHandle GetHandle(size_t dense_index) const
+        {
+            uint32_t slot_index = m_dense_to_slot[dense_index];
+            return {slot_index, m_slots[slot_index].generation};
+        }
+
+        size_t Size() const { return m_values.size(); }
+        bool   Empty() const { return m_values.empty(); }
+
+        /**
+         * @brief Remove all values. Slots are kept with bumped generations, so handles from before stay invalid.
+         */
+        void Clear()
+        {
+            for (uint32_t slot_index : m_dense_to_slot)
+                m_slots[slot_index].generation++;
+
+            m_free_head = SlotHandle::k_invalid_index;
+            for (uint32_t slot_index = static_cast<uint32_t>(m_slots.size()); slot_index-- > 0;)
+            {
+                m_slots[slot_index].dense_index = m_free_head;
+                m_free_head                     = slot_index;
+            }
+
+            m_values.clear();
+            m_dense_to_slot.clear();
+        }
+
+        auto begin() { return m_values.begin(); }
+        auto end() { return m_values.end(); }
+        auto begin() const { return m_values.begin(); }
+        auto end() const { return m_values.end(); }
+
+    private:
+        struct Slot
+        {
+            // index into dense arrays when occupied, next free slot when free
+            uint32_t dense_index;
+            uint32_t generation;
+        };
+
+        std::vector<Slot>     m_slots;
+        std::vector<T>        m_values;
+        std::vector<uint32_t> m_dense_to_slot;
+        uint32_t              m_free_head = SlotHandle::k_invalid_index;
+    };
+} // namespace Meow
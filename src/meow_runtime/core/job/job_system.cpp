@@ -0,0 +1,158 @@
+#include "job_system.h"
+
+#include "pch.h"
+
+namespace Meow
+{
+    namespace
+    {
+        constexpr uint32_t k_not_a_worker = static_cast<uint32_t>(-1);
+
+        thread_local uint32_t   t_worker_index = k_not_a_worker;
+        thread_local JobSystem* t_job_system   = nullptr;
+    } // namespace
+
+    JobSystem::JobSystem(uint32_t worker_count)
+    {
+        if (worker_count == 0)
+        {
+            uint32_t hardware_thread_count = std::thread::hardware_concurrency();
+            worker_count                   = hardware_thread_count > 1 ? hardware_thread_count - 1 : 0;
+        }
+
+        for (uint32_t i = 0; i < worker_count + 1; ++i)
+        {
+            m_queues.push_back(std::make_unique<JobQueue>());
+        }
+
+        m_workers.reserve(worker_count);
+        for (uint32_t i = 0; i < worker_count; ++i)
+        {
+            m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+        }
+
+        MEOW_INFO("JobSystem started with {} workers", worker_count);
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+            m_running = false;
+        }
+        m_wake_condition.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            if (worker.joinable())
+                worker.join();
+        }
+    }
+
+    void JobSystem::Schedule(Job job, JobCounter* counter)
+    {
+        if (counter)
+            counter->remaining.fetch_add(1, std::memory_order_relaxed);
+
+        uint32_t queue_index = (t_job_system == this) ? t_worker_index : static_cast<uint32_t>(m_queues.size() - 1);
+
+        {
+            std::lock_guard<std::mutex> lock(m_queues[queue_index]->mutex);
+            m_queues[queue_index]->jobs.push_back({std::move(job), counter});
+        }
+
+        m_pending_job_count.fetch_add(1, std::memory_order_release);
+
+        // lock before notifying so that a worker between checking the predicate and sleeping can't miss it
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+        }
+        m_wake_condition.notify_one();
+    }
+
+    bool JobSystem::TryRunPendingJob()
+    {
+        QueuedJob queued_job;
+        if (!TryGetJob(queued_job))
+            return false;
+
+        Execute(queued_job);
+        return true;
+    }
+
+    void JobSystem::Wait(const JobCounter& counter)
+    {
+        while (!counter.IsDone())
+        {
+            if (!TryRunPendingJob())
+                std::this_thread::yield();
+        }
+    }
+
+    uint32_t JobSystem::GetThreadIndex() const { return (t_job_system == this) ? t_worker_index : GetWorkerCount(); }
+
+    bool JobSystem::IsWorkerThread() { return t_worker_index != k_not_a_worker; }
+
+    bool JobSystem::TryGetJob(QueuedJob& queued_job)
+    {
+        if (m_pending_job_count.load(std::memory_order_acquire) == 0)
+            return false;
+
+        uint32_t queue_count = static_cast<uint32_t>(m_queues.size());
+        uint32_t self_index  = (t_job_system == this) ? t_worker_index : queue_count - 1;
+
+        // own queue, LIFO for cache locality
+        {
+            JobQueue&                   queue = *m_queues[self_index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                queued_job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                m_pending_job_count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // steal from others, FIFO so that the oldest and usually largest jobs are taken
+        for (uint32_t offset = 1; offset < queue_count; ++offset)
+        {
+            JobQueue&                   queue = *m_queues[(self_index + offset) % queue_count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                queued_job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                m_pending_job_count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void JobSystem::Execute(QueuedJob& queued_job)
+    {
+        queued_job.job();
+
+        if (queued_job.counter)
+            queued_job.counter->remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void JobSystem::WorkerLoop(uint32_t worker_index)
+    {
+        t_worker_index = worker_index;
+        t_job_system   = this;
+
+        while (m_running)
+        {
+            if (TryRunPendingJob())
+                continue;
+
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_wake_condition.wait(lock, [this]() {
+                return !m_running || m_pending_job_count.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+} // namespace Meow
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "core/base/non_copyable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Number of unfinished jobs in a batch. Pass it to JobSystem::Schedule and wait with JobSystem::Wait.
+     */
+    struct JobCounter
+    {
+        std::atomic<uint32_t> remaining {0};
+
+        bool IsDone() const { return remaining.load(std::memory_order_acquire) == 0; }
+    };
+
+    /**
+     * @brief Work-stealing thread pool.
+     *
+     * Each worker owns a deque. A worker pushes and pops its own jobs at the back, and steals from the front of
+     * other deques when its own is empty. Jobs scheduled from non-worker threads go to a shared injection queue.
+     *
+     * Waiting threads help executing jobs instead of blocking, so waiting inside a job doesn't dead lock.
+     */
+    class JobSystem : public NonCopyable
+    {
+    public:
+        using Job = std::function<void()>;
+
+        /**
+         * @param worker_count 0 means one worker per hardware thread except the calling thread.
+         */
+        explicit JobSystem(uint32_t worker_count = 0);
+
+        ~JobSystem() override;
+
+        uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+        /**
+         * @brief Index of the calling thread in [0, GetWorkerCount()]. Workers come first, and any other thread, which
+         * is the main thread in practice, gets GetWorkerCount(). Used to pick per-thread resources.
+         */
+        uint32_t GetThreadIndex() const;
+
+        void Schedule(Job job, JobCounter* counter = nullptr);
+
+        /**
+         * @brief Run one pending job on the calling thread if there is any.
+         *
+         * @return Whether a job was executed.
+         */
+        bool TryRunPendingJob();
+
+        void Wait(const JobCounter& counter);
+
+        /**
+         * @brief Split [0, count) into ranges of grain_size and call func(begin, end) for each range in parallel.
+         *
+         * Returns when all ranges are finished.
+         */
+        template<typename Func>
+        void ParallelFor(uint32_t count, uint32_t grain_size, Func&& func)
+        {
+            if (count == 0)
+                return;
+
+            grain_size = std::max(grain_size, 1u);
+            if (m_workers.empty() || count <= grain_size)
+            {
+                func(0u, count);
+                return;
+            }
+
+            JobCounter counter;
+            for (uint32_t begin = 0; begin < count; begin += grain_size)
+            {
+                uint32_t end = std::min(begin + grain_size, count);
+                Schedule([&func, begin, end]() { func(begin, end); }, &counter);
+            }
+            Wait(counter);
+        }
+
+        static bool IsWorkerThread();
+
+    private:
+        struct QueuedJob
+        {
+            Job         job;
+            JobCounter* counter;
+        };
+
+        struct JobQueue
+        {
+            std::mutex            mutex;
+            std::deque<QueuedJob> jobs;
+        };
+
+        bool TryGetJob(QueuedJob& queued_job);
+        void Execute(QueuedJob& queued_job);
+        void WorkerLoop(uint32_t worker_index);
+
+        // one queue per worker, the last one is the injection queue for non-worker threads
+        std::vector<std::unique_ptr<JobQueue>> m_queues;
+        std::vector<std::thread>               m_workers;
+
+        std::atomic<bool>       m_running {true};
+        std::atomic<uint32_t>   m_pending_job_count {0};
+        std::mutex              m_wake_mutex;
+        std::condition_variable m_wake_condition;
+    };
+} // namespace Meow
@@ -0,0 +1,152 @@
+#include "task_graph.h"
+
+#include "pch.h"
+
+#include <queue>
+
+namespace Meow
+{
+    TaskID TaskGraph::AddTask(const std::string& name, std::function<void()> func, bool main_thread_only)
+    {
+        Task task;
+        task.name             = name;
+        task.func             = std::move(func);
+        task.main_thread_only = main_thread_only;
+        m_tasks.push_back(std::move(task));
+
+        m_compiled = false;
+        return static_cast<TaskID>(m_tasks.size() - 1);
+    }
+
+    void TaskGraph::AddDependency(TaskID before, TaskID after)
+    {
+        if (before >= m_tasks.size() || after >= m_tasks.size() || before == after)
+        {
+            MEOW_ERROR("Invalid task dependency {} -> {}!", before, after);
+            return;
+        }
+
+        m_tasks[before].successors.push_back(after);
+        m_tasks[after].predecessor_count++;
+
+        m_compiled = false;
+    }
+
+    bool TaskGraph::Compile()
+    {
+        // Kahn's algorithm, only to detect cycles
+        std::vector<uint32_t> in_degrees(m_tasks.size());
+        std::queue<TaskID>    ready_tasks;
+        for (TaskID i = 0; i < m_tasks.size(); ++i)
+        {
+            in_degrees[i] = m_tasks[i].predecessor_count;
+            if (in_degrees[i] == 0)
+                ready_tasks.push(i);
+        }
+
+        size_t visited_count = 0;
+        while (!ready_tasks.empty())
+        {
+            TaskID task_id = ready_tasks.front();
+            ready_tasks.pop();
+            visited_count++;
+
+            for (TaskID successor : m_tasks[task_id].successors)
+            {
+                if (--in_degrees[successor] == 0)
+                    ready_tasks.push(successor);
+            }
+        }
+
+        if (visited_count != m_tasks.size())
+        {
+            MEOW_ERROR("Task graph contains a cycle!");
+            return false;
+        }
+
+        m_remaining_predecessors = std::vector<std::atomic<uint32_t>>(m_tasks.size());
+        m_compiled               = true;
+        return true;
+    }
+
+    void TaskGraph::Run(JobSystem& job_system)
+    {
+        FUNCTION_TIMER();
+
+        if (m_tasks.empty())
+            return;
+
+        if (!m_compiled && !Compile())
+            return;
+
+        m_remaining_tasks.remaining.store(static_cast<uint32_t>(m_tasks.size()), std::memory_order_relaxed);
+        for (TaskID i = 0; i < m_tasks.size(); ++i)
+        {
+            m_remaining_predecessors[i].store(m_tasks[i].predecessor_count, std::memory_order_relaxed);
+        }
+
+        for (TaskID i = 0; i < m_tasks.size(); ++i)
+        {
+            if (m_tasks[i].predecessor_count == 0)
+                Dispatch(job_system, i);
+        }
+
+        // execute main thread tasks here, and help with other jobs in the meantime
+        while (!m_remaining_tasks.IsDone())
+        {
+            TaskID main_thread_task     = 0;
+            bool   has_main_thread_task = false;
+            {
+                std::lock_guard<std::mutex> lock(m_main_thread_mutex);
+                if (!m_main_thread_tasks.empty())
+                {
+                    main_thread_task = m_main_thread_tasks.back();
+                    m_main_thread_tasks.pop_back();
+                    has_main_thread_task = true;
+                }
+            }
+
+            if (has_main_thread_task)
+                RunTask(job_system, main_thread_task);
+            else if (!job_system.TryRunPendingJob())
+                std::this_thread::yield();
+        }
+    }
+
+    void TaskGraph::Clear()
+    {
+        m_tasks.clear();
+        m_remaining_predecessors.clear();
+        m_compiled = false;
+    }
+
+    void TaskGraph::RunTask(JobSystem& job_system, TaskID task_id)
+    {
+        m_tasks[task_id].func();
+        OnTaskFinished(job_system, task_id);
+    }
+
+    void TaskGraph::OnTaskFinished(JobSystem& job_system, TaskID task_id)
+    {
+        for (TaskID successor : m_tasks[task_id].successors)
+        {
+            if (m_remaining_predecessors[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                Dispatch(job_system, successor);
+        }
+
+        // must be the last access to the graph of this task, Run may return right after it
+        m_remaining_tasks.remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void TaskGraph::Dispatch(JobSystem& job_system, TaskID task_id)
+    {
+        if (m_tasks[task_id].main_thread_only)
+        {
+            std::lock_guard<std::mutex> lock(m_main_thread_mutex);
+            m_main_thread_tasks.push_back(task_id);
+            return;
+        }
+
+        job_system.Schedule([this, &job_system, task_id]() { RunTask(job_system, task_id); });
+    }
+} // namespace Meow
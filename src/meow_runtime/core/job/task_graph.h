@@ -0,0 +1,62 @@
+#pragma once
+
+#include "job_system.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Meow
+{
+    using TaskID = uint32_t;
+
+    /**
+     * @brief Directed acyclic graph of tasks, executed on a JobSystem in dependency order.
+     *
+     * Tasks without dependencies between them run in parallel. Tasks marked main thread only are executed by the
+     * thread calling Run, which should be the main thread.
+     */
+    class TaskGraph
+    {
+    public:
+        TaskID AddTask(const std::string& name, std::function<void()> func, bool main_thread_only = false);
+
+        /**
+         * @brief Task after won't start until task before is finished.
+         */
+        void AddDependency(TaskID before, TaskID after);
+
+        /**
+         * @brief Check for cycles and cache a topological order. Called by Run when graph is modified.
+         */
+        bool Compile();
+
+        void Run(JobSystem& job_system);
+
+        void Clear();
+
+    private:
+        struct Task
+        {
+            std::string           name;
+            std::function<void()> func;
+            bool                  main_thread_only = false;
+            std::vector<TaskID>   successors;
+            uint32_t              predecessor_count = 0;
+        };
+
+        void RunTask(JobSystem& job_system, TaskID task_id);
+        void OnTaskFinished(JobSystem& job_system, TaskID task_id);
+        void Dispatch(JobSystem& job_system, TaskID task_id);
+
+        std::vector<Task> m_tasks;
+        bool              m_compiled = false;
+
+        // per run state
+        std::vector<std::atomic<uint32_t>> m_remaining_predecessors;
+        JobCounter                         m_remaining_tasks;
+        std::mutex                         m_main_thread_mutex;
+        std::vector<TaskID>                m_main_thread_tasks;
+    };
+} // namespace Meow
@@ -2,6 +2,9 @@
 
 #include <glm/glm.hpp>
 
+#include <cstddef>
+#include <vector>
+
 namespace Meow
 {
     struct BoundingBox
@@ -55,5 +58,58 @@ namespace Meow
             corners[6] = glm::vec3(min.x, max.y, max.z);
             corners[7] = glm::vec3(max.x, max.y, max.z);
         }
+
+        /**
+         * @brief Axis aligned box enclosing this box after transform, using center and extents so rotation is handled.
+         */
+        BoundingBox Transform(const glm::mat4& transform) const
+        {
+            glm::vec3 center  = (min + max) * 0.5f;
+            glm::vec3 extents = (max - min) * 0.5f;
+
+            glm::vec3 world_center = glm::vec3(transform * glm::vec4(center, 1.0f));
+            glm::vec3 world_extents(0.0f);
+            for (int i = 0; i < 3; ++i)
+            {
+                world_extents += glm::abs(glm::vec3(transform[i])) * extents[i];
+            }
+
+            return BoundingBox(world_center - world_extents, world_center + world_extents);
+        }
+    };
+
+    /**
+     * @brief Bounding boxes stored as structure of arrays, so that batch tests can load several boxes at once.
+     */
+    struct BoundingBoxColumns
+    {
+        std::vector<float> min_x;
+        std::vector<float> min_y;
+        std::vector<float> min_z;
+        std::vector<float> max_x;
+        std::vector<float> max_y;
+        std::vector<float> max_z;
+
+        size_t Size() const { return min_x.size(); }
+
+        void Clear()
+        {
+            min_x.clear();
+            min_y.clear();
+            min_z.clear();
+            max_x.clear();
+            max_y.clear();
+            max_z.clear();
+        }
+
+        void PushBack(const BoundingBox& box)
+        {
+            min_x.push_back(box.min.x);
+            min_y.push_back(box.min.y);
+            min_z.push_back(box.min.z);
+            max_x.push_back(box.max.x);
+            max_y.push_back(box.max.y);
+            max_z.push_back(box.max.z);
+        }
     };
 } // namespace Meow
\ No newline at end of file
@@ -0,0 +1,326 @@
+#include "dynamic_aabb_tree.h"
+
+#include "pch.h"
+
+#include <algorithm>
+
+namespace Meow
+{
+    DynamicAABBTree::DynamicAABBTree(float margin)
+        : m_margin(margin)
+    {}
+
+    int32_t DynamicAABBTree::CreateProxy(const BoundingBox& box, uint32_t user_data)
+    {
+        int32_t proxy = AllocateNode();
+
+        m_nodes[proxy].min       = box.min - glm::vec3(m_margin);
+        m_nodes[proxy].max       = box.max + glm::vec3(m_margin);
+        m_nodes[proxy].user_data = user_data;
+        m_nodes[proxy].height    = 0;
+
+        InsertLeaf(proxy);
+        m_proxy_count++;
+
+        return proxy;
+    }
+
+    void DynamicAABBTree::DestroyProxy(int32_t proxy)
+    {
+        ASSERT(proxy >= 0 && proxy < static_cast<int32_t>(m_nodes.size()));
+        ASSERT(m_nodes[proxy].IsLeaf());
+
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        m_proxy_count--;
+    }
+
+    bool DynamicAABBTree::MoveProxy(int32_t proxy, const BoundingBox& box)
+    {
+        ASSERT(proxy >= 0 && proxy < static_cast<int32_t>(m_nodes.size()));
+        ASSERT(m_nodes[proxy].IsLeaf());
+
+        Node& node = m_nodes[proxy];
+
+        // still inside the enlarged box, nothing to do
+        if (node.min.x <= box.min.x && node.min.y <= box.min.y && node.min.z <= box.min.z && box.max.x <= node.max.x &&
+            box.max.y <= node.max.y && box.max.z <= node.max.z)
+            return false;
+
+        RemoveLeaf(proxy);
+
+        m_nodes[proxy].min = box.min - glm::vec3(m_margin);
+        m_nodes[proxy].max = box.max + glm::vec3(m_margin);
+
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    void DynamicAABBTree::Clear()
+    {
+        m_nodes.clear();
+        m_root        = k_null_node;
+        m_free_list   = k_null_node;
+        m_proxy_count = 0;
+    }
+
+    bool DynamicAABBTree::RayIntersects(const glm::vec3& origin,
+                                        const glm::vec3& inv_direction,
+                                        float            max_distance,
+                                        const glm::vec3& box_min,
+                                        const glm::vec3& box_max)
+    {
+        float t_min = 0.0f;
+        float t_max = max_distance;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            float t1 = (box_min[i] - origin[i]) * inv_direction[i];
+            float t2 = (box_max[i] - origin[i]) * inv_direction[i];
+
+            // NaN appears when origin lies on the slab plane of an axis parallel ray, treat it as inside
+            if (t1 != t1 || t2 != t2)
+                continue;
+
+            t_min = std::max(t_min, std::min(t1, t2));
+            t_max = std::min(t_max, std::max(t1, t2));
+        }
+
+        return t_min <= t_max;
+    }
+
+    int32_t DynamicAABBTree::AllocateNode()
+    {
+        if (m_free_list == k_null_node)
+        {
+            m_nodes.emplace_back();
+            return static_cast<int32_t>(m_nodes.size() - 1);
+        }
+
+        int32_t node_index = m_free_list;
+        m_free_list        = m_nodes[node_index].parent_or_next;
+
+        m_nodes[node_index] = Node();
+        return node_index;
+    }
+
+    void DynamicAABBTree::FreeNode(int32_t node_index)
+    {
+        m_nodes[node_index].parent_or_next = m_free_list;
+        m_nodes[node_index].height         = -1;
+        m_free_list                        = node_index;
+    }
+
+    float DynamicAABBTree::SurfaceArea(const glm::vec3& min, const glm::vec3& max)
+    {
+        glm::vec3 size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    void DynamicAABBTree::InsertLeaf(int32_t leaf)
+    {
+        if (m_root == k_null_node)
+        {
+            m_root                       = leaf;
+            m_nodes[leaf].parent_or_next = k_null_node;
+            return;
+        }
+
+        // find the best sibling by surface area heuristic
+        glm::vec3 leaf_min = m_nodes[leaf].min;
+        glm::vec3 leaf_max = m_nodes[leaf].max;
+
+        int32_t index = m_root;
+        while (!m_nodes[index].IsLeaf())
+        {
+            const Node& node   = m_nodes[index];
+            int32_t     child1 = node.child1;
+            int32_t     child2 = node.child2;
+
+            float area          = SurfaceArea(node.min, node.max);
+            float combined_area = SurfaceArea(glm::min(node.min, leaf_min), glm::max(node.max, leaf_max));
+
+            // cost of creating a new parent for this node and the new leaf
+            float cost = 2.0f * combined_area;
+
+            // minimum cost of pushing the leaf further down the tree
+            float inheritance_cost = 2.0f * (combined_area - area);
+
+            auto child_cost = [&](int32_t child) {
+                const Node& child_node = m_nodes[child];
+                float       new_area =
+                    SurfaceArea(glm::min(child_node.min, leaf_min), glm::max(child_node.max, leaf_max));
+                if (child_node.IsLeaf())
+                    return new_area + inheritance_cost;
+                return new_area - SurfaceArea(child_node.min, child_node.max) + inheritance_cost;
+            };
+
+            float cost1 = child_cost(child1);
+            float cost2 = child_cost(child2);
+
+            if (cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? child1 : child2;
+        }
+
+        int32_t sibling = index;
+
+        // create a new parent
+        int32_t old_parent = m_nodes[sibling].parent_or_next;
+        int32_t new_parent = AllocateNode();
+
+        m_nodes[new_parent].parent_or_next = old_parent;
+        m_nodes[new_parent].min            = glm::min(m_nodes[sibling].min, leaf_min);
+        m_nodes[new_parent].max            = glm::max(m_nodes[sibling].max, leaf_max);
+        m_nodes[new_parent].height         = m_nodes[sibling].height + 1;
+        m_nodes[new_parent].child1         = sibling;
+        m_nodes[new_parent].child2         = leaf;
+
+        m_nodes[sibling].parent_or_next = new_parent;
+        m_nodes[leaf].parent_or_next    = new_parent;
+
+        if (old_parent != k_null_node)
+        {
+            if (m_nodes[old_parent].child1 == sibling)
+                m_nodes[old_parent].child1 = new_parent;
+            else
+                m_nodes[old_parent].child2 = new_parent;
+        }
+        else
+        {
+            m_root = new_parent;
+        }
+
+        FixUpwards(m_nodes[leaf].parent_or_next);
+    }
+
+    void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = k_null_node;
+            return;
+        }
+
+        int32_t parent       = m_nodes[leaf].parent_or_next;
+        int32_t grand_parent = m_nodes[parent].parent_or_next;
+        int32_t sibling      = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+        if (grand_parent != k_null_node)
+        {
+            // destroy parent and connect sibling to grand parent
+            if (m_nodes[grand_parent].child1 == parent)
+                m_nodes[grand_parent].child1 = sibling;
+            else
+                m_nodes[grand_parent].child2 = sibling;
+
+            m_nodes[sibling].parent_or_next = grand_parent;
+            FreeNode(parent);
+
+            FixUpwards(grand_parent);
+        }
+        else
+        {
+            m_root                          = sibling;
+            m_nodes[sibling].parent_or_next = k_null_node;
+            FreeNode(parent);
+        }
+    }
+
+    void DynamicAABBTree::FixUpwards(int32_t node_index)
+    {
+        while (node_index != k_null_node)
+        {
+            node_index = Balance(node_index);
+
+            Node&       node   = m_nodes[node_index];
+            const Node& child1 = m_nodes[node.child1];
+            const Node& child2 = m_nodes[node.child2];
+
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.min    = glm::min(child1.min, child2.min);
+            node.max    = glm::max(child1.max, child2.max);
+
+            node_index = node.parent_or_next;
+        }
+    }
+
+    /**
+     * @brief Rotate node with its higher child if the subtree is unbalanced. Returns the new root of the subtree.
+     */
+    int32_t DynamicAABBTree::Balance(int32_t a_index)
+    {
+        Node& a = m_nodes[a_index];
+        if (a.IsLeaf() || a.height < 2)
+            return a_index;
+
+        int32_t b_index = a.child1;
+        int32_t c_index = a.child2;
+        Node&   b       = m_nodes[b_index];
+        Node&   c       = m_nodes[c_index];
+
+        int32_t balance = c.height - b.height;
+
+        auto rotate_up = [&](int32_t up_index, int32_t other_index, bool up_is_child2) {
+            // up = child of a which is higher, it becomes the new subtree root
+            Node&   up      = m_nodes[up_index];
+            int32_t f_index = up.child1;
+            int32_t g_index = up.child2;
+            Node&   f       = m_nodes[f_index];
+            Node&   g       = m_nodes[g_index];
+            Node&   other   = m_nodes[other_index];
+
+            up.child1         = a_index;
+            up.parent_or_next = a.parent_or_next;
+            a.parent_or_next  = up_index;
+
+            if (up.parent_or_next != k_null_node)
+            {
+                if (m_nodes[up.parent_or_next].child1 == a_index)
+                    m_nodes[up.parent_or_next].child1 = up_index;
+                else
+                    m_nodes[up.parent_or_next].child2 = up_index;
+            }
+            else
+            {
+                m_root = up_index;
+            }
+
+            // keep the higher grandchild under up, give the lower one to a
+            int32_t keep_index  = f.height > g.height ? f_index : g_index;
+            int32_t moved_index = f.height > g.height ? g_index : f_index;
+            Node&   keep        = m_nodes[keep_index];
+            Node&   moved       = m_nodes[moved_index];
+
+            up.child2 = keep_index;
+            if (up_is_child2)
+                a.child2 = moved_index;
+            else
+                a.child1 = moved_index;
+            moved.parent_or_next = a_index;
+
+            a.min    = glm::min(other.min, moved.min);
+            a.max    = glm::max(other.max, moved.max);
+            a.height = 1 + std::max(other.height, moved.height);
+
+            up.min    = glm::min(a.min, keep.min);
+            up.max    = glm::max(a.max, keep.max);
+            up.height = 1 + std::max(a.height, keep.height);
+        };
+
+        if (balance > 1)
+        {
+            rotate_up(c_index, b_index, true);
+            return c_index;
+        }
+
+        if (balance < -1)
+        {
+            rotate_up(b_index, c_index, false);
+            return b_index;
+        }
+
+        return a_index;
+    }
+} // namespace Meow
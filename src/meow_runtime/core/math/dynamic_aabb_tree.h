@@ -0,0 +1,206 @@
+#pragma once
+
+#include "bounding_box.h"
+#include "frustum.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Bounding volume hierarchy of axis aligned boxes, updated incrementally.
+     *
+     * Leaves store boxes enlarged by a margin, so small movements don't touch the tree. Inserting picks the sibling
+     * with the lowest surface area cost, and the tree is kept balanced by rotations, so queries are O(log n) for
+     * sparse results.
+     */
+    class DynamicAABBTree
+    {
+    public:
+        static constexpr int32_t k_null_node = -1;
+
+        explicit DynamicAABBTree(float margin = 0.1f);
+
+        int32_t CreateProxy(const BoundingBox& box, uint32_t user_data);
+
+        void DestroyProxy(int32_t proxy);
+
+        /**
+         * @brief Update box of a proxy. Returns whether the proxy was reinserted.
+         */
+        bool MoveProxy(int32_t proxy, const BoundingBox& box);
+
+        uint32_t GetUserData(int32_t proxy) const { return m_nodes[proxy].user_data; }
+
+        uint32_t GetProxyCount() const { return m_proxy_count; }
+
+        int32_t GetHeight() const { return m_root == k_null_node ? 0 : m_nodes[m_root].height; }
+
+        void Clear();
+
+        /**
+         * @brief Call callback(proxy, fully_inside) for every leaf whose enlarged box is not outside the frustum.
+         *
+         * Subtrees fully inside are reported without testing their children.
+         */
+        template<typename Callback>
+        void QueryFrustum(const Frustum& frustum, Callback&& callback) const
+        {
+            if (m_root == k_null_node)
+                return;
+
+            // second element marks that the subtree is fully inside
+            std::vector<std::pair<int32_t, bool>> stack;
+            stack.reserve(64);
+            stack.push_back({m_root, false});
+
+            while (!stack.empty())
+            {
+                auto [node_index, fully_inside] = stack.back();
+                stack.pop_back();
+
+                const Node& node = m_nodes[node_index];
+
+                if (!fully_inside)
+                {
+                    FrustumTestResult result = frustum.Classify(node.min, node.max);
+                    if (result == FrustumTestResult::Outside)
+                        continue;
+                    fully_inside = result == FrustumTestResult::Inside;
+                }
+
+                if (node.IsLeaf())
+                {
+                    callback(node_index, fully_inside);
+                    continue;
+                }
+
+                stack.push_back({node.child1, fully_inside});
+                stack.push_back({node.child2, fully_inside});
+            }
+        }
+
+        /**
+         * @brief Call callback(proxy) for every leaf whose enlarged box overlaps the box.
+         */
+        template<typename Callback>
+        void QueryAABB(const BoundingBox& box, Callback&& callback) const
+        {
+            if (m_root == k_null_node)
+                return;
+
+            std::vector<int32_t> stack;
+            stack.reserve(64);
+            stack.push_back(m_root);
+
+            while (!stack.empty())
+            {
+                int32_t node_index = stack.back();
+                stack.pop_back();
+
+                const Node& node = m_nodes[node_index];
+                if (!Overlaps(node.min, node.max, box.min, box.max))
+                    continue;
+
+                if (node.IsLeaf())
+                {
+                    callback(node_index);
+                    continue;
+                }
+
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+
+        /**
+         * @brief Call callback(proxy) for every leaf whose enlarged box is hit by the ray segment.
+         */
+        template<typename Callback>
+        void QueryRay(const glm::vec3& origin,
+                      const glm::vec3& direction,
+                      float            max_distance,
+                      Callback&&       callback) const
+        {
+            if (m_root == k_null_node)
+                return;
+
+            glm::vec3 inv_direction(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+            std::vector<int32_t> stack;
+            stack.reserve(64);
+            stack.push_back(m_root);
+
+            while (!stack.empty())
+            {
+                int32_t node_index = stack.back();
+                stack.pop_back();
+
+                const Node& node = m_nodes[node_index];
+                if (!RayIntersects(origin, inv_direction, max_distance, node.min, node.max))
+                    continue;
+
+                if (node.IsLeaf())
+                {
+                    callback(node_index);
+                    continue;
+                }
+
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+
+        static bool
+        Overlaps(const glm::vec3& a_min, const glm::vec3& a_max, const glm::vec3& b_min, const glm::vec3& b_max)
+        {
+            return a_min.x <= b_max.x && a_max.x >= b_min.x && a_min.y <= b_max.y && a_max.y >= b_min.y &&
+                   a_min.z <= b_max.z && a_max.z >= b_min.z;
+        }
+
+        /**
+         * @brief Slab test. inv_direction is 1 / direction per component, infinity for zero components is fine.
+         */
+        static bool RayIntersects(const glm::vec3& origin,
+                                  const glm::vec3& inv_direction,
+                                  float            max_distance,
+                                  const glm::vec3& box_min,
+                                  const glm::vec3& box_max);
+
+    private:
+        struct Node
+        {
+            glm::vec3 min;
+            glm::vec3 max;
+
+            // parent when in tree, next free node when in free list
+            int32_t  parent_or_next = k_null_node;
+            int32_t  child1         = k_null_node;
+            int32_t  child2         = k_null_node;
+            int32_t  height         = -1; // leaf is 0, free node is -1
+            uint32_t user_data      = 0;
+
+            bool IsLeaf() const { return child1 == k_null_node; }
+        };
+
+        int32_t AllocateNode();
+        void    FreeNode(int32_t node_index);
+
+        void    InsertLeaf(int32_t leaf);
+        void    RemoveLeaf(int32_t leaf);
+        int32_t Balance(int32_t node_index);
+        void    FixUpwards(int32_t node_index);
+
+        static float SurfaceArea(const glm::vec3& min, const glm::vec3& max);
+
+        std::vector<Node> m_nodes;
+        int32_t           m_root        = k_null_node;
+        int32_t           m_free_list   = k_null_node;
+        uint32_t          m_proxy_count = 0;
+        float             m_margin;
+    };
+} // namespace Meow
@@ -4,6 +4,14 @@
 #include <iostream>
 #include <math.h>
 
+#if defined(__AVX__)
+#    include <immintrin.h>
+#    define MEOW_FRUSTUM_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define MEOW_FRUSTUM_SSE
+#endif
+
 namespace Meow
 {
     // Calculates frustum planes in world space
@@ -20,7 +28,7 @@ namespace Meow
 
         glm::vec3 right   = rotation * glm::vec3(1.0f, 0.0f, 0.0f);
         glm::vec3 forward = rotation * glm::vec3(0.0f, 0.0f, 1.0f);
-        glm::vec3 up      = glm::vec3(0.0f, 1.0f, 0.0f);
+        glm::vec3 up      = rotation * glm::vec3(0.0f, 1.0f, 0.0f);
 
         // Gets worlds space position of the center points of the near and far planes
         // The forward vector Z points towards the viewer so you need to negate it and scale it
@@ -71,25 +79,145 @@ namespace Meow
     }
 
     // False is fully outside, true if inside or intersects
-    // based on iquilez method
+    // A box is outside when its p-vertex, the corner farthest along the plane normal, is behind any plane
     bool Frustum::checkIfInside(BoundingBox* box)
     {
-        // Check box outside or inside of frustum
         for (int i = 0; i < 6; ++i)
         {
-            int out = 0;
-            out += ((pl[i].distance(glm::vec3(box->min.x, box->min.y, box->min.z)) < 0.0) ? 1 : 0);
-            out += ((pl[i].distance(glm::vec3(box->max.x, box->min.y, box->min.z)) < 0.0) ? 1 : 0);
-            out += ((pl[i].distance(glm::vec3(box->min.x, box->max.y, box->min.z)) < 0.0) ? 1 : 0);
-            out += ((pl[i].distance(glm::vec3(box->max.x, box->max.y, box->min.z)) < 0.0) ? 1 : 0);
-            out += ((pl[i].distance(glm::vec3(box->min.x, box->min.y, box->max.z)) < 0.0) ? 1 : 0);
-            out += ((pl[i].distance(glm::vec3(box->max.x, box->min.y, box->max.z)) < 0.0) ? 1 : 0);
-            out += ((pl[i].distance(glm::vec3(box->min.x, box->max.y, box->max.z)) < 0.0) ? 1 : 0);
-            out += ((pl[i].distance(glm::vec3(box->max.x, box->max.y, box->max.z)) < 0.0) ? 1 : 0);
-
-            if (out == 8)
+            glm::vec3 p_vertex(pl[i].normal.x >= 0.0f ? box->max.x : box->min.x,
+                               pl[i].normal.y >= 0.0f ? box->max.y : box->min.y,
+                               pl[i].normal.z >= 0.0f ? box->max.z : box->min.z);
+
+            if (pl[i].distance(p_vertex) < 0.0f)
                 return false;
         }
         return true;
     }
+
+    FrustumTestResult Frustum::Classify(const glm::vec3& min, const glm::vec3& max) const
+    {
+        FrustumTestResult result = FrustumTestResult::Inside;
+        for (int i = 0; i < 6; ++i)
+        {
+            const glm::vec3& normal = pl[i].normal;
+
+            glm::vec3 p_vertex(normal.x >= 0.0f ? max.x : min.x,
+                               normal.y >= 0.0f ? max.y : min.y,
+                               normal.z >= 0.0f ? max.z : min.z);
+            if (glm::dot(normal, p_vertex) + pl[i].D < 0.0f)
+                return FrustumTestResult::Outside;
+
+            // n-vertex is the corner nearest along the normal
+            glm::vec3 n_vertex(normal.x >= 0.0f ? min.x : max.x,
+                               normal.y >= 0.0f ? min.y : max.y,
+                               normal.z >= 0.0f ? min.z : max.z);
+            if (glm::dot(normal, n_vertex) + pl[i].D < 0.0f)
+                result = FrustumTestResult::Intersect;
+        }
+        return result;
+    }
+
+    std::array<glm::vec4, 6> Frustum::GetPlaneEquations() const
+    {
+        std::array<glm::vec4, 6> planes;
+        for (int i = 0; i < 6; ++i)
+        {
+            planes[i] = glm::vec4(pl[i].normal, pl[i].D);
+        }
+        return planes;
+    }
+
+    void Frustum::CheckIfInside(const BoundingBoxColumns& boxes, std::vector<uint8_t>& visibilities) const
+    {
+        const size_t count = boxes.Size();
+        visibilities.resize(count);
+
+        // p-vertex component of each plane is the same column for all boxes, so choose columns once per plane
+        const float* p_x[6];
+        const float* p_y[6];
+        const float* p_z[6];
+        for (int i = 0; i < 6; ++i)
+        {
+            p_x[i] = pl[i].normal.x >= 0.0f ? boxes.max_x.data() : boxes.min_x.data();
+            p_y[i] = pl[i].normal.y >= 0.0f ? boxes.max_y.data() : boxes.min_y.data();
+            p_z[i] = pl[i].normal.z >= 0.0f ? boxes.max_z.data() : boxes.min_z.data();
+        }
+
+        size_t begin = 0;
+
+#if defined(MEOW_FRUSTUM_AVX)
+        __m256 normal_x[6], normal_y[6], normal_z[6], plane_d[6];
+        for (int i = 0; i < 6; ++i)
+        {
+            normal_x[i] = _mm256_set1_ps(pl[i].normal.x);
+            normal_y[i] = _mm256_set1_ps(pl[i].normal.y);
+            normal_z[i] = _mm256_set1_ps(pl[i].normal.z);
+            plane_d[i]  = _mm256_set1_ps(pl[i].D);
+        }
+
+        for (; begin + 8 <= count; begin += 8)
+        {
+            __m256 outside = _mm256_setzero_ps();
+            for (int i = 0; i < 6; ++i)
+            {
+                __m256 distance = plane_d[i];
+                distance        = _mm256_add_ps(distance, _mm256_mul_ps(normal_x[i], _mm256_loadu_ps(p_x[i] + begin)));
+                distance        = _mm256_add_ps(distance, _mm256_mul_ps(normal_y[i], _mm256_loadu_ps(p_y[i] + begin)));
+                distance        = _mm256_add_ps(distance, _mm256_mul_ps(normal_z[i], _mm256_loadu_ps(p_z[i] + begin)));
+                outside         = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+
+            int outside_mask = _mm256_movemask_ps(outside);
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                visibilities[begin + lane] = ((outside_mask >> lane) & 1) ? 0 : 1;
+            }
+        }
+#elif defined(MEOW_FRUSTUM_SSE)
+        __m128 normal_x[6], normal_y[6], normal_z[6], plane_d[6];
+        for (int i = 0; i < 6; ++i)
+        {
+            normal_x[i] = _mm_set1_ps(pl[i].normal.x);
+            normal_y[i] = _mm_set1_ps(pl[i].normal.y);
+            normal_z[i] = _mm_set1_ps(pl[i].normal.z);
+            plane_d[i]  = _mm_set1_ps(pl[i].D);
+        }
+
+        for (; begin + 4 <= count; begin += 4)
+        {
+            __m128 outside = _mm_setzero_ps();
+            for (int i = 0; i < 6; ++i)
+            {
+                __m128 distance = plane_d[i];
+                distance        = _mm_add_ps(distance, _mm_mul_ps(normal_x[i], _mm_loadu_ps(p_x[i] + begin)));
+                distance        = _mm_add_ps(distance, _mm_mul_ps(normal_y[i], _mm_loadu_ps(p_y[i] + begin)));
+                distance        = _mm_add_ps(distance, _mm_mul_ps(normal_z[i], _mm_loadu_ps(p_z[i] + begin)));
+                outside         = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+            }
+
+            int outside_mask = _mm_movemask_ps(outside);
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                visibilities[begin + lane] = ((outside_mask >> lane) & 1) ? 0 : 1;
+            }
+        }
+#endif
+
+        // scalar fallback, also handles the tail
+        for (size_t box_index = begin; box_index < count; ++box_index)
+        {
+            uint8_t visible = 1;
+            for (int i = 0; i < 6; ++i)
+            {
+                float distance = pl[i].normal.x * p_x[i][box_index] + pl[i].normal.y * p_y[i][box_index] +
+                                 pl[i].normal.z * p_z[i][box_index] + pl[i].D;
+                if (distance < 0.0f)
+                {
+                    visible = 0;
+                    break;
+                }
+            }
+            visibilities[box_index] = visible;
+        }
+    }
 } // namespace Meow
\ No newline at end of file
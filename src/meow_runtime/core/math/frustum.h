@@ -5,8 +5,19 @@
 
 #include <glm/gtc/quaternion.hpp>
 
+#include <array>
+#include <cstdint>
+#include <vector>
+
 namespace Meow
 {
+    enum class FrustumTestResult
+    {
+        Outside,
+        Intersect,
+        Inside,
+    };
+
     class Frustum
     {
     private:
@@ -25,6 +36,23 @@ namespace Meow
         updatePlanes(const glm::vec3 cameraPos, const glm::quat rotation, float fovy, float AR, float near, float far);
         bool checkIfInside(BoundingBox* bounds);
 
+        /**
+         * @brief Test all boxes against the frustum. visibilities[i] is 1 if box i is inside or intersects.
+         *
+         * Uses AVX or SSE when the compiler targets them, and a scalar loop otherwise.
+         */
+        void CheckIfInside(const BoundingBoxColumns& boxes, std::vector<uint8_t>& visibilities) const;
+
+        /**
+         * @brief Like checkIfInside, but also tells whether the box is fully inside, used to skip subtrees of a BVH.
+         */
+        FrustumTestResult Classify(const glm::vec3& min, const glm::vec3& max) const;
+
+        /**
+         * @brief Planes as (normal, D), with normals pointing inside, e.g. to upload the frustum for GPU culling.
+         */
+        std::array<glm::vec4, 6> GetPlaneEquations() const;
+
     private:
         Plane pl[6];
     };
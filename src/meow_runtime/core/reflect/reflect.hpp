@@ -34,6 +34,10 @@ namespace Meow
                 m_setter = [field_ptr](void* obj, void* val) {
                     ClassType* self  = static_cast<ClassType*>(obj);
                     self->*field_ptr = *static_cast<FieldType*>(val);
+
+                    // let classes which track changes, e.g. Transform3DComponent, know that a field is set
+                    if constexpr (requires { self->OnReflectedFieldSet(); })
+                        self->OnReflectedFieldSet();
                 };
             }
 
@@ -2,10 +2,14 @@
 
 #include "scope_time_data.h"
 
+#include <mutex>
 #include <vector>
 
 namespace Meow
 {
+    /**
+     * @brief Collects scope times of a frame. Depth is tracked per thread, so timers can be used in jobs.
+     */
     class TimerSingleton
     {
     public:
@@ -21,6 +25,8 @@ namespace Meow
         void Push()
         {
             m_curr_depth++;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
             if (m_curr_depth > m_max_depth)
                 m_max_depth = m_curr_depth;
         }
@@ -35,6 +41,8 @@ namespace Meow
 
         void Upload(ScopeTimeData scope_time)
         {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
             if (m_scope_times.size() == 0)
                 m_global_start = scope_time.start;
             else
@@ -43,10 +51,16 @@ namespace Meow
             m_scope_times.push_back(scope_time);
         }
 
-        const std::vector<ScopeTimeData>& GetScopeTimes() { return m_scope_times; }
+        std::vector<ScopeTimeData> GetScopeTimes()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_scope_times;
+        }
 
         void Clear()
         {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
             m_curr_depth = -1;
             m_max_depth  = -1;
             m_scope_times.clear();
@@ -55,8 +69,10 @@ namespace Meow
     private:
         TimerSingleton() {}
 
-        int m_curr_depth = -1;
-        int m_max_depth  = -1;
+        std::mutex m_mutex;
+
+        inline static thread_local int m_curr_depth = -1;
+        int                            m_max_depth  = -1;
 
         std::chrono::microseconds m_global_start;
 
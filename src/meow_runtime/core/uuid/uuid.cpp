@@ -6,12 +6,24 @@
 
 namespace Meow
 {
-    static std::random_device                      s_RandomDevice;
-    static std::mt19937_64                         s_Engine(s_RandomDevice());
-    static std::uniform_int_distribution<uint64_t> s_UniformDistribution;
+    namespace
+    {
+        /**
+         * @brief Engine of the calling thread, since game objects are created from tick workers concurrently.
+         */
+        std::mt19937_64& GetEngine()
+        {
+            thread_local std::mt19937_64 engine([] {
+                std::random_device random_device;
+                std::seed_seq      seed {random_device(), random_device(), random_device(), random_device()};
+                return std::mt19937_64(seed);
+            }());
+            return engine;
+        }
+    } // namespace
 
     UUID::UUID()
-        : m_UUID(s_UniformDistribution(s_Engine))
+        : m_UUID(std::uniform_int_distribution<uint64_t>()(GetEngine()))
     {}
 
     UUID::UUID(uint64_t uuid)
@@ -14,11 +14,17 @@ namespace Meow
     {
         if (!m_parent_object.lock())
             MEOW_INFO("Not Found!");
-        m_transform = m_parent_object.lock()->TryGetComponent<Transform3DComponent>("Transform3DComponent");
+        m_transform = m_parent_object.lock()->TryGetComponent<Transform3DComponent>();
     }
 
     void Camera3DComponent::Tick(float dt)
     {
+        if (camera_mode == CameraMode::Free)
+        {
+            TickFreeCamera(dt);
+        }
+
+        // update after moving, so that culling in this frame uses the same pose as rendering
         auto transfrom_shared_ptr = m_transform.lock();
 
         m_frustum.updatePlanes(transfrom_shared_ptr->position,
@@ -27,26 +33,23 @@ namespace Meow
                                aspect_ratio,
                                near_plane,
                                far_plane);
-
-        if (camera_mode == CameraMode::Free)
-        {
-            TickFreeCamera(dt);
-        }
     }
 
     bool Camera3DComponent::FrustumCulling(std::shared_ptr<GameObject> gameobject)
     {
-        auto transform_shared_ptr = gameobject->TryGetComponent<Transform3DComponent>("Transform3DComponent");
+        auto transform_shared_ptr = gameobject->TryGetComponent<Transform3DComponent>();
         if (!transform_shared_ptr)
             return false;
 
-        auto model_shared_ptr = gameobject->TryGetComponent<ModelComponent>("ModelComponent");
+        auto model_shared_ptr = gameobject->TryGetComponent<ModelComponent>();
         if (!model_shared_ptr)
             return false;
 
-        auto bounding = model_shared_ptr->model.lock()->GetBounding();
-        bounding.min  = bounding.min * transform_shared_ptr->scale + transform_shared_ptr->position;
-        bounding.max  = bounding.max * transform_shared_ptr->scale + transform_shared_ptr->position;
+        Model* model = g_runtime_context.resource_system->Get(model_shared_ptr->GetModel());
+        if (!model)
+            return false;
+
+        auto bounding = model->GetBounding().Transform(transform_shared_ptr->GetTransform());
 
         return CheckVisibility(&bounding);
     }
@@ -138,12 +141,12 @@ namespace Meow
             glm::vec3 target_position = transform_component->position + movement_delta;
 
             // Apply smooth rotation (spherical interpolation)
-            transform_component->rotation = glm::slerp(
-                transform_component->rotation, target_rotation, 1.0f - std::exp(-rotation_smooth_factor * dt));
+            transform_component->SetRotation(glm::slerp(
+                transform_component->rotation, target_rotation, 1.0f - std::exp(-rotation_smooth_factor * dt)));
 
             // Apply smooth movement (linear interpolation)
-            transform_component->position =
-                glm::mix(transform_component->position, target_position, 1.0f - std::exp(-movement_smooth_factor * dt));
+            transform_component->SetPosition(glm::mix(
+                transform_component->position, target_position, 1.0f - std::exp(-movement_smooth_factor * dt)));
         }
     }
 
@@ -60,6 +60,8 @@ namespace Meow
 
         bool CheckVisibility(BoundingBox* bounding);
 
+        const Frustum& GetFrustum() const { return m_frustum; }
+
     private:
         std::pair<glm::vec3, glm::quat> CalculateFreeCameraDeltas(float dt);
 
@@ -0,0 +1,27 @@
+#include "model_component.h"
+
+#include "function/global/runtime_context.h"
+
+namespace Meow
+{
+    ModelComponent::~ModelComponent()
+    {
+        // game objects still referenced elsewhere may outlive resource system, which frees every model anyway
+        if (g_runtime_context.resource_system)
+            g_runtime_context.resource_system->Release(m_model);
+    }
+
+    void ModelComponent::SetModel(ResourceHandle<Model> model)
+    {
+        if (model == m_model)
+            return;
+
+        g_runtime_context.resource_system->AddRef(model);
+        g_runtime_context.resource_system->Release(m_model);
+        m_model = model;
+
+        // level indexes the bounds of the model, and renders what it resolves from the handle
+        if (auto gameobject = m_parent_object.lock())
+            gameobject->MarkRenderableDirty();
+    }
+} // namespace Meow
@@ -3,6 +3,7 @@
 #include "core/reflect/macros.h"
 #include "function/object/game_object.h"
 #include "function/render/model/model.hpp"
+#include "function/resource/resource_handle.h"
 
 #include <vector>
 
@@ -11,9 +12,23 @@ namespace Meow
     class [[reflectable_class()]] ModelComponent : public Component
     {
     public:
-        UUID                 uuid;
-        std::weak_ptr<Model> model;
-        UUID                 material_id;
+        UUID uuid;
+        UUID material_id;
+
+        ModelComponent() = default;
+        ~ModelComponent();
+
+        // the component holds a reference of its model, which a copy would release twice
+        ModelComponent(const ModelComponent&)            = delete;
+        ModelComponent& operator=(const ModelComponent&) = delete;
+
+        /**
+         * @brief Add a reference to the model and release the previous one, and mark the game object for the level to
+         * index it again. Resource pools are not thread safe, so don't call it from parallel ticks.
+         */
+        void SetModel(ResourceHandle<Model> model);
+
+        ResourceHandle<Model> GetModel() const { return m_model; }
 
         [[reflectable_method()]]
         void foo1()
@@ -26,5 +41,8 @@ namespace Meow
         {
             std::cout << "derived class uuid = " << uuid << std::endl;
         }
+
+    private:
+        ResourceHandle<Model> m_model;
     };
 } // namespace Meow
\ No newline at end of file
@@ -7,6 +7,12 @@
 
 namespace Meow
 {
+    /**
+     * @brief Local position, rotation and scale of a game object.
+     *
+     * Fields are public for reflection, but write them through the setters. Setters mark the game object, and the
+     * level only recomposes transforms of marked objects. Reflection marks it as well after setting a field.
+     */
     class [[reflectable_class()]] Transform3DComponent : public Component
     {
     public:
@@ -19,6 +25,43 @@ namespace Meow
         [[reflectable_field()]]
         glm::vec3 scale = glm::vec3(1.0f);
 
+        void SetPosition(const glm::vec3& new_position)
+        {
+            if (position == new_position)
+                return;
+
+            position = new_position;
+            MarkChanged();
+        }
+
+        void SetRotation(const glm::quat& new_rotation)
+        {
+            if (rotation == new_rotation)
+                return;
+
+            rotation = new_rotation;
+            MarkChanged();
+        }
+
+        void SetScale(const glm::vec3& new_scale)
+        {
+            if (scale == new_scale)
+                return;
+
+            scale = new_scale;
+            MarkChanged();
+        }
+
+        /**
+         * @brief Bumped on every change made through setters or reflection, for caches derived from the transform.
+         */
+        uint64_t GetVersion() const { return m_version; }
+
+        /**
+         * @brief Called by reflection::FieldAccessor after a field is set.
+         */
+        void OnReflectedFieldSet() { MarkChanged(); }
+
         /**
          * @brief Get the Transform from position, rotation(quaternion) and scale
          *
@@ -30,6 +73,9 @@ namespace Meow
          *
          * 3. Translate
          *
+         * It is the local transform relative to parent. World transforms are cached by Level, see
+         * Level::GetWorldTransform().
+         *
          * @return glm::mat4
          */
         glm::mat4 GetTransform() const
@@ -57,5 +103,17 @@ namespace Meow
 
             return transform;
         }
+
+    private:
+        void MarkChanged()
+        {
+            ++m_version;
+
+            // the object isn't in a level yet when it has no parent, and the level reads it whole when it's added
+            if (auto gameobject = m_parent_object.lock())
+                gameobject->MarkTransformDirty();
+        }
+
+        uint64_t m_version = 0;
     };
 } // namespace Meow
\ No newline at end of file
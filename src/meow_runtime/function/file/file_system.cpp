@@ -44,6 +44,24 @@ namespace Meow
         return {data_ptr, data_size};
     }
 
+    bool FileSystem::WriteBinaryFile(std::string const& file_path, const uint8_t* data_ptr, size_t data_size)
+    {
+        FUNCTION_TIMER();
+
+        std::filesystem::path full_path = m_root_path / file_path;
+
+        std::error_code error_code;
+        std::filesystem::create_directories(full_path.parent_path(), error_code);
+        if (error_code)
+            return false;
+
+        std::ofstream ofs(full_path, std::ios::binary | std::ios::trunc);
+        if (!ofs)
+            return false;
+
+        return static_cast<bool>(ofs.write(reinterpret_cast<const char*>(data_ptr), data_size));
+    }
+
     std::tuple<uint32_t, uint32_t> FileSystem::GetImageFileWidthHeight(std::string const& file_path)
     {
         FUNCTION_TIMER();
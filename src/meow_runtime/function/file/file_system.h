@@ -55,6 +55,15 @@ namespace Meow
          */
         std::tuple<uint8_t*, uint32_t> ReadBinaryFile(std::string const& file_path);
 
+        /**
+         * @brief Write binary file by relative path, creating its directories and replacing any existing file.
+         *
+         * @param file_path Relative path.
+         * @return true File is written;
+         * @return false File can't be written.
+         */
+        bool WriteBinaryFile(std::string const& file_path, const uint8_t* data_ptr, size_t data_size);
+
         std::tuple<uint32_t, uint32_t> GetImageFileWidthHeight(std::string const& file_path);
 
         /**
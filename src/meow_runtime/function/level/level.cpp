@@ -2,44 +2,212 @@
 
 #include "pch.h"
 
+#include "function/components/light/directional_light_component.h"
 #include "function/components/model/model_component.h"
+#include "function/components/transform/transform_3d_component.hpp"
 #include "function/global/runtime_context.h"
 #include "function/render/material/material.h"
 
+#include <mutex>
+
 namespace Meow
 {
+    namespace
+    {
+        constexpr uint32_t k_parallel_tick_grain_size = 256;
+    } // namespace
+
     void Level::Tick(float dt)
     {
         FUNCTION_TIMER();
 
-        for (auto& kv : m_gameobjects)
+        std::vector<GameObjectHandle> component_set_changed;
+        std::vector<GameObjectHandle> renderable_changed;
+
+        // objects whose transform is set since last tick, see Transform3DComponent
+        m_transform_changed.clear();
+
+        m_is_ticking = true;
+        TickGameObjects(dt, component_set_changed, renderable_changed, m_transform_changed);
+        m_is_ticking = false;
+
+        // sync point, apply structural changes recorded during tick
+        FlushCommandBuffer(component_set_changed, renderable_changed, m_transform_changed);
+
+        // an added transform or model has to be composed and indexed like a moved object
+        for (GameObjectHandle handle : component_set_changed)
         {
-            kv.second->Tick(dt);
+            const auto* gameobject = m_gameobjects.Get(handle);
+            if (!gameobject || !(*gameobject)->IsComponentSetDirty())
+                continue;
+
+            (*gameobject)->ClearComponentSetDirty();
+            m_transform_changed.push_back(handle);
         }
 
+        UpdateLocalTransforms(m_transform_changed);
+
+        // only objects whose transform or parent changed are recomputed, static objects cost no matrix math
+        m_world_transform_changed.clear();
+        m_transform_hierarchy.Update(m_world_transform_changed);
+        UpdateSpatialIndex(m_world_transform_changed);
+
+        // objects which switched model without moving
+        UpdateSpatialIndex(renderable_changed);
+
+        GatherDirectionalLights();
         FrustumCulling();
     }
 
-    std::vector<std::weak_ptr<GameObject>>* Level::GetVisiblesPerShadingModel(ShadingModelType shading_model)
+    void Level::TickGameObjects(float                          dt,
+                                std::vector<GameObjectHandle>& component_set_changed,
+                                std::vector<GameObjectHandle>& renderable_changed,
+                                std::vector<GameObjectHandle>& transform_changed)
     {
-        if (m_visibles_per_shading_model.find(shading_model) == m_visibles_per_shading_model.end())
+        FUNCTION_TIMER();
+
+        JobSystem* job_system = g_runtime_context.job_system.get();
+
+        if (!m_parallel_tick_enabled || !job_system || job_system->GetWorkerCount() == 0)
+        {
+            for (size_t i = 0; i < m_gameobjects.Size(); ++i)
+            {
+                GameObject*      gameobject = m_gameobjects.begin()[i].get();
+                GameObjectHandle handle     = m_gameobjects.GetHandle(i);
+                gameobject->Tick(dt);
+
+                if (gameobject->IsComponentSetDirty())
+                    component_set_changed.push_back(handle);
+
+                if (gameobject->IsRenderableDirty())
+                {
+                    gameobject->ClearRenderableDirty();
+                    renderable_changed.push_back(handle);
+                }
+
+                if (gameobject->IsTransformDirty())
+                {
+                    gameobject->ClearTransformDirty();
+                    transform_changed.push_back(handle);
+                }
+            }
+            return;
+        }
+
+        std::mutex changed_mutex;
+
+        job_system->ParallelFor(
+            static_cast<uint32_t>(m_gameobjects.Size()), k_parallel_tick_grain_size, [&](uint32_t begin, uint32_t end) {
+                std::vector<GameObjectHandle> local_changed;
+                std::vector<GameObjectHandle> local_renderable_changed;
+                std::vector<GameObjectHandle> local_transform_changed;
+
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    GameObject*      gameobject = m_gameobjects.begin()[i].get();
+                    GameObjectHandle handle     = m_gameobjects.GetHandle(i);
+                    gameobject->Tick(dt);
+
+                    if (gameobject->IsComponentSetDirty())
+                        local_changed.push_back(handle);
+
+                    if (gameobject->IsRenderableDirty())
+                    {
+                        gameobject->ClearRenderableDirty();
+                        local_renderable_changed.push_back(handle);
+                    }
+
+                    if (gameobject->IsTransformDirty())
+                    {
+                        gameobject->ClearTransformDirty();
+                        local_transform_changed.push_back(handle);
+                    }
+                }
+
+                if (local_changed.empty() && local_renderable_changed.empty() && local_transform_changed.empty())
+                    return;
+
+                std::lock_guard<std::mutex> lock(changed_mutex);
+                component_set_changed.insert(component_set_changed.end(), local_changed.begin(), local_changed.end());
+                renderable_changed.insert(
+                    renderable_changed.end(), local_renderable_changed.begin(), local_renderable_changed.end());
+                transform_changed.insert(
+                    transform_changed.end(), local_transform_changed.begin(), local_transform_changed.end());
+            });
+    }
+
+    void Level::FlushCommandBuffer(std::vector<GameObjectHandle>& component_set_changed,
+                                   std::vector<GameObjectHandle>& renderable_changed,
+                                   std::vector<GameObjectHandle>& transform_changed)
+    {
+        FUNCTION_TIMER();
+
+        for (auto& command : m_command_buffer.TakeCommands())
+        {
+            switch (command.type)
+            {
+                case LevelCommandBuffer::CommandType::Create:
+                    command.gameobject->ClearComponentSetDirty();
+                    command.gameobject->ClearTransformDirty();
+                    transform_changed.push_back(AddGameObject(command.gameobject));
+                    break;
+                case LevelCommandBuffer::CommandType::Delete:
+                    DeleteGameObjectByID(command.go_id);
+                    break;
+                case LevelCommandBuffer::CommandType::Modify: {
+                    GameObjectHandle handle     = GetGameObjectHandle(command.go_id);
+                    const auto*      gameobject = m_gameobjects.Get(handle);
+                    if (!gameobject)
+                    {
+                        MEOW_WARN("GameObject {} is deleted before deferred modification!",
+                                  static_cast<uint64_t>(command.go_id));
+                        break;
+                    }
+
+                    command.modify_func(*gameobject);
+                    if ((*gameobject)->IsComponentSetDirty())
+                        component_set_changed.push_back(handle);
+
+                    if ((*gameobject)->IsRenderableDirty())
+                    {
+                        (*gameobject)->ClearRenderableDirty();
+                        renderable_changed.push_back(handle);
+                    }
+
+                    if ((*gameobject)->IsTransformDirty())
+                    {
+                        (*gameobject)->ClearTransformDirty();
+                        transform_changed.push_back(handle);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<VisibleObject>* Level::GetVisiblesPerShadingModel(ShadingModelType shading_model)
+    {
+        size_t bucket = static_cast<size_t>(shading_model);
+        if (bucket >= m_visibles_per_shading_model.size())
         {
             return nullptr;
         }
 
-        return &m_visibles_per_shading_model.at(shading_model);
+        return &m_visibles_per_shading_model[bucket];
     }
 
     std::weak_ptr<GameObject> Level::GetGameObjectByID(UUID go_id) const
     {
         FUNCTION_TIMER();
 
-        auto iter = m_gameobjects.find(go_id);
-        if (iter != m_gameobjects.end())
+        if (const auto* gameobject = m_gameobjects.Get(GetGameObjectHandle(go_id)))
         {
-            return iter->second;
+            return *gameobject;
         }
 
+        if (m_is_ticking)
+            return m_command_buffer.FindCreated(go_id);
+
         return std::weak_ptr<GameObject>();
     }
 
@@ -47,6 +215,7 @@ namespace Meow
     {
         FUNCTION_TIMER();
 
+        // tick workers may create objects concurrently, the id comes from the engine of the calling thread
         UUID object_id;
 
         std::shared_ptr<GameObject> gobject;
@@ -59,51 +228,371 @@ namespace Meow
             MEOW_ERROR("cannot allocate memory for new gobject");
         }
 
-        m_gameobjects.insert({object_id, gobject});
+        if (m_is_ticking)
+        {
+            m_command_buffer.RecordCreate(gobject);
+            return object_id;
+        }
+
+        AddGameObject(gobject);
 
         return object_id;
     }
 
-    void Level::FrustumCulling()
+    void Level::DeleteGameObjectByID(UUID go_id)
     {
-        m_visibles_per_shading_model.clear();
+        FUNCTION_TIMER();
 
-        std::shared_ptr<GameObject> main_camera = GetGameObjectByID(m_main_camera_id).lock();
+        if (m_is_ticking)
+        {
+            m_command_buffer.RecordDelete(go_id);
+            return;
+        }
 
-        if (!main_camera)
+        auto iter = m_handles_by_id.find(go_id);
+        if (iter == m_handles_by_id.end())
             return;
 
-        std::shared_ptr<Camera3DComponent> main_camera_component =
-            main_camera->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+        RemoveFromSpatialIndex(iter->second);
+        m_transform_hierarchy.Remove(iter->second);
+        m_gameobjects.Remove(iter->second);
+        m_handles_by_id.erase(iter);
+    }
 
-        if (!main_camera_component)
+    void Level::SetParent(UUID go_id, UUID parent_id)
+    {
+        FUNCTION_TIMER();
+
+        if (m_is_ticking)
         {
+            m_command_buffer.RecordModify(
+                go_id, [this, go_id, parent_id](const std::shared_ptr<GameObject>&) { SetParent(go_id, parent_id); });
             return;
         }
 
-        for (const auto& pair : m_gameobjects)
+        GameObjectHandle handle        = GetGameObjectHandle(go_id);
+        GameObjectHandle parent_handle = GetGameObjectHandle(parent_id);
+        if (!m_gameobjects.Contains(handle) || !m_gameobjects.Contains(parent_handle))
+        {
+            MEOW_WARN("GameObject {} or its parent {} is not in level!",
+                      static_cast<uint64_t>(go_id),
+                      static_cast<uint64_t>(parent_id));
+            return;
+        }
+
+        if (!m_transform_hierarchy.SetParent(handle, parent_handle))
+        {
+            MEOW_WARN("Setting parent of GameObject {} to {} creates a cycle!",
+                      static_cast<uint64_t>(go_id),
+                      static_cast<uint64_t>(parent_id));
+        }
+    }
+
+    void Level::ClearParent(UUID go_id)
+    {
+        FUNCTION_TIMER();
+
+        if (m_is_ticking)
+        {
+            m_command_buffer.RecordModify(go_id,
+                                          [this, go_id](const std::shared_ptr<GameObject>&) { ClearParent(go_id); });
+            return;
+        }
+
+        GameObjectHandle handle = GetGameObjectHandle(go_id);
+        if (m_gameobjects.Contains(handle))
+            m_transform_hierarchy.SetParent(handle, {});
+    }
+
+    GameObjectHandle Level::GetGameObjectHandle(UUID go_id) const
+    {
+        auto iter = m_handles_by_id.find(go_id);
+        if (iter == m_handles_by_id.end())
+            return {};
+
+        return iter->second;
+    }
+
+    GameObject* Level::GetGameObject(GameObjectHandle handle) const
+    {
+        const auto* gameobject = m_gameobjects.Get(handle);
+        return gameobject ? gameobject->get() : nullptr;
+    }
+
+    GameObjectHandle Level::AddGameObject(const std::shared_ptr<GameObject>& gameobject)
+    {
+        GameObjectHandle handle = m_gameobjects.Insert(gameobject);
+
+        // composed and indexed by the next tick
+        gameobject->MarkTransformDirty();
+
+        m_handles_by_id[gameobject->GetID()] = handle;
+        return handle;
+    }
+
+    void Level::GatherDirectionalLights()
+    {
+        m_directional_lights.clear();
+
+        for (const auto& gameobject : m_gameobjects)
+        {
+            if (gameobject->HasComponent<DirectionalLightComponent>())
+                m_directional_lights.push_back(gameobject.get());
+        }
+    }
+
+    void Level::UpdateLocalTransforms(const std::vector<GameObjectHandle>& changed)
+    {
+        FUNCTION_TIMER();
+
+        for (GameObjectHandle handle : changed)
         {
-            // if (main_camera_component->FrustumCulling(pair.second))
-            // {
-            //     m_visibles[pair.first] = pair.second;
-            // }
+            const auto* gameobject = m_gameobjects.Get(handle);
+            if (!gameobject)
+                continue;
 
-            std::shared_ptr<ModelComponent> current_gameobject_model_component =
-                pair.second->TryGetComponent<ModelComponent>("ModelComponent");
+            std::shared_ptr<Transform3DComponent> transform_component =
+                (*gameobject)->TryGetComponent<Transform3DComponent>();
+            m_transform_hierarchy.SetLocalTransform(
+                handle, transform_component ? transform_component->GetTransform() : glm::mat4(1.0f));
+        }
+    }
 
-            if (!current_gameobject_model_component)
+    void Level::UpdateSpatialIndex(const std::vector<GameObjectHandle>& changed)
+    {
+        FUNCTION_TIMER();
+
+        for (GameObjectHandle handle : changed)
+        {
+            const auto* gameobject = m_gameobjects.Get(handle);
+            if (!gameobject)
+                continue;
+
+            std::shared_ptr<ModelComponent> model_component = (*gameobject)->TryGetComponent<ModelComponent>();
+            if (!model_component || !(*gameobject)->HasComponent<Transform3DComponent>())
             {
+                RemoveFromSpatialIndex(handle);
                 continue;
             }
 
-            auto material = g_runtime_context.resource_system->GetResource<Material>(
-                current_gameobject_model_component->material_id);
-            if (!material)
+            ResourceHandle<Model> model_handle = model_component->GetModel();
+            Model*                model        = g_runtime_context.resource_system->Get(model_handle);
+            if (!model)
             {
+                RemoveFromSpatialIndex(handle);
                 continue;
             }
 
-            m_visibles_per_shading_model[material->GetShadingModelType()].push_back(pair.second);
+            if (handle.index >= m_spatial_entries.size())
+                m_spatial_entries.resize(handle.index + 1);
+
+            SpatialEntry& entry = m_spatial_entries[handle.index];
+
+            // slot is reused by a new object
+            if (entry.proxy != DynamicAABBTree::k_null_node && entry.generation != handle.generation)
+            {
+                m_spatial_index.DestroyProxy(entry.proxy);
+                entry.proxy = DynamicAABBTree::k_null_node;
+            }
+
+            if (entry.proxy == DynamicAABBTree::k_null_node || entry.model != model_handle)
+                ++m_renderable_version;
+
+            entry.generation      = handle.generation;
+            entry.model_component = model_component.get();
+            entry.model           = model_handle;
+            entry.bounds          = model->GetBounding().Transform(m_transform_hierarchy.GetWorldTransform(handle));
+
+            if (entry.proxy == DynamicAABBTree::k_null_node)
+                entry.proxy = m_spatial_index.CreateProxy(entry.bounds, handle.index);
+            else
+                m_spatial_index.MoveProxy(entry.proxy, entry.bounds);
+        }
+    }
+
+    void Level::RemoveFromSpatialIndex(GameObjectHandle handle)
+    {
+        if (handle.index >= m_spatial_entries.size())
+            return;
+
+        SpatialEntry& entry = m_spatial_entries[handle.index];
+        if (entry.proxy == DynamicAABBTree::k_null_node || entry.generation != handle.generation)
+            return;
+
+        m_spatial_index.DestroyProxy(entry.proxy);
+        entry = SpatialEntry {};
+        ++m_renderable_version;
+    }
+
+    template<typename Callback>
+    void Level::QuerySpatialEntries(const Frustum& frustum, Callback&& on_visible)
+    {
+        m_cull_candidates.clear();
+        m_cull_bounds.Clear();
+
+        // the tree only tests enlarged boxes, so leaves crossing the frustum are tested again with their tight bounds
+        m_spatial_index.QueryFrustum(frustum, [&](int32_t proxy, bool fully_inside) {
+            uint32_t entry_index = m_spatial_index.GetUserData(proxy);
+            if (fully_inside)
+            {
+                on_visible(entry_index);
+                return;
+            }
+
+            m_cull_candidates.push_back(entry_index);
+            m_cull_bounds.PushBack(m_spatial_entries[entry_index].bounds);
+        });
+
+        frustum.CheckIfInside(m_cull_bounds, m_cull_visibilities);
+
+        for (size_t i = 0; i < m_cull_candidates.size(); ++i)
+        {
+            if (m_cull_visibilities[i])
+                on_visible(m_cull_candidates[i]);
+        }
+    }
+
+    void Level::CullVisibles(const Frustum&              frustum,
+                             ShadingModelType            shading_model,
+                             std::vector<VisibleObject>& visibles)
+    {
+        FUNCTION_TIMER();
+
+        QuerySpatialEntries(frustum, [&](uint32_t entry_index) {
+            SpatialEntry& entry = m_spatial_entries[entry_index];
+            if (!RefreshShadingModel(entry) || entry.shading_model != shading_model)
+                return;
+
+            Model* model = g_runtime_context.resource_system->Get(entry.model);
+            if (!model)
+                return;
+
+            GameObjectHandle handle {entry_index, entry.generation};
+            visibles.push_back({handle,
+                                model,
+                                entry.material_id,
+                                m_transform_hierarchy.GetWorldTransform(handle),
+                                m_transform_hierarchy.GetWorldTransformStamp(handle)});
+        });
+    }
+
+    void Level::GatherRenderables(ShadingModelType shading_model, std::vector<VisibleObject>& renderables)
+    {
+        FUNCTION_TIMER();
+
+        for (uint32_t entry_index = 0; entry_index < m_spatial_entries.size(); ++entry_index)
+        {
+            SpatialEntry& entry = m_spatial_entries[entry_index];
+            if (entry.proxy == DynamicAABBTree::k_null_node)
+                continue;
+
+            if (!RefreshShadingModel(entry) || entry.shading_model != shading_model)
+                continue;
+
+            Model* model = g_runtime_context.resource_system->Get(entry.model);
+            if (!model)
+                continue;
+
+            GameObjectHandle handle {entry_index, entry.generation};
+            renderables.push_back({handle,
+                                   model,
+                                   entry.material_id,
+                                   m_transform_hierarchy.GetWorldTransform(handle),
+                                   m_transform_hierarchy.GetWorldTransformStamp(handle)});
         }
     }
+
+    void Level::QueryAABB(const BoundingBox& box, std::vector<GameObjectHandle>& handles) const
+    {
+        FUNCTION_TIMER();
+
+        m_spatial_index.QueryAABB(box, [&](int32_t proxy) {
+            uint32_t            entry_index = m_spatial_index.GetUserData(proxy);
+            const SpatialEntry& entry       = m_spatial_entries[entry_index];
+
+            if (DynamicAABBTree::Overlaps(entry.bounds.min, entry.bounds.max, box.min, box.max))
+                handles.push_back({entry_index, entry.generation});
+        });
+    }
+
+    void Level::QueryRay(const glm::vec3&               origin,
+                         const glm::vec3&               direction,
+                         float                          max_distance,
+                         std::vector<GameObjectHandle>& handles) const
+    {
+        FUNCTION_TIMER();
+
+        glm::vec3 inv_direction(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+        m_spatial_index.QueryRay(origin, direction, max_distance, [&](int32_t proxy) {
+            uint32_t            entry_index = m_spatial_index.GetUserData(proxy);
+            const SpatialEntry& entry       = m_spatial_entries[entry_index];
+
+            if (DynamicAABBTree::RayIntersects(origin, inv_direction, max_distance, entry.bounds.min, entry.bounds.max))
+                handles.push_back({entry_index, entry.generation});
+        });
+    }
+
+    void Level::FrustumCulling()
+    {
+        FUNCTION_TIMER();
+
+        // keep capacity of buckets, so that no allocation happens once the scene is warmed up
+        for (auto& visibles : m_visibles_per_shading_model)
+        {
+            visibles.clear();
+        }
+
+        std::shared_ptr<GameObject> main_camera = GetGameObjectByID(m_main_camera_id).lock();
+
+        if (!main_camera)
+            return;
+
+        std::shared_ptr<Camera3DComponent> main_camera_component = main_camera->TryGetComponent<Camera3DComponent>();
+
+        if (!main_camera_component)
+        {
+            return;
+        }
+
+        QuerySpatialEntries(main_camera_component->GetFrustum(), [&](uint32_t entry_index) {
+            SpatialEntry& entry = m_spatial_entries[entry_index];
+            if (!RefreshShadingModel(entry))
+                return;
+
+            Model* model = g_runtime_context.resource_system->Get(entry.model);
+            if (!model)
+                return;
+
+            GameObjectHandle handle {entry_index, entry.generation};
+            m_visibles_per_shading_model[static_cast<size_t>(entry.shading_model)].push_back(
+                {handle,
+                 model,
+                 entry.material_id,
+                 m_transform_hierarchy.GetWorldTransform(handle),
+                 m_transform_hierarchy.GetWorldTransformStamp(handle)});
+        });
+    }
+
+    bool Level::RefreshShadingModel(SpatialEntry& entry)
+    {
+        UUID material_id = entry.model_component->material_id;
+        if (entry.has_material && entry.material_id == material_id)
+            return true;
+
+        // material is switched, e.g. by editor, or not loaded yet
+        const auto& resource_system = g_runtime_context.resource_system;
+        Material*   material        = resource_system->Get(resource_system->GetHandle<Material>(material_id));
+
+        // an unloaded material is looked up every frame, which must not invalidate renderables every frame
+        if (entry.material_id != material_id || entry.has_material != (material != nullptr))
+            ++m_renderable_version;
+
+        entry.material_id  = material_id;
+        entry.has_material = material != nullptr;
+        if (material)
+            entry.shading_model = material->GetShadingModelType();
+
+        return entry.has_material;
+    }
 } // namespace Meow
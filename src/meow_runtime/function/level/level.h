@@ -1,34 +1,213 @@
 #pragma once
 
+#include "core/math/bounding_box.h"
+#include "core/math/dynamic_aabb_tree.h"
 #include "function/components/camera/camera_3d_component.hpp"
 #include "function/object/game_object.h"
+#include "function/object/game_object_handle.h"
 #include "function/render/material/shading_model_type.h"
+#include "function/resource/resource_handle.h"
+#include "level_command_buffer.h"
+#include "transform_hierarchy.h"
 
+#include <glm/glm.hpp>
+
+#include <array>
+#include <atomic>
 #include <unordered_map>
 
 namespace Meow
 {
+    struct Model;
+    class ModelComponent;
+
+    /**
+     * @brief Everything a render pass needs to draw a visible object, gathered when culling.
+     */
+    struct VisibleObject
+    {
+        GameObjectHandle handle;
+        Model*           model; // resolved when culling, resource system defers releases past the frames in flight
+        UUID             material_id;
+        glm::mat4        transform;
+        uint64_t         transform_stamp; // see TransformHierarchy::GetWorldTransformStamp
+    };
+
     class Level
     {
     public:
         void Tick(float dt);
 
-        std::unordered_map<UUID, std::shared_ptr<GameObject>>& GetAllGameObjects() { return m_gameobjects; }
+        const SlotMap<std::shared_ptr<GameObject>>& GetAllGameObjects() const { return m_gameobjects; }
+
+        std::vector<VisibleObject>* GetVisiblesPerShadingModel(ShadingModelType shading_model);
+
+        /**
+         * @brief Append objects of a shading model inside the frustum, e.g. shadow casters inside a light frustum.
+         */
+        void CullVisibles(const Frustum& frustum, ShadingModelType shading_model, std::vector<VisibleObject>& visibles);
+
+        /**
+         * @brief Append every renderable object of a shading model without culling, e.g. to upload them for GPU
+         * culling.
+         */
+        void GatherRenderables(ShadingModelType shading_model, std::vector<VisibleObject>& renderables);
+
+        /**
+         * @brief Bumped when an object starts or stops being rendered, or changes its model or material. Moving objects
+         * doesn't bump it, so gathered renderables stay valid for static and moving objects alike.
+         */
+        uint64_t GetRenderableVersion() const { return m_renderable_version; }
+
+        /**
+         * @brief Append handles of objects whose world bounding box overlaps the box.
+         */
+        void QueryAABB(const BoundingBox& box, std::vector<GameObjectHandle>& handles) const;
+
+        /**
+         * @brief Append handles of objects whose world bounding box is hit by the ray segment.
+         */
+        void QueryRay(const glm::vec3&               origin,
+                      const glm::vec3&               direction,
+                      float                          max_distance,
+                      std::vector<GameObjectHandle>& handles) const;
+
+        /**
+         * @brief Attach a game object to a parent, so that its transform becomes relative to the parent.
+         */
+        void SetParent(UUID go_id, UUID parent_id);
+        void ClearParent(UUID go_id);
+
+        /**
+         * @brief World transform cached at the last tick, including parent transforms.
+         */
+        const glm::mat4& GetWorldTransform(GameObjectHandle handle) const
+        {
+            return m_transform_hierarchy.GetWorldTransform(handle);
+        }
+
+        uint64_t GetWorldTransformStamp(GameObjectHandle handle) const
+        {
+            return m_transform_hierarchy.GetWorldTransformStamp(handle);
+        }
+
+        const std::vector<GameObject*>& GetDirectionalLights() const { return m_directional_lights; }
+
+        std::weak_ptr<GameObject> GetGameObjectByID(UUID go_id) const;
 
-        std::vector<std::weak_ptr<GameObject>>* GetVisiblesPerShadingModel(ShadingModelType shading_model);
-        std::weak_ptr<GameObject>               GetGameObjectByID(UUID go_id) const;
+        GameObjectHandle GetGameObjectHandle(UUID go_id) const;
 
+        /**
+         * @brief O(1) lookup without hashing or reference counting. Returns nullptr if handle is stale.
+         */
+        GameObject* GetGameObject(GameObjectHandle handle) const;
+
+        /**
+         * @brief Create a game object. When called during tick, the object is added to level at the sync point after
+         * tick, but it can already be found by GetGameObjectByID.
+         */
         UUID CreateObject();
-        void DeleteGameObjectByID(UUID go_id) { m_gameobjects.erase(go_id); }
+
+        /**
+         * @brief Delete a game object. When called during tick, it is deferred to the sync point after tick.
+         */
+        void DeleteGameObjectByID(UUID go_id);
+
+        /**
+         * @brief Add a component to a game object owned by level. When called during tick, it is deferred to the sync
+         * point after tick, so that game objects ticking on other threads are not modified.
+         */
+        template<typename TComponent>
+        void QueueAddComponent(UUID                        go_id,
+                               const std::string&          component_type_name,
+                               std::shared_ptr<TComponent> component_ptr)
+        {
+            auto add_component = [component_type_name, component_ptr](const std::shared_ptr<GameObject>& gameobject) {
+                TryAddComponent(gameobject, component_type_name, component_ptr);
+            };
+
+            if (m_is_ticking)
+            {
+                m_command_buffer.RecordModify(go_id, std::move(add_component));
+                return;
+            }
+
+            if (auto gameobject = GetGameObjectByID(go_id).lock())
+                add_component(gameobject);
+        }
+
+        /**
+         * @brief Tick game objects on job system workers. Components must not modify other game objects when enabled.
+         */
+        void SetParallelTickEnabled(bool enabled) { m_parallel_tick_enabled = enabled; }
+        bool IsParallelTickEnabled() const { return m_parallel_tick_enabled; }
 
         void       SetMainCameraID(UUID go_id) { m_main_camera_id = go_id; }
         const UUID GetMainCameraID() const { return m_main_camera_id; }
 
     private:
+        GameObjectHandle AddGameObject(const std::shared_ptr<GameObject>& gameobject);
+        void TickGameObjects(float                          dt,
+                             std::vector<GameObjectHandle>& component_set_changed,
+                             std::vector<GameObjectHandle>& renderable_changed,
+                             std::vector<GameObjectHandle>& transform_changed);
+        void FlushCommandBuffer(std::vector<GameObjectHandle>& component_set_changed,
+                                std::vector<GameObjectHandle>& renderable_changed,
+                                std::vector<GameObjectHandle>& transform_changed);
         void FrustumCulling();
+        void GatherDirectionalLights();
+
+        void UpdateLocalTransforms(const std::vector<GameObjectHandle>& changed);
+
+        void UpdateSpatialIndex(const std::vector<GameObjectHandle>& changed);
+        void RemoveFromSpatialIndex(GameObjectHandle handle);
+
+        /**
+         * @brief Call on_visible(entry_index) for every spatial entry inside the frustum.
+         */
+        template<typename Callback>
+        void QuerySpatialEntries(const Frustum& frustum, Callback&& on_visible);
+
+        /**
+         * @brief Renderable object in spatial index, indexed by handle index.
+         */
+        struct SpatialEntry
+        {
+            int32_t               proxy           = DynamicAABBTree::k_null_node;
+            uint32_t              generation      = 0;
+            ModelComponent*       model_component = nullptr;
+            ResourceHandle<Model> model;
+            BoundingBox           bounds;
+
+            // shading model of the material, looked up again only when material_id of the component changes
+            UUID             material_id   = 0;
+            bool             has_material  = false;
+            ShadingModelType shading_model = ShadingModelType::Opaque;
+        };
+
+        bool RefreshShadingModel(SpatialEntry& entry);
+
+        SlotMap<std::shared_ptr<GameObject>>                               m_gameobjects;
+        std::unordered_map<UUID, GameObjectHandle>                         m_handles_by_id;
+        std::array<std::vector<VisibleObject>, k_shading_model_type_count> m_visibles_per_shading_model;
+        std::vector<GameObject*>                                           m_directional_lights;
+
+        DynamicAABBTree               m_spatial_index;
+        std::vector<SpatialEntry>     m_spatial_entries;
+        uint64_t                      m_renderable_version = 0;
+        std::vector<GameObjectHandle> m_transform_changed;
+        std::vector<GameObjectHandle> m_world_transform_changed;
+
+        TransformHierarchy m_transform_hierarchy;
+
+        // culling scratch, kept to reuse allocations
+        std::vector<uint32_t> m_cull_candidates;
+        BoundingBoxColumns    m_cull_bounds;
+        std::vector<uint8_t>  m_cull_visibilities;
 
-        std::unordered_map<UUID, std::shared_ptr<GameObject>>                        m_gameobjects;
-        std::unordered_map<ShadingModelType, std::vector<std::weak_ptr<GameObject>>> m_visibles_per_shading_model;
+        LevelCommandBuffer m_command_buffer;
+        std::atomic<bool>  m_is_ticking            = false;
+        bool               m_parallel_tick_enabled = false;
 
         UUID m_main_camera_id;
     };
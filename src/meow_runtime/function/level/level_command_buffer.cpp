@@ -0,0 +1,49 @@
+#include "level_command_buffer.h"
+
+#include "pch.h"
+
+#include "function/object/game_object.h"
+
+namespace Meow
+{
+    void LevelCommandBuffer::RecordCreate(std::shared_ptr<GameObject> gameobject)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_commands.push_back({CommandType::Create, gameobject->GetID(), std::move(gameobject), nullptr});
+    }
+
+    void LevelCommandBuffer::RecordDelete(UUID go_id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_commands.push_back({CommandType::Delete, go_id, nullptr, nullptr});
+    }
+
+    void LevelCommandBuffer::RecordModify(UUID                                                    go_id,
+                                          std::function<void(const std::shared_ptr<GameObject>&)> modify_func)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_commands.push_back({CommandType::Modify, go_id, nullptr, std::move(modify_func)});
+    }
+
+    std::shared_ptr<GameObject> LevelCommandBuffer::FindCreated(UUID go_id) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (const auto& command : m_commands)
+        {
+            if (command.type == CommandType::Create && command.go_id == go_id)
+                return command.gameobject;
+        }
+
+        return nullptr;
+    }
+
+    std::vector<LevelCommandBuffer::Command> LevelCommandBuffer::TakeCommands()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::vector<Command> commands;
+        commands.swap(m_commands);
+        return commands;
+    }
+} // namespace Meow
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "core/uuid/uuid.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Meow
+{
+    class GameObject;
+
+    /**
+     * @brief Structural changes to a level recorded while the level is ticking.
+     *
+     * Recording is thread safe. The level replays commands in recording order at the sync point after ticking.
+     */
+    class LevelCommandBuffer
+    {
+    public:
+        enum class CommandType
+        {
+            Create,
+            Delete,
+            Modify,
+        };
+
+        struct Command
+        {
+            CommandType                                             type;
+            UUID                                                    go_id;
+            std::shared_ptr<GameObject>                             gameobject;
+            std::function<void(const std::shared_ptr<GameObject>&)> modify_func;
+        };
+
+        void RecordCreate(std::shared_ptr<GameObject> gameobject);
+
+        void RecordDelete(UUID go_id);
+
+        void RecordModify(UUID go_id, std::function<void(const std::shared_ptr<GameObject>&)> modify_func);
+
+        /**
+         * @brief Find a game object which is created in this buffer but not flushed yet.
+         */
+        std::shared_ptr<GameObject> FindCreated(UUID go_id) const;
+
+        std::vector<Command> TakeCommands();
+
+    private:
+        mutable std::mutex   m_mutex;
+        std::vector<Command> m_commands;
+    };
+} // namespace Meow
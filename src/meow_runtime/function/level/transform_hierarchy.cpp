@@ -0,0 +1,209 @@
+#include "transform_hierarchy.h"
+
+#include "pch.h"
+
+#include <algorithm>
+
+namespace Meow
+{
+    namespace
+    {
+        const glm::mat4                     k_identity_transform = glm::mat4(1.0f);
+        const std::vector<GameObjectHandle> k_no_children;
+    } // namespace
+
+    bool TransformHierarchy::SetParent(GameObjectHandle child, GameObjectHandle parent)
+    {
+        if (child == parent)
+            return false;
+
+        // walk up from new parent, child must not be one of its ancestors
+        for (GameObjectHandle ancestor = parent; IsAlive(ancestor); ancestor = m_nodes[ancestor.index].parent)
+        {
+            if (ancestor == child)
+                return false;
+        }
+
+        GetOrCreateNode(child);
+        DetachFromParent(child);
+
+        if (parent.IsValid())
+        {
+            GetOrCreateNode(parent).children.push_back(child);
+            m_nodes[child.index].parent = parent;
+        }
+
+        MarkDirty(child);
+        return true;
+    }
+
+    GameObjectHandle TransformHierarchy::GetParent(GameObjectHandle handle) const
+    {
+        if (!IsAlive(handle))
+            return {};
+
+        return m_nodes[handle.index].parent;
+    }
+
+    const std::vector<GameObjectHandle>& TransformHierarchy::GetChildren(GameObjectHandle handle) const
+    {
+        if (!IsAlive(handle))
+            return k_no_children;
+
+        return m_nodes[handle.index].children;
+    }
+
+    void TransformHierarchy::Remove(GameObjectHandle handle)
+    {
+        if (!IsAlive(handle))
+            return;
+
+        DetachFromParent(handle);
+
+        Node& node = m_nodes[handle.index];
+        for (GameObjectHandle child : node.children)
+        {
+            m_nodes[child.index].parent = {};
+            MarkDirty(child);
+        }
+
+        node = Node {};
+    }
+
+    void TransformHierarchy::SetLocalTransform(GameObjectHandle handle, const glm::mat4& local_transform)
+    {
+        GetOrCreateNode(handle);
+
+        m_local_transforms[handle.index] = local_transform;
+        MarkDirty(handle);
+    }
+
+    void TransformHierarchy::Update(std::vector<GameObjectHandle>& world_changed)
+    {
+        FUNCTION_TIMER();
+
+        if (m_dirty.empty())
+            return;
+
+        ++m_update_count;
+
+        for (GameObjectHandle handle : m_dirty)
+        {
+            // already updated as a descendant of another dirty object
+            if (!IsAlive(handle) || !m_nodes[handle.index].dirty)
+                continue;
+
+            // start from the topmost dirty ancestor, so that parents are always updated before children
+            GameObjectHandle root = handle;
+            for (GameObjectHandle ancestor = m_nodes[handle.index].parent; IsAlive(ancestor);
+                 ancestor                  = m_nodes[ancestor.index].parent)
+            {
+                if (m_nodes[ancestor.index].dirty)
+                    root = ancestor;
+            }
+
+            UpdateSubtree(root, world_changed);
+        }
+
+        m_dirty.clear();
+    }
+
+    const glm::mat4& TransformHierarchy::GetWorldTransform(GameObjectHandle handle) const
+    {
+        if (!IsAlive(handle))
+            return k_identity_transform;
+
+        return m_world_transforms[handle.index];
+    }
+
+    uint64_t TransformHierarchy::GetWorldTransformStamp(GameObjectHandle handle) const
+    {
+        if (!IsAlive(handle))
+            return 0;
+
+        return m_nodes[handle.index].world_stamp;
+    }
+
+    bool TransformHierarchy::IsAlive(GameObjectHandle handle) const
+    {
+        return handle.index < m_nodes.size() && m_nodes[handle.index].alive &&
+               m_nodes[handle.index].generation == handle.generation;
+    }
+
+    TransformHierarchy::Node& TransformHierarchy::GetOrCreateNode(GameObjectHandle handle)
+    {
+        if (handle.index >= m_nodes.size())
+        {
+            m_nodes.resize(handle.index + 1);
+            m_local_transforms.resize(handle.index + 1, k_identity_transform);
+            m_world_transforms.resize(handle.index + 1, k_identity_transform);
+        }
+
+        Node& node = m_nodes[handle.index];
+        if (!IsAlive(handle))
+        {
+            node                             = Node {};
+            node.generation                  = handle.generation;
+            node.alive                       = true;
+            m_local_transforms[handle.index] = k_identity_transform;
+        }
+
+        return node;
+    }
+
+    void TransformHierarchy::MarkDirty(GameObjectHandle handle)
+    {
+        Node& node = m_nodes[handle.index];
+        if (node.dirty)
+            return;
+
+        node.dirty = true;
+        m_dirty.push_back(handle);
+    }
+
+    void TransformHierarchy::DetachFromParent(GameObjectHandle handle)
+    {
+        Node& node = m_nodes[handle.index];
+        if (!IsAlive(node.parent))
+        {
+            node.parent = {};
+            return;
+        }
+
+        auto& siblings = m_nodes[node.parent.index].children;
+        auto  iter     = std::find(siblings.begin(), siblings.end(), handle);
+        if (iter != siblings.end())
+        {
+            *iter = siblings.back();
+            siblings.pop_back();
+        }
+
+        node.parent = {};
+    }
+
+    void TransformHierarchy::UpdateSubtree(GameObjectHandle root, std::vector<GameObjectHandle>& world_changed)
+    {
+        m_update_stack.clear();
+        m_update_stack.push_back(root);
+
+        while (!m_update_stack.empty())
+        {
+            GameObjectHandle handle = m_update_stack.back();
+            m_update_stack.pop_back();
+
+            Node& node = m_nodes[handle.index];
+
+            if (IsAlive(node.parent))
+                m_world_transforms[handle.index] =
+                    m_world_transforms[node.parent.index] * m_local_transforms[handle.index];
+            else
+                m_world_transforms[handle.index] = m_local_transforms[handle.index];
+
+            node.dirty       = false;
+            node.world_stamp = m_update_count;
+            world_changed.push_back(handle);
+
+            m_update_stack.insert(m_update_stack.end(), node.children.begin(), node.children.end());
+        }
+    }
+} // namespace Meow
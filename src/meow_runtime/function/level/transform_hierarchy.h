@@ -0,0 +1,81 @@
+#pragma once
+
+#include "function/object/game_object_handle.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Parent-child relations and cached world transforms of game objects in a level.
+     *
+     * World transforms are stored contiguously, indexed by handle index. Only objects whose local transform or parent
+     * changed are recomputed, together with their descendants, parents before children.
+     */
+    class TransformHierarchy
+    {
+    public:
+        /**
+         * @brief Attach child to parent. Invalid parent detaches child. Returns false if it would create a cycle.
+         */
+        bool SetParent(GameObjectHandle child, GameObjectHandle parent);
+
+        GameObjectHandle GetParent(GameObjectHandle handle) const;
+
+        const std::vector<GameObjectHandle>& GetChildren(GameObjectHandle handle) const;
+
+        /**
+         * @brief Detach an object from its parent. Its children become roots.
+         */
+        void Remove(GameObjectHandle handle);
+
+        void SetLocalTransform(GameObjectHandle handle, const glm::mat4& local_transform);
+
+        /**
+         * @brief Recompute world transforms of dirty objects and their descendants. Appends handles of objects whose
+         * world transform is recomputed.
+         */
+        void Update(std::vector<GameObjectHandle>& world_changed);
+
+        const glm::mat4& GetWorldTransform(GameObjectHandle handle) const;
+
+        /**
+         * @brief Changes whenever the world transform is recomputed, so that caches of it can tell if they are stale.
+         * Objects never updated have stamp 0.
+         */
+        uint64_t GetWorldTransformStamp(GameObjectHandle handle) const;
+
+        const std::vector<glm::mat4>& GetWorldTransforms() const { return m_world_transforms; }
+
+    private:
+        struct Node
+        {
+            uint32_t                      generation  = 0;
+            bool                          alive       = false;
+            bool                          dirty       = false;
+            uint64_t                      world_stamp = 0;
+            GameObjectHandle              parent;
+            std::vector<GameObjectHandle> children;
+        };
+
+        bool  IsAlive(GameObjectHandle handle) const;
+        Node& GetOrCreateNode(GameObjectHandle handle);
+        void  MarkDirty(GameObjectHandle handle);
+        void  DetachFromParent(GameObjectHandle handle);
+        void  UpdateSubtree(GameObjectHandle root, std::vector<GameObjectHandle>& world_changed);
+
+        // indexed by handle index
+        std::vector<Node>      m_nodes;
+        std::vector<glm::mat4> m_local_transforms;
+        std::vector<glm::mat4> m_world_transforms;
+
+        std::vector<GameObjectHandle> m_dirty;
+        std::vector<GameObjectHandle> m_update_stack;
+
+        // shared by all hierarchies, so that stamps of objects in different levels never collide
+        inline static uint64_t m_update_count = 0;
+    };
+} // namespace Meow
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace Meow
+{
+    using ComponentTypeID = uint32_t;
+    using ComponentMask   = uint64_t;
+
+    constexpr uint32_t        k_max_component_types       = 64;
+    constexpr ComponentTypeID k_invalid_component_type_id = static_cast<ComponentTypeID>(-1);
+
+    /**
+     * @brief Compile-time id and name of a component type.
+     *
+     * Specializations are generated by CodeGenerator into generated/component_type_id.gen.h for every reflectable
+     * class deriving from Component.
+     */
+    template<typename TComponent>
+    struct ComponentTypeTraits;
+
+    template<typename TComponent>
+    concept HasComponentTypeID = requires { ComponentTypeTraits<TComponent>::id; };
+
+    template<typename TComponent>
+    constexpr ComponentMask ComponentBit()
+    {
+        return ComponentMask(1) << ComponentTypeTraits<TComponent>::id;
+    }
+} // namespace Meow
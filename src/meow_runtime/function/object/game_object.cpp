@@ -2,6 +2,17 @@
 
 namespace Meow
 {
+    ComponentTypeID GetComponentTypeID(std::string_view component_type_name)
+    {
+        for (ComponentTypeID i = 0; i < k_component_type_count; ++i)
+        {
+            if (component_type_name == k_component_type_names[i])
+                return i;
+        }
+
+        return k_invalid_component_type_id;
+    }
+
     void GameObject::Tick(float dt)
     {
         for (auto& refl_component : m_refl_components)
@@ -12,6 +23,10 @@ namespace Meow
 
     bool GameObject::HasComponent(const std::string& compenent_type_name) const
     {
+        ComponentTypeID type_id = GetComponentTypeID(compenent_type_name);
+        if (type_id != k_invalid_component_type_id)
+            return (m_component_mask & (ComponentMask(1) << type_id)) != 0;
+
         for (const auto& refl_component : m_refl_components)
         {
             if (refl_component.type_name == compenent_type_name)
@@ -5,7 +5,9 @@
 #include "core/reflect/macros.h"
 #include "core/reflect/reflect_pointer.hpp"
 #include "core/uuid/uuid.h"
+#include "generated/component_type_id.gen.h"
 
+#include <bit>
 
 namespace Meow
 {
@@ -26,6 +28,13 @@ namespace Meow
         }
     };
 
+    /**
+     * @brief Look up the generated type id of a component by its type name.
+     *
+     * @return k_invalid_component_type_id if the component type has no generated id.
+     */
+    ComponentTypeID GetComponentTypeID(std::string_view component_type_name);
+
     class GameObject
     {
     public:
@@ -44,22 +53,79 @@ namespace Meow
 
         bool HasComponent(const std::string& compenent_type_name) const;
 
+        template<typename TComponent>
+        bool HasComponent() const
+        {
+            return (m_component_mask & ComponentBit<TComponent>()) != 0;
+        }
+
+        ComponentMask GetComponentMask() const { return m_component_mask; }
+
         std::vector<reflect::refl_shared_ptr<Component>> GetComponents() { return m_refl_components; }
 
+        /**
+         * @brief Whether components have been added since the level last read its components.
+         */
+        bool IsComponentSetDirty() const { return m_component_set_dirty; }
+        void ClearComponentSetDirty() { m_component_set_dirty = false; }
+
+        /**
+         * @brief Whether what the object renders, e.g. its model, has changed since the level last indexed it.
+         */
+        bool IsRenderableDirty() const { return m_renderable_dirty; }
+        void MarkRenderableDirty() { m_renderable_dirty = true; }
+        void ClearRenderableDirty() { m_renderable_dirty = false; }
+
+        /**
+         * @brief Whether the transform has been set since the level last composed it, see Transform3DComponent.
+         */
+        bool IsTransformDirty() const { return m_transform_dirty; }
+        void MarkTransformDirty() { m_transform_dirty = true; }
+        void ClearTransformDirty() { m_transform_dirty = false; }
+
+        /**
+         * @brief Get component by its generated type id, which is a bitmask test plus an indexed fetch.
+         *
+         * Components with generated ids are kept sorted by id, so the index of a component is the count of set bits
+         * below its own bit in the mask.
+         */
         template<typename TComponent>
-        std::shared_ptr<TComponent> TryGetComponent(const std::string& component_type_name)
+        std::shared_ptr<TComponent> TryGetComponent()
         {
-            FUNCTION_TIMER();
+            static_assert(HasComponentTypeID<TComponent>, "Component type has no generated type id!");
 
-            for (auto& refl_component : m_refl_components)
+            constexpr ComponentMask component_bit = ComponentBit<TComponent>();
+            if ((m_component_mask & component_bit) == 0)
             {
-                if (refl_component.type_name == component_type_name)
+                return std::shared_ptr<TComponent>(nullptr);
+            }
+
+            return std::static_pointer_cast<TComponent>(
+                m_typed_components[std::popcount(m_component_mask & (component_bit - 1))]);
+        }
+
+        template<typename TComponent>
+        std::shared_ptr<TComponent> TryGetComponent(const std::string& component_type_name)
+        {
+            if constexpr (HasComponentTypeID<TComponent>)
+            {
+                ASSERT(component_type_name == ComponentTypeTraits<TComponent>::name);
+                return TryGetComponent<TComponent>();
+            }
+            else
+            {
+                FUNCTION_TIMER();
+
+                for (auto& refl_component : m_refl_components)
                 {
-                    return std::dynamic_pointer_cast<TComponent>(refl_component.shared_ptr);
+                    if (refl_component.type_name == component_type_name)
+                    {
+                        return std::dynamic_pointer_cast<TComponent>(refl_component.shared_ptr);
+                    }
                 }
-            }
 
-            return std::shared_ptr<TComponent>(nullptr);
+                return std::shared_ptr<TComponent>(nullptr);
+            }
         }
 
         template<typename TComponent>
@@ -71,6 +137,11 @@ namespace Meow
         UUID                                             m_id;
         std::string                                      m_name = "Default Object";
         std::vector<reflect::refl_shared_ptr<Component>> m_refl_components;
+        std::vector<std::shared_ptr<Component>>          m_typed_components;
+        ComponentMask                                    m_component_mask      = 0;
+        bool                                             m_component_set_dirty = false;
+        bool                                             m_renderable_dirty    = false;
+        bool                                             m_transform_dirty     = false;
     };
 
     template<typename TComponent>
@@ -89,17 +160,39 @@ namespace Meow
 #endif
 
         // Check if a component of the same type already exists
-        for (const auto& refl_component : gameobject->m_refl_components)
+        if constexpr (HasComponentTypeID<TComponent>)
         {
-            if (refl_component.type_name == component_type_name)
+            if (gameobject->HasComponent<TComponent>())
             {
                 MEOW_ERROR("Component already exists: {}", component_type_name);
                 return std::shared_ptr<TComponent>(nullptr);
             }
         }
+        else
+        {
+            for (const auto& refl_component : gameobject->m_refl_components)
+            {
+                if (refl_component.type_name == component_type_name)
+                {
+                    MEOW_ERROR("Component already exists: {}", component_type_name);
+                    return std::shared_ptr<TComponent>(nullptr);
+                }
+            }
+        }
 
         // Add the component to the container
         gameobject->m_refl_components.emplace_back(component_type_name, component_ptr);
+        gameobject->m_component_set_dirty = true;
+
+        // Keep typed components sorted by type id
+        if constexpr (HasComponentTypeID<TComponent>)
+        {
+            constexpr ComponentMask component_bit = ComponentBit<TComponent>();
+
+            auto index = std::popcount(gameobject->m_component_mask & (component_bit - 1));
+            gameobject->m_typed_components.insert(gameobject->m_typed_components.begin() + index, component_ptr);
+            gameobject->m_component_mask |= component_bit;
+        }
 
 #ifdef MEOW_DEBUG
         if (gameobject->m_refl_components.size() < 1)
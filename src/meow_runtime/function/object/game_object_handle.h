@@ -0,0 +1,12 @@
+#pragma once
+
+#include "core/base/slot_map.hpp"
+
+namespace Meow
+{
+    /**
+     * @brief Handle of a game object in its level. UUID stays the persistent identity, handles are only valid while
+     * the level is alive and are cheaper to resolve.
+     */
+    using GameObjectHandle = SlotHandle;
+} // namespace Meow
@@ -60,16 +60,11 @@ namespace Meow
 
     void GPUParticle2D::UploadParticleData(const std::vector<GPUParticleData2D>& particle_data)
     {
-        const vk::raii::PhysicalDevice& physical_device = g_runtime_context.render_system->GetPhysicalDevice();
-        const vk::raii::Device&         logical_device  = g_runtime_context.render_system->GetLogicalDevice();
-        const vk::raii::CommandPool&    onetime_submit_command_pool =
-            g_runtime_context.render_system->GetOneTimeSubmitCommandPool();
-        const vk::raii::Queue& graphics_queue = g_runtime_context.render_system->GetGraphicsQueue();
+        UploadManager& upload_manager = g_runtime_context.render_system->GetUploadManager();
 
         for (auto& particle_storage_buffer : m_particle_storage_buffer_per_frame)
         {
-            particle_storage_buffer.Upload(
-                physical_device, logical_device, onetime_submit_command_pool, graphics_queue, particle_data, 0);
+            particle_storage_buffer.Upload(upload_manager, particle_data, 0);
         }
     }
 
@@ -0,0 +1,208 @@
+#include "bindless_descriptor_table.h"
+
+#include "pch.h"
+
+#include "function/render/buffer_data/image_data.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Meow
+{
+    namespace
+    {
+        // left to descriptors of the other sets, which count against the same per-stage limits
+        constexpr uint32_t k_reserved_descriptor_count = 64;
+
+        uint32_t ClampToLimit(uint32_t count, uint32_t limit)
+        {
+            return std::min(count, limit > k_reserved_descriptor_count ? limit - k_reserved_descriptor_count : 1u);
+        }
+    } // namespace
+
+    BindlessDescriptorTable::BindlessDescriptorTable(const vk::raii::PhysicalDevice& physical_device,
+                                                     const vk::raii::Device&         logical_device)
+        : m_logical_device(&logical_device)
+    {
+        FUNCTION_TIMER();
+
+        auto properties = physical_device.getProperties2<vk::PhysicalDeviceProperties2,
+                                                         vk::PhysicalDeviceDescriptorIndexingProperties>();
+        const auto& limits = properties.get<vk::PhysicalDeviceDescriptorIndexingProperties>();
+
+        // combined image samplers count both as samplers and as sampled images
+        uint32_t max_sampled_images =
+            std::min({limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                      limits.maxPerStageDescriptorUpdateAfterBindSamplers,
+                      limits.maxDescriptorSetUpdateAfterBindSampledImages,
+                      limits.maxDescriptorSetUpdateAfterBindSamplers});
+        uint32_t max_storage_buffers = std::min(limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                                                limits.maxDescriptorSetUpdateAfterBindStorageBuffers);
+
+        m_image_indices.capacity  = ClampToLimit(k_max_sampled_images, max_sampled_images);
+        m_buffer_indices.capacity = ClampToLimit(k_max_storage_buffers, max_storage_buffers);
+
+        std::array<vk::DescriptorPoolSize, 2> pool_sizes = {
+            vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, m_image_indices.capacity),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, m_buffer_indices.capacity)};
+
+        vk::DescriptorPoolCreateInfo descriptor_pool_create_info(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet |
+                                                                     vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+                                                                 1,
+                                                                 pool_sizes);
+        m_descriptor_pool = vk::raii::DescriptorPool(logical_device, descriptor_pool_create_info);
+
+        std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {
+            vk::DescriptorSetLayoutBinding(k_sampled_images_binding,
+                                           vk::DescriptorType::eCombinedImageSampler,
+                                           m_image_indices.capacity,
+                                           vk::ShaderStageFlagBits::eAll),
+            vk::DescriptorSetLayoutBinding(k_storage_buffers_binding,
+                                           vk::DescriptorType::eStorageBuffer,
+                                           m_buffer_indices.capacity,
+                                           vk::ShaderStageFlagBits::eAll)};
+
+        // elements never written are fine as long as shaders don't read them
+        vk::DescriptorBindingFlags binding_flags = vk::DescriptorBindingFlagBits::ePartiallyBound |
+                                                   vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                                   vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+        std::array<vk::DescriptorBindingFlags, 2>     binding_flags_array = {binding_flags, binding_flags};
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo binding_flags_create_info(binding_flags_array);
+
+        vk::DescriptorSetLayoutCreateInfo descriptor_set_layout_create_info(
+            vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool, bindings, &binding_flags_create_info);
+        m_descriptor_set_layout = vk::raii::DescriptorSetLayout(logical_device, descriptor_set_layout_create_info);
+
+        vk::DescriptorSetAllocateInfo descriptor_set_allocate_info(*m_descriptor_pool, *m_descriptor_set_layout);
+        m_descriptor_set = std::move(vk::raii::DescriptorSets(logical_device, descriptor_set_allocate_info).front());
+
+        MEOW_INFO("Bindless descriptor table holds {} images and {} storage buffers.",
+                  m_image_indices.capacity,
+                  m_buffer_indices.capacity);
+    }
+
+    vk::PhysicalDeviceDescriptorIndexingFeatures BindlessDescriptorTable::GetRequiredFeatures()
+    {
+        vk::PhysicalDeviceDescriptorIndexingFeatures features;
+        features.shaderSampledImageArrayNonUniformIndexing     = vk::True;
+        features.shaderStorageBufferArrayNonUniformIndexing    = vk::True;
+        features.descriptorBindingSampledImageUpdateAfterBind  = vk::True;
+        features.descriptorBindingStorageBufferUpdateAfterBind = vk::True;
+        features.descriptorBindingUpdateUnusedWhilePending     = vk::True;
+        features.descriptorBindingPartiallyBound               = vk::True;
+        features.runtimeDescriptorArray                        = vk::True;
+        return features;
+    }
+
+    bool BindlessDescriptorTable::IsSupported(const vk::PhysicalDeviceDescriptorIndexingFeatures& features)
+    {
+        return features.shaderSampledImageArrayNonUniformIndexing &&
+               features.shaderStorageBufferArrayNonUniformIndexing &&
+               features.descriptorBindingSampledImageUpdateAfterBind &&
+               features.descriptorBindingStorageBufferUpdateAfterBind &&
+               features.descriptorBindingUpdateUnusedWhilePending && features.descriptorBindingPartiallyBound &&
+               features.runtimeDescriptorArray;
+    }
+
+    uint32_t BindlessDescriptorTable::AddImage(const ImageData& image_data)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        VkImageView image_view = static_cast<VkImageView>(*image_data.image_view);
+
+        auto it = m_image_view_indices.find(image_view);
+        if (it != m_image_view_indices.end())
+            return it->second;
+
+        uint32_t index = m_image_indices.Acquire();
+        if (index == k_invalid_index)
+        {
+            MEOW_ERROR("Bindless descriptor table is out of images!");
+            return k_invalid_index;
+        }
+
+        vk::DescriptorImageInfo descriptor_image_info(
+            *image_data.sampler, *image_data.image_view, vk::ImageLayout::eShaderReadOnlyOptimal);
+
+        vk::WriteDescriptorSet write_descriptor_set(*m_descriptor_set,
+                                                    k_sampled_images_binding,
+                                                    index,
+                                                    1,
+                                                    vk::DescriptorType::eCombinedImageSampler,
+                                                    &descriptor_image_info);
+        m_logical_device->updateDescriptorSets(write_descriptor_set, nullptr);
+
+        m_image_view_indices.emplace(image_view, index);
+        return index;
+    }
+
+    uint32_t BindlessDescriptorTable::AddBuffer(vk::Buffer buffer, vk::DeviceSize range)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        uint32_t index = m_buffer_indices.Acquire();
+        if (index == k_invalid_index)
+        {
+            MEOW_ERROR("Bindless descriptor table is out of storage buffers!");
+            return k_invalid_index;
+        }
+
+        vk::DescriptorBufferInfo descriptor_buffer_info(buffer, 0, range);
+
+        vk::WriteDescriptorSet write_descriptor_set(*m_descriptor_set,
+                                                    k_storage_buffers_binding,
+                                                    index,
+                                                    1,
+                                                    vk::DescriptorType::eStorageBuffer,
+                                                    nullptr,
+                                                    &descriptor_buffer_info);
+        m_logical_device->updateDescriptorSets(write_descriptor_set, nullptr);
+
+        return index;
+    }
+
+    void BindlessDescriptorTable::RemoveImage(uint32_t index)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = std::find_if(m_image_view_indices.begin(), m_image_view_indices.end(), [index](const auto& pair) {
+            return pair.second == index;
+        });
+        if (it == m_image_view_indices.end())
+        {
+            MEOW_WARN("Bindless image {} is not in use.", index);
+            return;
+        }
+
+        m_image_view_indices.erase(it);
+        m_image_indices.Release(index);
+    }
+
+    void BindlessDescriptorTable::RemoveBuffer(uint32_t index)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_buffer_indices.Release(index);
+    }
+
+    uint32_t BindlessDescriptorTable::IndexList::Acquire()
+    {
+        if (!free_indices.empty())
+        {
+            uint32_t index = free_indices.back();
+            free_indices.pop_back();
+            return index;
+        }
+
+        if (next == capacity)
+            return k_invalid_index;
+
+        return next++;
+    }
+
+    void BindlessDescriptorTable::IndexList::Release(uint32_t index)
+    {
+        if (index < next)
+            free_indices.push_back(index);
+    }
+} // namespace Meow
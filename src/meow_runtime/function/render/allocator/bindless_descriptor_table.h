@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Meow
+{
+    struct ImageData;
+
+    /**
+     * @brief One descriptor set holding large arrays of sampled images and storage buffers, which shaders index at
+     * runtime, so that a pass binds it once instead of binding textures per material.
+     *
+     * Shaders declare the arrays as k_sampled_images_binding_name and k_storage_buffers_binding_name in a set of their
+     * own, whose layout ShaderFactory replaces by the layout of the table. Materials reference their textures by the
+     * indices returned here, written into the k_texture_indices_binding_name uniform block.
+     *
+     * Bindings are partially bound and update after bind, so entries may be added from any thread while frames using
+     * other entries are in flight.
+     */
+    class BindlessDescriptorTable
+    {
+    public:
+        static constexpr uint32_t k_invalid_index           = 0xffffffff;
+        static constexpr uint32_t k_sampled_images_binding  = 0;
+        static constexpr uint32_t k_storage_buffers_binding = 1;
+
+        static constexpr const char* k_sampled_images_binding_name  = "bindlessTextures";
+        static constexpr const char* k_storage_buffers_binding_name = "bindlessBuffers";
+        static constexpr const char* k_texture_indices_binding_name = "textureIndices";
+
+        static constexpr uint32_t k_max_sampled_images  = 16384;
+        static constexpr uint32_t k_max_storage_buffers = 4096;
+
+        BindlessDescriptorTable(const vk::raii::PhysicalDevice& physical_device,
+                                const vk::raii::Device&         logical_device);
+
+        BindlessDescriptorTable(const BindlessDescriptorTable&)            = delete;
+        BindlessDescriptorTable& operator=(const BindlessDescriptorTable&) = delete;
+
+        /**
+         * @brief Descriptor indexing features the table needs, to be enabled on the device.
+         */
+        static vk::PhysicalDeviceDescriptorIndexingFeatures GetRequiredFeatures();
+
+        static bool IsSupported(const vk::PhysicalDeviceDescriptorIndexingFeatures& features);
+
+        /**
+         * @brief Write the image, read in eShaderReadOnlyOptimal, into a free element and return its index. An image
+         * already added returns the same index.
+         */
+        uint32_t AddImage(const ImageData& image_data);
+
+        uint32_t AddBuffer(vk::Buffer buffer, vk::DeviceSize range = VK_WHOLE_SIZE);
+
+        /**
+         * @brief Give the index back for reuse. Frames still in flight must not read it anymore.
+         */
+        void RemoveImage(uint32_t index);
+
+        void RemoveBuffer(uint32_t index);
+
+        vk::DescriptorSetLayout GetDescriptorSetLayout() const { return *m_descriptor_set_layout; }
+        vk::DescriptorSet       GetDescriptorSet() const { return *m_descriptor_set; }
+
+        uint32_t GetImageCapacity() const { return m_image_indices.capacity; }
+        uint32_t GetBufferCapacity() const { return m_buffer_indices.capacity; }
+
+    private:
+        struct IndexList
+        {
+            uint32_t              capacity = 0;
+            uint32_t              next     = 0;
+            std::vector<uint32_t> free_indices;
+
+            uint32_t Acquire();
+            void     Release(uint32_t index);
+        };
+
+        const vk::raii::Device* m_logical_device = nullptr;
+
+        vk::raii::DescriptorPool      m_descriptor_pool       = nullptr;
+        vk::raii::DescriptorSetLayout m_descriptor_set_layout = nullptr;
+        vk::raii::DescriptorSet       m_descriptor_set        = nullptr;
+
+        std::mutex m_mutex;
+
+        IndexList                                 m_image_indices;
+        IndexList                                 m_buffer_indices;
+        std::unordered_map<VkImageView, uint32_t> m_image_view_indices;
+    };
+} // namespace Meow
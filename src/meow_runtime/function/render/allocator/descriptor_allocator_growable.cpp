@@ -1,58 +1,117 @@
 #include "descriptor_allocator_growable.h"
 
+#include "core/base/hash.h"
 #include "function/global/runtime_context.h"
 
 namespace Meow
 {
+    namespace
+    {
+        template<typename T>
+        uint64_t HashValue(const T& value, uint64_t seed)
+        {
+            return HashBytes(&value, sizeof(T), seed);
+        }
+
+        bool IsImageDescriptor(vk::DescriptorType type)
+        {
+            return type == vk::DescriptorType::eSampler || type == vk::DescriptorType::eCombinedImageSampler ||
+                   type == vk::DescriptorType::eSampledImage || type == vk::DescriptorType::eStorageImage ||
+                   type == vk::DescriptorType::eInputAttachment;
+        }
+
+        // fields are hashed one by one, since the vulkan structs have padding
+        uint64_t HashBindings(vk::DescriptorSetLayout               descriptor_set_layout,
+                              const std::vector<DescriptorBinding>& bindings)
+        {
+            uint64_t hash = HashValue(static_cast<VkDescriptorSetLayout>(descriptor_set_layout), k_fnv_offset_basis);
+            for (const DescriptorBinding& binding : bindings)
+            {
+                hash = HashValue(binding.binding, hash);
+                hash = HashValue(binding.type, hash);
+
+                if (IsImageDescriptor(binding.type))
+                {
+                    hash = HashValue(static_cast<VkSampler>(binding.image_info.sampler), hash);
+                    hash = HashValue(static_cast<VkImageView>(binding.image_info.imageView), hash);
+                    hash = HashValue(binding.image_info.imageLayout, hash);
+                }
+                else
+                {
+                    hash = HashValue(static_cast<VkBuffer>(binding.buffer_info.buffer), hash);
+                    hash = HashValue(binding.buffer_info.offset, hash);
+                    hash = HashValue(binding.buffer_info.range, hash);
+                }
+            }
+            return hash;
+        }
+    } // namespace
+
     DescriptorAllocatorGrowable::DescriptorAllocatorGrowable(const vk::raii::Device&             logical_device,
                                                              uint32_t                            initialSets,
-                                                             std::vector<vk::DescriptorPoolSize> pool_sizes)
+                                                             std::vector<vk::DescriptorPoolSize> pool_sizes,
+                                                             uint32_t                            frame_count,
+                                                             uint32_t                            thread_count)
     {
         this->pool_sizes = pool_sizes;
 
-        setsPerPool = initialSets * 1.5; // grow it next allocation
+        persistentPools.flags       = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet;
+        persistentPools.setsPerPool = initialSets * 1.5; // grow it next allocation
 
-        vk::DescriptorPoolCreateInfo descriptor_pool_create_info(
-            vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet, initialSets, pool_sizes);
-        readyPools.push_back(std::make_shared<vk::raii::DescriptorPool>(logical_device, descriptor_pool_create_info));
+        vk::DescriptorPoolCreateInfo descriptor_pool_create_info(persistentPools.flags, initialSets, pool_sizes);
+        persistentPools.readyPools.push_back(
+            std::make_shared<vk::raii::DescriptorPool>(logical_device, descriptor_pool_create_info));
+
+        // transient sets are never freed one by one, and their pools are created on first use
+        frames.resize(frame_count);
+        for (auto& threads : frames)
+        {
+            threads.resize(thread_count);
+            for (auto& thread : threads)
+            {
+                thread.pools.setsPerPool = initialSets;
+            }
+        }
     }
 
-    void DescriptorAllocatorGrowable::ClearPools()
+    void DescriptorAllocatorGrowable::ClearPools() { ClearPools(persistentPools); }
+
+    void DescriptorAllocatorGrowable::ClearPools(PoolChain& pool_chain)
     {
-        for (auto p : readyPools)
+        for (auto p : pool_chain.readyPools)
         {
             (*p).reset(vk::DescriptorPoolResetFlags());
         }
-        for (auto p : fullPools)
+        for (auto p : pool_chain.fullPools)
         {
             (*p).reset(vk::DescriptorPoolResetFlags());
-            readyPools.push_back(p);
+            pool_chain.readyPools.push_back(p);
         }
-        fullPools.clear();
+        pool_chain.fullPools.clear();
     }
 
-    std::shared_ptr<vk::raii::DescriptorPool> DescriptorAllocatorGrowable::PopPool()
+    std::shared_ptr<vk::raii::DescriptorPool> DescriptorAllocatorGrowable::PopPool(PoolChain& pool_chain)
     {
         const vk::raii::Device& logical_device = g_runtime_context.render_system->GetLogicalDevice();
 
         vk::DescriptorPoolCreateInfo descriptor_pool_create_info(
-            vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet, setsPerPool, pool_sizes);
+            pool_chain.flags, pool_chain.setsPerPool, pool_sizes);
 
         std::shared_ptr<vk::raii::DescriptorPool> newPool;
-        if (readyPools.size() != 0)
+        if (pool_chain.readyPools.size() != 0)
         {
-            newPool = readyPools.back();
-            readyPools.pop_back();
+            newPool = pool_chain.readyPools.back();
+            pool_chain.readyPools.pop_back();
         }
         else
         {
             // need to create a new pool
             newPool = std::make_shared<vk::raii::DescriptorPool>(logical_device, descriptor_pool_create_info);
 
-            setsPerPool = setsPerPool * 1.5;
-            if (setsPerPool > 4092)
+            pool_chain.setsPerPool = pool_chain.setsPerPool * 1.5;
+            if (pool_chain.setsPerPool > 4092)
             {
-                setsPerPool = 4092;
+                pool_chain.setsPerPool = 4092;
             }
         }
 
@@ -67,34 +126,107 @@ namespace Meow
             return nullptr;
         }
 
+        vk::DescriptorSetAllocateInfo descriptor_set_allocate_info(
+            nullptr, descriptor_set_layouts.size(), descriptor_set_layouts.data(), pNext);
+
+        return AllocateFrom(persistentPools, descriptor_set_allocate_info);
+    }
+
+    vk::raii::DescriptorSets DescriptorAllocatorGrowable::AllocateFrom(PoolChain&                    pool_chain,
+                                                                       vk::DescriptorSetAllocateInfo allocate_info)
+    {
         const vk::raii::Device& logical_device = g_runtime_context.render_system->GetLogicalDevice();
 
         // get or create a pool to allocate from
-        std::shared_ptr<vk::raii::DescriptorPool> poolToUse = PopPool();
+        std::shared_ptr<vk::raii::DescriptorPool> poolToUse = PopPool(pool_chain);
 
-        vk::DescriptorSetAllocateInfo descriptor_set_allocate_info(
-            **poolToUse, descriptor_set_layouts.size(), descriptor_set_layouts.data(), pNext);
+        allocate_info.descriptorPool = **poolToUse;
 
         vk::raii::DescriptorSets descriptor_sets = nullptr;
 
         try
         {
-            descriptor_sets = vk::raii::DescriptorSets(logical_device, descriptor_set_allocate_info);
+            descriptor_sets = vk::raii::DescriptorSets(logical_device, allocate_info);
         }
         catch (const std::exception& e)
         {
             MEOW_INFO("{}\nAllocation failed. Try again", e.what());
 
-            fullPools.push_back(poolToUse);
+            pool_chain.fullPools.push_back(poolToUse);
 
-            poolToUse                                   = PopPool();
-            descriptor_set_allocate_info.descriptorPool = **poolToUse;
+            poolToUse                    = PopPool(pool_chain);
+            allocate_info.descriptorPool = **poolToUse;
 
-            descriptor_sets = vk::raii::DescriptorSets(logical_device, descriptor_set_allocate_info);
+            descriptor_sets = vk::raii::DescriptorSets(logical_device, allocate_info);
         }
 
-        readyPools.push_back(poolToUse);
+        pool_chain.readyPools.push_back(poolToUse);
 
         return descriptor_sets;
     }
+
+    void DescriptorAllocatorGrowable::BeginFrame(uint32_t frame_index)
+    {
+        FUNCTION_TIMER();
+
+        for (auto& thread : frames[frame_index])
+        {
+            if (!thread.used)
+                continue;
+
+            ClearPools(thread.pools);
+            thread.set_cache.clear();
+            thread.used = false;
+        }
+    }
+
+    vk::DescriptorSet DescriptorAllocatorGrowable::AllocateTransient(uint32_t                frame_index,
+                                                                     vk::DescriptorSetLayout descriptor_set_layout)
+    {
+        ThreadData& thread = frames[frame_index][g_runtime_context.job_system->GetThreadIndex()];
+        thread.used        = true;
+
+        vk::DescriptorSetAllocateInfo descriptor_set_allocate_info(nullptr, descriptor_set_layout);
+        vk::raii::DescriptorSets      descriptor_sets = AllocateFrom(thread.pools, descriptor_set_allocate_info);
+
+        // the set goes away with the reset of its pool, which has no eFreeDescriptorSet to free it by
+        return descriptor_sets.front().release();
+    }
+
+    vk::DescriptorSet
+    DescriptorAllocatorGrowable::GetTransient(uint32_t                              frame_index,
+                                              vk::DescriptorSetLayout               descriptor_set_layout,
+                                              const std::vector<DescriptorBinding>& bindings)
+    {
+        ThreadData& thread = frames[frame_index][g_runtime_context.job_system->GetThreadIndex()];
+
+        uint64_t hash = HashBindings(descriptor_set_layout, bindings);
+
+        auto it = thread.set_cache.find(hash);
+        if (it != thread.set_cache.end() && it->second.descriptor_set_layout == descriptor_set_layout &&
+            it->second.bindings == bindings)
+            return it->second.descriptor_set;
+
+        vk::DescriptorSet descriptor_set = AllocateTransient(frame_index, descriptor_set_layout);
+
+        std::vector<vk::WriteDescriptorSet> write_descriptor_sets;
+        write_descriptor_sets.reserve(bindings.size());
+        for (const DescriptorBinding& binding : bindings)
+        {
+            vk::WriteDescriptorSet write_descriptor_set(descriptor_set, binding.binding, 0, 1, binding.type);
+            if (IsImageDescriptor(binding.type))
+                write_descriptor_set.pImageInfo = &binding.image_info;
+            else
+                write_descriptor_set.pBufferInfo = &binding.buffer_info;
+
+            write_descriptor_sets.push_back(write_descriptor_set);
+        }
+        g_runtime_context.render_system->GetLogicalDevice().updateDescriptorSets(write_descriptor_sets, nullptr);
+
+        // on a hash collision the cached set is kept, and this one is written again next time
+        if (it == thread.set_cache.end())
+            thread.set_cache.emplace(hash, CachedSet {descriptor_set_layout, bindings, descriptor_set});
+
+        return descriptor_set;
+    }
 } // namespace Meow
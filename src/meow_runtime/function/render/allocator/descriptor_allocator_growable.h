@@ -4,8 +4,32 @@
 
 #include <vulkan/vulkan_raii.hpp>
 
+#include <unordered_map>
+
 namespace Meow
 {
+    /**
+     * @brief One binding of a transient descriptor set. Only the info matching the descriptor type is read.
+     */
+    struct DescriptorBinding
+    {
+        uint32_t                 binding = 0;
+        vk::DescriptorType       type    = vk::DescriptorType::eUniformBuffer;
+        vk::DescriptorBufferInfo buffer_info;
+        vk::DescriptorImageInfo  image_info;
+
+        bool operator==(const DescriptorBinding& rhs) const = default;
+    };
+
+    /**
+     * @brief Growable descriptor pools for persistent sets, plus per-frame, per-thread pools for transient sets.
+     *
+     * Persistent sets, such as the ones of materials, live until they are destroyed. Transient sets are only valid in
+     * the frame they are allocated in: every thread of the job system owns pools per frame in flight, selected by
+     * JobSystem::GetThreadIndex(), which are reset wholesale when the frame slot begins again instead of freeing sets
+     * one by one. Transient sets with the same layout and bindings are allocated and written once per frame and
+     * thread, then returned from a cache keyed by the hash of their bindings.
+     */
     struct DescriptorAllocatorGrowable
     {
     public:
@@ -14,19 +38,67 @@ namespace Meow
 
         DescriptorAllocatorGrowable(const vk::raii::Device&             logical_device,
                                     uint32_t                            initialSets,
-                                    std::vector<vk::DescriptorPoolSize> pool_sizes);
+                                    std::vector<vk::DescriptorPoolSize> pool_sizes,
+                                    uint32_t                            frame_count,
+                                    uint32_t                            thread_count);
 
         void ClearPools();
 
         vk::raii::DescriptorSets Allocate(std::vector<vk::DescriptorSetLayout> descriptor_set_layouts,
                                           void*                                pNext = nullptr);
 
+        /**
+         * @brief Reset transient pools of the frame slot. Call it after waiting for the fences of the slot.
+         */
+        void BeginFrame(uint32_t frame_index);
+
+        /**
+         * @brief Allocate an unwritten set from the pools of the calling thread. It stays valid until the frame slot
+         * begins again.
+         */
+        vk::DescriptorSet AllocateTransient(uint32_t frame_index, vk::DescriptorSetLayout descriptor_set_layout);
+
+        /**
+         * @brief Return a set written with the bindings, reusing the one of this frame and thread with the same layout
+         * and bindings if any. Texel buffers are not supported.
+         */
+        vk::DescriptorSet GetTransient(uint32_t                              frame_index,
+                                       vk::DescriptorSetLayout               descriptor_set_layout,
+                                       const std::vector<DescriptorBinding>& bindings);
+
     private:
-        std::shared_ptr<vk::raii::DescriptorPool> PopPool();
+        struct PoolChain
+        {
+            vk::DescriptorPoolCreateFlags                          flags;
+            std::vector<std::shared_ptr<vk::raii::DescriptorPool>> fullPools;
+            std::vector<std::shared_ptr<vk::raii::DescriptorPool>> readyPools;
+            uint32_t                                               setsPerPool = 0;
+        };
+
+        struct CachedSet
+        {
+            vk::DescriptorSetLayout        descriptor_set_layout;
+            std::vector<DescriptorBinding> bindings;
+            vk::DescriptorSet              descriptor_set;
+        };
+
+        struct ThreadData
+        {
+            PoolChain                               pools;
+            std::unordered_map<uint64_t, CachedSet> set_cache;
+            bool                                    used = false;
+        };
+
+        static void ClearPools(PoolChain& pool_chain);
+
+        std::shared_ptr<vk::raii::DescriptorPool> PopPool(PoolChain& pool_chain);
+
+        vk::raii::DescriptorSets AllocateFrom(PoolChain& pool_chain, vk::DescriptorSetAllocateInfo allocate_info);
+
+        std::vector<vk::DescriptorPoolSize> pool_sizes;
+        PoolChain                           persistentPools;
 
-        std::vector<vk::DescriptorPoolSize>                    pool_sizes;
-        std::vector<std::shared_ptr<vk::raii::DescriptorPool>> fullPools;
-        std::vector<std::shared_ptr<vk::raii::DescriptorPool>> readyPools;
-        uint32_t                                               setsPerPool;
+        // transient pools, indexed by frame, then by thread
+        std::vector<std::vector<ThreadData>> frames;
     };
 } // namespace Meow
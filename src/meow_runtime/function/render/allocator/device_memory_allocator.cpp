@@ -0,0 +1,382 @@
+#include "device_memory_allocator.h"
+
+#include "pch.h"
+
+#include "function/global/runtime_context.h"
+#include "function/render/utils/vulkan_initialization_utils.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace Meow
+{
+    DeviceMemoryAllocator::DeviceMemoryAllocator(const vk::raii::PhysicalDevice& physical_device,
+                                                 const vk::raii::Device&         logical_device,
+                                                 bool                            memory_budget_supported)
+        : m_physical_device(&physical_device)
+        , m_logical_device(&logical_device)
+        , m_memory_properties(physical_device.getMemoryProperties())
+        , m_memory_budget_supported(memory_budget_supported)
+    {
+        const vk::PhysicalDeviceLimits& limits = physical_device.getProperties().limits;
+
+        m_max_device_memory_count = limits.maxMemoryAllocationCount;
+
+        // placements are aligned to their size, so with pages no larger than the smallest one, neighbours never
+        // share a page
+        m_split_by_tiling = limits.bufferImageGranularity > k_min_placement_size;
+
+        uint32_t tiling_count = m_split_by_tiling ? 2 : 1;
+        m_pools.resize(m_memory_properties.memoryTypeCount * tiling_count);
+        for (uint32_t i = 0; i < m_pools.size(); ++i)
+        {
+            uint32_t       memory_type_index = i / tiling_count;
+            vk::DeviceSize heap_size =
+                m_memory_properties.memoryHeaps[m_memory_properties.memoryTypes[memory_type_index].heapIndex].size;
+
+            // small heaps, like the host visible part of device local memory, would be taken by a few blocks
+            m_pools[i].memory_type_index = memory_type_index;
+            m_pools[i].block_size =
+                std::clamp(std::bit_floor(heap_size / 8), k_min_block_size, k_max_block_size);
+        }
+
+        m_dedicated_sizes.resize(m_memory_properties.memoryHeapCount, 0);
+        m_dedicated_counts.resize(m_memory_properties.memoryHeapCount, 0);
+    }
+
+    DeviceMemoryAllocator::~DeviceMemoryAllocator()
+    {
+        for (const Pool& pool : m_pools)
+        {
+            for (const auto& block : pool.blocks)
+            {
+                if (block && !block->placement.IsEmpty())
+                {
+                    MEOW_WARN("{} device memory allocations are still alive when the allocator is destroyed.",
+                              block->placement.GetAllocationCount());
+                }
+            }
+        }
+    }
+
+    DeviceMemoryAllocation DeviceMemoryAllocator::Allocate(const vk::MemoryRequirements& memory_requirements,
+                                                           vk::MemoryPropertyFlags       memory_property_flags,
+                                                           ResourceTiling                tiling)
+    {
+        FUNCTION_TIMER();
+
+        uint32_t memory_type_index =
+            FindMemoryType(m_memory_properties, memory_requirements.memoryTypeBits, memory_property_flags);
+        uint32_t pool_index = GetPoolIndex(memory_type_index, tiling);
+        uint32_t heap_index = m_memory_properties.memoryTypes[memory_type_index].heapIndex;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Pool& pool = m_pools[pool_index];
+
+        if (memory_requirements.size > pool.block_size / 2)
+        {
+            DeviceMemoryAllocation allocation = DeviceMemoryAllocation::CreateDedicated(
+                *m_logical_device, m_memory_properties, memory_requirements, memory_property_flags);
+            allocation.m_allocator = this;
+
+            m_dedicated_sizes[heap_index] += allocation.m_size;
+            ++m_dedicated_counts[heap_index];
+
+            return allocation;
+        }
+
+        Block*         block  = nullptr;
+        vk::DeviceSize offset = BuddyAllocator::k_invalid_offset;
+        for (const auto& pool_block : pool.blocks)
+        {
+            if (!pool_block)
+                continue;
+
+            offset = pool_block->placement.Allocate(memory_requirements.size, memory_requirements.alignment);
+            if (offset != BuddyAllocator::k_invalid_offset)
+            {
+                block = pool_block.get();
+                break;
+            }
+        }
+
+        if (!block)
+        {
+            block  = CreateBlock(pool_index, std::max(memory_requirements.size, memory_requirements.alignment));
+            offset = block->placement.Allocate(memory_requirements.size, memory_requirements.alignment);
+        }
+
+        DeviceMemoryAllocation allocation;
+        allocation.m_allocator       = this;
+        allocation.m_block           = block;
+        allocation.m_heap_index      = heap_index;
+        allocation.m_memory          = *block->memory;
+        allocation.m_offset          = offset;
+        allocation.m_size            = memory_requirements.size;
+        allocation.m_mapped_data_ptr = block->mapped_data_ptr ? block->mapped_data_ptr + offset : nullptr;
+
+        return allocation;
+    }
+
+    DeviceMemoryStatistics DeviceMemoryAllocator::GetStatistics() const
+    {
+        DeviceMemoryStatistics statistics;
+        statistics.max_device_memory_count = m_max_device_memory_count;
+        statistics.budget_supported        = m_memory_budget_supported;
+
+        std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> heap_budgets = QueryHeapBudgets();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        statistics.heaps.resize(m_memory_properties.memoryHeapCount);
+        for (uint32_t i = 0; i < m_memory_properties.memoryHeapCount; ++i)
+        {
+            DeviceMemoryStatistics::Heap& heap = statistics.heaps[i];
+            heap.size                          = m_memory_properties.memoryHeaps[i].size;
+            heap.dedicated_size                = m_dedicated_sizes[i];
+            heap.dedicated_count               = m_dedicated_counts[i];
+            statistics.device_memory_count += m_dedicated_counts[i];
+        }
+
+        for (const Pool& pool : m_pools)
+        {
+            DeviceMemoryStatistics::Heap& heap =
+                statistics.heaps[m_memory_properties.memoryTypes[pool.memory_type_index].heapIndex];
+
+            for (const auto& block : pool.blocks)
+            {
+                if (!block)
+                    continue;
+
+                heap.block_size += block->placement.GetSize();
+                heap.block_used_size += block->placement.GetAllocatedSize();
+                heap.allocation_count += block->placement.GetAllocationCount();
+                ++heap.block_count;
+                ++statistics.device_memory_count;
+            }
+        }
+
+        for (uint32_t i = 0; i < statistics.heaps.size(); ++i)
+        {
+            DeviceMemoryStatistics::Heap& heap = statistics.heaps[i];
+            if (heap_budgets.empty())
+            {
+                heap.budget = heap.size;
+                heap.usage  = heap.block_size + heap.dedicated_size;
+            }
+            else
+            {
+                heap.budget = heap_budgets[i].first;
+                heap.usage  = heap_budgets[i].second;
+            }
+        }
+
+        return statistics;
+    }
+
+    uint32_t DeviceMemoryAllocator::GetPoolIndex(uint32_t memory_type_index, ResourceTiling tiling) const
+    {
+        if (!m_split_by_tiling)
+            return memory_type_index;
+
+        return memory_type_index * 2 + (tiling == ResourceTiling::Optimal ? 1 : 0);
+    }
+
+    DeviceMemoryAllocator::Block* DeviceMemoryAllocator::CreateBlock(uint32_t pool_index, vk::DeviceSize required_size)
+    {
+        FUNCTION_TIMER();
+
+        Pool&    pool       = m_pools[pool_index];
+        uint32_t heap_index = m_memory_properties.memoryTypes[pool.memory_type_index].heapIndex;
+
+        vk::DeviceSize block_size = pool.block_size;
+
+        // shrink the block rather than going over budget, which makes the driver page memory out
+        std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> heap_budgets = QueryHeapBudgets();
+        if (!heap_budgets.empty())
+        {
+            auto [budget, usage] = heap_budgets[heap_index];
+
+            vk::DeviceSize min_block_size = std::max(std::bit_ceil(required_size), k_min_placement_size);
+            while (usage + block_size > budget && block_size / 2 >= min_block_size)
+            {
+                block_size /= 2;
+            }
+
+            if (usage + block_size > budget)
+            {
+                MEOW_WARN("Device memory heap {} goes over budget: {} of {} bytes are used, allocating {} more.",
+                          heap_index,
+                          usage,
+                          budget,
+                          block_size);
+            }
+        }
+
+        vk::MemoryAllocateInfo memory_allocate_info(block_size, pool.memory_type_index);
+        vk::raii::DeviceMemory memory(*m_logical_device, memory_allocate_info);
+
+        uint8_t* mapped_data_ptr = nullptr;
+        if (m_memory_properties.memoryTypes[pool.memory_type_index].propertyFlags &
+            vk::MemoryPropertyFlagBits::eHostVisible)
+        {
+            mapped_data_ptr = static_cast<uint8_t*>(memory.mapMemory(0, VK_WHOLE_SIZE));
+        }
+
+        auto block = std::unique_ptr<Block>(new Block {
+            std::move(memory), mapped_data_ptr, BuddyAllocator(block_size, k_min_placement_size), pool_index});
+
+        MEOW_INFO("Device memory block of {} bytes is created for memory type {}.", block_size, pool.memory_type_index);
+
+        // reuse a slot of a freed block, so that existing blocks keep their position
+        auto slot = std::find(pool.blocks.begin(), pool.blocks.end(), nullptr);
+        if (slot == pool.blocks.end())
+            slot = pool.blocks.insert(pool.blocks.end(), nullptr);
+        *slot = std::move(block);
+
+        return slot->get();
+    }
+
+    void DeviceMemoryAllocator::Free(DeviceMemoryAllocation& allocation)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (allocation.IsDedicated())
+        {
+            m_dedicated_sizes[allocation.m_heap_index] -= allocation.m_size;
+            --m_dedicated_counts[allocation.m_heap_index];
+            return;
+        }
+
+        Block* block = allocation.m_block;
+        block->placement.Free(allocation.m_offset);
+
+        if (!block->placement.IsEmpty())
+            return;
+
+        // one empty block is kept per pool, so that a resource recreated every frame doesn't allocate memory again
+        Pool& pool        = m_pools[block->pool_index];
+        auto  block_count = std::count_if(
+            pool.blocks.begin(), pool.blocks.end(), [](const std::unique_ptr<Block>& b) { return b != nullptr; });
+        if (block_count <= 1)
+            return;
+
+        for (auto& pool_block : pool.blocks)
+        {
+            if (pool_block.get() == block)
+            {
+                pool_block = nullptr;
+                break;
+            }
+        }
+    }
+
+    std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> DeviceMemoryAllocator::QueryHeapBudgets() const
+    {
+        std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> heap_budgets;
+        if (!m_memory_budget_supported)
+            return heap_budgets;
+
+        auto memory_properties_chain =
+            m_physical_device->getMemoryProperties2<vk::PhysicalDeviceMemoryProperties2,
+                                                    vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+        const auto& budget_properties = memory_properties_chain.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+
+        heap_budgets.resize(m_memory_properties.memoryHeapCount);
+        for (uint32_t i = 0; i < m_memory_properties.memoryHeapCount; ++i)
+        {
+            heap_budgets[i] = {budget_properties.heapBudget[i], budget_properties.heapUsage[i]};
+        }
+
+        return heap_budgets;
+    }
+
+    DeviceMemoryAllocation::DeviceMemoryAllocation(DeviceMemoryAllocation&& rhs) noexcept
+        : m_allocator(std::exchange(rhs.m_allocator, nullptr))
+        , m_block(std::exchange(rhs.m_block, nullptr))
+        , m_dedicated_memory(std::exchange(rhs.m_dedicated_memory, nullptr))
+        , m_heap_index(rhs.m_heap_index)
+        , m_memory(std::exchange(rhs.m_memory, nullptr))
+        , m_offset(std::exchange(rhs.m_offset, 0))
+        , m_size(std::exchange(rhs.m_size, 0))
+        , m_mapped_data_ptr(std::exchange(rhs.m_mapped_data_ptr, nullptr))
+    {}
+
+    DeviceMemoryAllocation& DeviceMemoryAllocation::operator=(DeviceMemoryAllocation&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Free();
+
+            m_allocator        = std::exchange(rhs.m_allocator, nullptr);
+            m_block            = std::exchange(rhs.m_block, nullptr);
+            m_dedicated_memory = std::exchange(rhs.m_dedicated_memory, nullptr);
+            m_heap_index       = rhs.m_heap_index;
+            m_memory           = std::exchange(rhs.m_memory, nullptr);
+            m_offset           = std::exchange(rhs.m_offset, 0);
+            m_size             = std::exchange(rhs.m_size, 0);
+            m_mapped_data_ptr  = std::exchange(rhs.m_mapped_data_ptr, nullptr);
+        }
+        return *this;
+    }
+
+    DeviceMemoryAllocation
+    DeviceMemoryAllocation::CreateDedicated(const vk::raii::Device&                   logical_device,
+                                            const vk::PhysicalDeviceMemoryProperties& memory_properties,
+                                            const vk::MemoryRequirements&             memory_requirements,
+                                            vk::MemoryPropertyFlags                   memory_property_flags)
+    {
+        uint32_t memory_type_index =
+            FindMemoryType(memory_properties, memory_requirements.memoryTypeBits, memory_property_flags);
+
+        DeviceMemoryAllocation allocation;
+        allocation.m_dedicated_memory = vk::raii::DeviceMemory(
+            logical_device, vk::MemoryAllocateInfo(memory_requirements.size, memory_type_index));
+        allocation.m_heap_index = memory_properties.memoryTypes[memory_type_index].heapIndex;
+        allocation.m_memory     = *allocation.m_dedicated_memory;
+        allocation.m_size       = memory_requirements.size;
+
+        if (memory_properties.memoryTypes[memory_type_index].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible)
+        {
+            allocation.m_mapped_data_ptr =
+                static_cast<uint8_t*>(allocation.m_dedicated_memory.mapMemory(0, VK_WHOLE_SIZE));
+        }
+
+        return allocation;
+    }
+
+    void DeviceMemoryAllocation::Free()
+    {
+        if (!m_memory)
+            return;
+
+        if (m_allocator)
+            m_allocator->Free(*this);
+
+        // freeing dedicated memory unmaps it implicitly
+        m_dedicated_memory = nullptr;
+        m_allocator        = nullptr;
+        m_block            = nullptr;
+        m_memory           = nullptr;
+        m_offset           = 0;
+        m_size             = 0;
+        m_mapped_data_ptr  = nullptr;
+    }
+
+    DeviceMemoryAllocation AllocateResourceMemory(const vk::raii::PhysicalDevice& physical_device,
+                                                  const vk::raii::Device&         logical_device,
+                                                  const vk::MemoryRequirements&   memory_requirements,
+                                                  vk::MemoryPropertyFlags         memory_property_flags,
+                                                  ResourceTiling                  tiling)
+    {
+        if (g_runtime_context.render_system)
+        {
+            return g_runtime_context.render_system->GetDeviceMemoryAllocator().Allocate(
+                memory_requirements, memory_property_flags, tiling);
+        }
+
+        return DeviceMemoryAllocation::CreateDedicated(
+            logical_device, physical_device.getMemoryProperties(), memory_requirements, memory_property_flags);
+    }
+} // namespace Meow
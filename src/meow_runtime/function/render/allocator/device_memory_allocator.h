@@ -0,0 +1,194 @@
+#pragma once
+
+#include "core/base/buddy_allocator.h"
+#include "core/base/non_copyable.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Meow
+{
+    class DeviceMemoryAllocation;
+
+    /**
+     * @brief Whether a resource is laid out linearly, like buffers and linear images, or in an implementation defined
+     * way, like optimal images. Both kinds may only share a page of bufferImageGranularity bytes if they are apart.
+     */
+    enum class ResourceTiling
+    {
+        Linear,
+        Optimal,
+    };
+
+    struct DeviceMemoryStatistics
+    {
+        struct Heap
+        {
+            vk::DeviceSize size = 0;
+            // from VK_EXT_memory_budget if supported, otherwise heap size and memory allocated here
+            vk::DeviceSize budget = 0;
+            vk::DeviceSize usage  = 0;
+
+            vk::DeviceSize block_size       = 0;
+            vk::DeviceSize block_used_size  = 0;
+            vk::DeviceSize dedicated_size   = 0;
+            uint32_t       block_count      = 0;
+            uint32_t       allocation_count = 0;
+            uint32_t       dedicated_count  = 0;
+        };
+
+        std::vector<Heap> heaps;
+
+        // live vkAllocateMemory objects, which are limited by maxMemoryAllocationCount
+        uint32_t device_memory_count     = 0;
+        uint32_t max_device_memory_count = 0;
+        bool     budget_supported        = false;
+    };
+
+    /**
+     * @brief Places buffers and images inside large blocks of device memory, so that they don't cost one Vulkan
+     * allocation each.
+     *
+     * There is a pool of blocks per memory type, split by ResourceTiling when bufferImageGranularity is larger than
+     * the smallest placement, so that linear and optimal resources never share a page. Ranges are placed inside a
+     * block by BuddyAllocator. Resources larger than half a block get dedicated memory. Host visible blocks are mapped
+     * once when created, and stay mapped until freed, so allocations expose a pointer instead of being mapped.
+     *
+     * With VK_EXT_memory_budget, new blocks are sized to stay inside the heap budget when possible.
+     */
+    class DeviceMemoryAllocator
+    {
+    public:
+        static constexpr vk::DeviceSize k_max_block_size     = 64ull * 1024 * 1024;
+        static constexpr vk::DeviceSize k_min_block_size     = 1024ull * 1024;
+        static constexpr vk::DeviceSize k_min_placement_size = 256;
+
+        DeviceMemoryAllocator(const vk::raii::PhysicalDevice& physical_device,
+                              const vk::raii::Device&         logical_device,
+                              bool                            memory_budget_supported);
+
+        ~DeviceMemoryAllocator();
+
+        DeviceMemoryAllocator(const DeviceMemoryAllocator&)            = delete;
+        DeviceMemoryAllocator& operator=(const DeviceMemoryAllocator&) = delete;
+
+        /**
+         * @brief Thread safe. Throws like vk::raii::DeviceMemory if memory runs out.
+         */
+        DeviceMemoryAllocation Allocate(const vk::MemoryRequirements& memory_requirements,
+                                        vk::MemoryPropertyFlags       memory_property_flags,
+                                        ResourceTiling                tiling);
+
+        DeviceMemoryStatistics GetStatistics() const;
+
+    private:
+        friend class DeviceMemoryAllocation;
+
+        struct Block
+        {
+            vk::raii::DeviceMemory memory          = nullptr;
+            uint8_t*               mapped_data_ptr = nullptr;
+            BuddyAllocator         placement;
+            uint32_t               pool_index;
+        };
+
+        struct Pool
+        {
+            uint32_t                            memory_type_index;
+            vk::DeviceSize                      block_size;
+            std::vector<std::unique_ptr<Block>> blocks;
+        };
+
+        uint32_t GetPoolIndex(uint32_t memory_type_index, ResourceTiling tiling) const;
+
+        Block* CreateBlock(uint32_t pool_index, vk::DeviceSize required_size);
+
+        void Free(DeviceMemoryAllocation& allocation);
+
+        /**
+         * @brief Per-heap budget and process usage, or empty if VK_EXT_memory_budget is not supported.
+         */
+        std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> QueryHeapBudgets() const;
+
+        const vk::raii::PhysicalDevice* m_physical_device = nullptr;
+        const vk::raii::Device*         m_logical_device  = nullptr;
+
+        vk::PhysicalDeviceMemoryProperties m_memory_properties;
+        uint32_t                           m_max_device_memory_count = 0;
+        bool                               m_memory_budget_supported = false;
+        bool                               m_split_by_tiling         = false;
+
+        mutable std::mutex m_mutex;
+        std::vector<Pool>  m_pools;
+
+        // dedicated memory is owned by its allocation, and only counted here
+        std::vector<vk::DeviceSize> m_dedicated_sizes;
+        std::vector<uint32_t>       m_dedicated_counts;
+    };
+
+    /**
+     * @brief A range of device memory, placed inside a block of DeviceMemoryAllocator or dedicated. Resources bind to
+     * GetMemory() at GetOffset(). The range goes back to the allocator when it is destroyed, so it should outlive the
+     * resource bound to it.
+     */
+    class DeviceMemoryAllocation : public NonCopyable
+    {
+    public:
+        DeviceMemoryAllocation() {}
+        DeviceMemoryAllocation(std::nullptr_t) {}
+
+        ~DeviceMemoryAllocation() override { Free(); }
+
+        DeviceMemoryAllocation(DeviceMemoryAllocation&& rhs) noexcept;
+        DeviceMemoryAllocation& operator=(DeviceMemoryAllocation&& rhs) noexcept;
+
+        /**
+         * @brief Allocate a dedicated memory object, not tracked by any allocator.
+         */
+        static DeviceMemoryAllocation CreateDedicated(const vk::raii::Device&                   logical_device,
+                                                      const vk::PhysicalDeviceMemoryProperties& memory_properties,
+                                                      const vk::MemoryRequirements&             memory_requirements,
+                                                      vk::MemoryPropertyFlags                   memory_property_flags);
+
+        vk::DeviceMemory GetMemory() const { return m_memory; }
+        vk::DeviceSize   GetOffset() const { return m_offset; }
+        vk::DeviceSize   GetSize() const { return m_size; }
+
+        /**
+         * @brief Persistently mapped pointer to the start of the range, or nullptr if memory is not host visible.
+         */
+        uint8_t* GetMappedData() const { return m_mapped_data_ptr; }
+
+        bool IsDedicated() const { return m_block == nullptr; }
+
+        explicit operator bool() const { return m_memory != vk::DeviceMemory(); }
+
+        void Free();
+
+    private:
+        friend class DeviceMemoryAllocator;
+
+        DeviceMemoryAllocator*        m_allocator        = nullptr;
+        DeviceMemoryAllocator::Block* m_block            = nullptr;
+        vk::raii::DeviceMemory        m_dedicated_memory = nullptr;
+        uint32_t                      m_heap_index       = 0;
+
+        vk::DeviceMemory m_memory          = nullptr;
+        vk::DeviceSize   m_offset          = 0;
+        vk::DeviceSize   m_size            = 0;
+        uint8_t*         m_mapped_data_ptr = nullptr;
+    };
+
+    /**
+     * @brief Allocate memory for a resource from the allocator of the render system. Resources created while the
+     * render system itself is being constructed, before it is reachable, get dedicated memory.
+     */
+    DeviceMemoryAllocation AllocateResourceMemory(const vk::raii::PhysicalDevice& physical_device,
+                                                  const vk::raii::Device&         logical_device,
+                                                  const vk::MemoryRequirements&   memory_requirements,
+                                                  vk::MemoryPropertyFlags         memory_property_flags,
+                                                  ResourceTiling                  tiling);
+} // namespace Meow
@@ -0,0 +1,70 @@
+#include "dynamic_uniform_allocator.h"
+
+#include "pch.h"
+
+#include "core/base/alignment.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Meow
+{
+    DynamicUniformAllocator::DynamicUniformAllocator(const vk::raii::PhysicalDevice& physical_device,
+                                                     const vk::raii::Device&         logical_device,
+                                                     uint32_t                        frame_count,
+                                                     vk::DeviceSize                  initial_size)
+        : m_physical_device(&physical_device)
+        , m_logical_device(&logical_device)
+    {
+        m_frames.resize(frame_count);
+        for (auto& frame : m_frames)
+        {
+            frame.buffer = std::make_unique<UniformBuffer>(physical_device, logical_device, initial_size);
+        }
+    }
+
+    void DynamicUniformAllocator::BeginFrame(uint32_t frame_index)
+    {
+        FUNCTION_TIMER();
+
+        FrameData& frame = m_frames[frame_index];
+
+        // retired buffers and the memory reset here were last read by the previous submissions of this slot, whose
+        // fences the window waits for before beginning the frame
+        frame.retired_buffers.clear();
+        frame.buffer->ResetMemory();
+    }
+
+    uint32_t DynamicUniformAllocator::Populate(uint32_t frame_index, const void* data, uint64_t size)
+    {
+        FrameData& frame = m_frames[frame_index];
+
+        uint64_t offset = Align<uint64_t>(frame.buffer->allocated_memory, frame.buffer->min_alignment);
+        if (offset + size > frame.buffer->device_size)
+            Grow(frame, offset + size);
+
+        std::memcpy(frame.buffer->mapped_data_ptr + offset, data, size);
+        frame.buffer->allocated_memory = offset + size;
+
+        m_high_water_mark = std::max(m_high_water_mark, frame.buffer->allocated_memory);
+
+        return static_cast<uint32_t>(offset);
+    }
+
+    void DynamicUniformAllocator::Grow(FrameData& frame, uint64_t required_size)
+    {
+        FUNCTION_TIMER();
+
+        uint64_t new_size = std::max<uint64_t>(frame.buffer->device_size * 2, required_size);
+
+        auto new_buffer = std::make_unique<UniformBuffer>(*m_physical_device, *m_logical_device, new_size);
+        std::memcpy(new_buffer->mapped_data_ptr, frame.buffer->mapped_data_ptr, frame.buffer->allocated_memory);
+        new_buffer->allocated_memory = frame.buffer->allocated_memory;
+
+        MEOW_INFO("Dynamic uniform buffer grows from {} to {} bytes.", frame.buffer->device_size, new_size);
+
+        frame.retired_buffers.push_back(std::move(frame.buffer));
+        frame.buffer = std::move(new_buffer);
+        ++frame.version;
+    }
+} // namespace Meow
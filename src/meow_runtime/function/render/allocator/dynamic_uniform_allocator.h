@@ -0,0 +1,79 @@
+#pragma once
+
+#include "function/render/buffer_data/uniform_buffer.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Per-frame linear allocator for dynamic uniform data, shared by all materials.
+     *
+     * Every frame in flight owns one host visible buffer, and allocations bump an offset into it. When a frame runs
+     * out of space, its buffer is replaced by a larger one and the data written so far is copied over, so nothing is
+     * overwritten. The replaced buffer is kept alive until the same frame slot begins again, since command buffers in
+     * flight may still read it. Each replacement bumps the version of the frame, which tells materials to rebind
+     * their descriptors.
+     */
+    class DynamicUniformAllocator
+    {
+    public:
+        static constexpr vk::DeviceSize k_default_initial_size = 1024 * 1024;
+
+        DynamicUniformAllocator(std::nullptr_t) {}
+
+        DynamicUniformAllocator(const vk::raii::PhysicalDevice& physical_device,
+                                const vk::raii::Device&         logical_device,
+                                uint32_t                        frame_count,
+                                vk::DeviceSize                  initial_size = k_default_initial_size);
+
+        DynamicUniformAllocator(DynamicUniformAllocator&& rhs) noexcept            = default;
+        DynamicUniformAllocator& operator=(DynamicUniformAllocator&& rhs) noexcept = default;
+
+        /**
+         * @brief Reset the frame before populating any material. Buffers retired by this frame slot are released.
+         *
+         * Call it only once the in-flight fences of the frame slot have been waited for, since the previous
+         * submissions of the slot read the memory being reset.
+         */
+        void BeginFrame(uint32_t frame_index);
+
+        /**
+         * @brief Copy data into the frame buffer, and return its offset which is used as dynamic offset.
+         */
+        uint32_t Populate(uint32_t frame_index, const void* data, uint64_t size);
+
+        const UniformBuffer& GetBuffer(uint32_t frame_index) const { return *m_frames[frame_index].buffer; }
+
+        /**
+         * @brief Bumped whenever the buffer of the frame is replaced.
+         */
+        uint32_t GetVersion(uint32_t frame_index) const { return m_frames[frame_index].version; }
+
+        uint64_t GetUsedSize(uint32_t frame_index) const { return m_frames[frame_index].buffer->allocated_memory; }
+
+        /**
+         * @brief The most bytes ever used by one frame.
+         */
+        uint64_t GetHighWaterMark() const { return m_high_water_mark; }
+
+    private:
+        struct FrameData
+        {
+            std::unique_ptr<UniformBuffer>              buffer;
+            std::vector<std::unique_ptr<UniformBuffer>> retired_buffers;
+            uint32_t                                    version = 0;
+        };
+
+        void Grow(FrameData& frame, uint64_t required_size);
+
+        const vk::raii::PhysicalDevice* m_physical_device = nullptr;
+        const vk::raii::Device*         m_logical_device  = nullptr;
+
+        std::vector<FrameData> m_frames;
+        uint64_t               m_high_water_mark = 0;
+    };
+} // namespace Meow
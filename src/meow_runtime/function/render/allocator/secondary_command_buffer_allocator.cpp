@@ -0,0 +1,63 @@
+#include "secondary_command_buffer_allocator.h"
+
+#include "pch.h"
+
+#include "function/global/runtime_context.h"
+
+namespace Meow
+{
+    SecondaryCommandBufferAllocator::SecondaryCommandBufferAllocator(const vk::raii::Device& logical_device,
+                                                                     uint32_t                queue_family_index,
+                                                                     uint32_t                frame_count,
+                                                                     uint32_t                thread_count)
+        : m_logical_device(&logical_device)
+    {
+        m_frames.resize(frame_count);
+        for (auto& threads : m_frames)
+        {
+            threads.resize(thread_count);
+            for (auto& thread : threads)
+            {
+                thread.command_pool = vk::raii::CommandPool(
+                    logical_device, {vk::CommandPoolCreateFlagBits::eTransient, queue_family_index});
+            }
+        }
+    }
+
+    void SecondaryCommandBufferAllocator::BeginFrame(uint32_t frame_index)
+    {
+        FUNCTION_TIMER();
+
+        for (auto& thread : m_frames[frame_index])
+        {
+            if (thread.used_count == 0)
+                continue;
+
+            thread.command_pool.reset();
+            thread.used_count = 0;
+        }
+    }
+
+    const vk::raii::CommandBuffer&
+    SecondaryCommandBufferAllocator::Begin(uint32_t frame_index, vk::RenderPass render_pass, uint32_t subpass)
+    {
+        uint32_t    thread_index = g_runtime_context.job_system->GetThreadIndex();
+        ThreadData& thread       = m_frames[frame_index][thread_index];
+
+        if (thread.used_count == thread.command_buffers.size())
+        {
+            vk::CommandBufferAllocateInfo command_buffer_allocate_info(
+                *thread.command_pool, vk::CommandBufferLevel::eSecondary, 1);
+            vk::raii::CommandBuffers command_buffers(*m_logical_device, command_buffer_allocate_info);
+            thread.command_buffers.push_back(std::move(command_buffers[0]));
+        }
+
+        const vk::raii::CommandBuffer& command_buffer = thread.command_buffers[thread.used_count++];
+
+        // framebuffer is left unknown, so recording doesn't depend on which swapchain image is drawn to
+        vk::CommandBufferInheritanceInfo inheritance_info(render_pass, subpass);
+        command_buffer.begin({vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inheritance_info});
+
+        return command_buffer;
+    }
+} // namespace Meow
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <deque>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Per-frame, per-thread pools of secondary command buffers for recording passes on job workers.
+     *
+     * Command pools can only be used by one thread at a time, so every thread of the job system owns one pool per
+     * frame in flight, selected by JobSystem::GetThreadIndex(). Command buffers are reused instead of freed: beginning
+     * a frame resets the pools of its slot, which must happen after the fence of that slot has been waited for.
+     */
+    class SecondaryCommandBufferAllocator
+    {
+    public:
+        SecondaryCommandBufferAllocator(std::nullptr_t) {}
+
+        SecondaryCommandBufferAllocator(const vk::raii::Device& logical_device,
+                                        uint32_t                queue_family_index,
+                                        uint32_t                frame_count,
+                                        uint32_t                thread_count);
+
+        SecondaryCommandBufferAllocator(SecondaryCommandBufferAllocator&& rhs) noexcept            = default;
+        SecondaryCommandBufferAllocator& operator=(SecondaryCommandBufferAllocator&& rhs) noexcept = default;
+
+        /**
+         * @brief Reset command buffers of the frame slot. Call it after waiting for the fence of the slot.
+         */
+        void BeginFrame(uint32_t frame_index);
+
+        /**
+         * @brief Take a command buffer of the calling thread and begin it inside the given subpass. The reference stays
+         * valid until the frame slot begins again.
+         */
+        const vk::raii::CommandBuffer& Begin(uint32_t frame_index, vk::RenderPass render_pass, uint32_t subpass);
+
+    private:
+        struct ThreadData
+        {
+            vk::raii::CommandPool command_pool = nullptr;
+            // deque keeps references valid while it grows
+            std::deque<vk::raii::CommandBuffer> command_buffers;
+            uint32_t                            used_count = 0;
+        };
+
+        const vk::raii::Device* m_logical_device = nullptr;
+
+        // indexed by frame, then by thread
+        std::vector<std::vector<ThreadData>> m_frames;
+    };
+} // namespace Meow
@@ -0,0 +1,378 @@
+#include "gpu_culler.h"
+
+#include "pch.h"
+
+#include "function/global/runtime_context.h"
+#include "function/render/material/material_factory.h"
+#include "function/render/material/shader_factory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace Meow
+{
+    namespace
+    {
+        constexpr uint32_t k_no_command = 0xffffffff;
+
+        /**
+         * @brief One visible instance, the object element in the high bits and its draw command in the low bits.
+         */
+        uint64_t MakeVisibleKey(uint32_t object_index, uint32_t command_index)
+        {
+            return (static_cast<uint64_t>(object_index) << 32) | command_index;
+        }
+    } // namespace
+
+    GPUCuller::GPUCuller(uint32_t frame_count)
+    {
+        static_assert(sizeof(CullObject) == 48, "CullObject must match the std430 layout of gpu_cull.comp");
+
+        const vk::raii::Device& logical_device = g_runtime_context.render_system->GetLogicalDevice();
+
+        ShaderFactory   shader_factory;
+        MaterialFactory material_factory;
+
+        auto cull_shader = shader_factory.clear().SetComputeShader("builtin/shaders/gpu_cull.comp.spv").Create();
+
+        m_cull_material = std::make_shared<Material>(cull_shader);
+        g_runtime_context.resource_system->Register(m_cull_material);
+        material_factory.Init(cull_shader.get());
+        material_factory.CreateComputePipeline(logical_device, cull_shader.get(), m_cull_material.get());
+        m_cull_material->SetDebugName("GPU Cull Material");
+
+        m_frames.resize(frame_count);
+    }
+
+    void GPUCuller::Dispatch(const vk::raii::CommandBuffer& command_buffer,
+                             uint32_t                       frame_index,
+                             Level&                         level,
+                             ShadingModelType               shading_model,
+                             const Frustum&                 frustum)
+    {
+        FUNCTION_TIMER();
+
+        FrameData& frame = m_frames[frame_index];
+
+        // the window waits for the fences of this slot before recording, so results of its last dispatch can be read
+        if (m_validation_enabled && frame.has_results)
+            ValidateResults(frame);
+        frame.has_results = false;
+
+        if (m_renderable_version != level.GetRenderableVersion())
+            RefreshRenderables(level, shading_model);
+
+        frame.command_count = static_cast<uint32_t>(m_meshes.size());
+        if (m_cull_objects.empty())
+            return;
+
+        ObjectDataBuffer& object_data_buffer = g_runtime_context.render_system->GetObjectDataBuffer();
+
+        // the shader reads model matrices of every renderable, not only of the visible ones
+        for (const VisibleObject& renderable : m_renderables)
+        {
+            object_data_buffer.Update(frame_index,
+                                      renderable.handle,
+                                      level.GetWorldTransformStamp(renderable.handle),
+                                      level.GetWorldTransform(renderable.handle));
+        }
+
+        uint32_t cull_object_count = static_cast<uint32_t>(m_cull_objects.size());
+        if (frame.cull_object_version != m_renderable_version)
+        {
+            Reserve(frame.cull_objects,
+                    cull_object_count,
+                    sizeof(CullObject),
+                    vk::BufferUsageFlagBits::eStorageBuffer,
+                    "cullObjects",
+                    frame_index);
+            std::memcpy(
+                frame.cull_objects.mapped_data_ptr, m_cull_objects.data(), sizeof(CullObject) * cull_object_count);
+            frame.cull_object_version = m_renderable_version;
+        }
+
+        vk::BufferUsageFlags indirect_usage =
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer;
+        Reserve(frame.draw_commands,
+                frame.command_count,
+                sizeof(vk::DrawIndexedIndirectCommand),
+                indirect_usage,
+                "drawCommands",
+                frame_index);
+        Reserve(frame.draw_counts, frame.command_count, sizeof(uint32_t), indirect_usage, "drawCounts", frame_index);
+
+        // instances are counted by the shader, so every draw starts empty inside its own range
+        uint32_t first_instance = object_data_buffer.ReserveInstances(frame_index, m_instance_capacity);
+        auto*    draw_commands =
+            reinterpret_cast<vk::DrawIndexedIndirectCommand*>(frame.draw_commands.mapped_data_ptr);
+        for (uint32_t i = 0; i < frame.command_count; ++i)
+        {
+            draw_commands[i] = vk::DrawIndexedIndirectCommand(
+                m_meshes[i]->index_buffer_ptr->data_number, 0, 0, 0, first_instance + m_mesh_instance_offsets[i]);
+        }
+        std::memset(frame.draw_counts.mapped_data_ptr, 0, sizeof(uint32_t) * frame.command_count);
+
+        struct CullData
+        {
+            glm::vec4 frustum_planes[6];
+            uint32_t  object_count;
+        };
+
+        CullData                 cull_data;
+        std::array<glm::vec4, 6> planes = frustum.GetPlaneEquations();
+        std::copy(planes.begin(), planes.end(), cull_data.frustum_planes);
+        cull_data.object_count = cull_object_count;
+
+        m_cull_material->PopulateUniformBuffer("cullData", &cull_data, sizeof(cull_data), frame_index);
+
+        m_cull_material->BindPipeline(command_buffer);
+        m_cull_material->BindDescriptorSetToPipeline(command_buffer, 0, 1, 0, false, frame_index);
+        command_buffer.dispatch((cull_object_count + k_group_size - 1) / k_group_size, 1, 1);
+
+        // indirect commands, instance indices and validation on the host all wait for culling
+        vk::MemoryBarrier memory_barrier(vk::AccessFlagBits::eShaderWrite,
+                                         vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eShaderRead |
+                                             vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eHostRead);
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                                       vk::PipelineStageFlagBits::eDrawIndirect |
+                                           vk::PipelineStageFlagBits::eVertexShader |
+                                           vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eHost,
+                                       {},
+                                       memory_barrier,
+                                       nullptr,
+                                       nullptr);
+
+        if (m_validation_enabled)
+            RecordValidation(command_buffer, frame_index, first_instance, level, shading_model, frustum);
+    }
+
+    uint32_t GPUCuller::Draw(const vk::raii::CommandBuffer& command_buffer,
+                             RenderStateCache&              state_cache,
+                             uint32_t                       frame_index) const
+    {
+        FUNCTION_TIMER();
+
+        const FrameData& frame = m_frames[frame_index];
+        if (m_cull_objects.empty())
+            return 0;
+
+        // meshes own their vertex and index buffers, so each one is an indirect draw of its own, skipped by the GPU
+        // when its count is 0
+        for (uint32_t i = 0; i < frame.command_count; ++i)
+        {
+            ModelMesh* mesh = m_meshes[i];
+            if (state_cache.SetMesh(mesh))
+                mesh->BindOnly(command_buffer);
+
+            command_buffer.drawIndexedIndirectCountKHR(*frame.draw_commands.buffer->buffer,
+                                                       sizeof(vk::DrawIndexedIndirectCommand) * i,
+                                                       *frame.draw_counts.buffer->buffer,
+                                                       sizeof(uint32_t) * i,
+                                                       1,
+                                                       sizeof(vk::DrawIndexedIndirectCommand));
+        }
+
+        return frame.command_count;
+    }
+
+    void GPUCuller::RefreshRenderables(Level& level, ShadingModelType shading_model)
+    {
+        FUNCTION_TIMER();
+
+        m_renderables.clear();
+        level.GatherRenderables(shading_model, m_renderables);
+
+        m_cull_objects.clear();
+        m_meshes.clear();
+
+        m_command_indices.clear();
+        std::vector<uint32_t> instance_counts;
+        for (const VisibleObject& renderable : m_renderables)
+        {
+            if (!renderable.model)
+                continue;
+
+            // whole models are culled, same as the CPU culler
+            const BoundingBox& bounding = renderable.model->GetBounding();
+            for (ModelMesh* mesh : renderable.model->meshes)
+            {
+                if (!mesh->index_buffer_ptr)
+                    continue;
+
+                auto [it, inserted] = m_command_indices.try_emplace(mesh, static_cast<uint32_t>(m_meshes.size()));
+                if (inserted)
+                {
+                    m_meshes.push_back(mesh);
+                    instance_counts.push_back(0);
+                }
+                ++instance_counts[it->second];
+
+                m_cull_objects.push_back({glm::vec4(bounding.min, 1.0f),
+                                          glm::vec4(bounding.max, 1.0f),
+                                          renderable.handle.index,
+                                          it->second,
+                                          {0, 0}});
+            }
+        }
+
+        // every mesh gets room for all of its instances, so that the shader never writes out of its range
+        m_mesh_instance_offsets.resize(m_meshes.size());
+        m_instance_capacity = 0;
+        for (uint32_t i = 0; i < m_meshes.size(); ++i)
+        {
+            m_mesh_instance_offsets[i] = m_instance_capacity;
+            m_instance_capacity += instance_counts[i];
+        }
+
+        m_renderable_version = level.GetRenderableVersion();
+    }
+
+    void GPUCuller::Reserve(MappedBuffer&        mapped_buffer,
+                            uint32_t             count,
+                            uint32_t             element_size,
+                            vk::BufferUsageFlags usage,
+                            const char*          binding_name,
+                            uint32_t             frame_index)
+    {
+        if (count <= mapped_buffer.capacity)
+            return;
+
+        const vk::raii::PhysicalDevice& physical_device = g_runtime_context.render_system->GetPhysicalDevice();
+        const vk::raii::Device&         logical_device  = g_runtime_context.render_system->GetLogicalDevice();
+
+        uint32_t new_capacity = std::max(mapped_buffer.capacity * 2, count);
+
+        // only the command buffer of this slot reads the old buffer, and Dispatch() runs after its fence was waited
+        // for, so it is freed at once
+        mapped_buffer.buffer = std::make_unique<BufferData>(physical_device,
+                                                            logical_device,
+                                                            static_cast<vk::DeviceSize>(element_size) * new_capacity,
+                                                            usage,
+                                                            vk::MemoryPropertyFlagBits::eHostVisible |
+                                                                vk::MemoryPropertyFlagBits::eHostCoherent);
+        mapped_buffer.mapped_data_ptr = mapped_buffer.buffer->memory.GetMappedData();
+        mapped_buffer.capacity        = new_capacity;
+
+        if (binding_name)
+        {
+            m_cull_material->BindBufferToDescriptorSet(
+                binding_name, mapped_buffer.buffer->buffer, VK_WHOLE_SIZE, nullptr, frame_index);
+        }
+    }
+
+    void GPUCuller::RecordValidation(const vk::raii::CommandBuffer& command_buffer,
+                                     uint32_t                       frame_index,
+                                     uint32_t                       first_instance,
+                                     Level&                         level,
+                                     ShadingModelType               shading_model,
+                                     const Frustum&                 frustum)
+    {
+        FUNCTION_TIMER();
+
+        FrameData& frame = m_frames[frame_index];
+
+        // the instance buffer may be replaced by a larger one later in the frame, so the indices are copied out
+        Reserve(frame.visible_indices,
+                m_instance_capacity,
+                sizeof(uint32_t),
+                vk::BufferUsageFlagBits::eTransferDst,
+                nullptr,
+                frame_index);
+
+        const ObjectDataBuffer& object_data_buffer = g_runtime_context.render_system->GetObjectDataBuffer();
+        vk::BufferCopy          region(sizeof(uint32_t) * first_instance, 0, sizeof(uint32_t) * m_instance_capacity);
+        command_buffer.copyBuffer(
+            *object_data_buffer.GetInstanceBuffer(frame_index), *frame.visible_indices.buffer->buffer, region);
+
+        vk::MemoryBarrier readback_barrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead);
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                       vk::PipelineStageFlagBits::eHost,
+                                       {},
+                                       readback_barrier,
+                                       nullptr,
+                                       nullptr);
+
+        // meshes and their ranges may change before the slot is reused
+        frame.instance_offsets  = m_mesh_instance_offsets;
+        frame.instance_capacity = m_instance_capacity;
+
+        // the CPU culler tests the same model bounds against the same frustum
+        m_cpu_visibles.clear();
+        level.CullVisibles(frustum, shading_model, m_cpu_visibles);
+
+        frame.expected_visibles.clear();
+        for (const VisibleObject& visible : m_cpu_visibles)
+        {
+            if (!visible.model)
+                continue;
+
+            for (ModelMesh* mesh : visible.model->meshes)
+            {
+                if (!mesh->index_buffer_ptr)
+                    continue;
+
+                // a mesh without a draw command makes the comparison fail, as it should
+                auto     it            = m_command_indices.find(mesh);
+                uint32_t command_index = it != m_command_indices.end() ? it->second : k_no_command;
+                frame.expected_visibles.push_back(MakeVisibleKey(visible.handle.index, command_index));
+            }
+        }
+        std::sort(frame.expected_visibles.begin(), frame.expected_visibles.end());
+
+        frame.has_results = true;
+    }
+
+    void GPUCuller::ValidateResults(const FrameData& frame) const
+    {
+        FUNCTION_TIMER();
+
+        const auto* draw_commands =
+            reinterpret_cast<const vk::DrawIndexedIndirectCommand*>(frame.draw_commands.mapped_data_ptr);
+        const auto* object_indices = reinterpret_cast<const uint32_t*>(frame.visible_indices.mapped_data_ptr);
+
+        std::vector<uint64_t> visibles;
+        for (uint32_t i = 0; i < frame.command_count; ++i)
+        {
+            uint32_t begin = frame.instance_offsets[i];
+            uint32_t end   = i + 1 < frame.command_count ? frame.instance_offsets[i + 1] : frame.instance_capacity;
+
+            uint32_t instance_count = draw_commands[i].instanceCount;
+            if (instance_count > end - begin)
+            {
+                MEOW_WARN(
+                    "GPU culling counted {} instances of mesh {}, which only has {}.", instance_count, i, end - begin);
+                instance_count = end - begin;
+            }
+
+            for (uint32_t k = begin; k < begin + instance_count; ++k)
+            {
+                visibles.push_back(MakeVisibleKey(object_indices[k], i));
+            }
+        }
+        std::sort(visibles.begin(), visibles.end());
+
+        if (visibles == frame.expected_visibles)
+            return;
+
+        std::vector<uint64_t> missing;
+        std::vector<uint64_t> extra;
+        std::set_difference(frame.expected_visibles.begin(),
+                            frame.expected_visibles.end(),
+                            visibles.begin(),
+                            visibles.end(),
+                            std::back_inserter(missing));
+        std::set_difference(visibles.begin(),
+                            visibles.end(),
+                            frame.expected_visibles.begin(),
+                            frame.expected_visibles.end(),
+                            std::back_inserter(extra));
+
+        MEOW_WARN("GPU culling found {} visible instances, CPU culling {}: {} missing, {} extra, e.g. object {}.",
+                  visibles.size(),
+                  frame.expected_visibles.size(),
+                  missing.size(),
+                  extra.size(),
+                  static_cast<uint32_t>((missing.empty() ? extra.front() : missing.front()) >> 32));
+    }
+} // namespace Meow
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "core/math/frustum.h"
+#include "function/level/level.h"
+#include "function/render/batch/render_state_cache.h"
+#include "function/render/buffer_data/buffer_data.h"
+#include "function/render/material/material.h"
+#include "function/render/model/model_mesh.h"
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Frustum culling of one shading model on the GPU, feeding one indirect draw per mesh.
+     *
+     * Every mesh of every renderable object is uploaded as a cull object holding model space bounds and the element
+     * of the object in ObjectDataBuffer. Cull objects are only uploaded again when Level::GetRenderableVersion
+     * changes, so moving objects cost nothing more than their object data. A compute shader transforms the bounds by
+     * the model matrix, tests them against the frustum, and appends the object index of each visible one to the
+     * instance range reserved for its mesh, counting instances in the VkDrawIndexedIndirectCommand of the mesh. Meshes
+     * left without instances write a draw count of 0, so that drawIndexedIndirectCount skips them.
+     *
+     * Buffers are host visible like ObjectDataBuffer. With validation enabled, the object indices written by the
+     * shader are copied to a readback buffer after the dispatch, and compared with Level::CullVisibles for the same
+     * frustum once the frame slot is reused.
+     */
+    class GPUCuller
+    {
+    public:
+        // local_size_x of gpu_cull.comp
+        static constexpr uint32_t k_group_size = 64;
+
+        GPUCuller(uint32_t frame_count);
+
+        GPUCuller(GPUCuller&& rhs) noexcept            = default;
+        GPUCuller& operator=(GPUCuller&& rhs) noexcept = default;
+
+        /**
+         * @brief Upload renderables if they changed, update their object data, reset draw commands and record the
+         * culling dispatch, followed by a barrier for indirect draws. Call it outside render passes, after the fence
+         * of the frame slot has been waited for.
+         */
+        void Dispatch(const vk::raii::CommandBuffer& command_buffer,
+                      uint32_t                       frame_index,
+                      Level&                         level,
+                      ShadingModelType               shading_model,
+                      const Frustum&                 frustum);
+
+        /**
+         * @brief Draw every mesh with its visible instances, with pipeline and descriptor sets already bound. Returns
+         * the number of indirect draws.
+         */
+        uint32_t
+        Draw(const vk::raii::CommandBuffer& command_buffer, RenderStateCache& state_cache, uint32_t frame_index) const;
+
+        /**
+         * @brief Compare the visible objects of each mesh with those of the CPU culler, and warn if they differ.
+         */
+        void SetValidationEnabled(bool enabled) { m_validation_enabled = enabled; }
+
+    private:
+        static constexpr uint64_t k_no_version = std::numeric_limits<uint64_t>::max();
+
+        /**
+         * @brief Layout of CullObject in gpu_cull.comp (std430).
+         */
+        struct CullObject
+        {
+            glm::vec4 bounds_min;
+            glm::vec4 bounds_max;
+            uint32_t  object_index;
+            uint32_t  command_index;
+            uint32_t  padding[2];
+        };
+
+        struct MappedBuffer
+        {
+            std::unique_ptr<BufferData> buffer;
+            uint8_t*                    mapped_data_ptr = nullptr;
+            uint32_t                    capacity        = 0;
+        };
+
+        struct FrameData
+        {
+            MappedBuffer cull_objects;
+            MappedBuffer draw_commands;
+            MappedBuffer draw_counts;
+            uint64_t     cull_object_version = k_no_version;
+
+            // for validation, from the last dispatch of this slot
+            MappedBuffer          visible_indices;
+            std::vector<uint32_t> instance_offsets;
+            uint32_t              instance_capacity = 0;
+            std::vector<uint64_t> expected_visibles;
+            uint32_t              command_count = 0;
+            bool                  has_results   = false;
+        };
+
+        void RefreshRenderables(Level& level, ShadingModelType shading_model);
+
+        /**
+         * @brief Make room for count elements, and bind the buffer again if it is replaced and has a binding name.
+         */
+        void Reserve(MappedBuffer&        mapped_buffer,
+                     uint32_t             count,
+                     uint32_t             element_size,
+                     vk::BufferUsageFlags usage,
+                     const char*          binding_name,
+                     uint32_t             frame_index);
+
+        /**
+         * @brief Copy the object indices written by the dispatch into the readback buffer, and remember which
+         * objects the CPU culler finds visible.
+         */
+        void RecordValidation(const vk::raii::CommandBuffer& command_buffer,
+                              uint32_t                       frame_index,
+                              uint32_t                       first_instance,
+                              Level&                         level,
+                              ShadingModelType               shading_model,
+                              const Frustum&                 frustum);
+
+        void ValidateResults(const FrameData& frame) const;
+
+        std::shared_ptr<Material> m_cull_material = nullptr;
+        std::vector<FrameData>    m_frames;
+
+        std::vector<VisibleObject> m_renderables;
+        uint64_t                   m_renderable_version = k_no_version;
+        std::vector<CullObject>    m_cull_objects;
+
+        // one draw command per mesh, whose instances start at the offset inside the reserved instance range
+        std::vector<ModelMesh*>                  m_meshes;
+        std::unordered_map<ModelMesh*, uint32_t> m_command_indices;
+        std::vector<uint32_t>                    m_mesh_instance_offsets;
+        uint32_t                                 m_instance_capacity = 0;
+
+        std::vector<VisibleObject> m_cpu_visibles;
+
+        bool m_validation_enabled = false;
+    };
+} // namespace Meow
@@ -0,0 +1,59 @@
+#include "instance_batcher.h"
+
+#include "pch.h"
+
+#include "function/global/runtime_context.h"
+
+namespace Meow
+{
+    void InstanceBatcher::Build(const std::vector<VisibleObject>& visibles, uint32_t frame_index, const SortView& view)
+    {
+        FUNCTION_TIMER();
+
+        ObjectDataBuffer& object_data_buffer = g_runtime_context.render_system->GetObjectDataBuffer();
+
+        m_visible_object_indices.resize(visibles.size());
+        m_object_indices.clear();
+        m_draws.clear();
+
+        for (uint32_t i = 0; i < visibles.size(); ++i)
+        {
+            const VisibleObject& visible = visibles[i];
+            if (!visible.model)
+                continue;
+
+            m_visible_object_indices[i] =
+                object_data_buffer.Update(frame_index, visible.handle, visible.transform_stamp, visible.transform);
+        }
+
+        m_queue.Clear();
+        m_queue.PushVisibles(visibles, 0, SortOrder::FrontToBack, view);
+        m_queue.Sort();
+
+        const std::vector<RenderItem>& items = m_queue.GetItems();
+        if (items.empty())
+            return;
+
+        // items are sorted by state first, so every run of the same mesh and material becomes one draw
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            const RenderItem& item = items[i];
+
+            bool new_group = i == 0 || item.mesh != items[i - 1].mesh ||
+                             RenderQueue::GetStateBits(item.sort_key) !=
+                                 RenderQueue::GetStateBits(items[i - 1].sort_key);
+            if (new_group)
+                m_draws.push_back({item.mesh, static_cast<uint32_t>(i), 0});
+
+            m_object_indices.push_back(m_visible_object_indices[item.visible_index]);
+            ++m_draws.back().instance_count;
+        }
+
+        uint32_t first_instance = object_data_buffer.AppendInstances(
+            frame_index, m_object_indices.data(), static_cast<uint32_t>(m_object_indices.size()));
+        for (auto& draw : m_draws)
+        {
+            draw.first_instance += first_instance;
+        }
+    }
+} // namespace Meow
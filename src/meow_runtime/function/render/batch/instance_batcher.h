@@ -0,0 +1,49 @@
+#pragma once
+
+#include "function/level/level.h"
+#include "function/render/model/model_mesh.h"
+#include "render_queue.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief One instanced draw of a mesh, covering a range of the instance buffer of ObjectDataBuffer.
+     */
+    struct InstancedDraw
+    {
+        ModelMesh* mesh           = nullptr;
+        uint32_t   first_instance = 0;
+        uint32_t   instance_count = 0;
+    };
+
+    /**
+     * @brief Groups visible objects of a pass by mesh and material, so that draw count scales with unique meshes
+     * instead of objects.
+     *
+     * Object data of every visible object is written to ObjectDataBuffer, the object indices of each group are
+     * appended to its instance buffer, and one InstancedDraw is built per group. Groups come from a front to back
+     * RenderQueue, so draws are ordered by state and instances inside a draw by depth. Order inside the pass is not
+     * kept, so it only suits passes that do not depend on draw order.
+     */
+    class InstanceBatcher
+    {
+    public:
+        void Build(const std::vector<VisibleObject>& visibles, uint32_t frame_index, const SortView& view = {});
+
+        const std::vector<InstancedDraw>& GetDraws() const { return m_draws; }
+
+        /**
+         * @brief Number of instances in the last build, which is the draw count without batching.
+         */
+        uint32_t GetInstanceCount() const { return static_cast<uint32_t>(m_object_indices.size()); }
+
+    private:
+        RenderQueue                m_queue;
+        std::vector<uint32_t>      m_visible_object_indices;
+        std::vector<uint32_t>      m_object_indices;
+        std::vector<InstancedDraw> m_draws;
+    };
+} // namespace Meow
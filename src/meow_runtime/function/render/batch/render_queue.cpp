@@ -0,0 +1,85 @@
+#include "render_queue.h"
+
+#include "pch.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Meow
+{
+    namespace
+    {
+        constexpr uint32_t k_radix_bits = 8;
+        constexpr uint32_t k_radix_size = 1u << k_radix_bits;
+        constexpr uint64_t k_radix_mask = k_radix_size - 1;
+
+        constexpr uint64_t Mask(uint32_t bits) { return (1ull << bits) - 1; }
+    } // namespace
+
+    uint64_t RenderQueue::MakeKey(SortOrder order, uint32_t layer, uint32_t material, uint32_t mesh, uint32_t depth)
+    {
+        uint64_t key = layer & Mask(k_layer_bits);
+
+        if (order == SortOrder::FrontToBack)
+        {
+            key = (key << k_material_bits) | (material & Mask(k_material_bits));
+            key = (key << k_mesh_bits) | (mesh & Mask(k_mesh_bits));
+            key = (key << k_depth_bits) | (depth & Mask(k_depth_bits));
+        }
+        else
+        {
+            key = (key << k_depth_bits) | (Mask(k_depth_bits) - (depth & Mask(k_depth_bits)));
+            key = (key << k_material_bits) | (material & Mask(k_material_bits));
+            key = (key << k_mesh_bits) | (mesh & Mask(k_mesh_bits));
+        }
+
+        return key;
+    }
+
+    uint32_t RenderQueue::QuantizeDepth(float depth, float max_depth)
+    {
+        if (max_depth <= 0.0f)
+            return 0;
+
+        float normalized = std::clamp(depth / max_depth, 0.0f, 1.0f);
+        return static_cast<uint32_t>(normalized * static_cast<float>(Mask(k_depth_bits)));
+    }
+
+    void RenderQueue::Sort()
+    {
+        FUNCTION_TIMER();
+
+        if (m_items.size() < 2)
+            return;
+
+        m_scratch_items.resize(m_items.size());
+
+        for (uint32_t shift = 0; shift < 64; shift += k_radix_bits)
+        {
+            std::array<uint32_t, k_radix_size> offsets {};
+            for (const RenderItem& item : m_items)
+            {
+                ++offsets[(item.sort_key >> shift) & k_radix_mask];
+            }
+
+            // fields like layer and material are often equal for the whole queue, then this digit moves nothing
+            if (offsets[(m_items[0].sort_key >> shift) & k_radix_mask] == m_items.size())
+                continue;
+
+            uint32_t offset = 0;
+            for (uint32_t& count : offsets)
+            {
+                uint32_t bucket_count = count;
+                count                 = offset;
+                offset += bucket_count;
+            }
+
+            for (const RenderItem& item : m_items)
+            {
+                m_scratch_items[offsets[(item.sort_key >> shift) & k_radix_mask]++] = item;
+            }
+
+            std::swap(m_items, m_scratch_items);
+        }
+    }
+} // namespace Meow
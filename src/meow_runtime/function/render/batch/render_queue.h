@@ -0,0 +1,93 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Meow
+{
+    struct ModelMesh;
+    struct VisibleObject;
+
+    /**
+     * @brief Camera used to compute sort depth. A zero forward puts every item at depth 0, so items are only sorted
+     * by state, e.g. in shadow passes.
+     */
+    struct SortView
+    {
+        glm::vec3 position  = glm::vec3(0.0f);
+        glm::vec3 forward   = glm::vec3(0.0f);
+        float     max_depth = 1.0f;
+    };
+
+    enum class SortOrder : uint8_t
+    {
+        FrontToBack,
+        BackToFront,
+    };
+
+    /**
+     * @brief One mesh to draw. visible_index points into the visible list the queue is built from.
+     */
+    struct RenderItem
+    {
+        uint64_t   sort_key      = 0;
+        ModelMesh* mesh          = nullptr;
+        uint32_t   visible_index = 0;
+    };
+
+    /**
+     * @brief Draw list of a pass ordered by 64-bit sort keys, which are sorted by LSD radix sort.
+     *
+     * Front to back keys are layer | material | mesh | depth, so draws sharing state are adjacent and each run is
+     * ordered front to back. Back to front keys are layer | inverted depth | material | mesh, which is the order
+     * translucent objects need. Materials own their pipeline here, so the material field also orders pipelines.
+     */
+    class RenderQueue
+    {
+    public:
+        static constexpr uint32_t k_layer_bits    = 4;
+        static constexpr uint32_t k_material_bits = 16;
+        static constexpr uint32_t k_mesh_bits     = 20;
+        static constexpr uint32_t k_depth_bits    = 24;
+
+        static uint64_t MakeKey(SortOrder order, uint32_t layer, uint32_t material, uint32_t mesh, uint32_t depth);
+
+        /**
+         * @brief Map view depth in [0, max_depth] to the depth field of a key.
+         */
+        static uint32_t QuantizeDepth(float depth, float max_depth);
+
+        /**
+         * @brief Key without depth, which is equal for front to back items drawn with the same state.
+         */
+        static uint64_t GetStateBits(uint64_t front_to_back_key) { return front_to_back_key >> k_depth_bits; }
+
+        void Clear() { m_items.clear(); }
+
+        void Push(uint64_t sort_key, ModelMesh* mesh, uint32_t visible_index)
+        {
+            m_items.push_back({sort_key, mesh, visible_index});
+        }
+
+        /**
+         * @brief Push every mesh of the visible objects, with keys of the given order.
+         */
+        void PushVisibles(const std::vector<VisibleObject>& visibles,
+                          uint32_t                          layer,
+                          SortOrder                         order,
+                          const SortView&                   view);
+
+        /**
+         * @brief Stable, so items with equal keys keep the order they were pushed in.
+         */
+        void Sort();
+
+        const std::vector<RenderItem>& GetItems() const { return m_items; }
+
+    private:
+        std::vector<RenderItem> m_items;
+        std::vector<RenderItem> m_scratch_items;
+    };
+} // namespace Meow
@@ -0,0 +1,47 @@
+#include "render_queue.h"
+
+#include "pch.h"
+
+#include "function/global/runtime_context.h"
+#include "function/level/level.h"
+#include "function/render/model/model_mesh.h"
+
+// apart from keys and sorting, which don't depend on levels or resources and are unit tested alone
+namespace Meow
+{
+    void RenderQueue::PushVisibles(const std::vector<VisibleObject>& visibles,
+                                   uint32_t                          layer,
+                                   SortOrder                         order,
+                                   const SortView&                   view)
+    {
+        FUNCTION_TIMER();
+
+        // visibles of a pass mostly share one material, so only look up its handle when it changes
+        bool     has_material        = false;
+        UUID     last_material_id    = UUID(0);
+        uint32_t last_material_index = 0;
+
+        for (uint32_t i = 0; i < visibles.size(); ++i)
+        {
+            const VisibleObject& visible = visibles[i];
+            if (!visible.model)
+                continue;
+
+            if (!has_material || visible.material_id != last_material_id)
+            {
+                has_material     = true;
+                last_material_id = visible.material_id;
+                last_material_index =
+                    g_runtime_context.resource_system->GetHandle<Material>(visible.material_id).GetIndex();
+            }
+
+            float    view_depth = glm::dot(glm::vec3(visible.transform[3]) - view.position, view.forward);
+            uint32_t depth      = QuantizeDepth(view_depth, view.max_depth);
+
+            for (ModelMesh* mesh : visible.model->meshes)
+            {
+                Push(MakeKey(order, layer, last_material_index, mesh->sort_id, depth), mesh, i);
+            }
+        }
+    }
+} // namespace Meow
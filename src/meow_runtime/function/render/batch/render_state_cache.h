@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Meow
+{
+    struct ModelMesh;
+
+    /**
+     * @brief State last bound while recording a render pass, so that binds of the same pipeline, descriptor sets or
+     * mesh buffers can be skipped. Each Set* function returns true if the bind has to be recorded.
+     *
+     * It is reset when a render pass starts, since nothing bound before is assumed to still be valid.
+     */
+    class RenderStateCache
+    {
+    public:
+        static constexpr uint32_t k_max_descriptor_sets = 8;
+
+        void Reset() { *this = RenderStateCache(); }
+
+        bool SetPipeline(vk::Pipeline pipeline)
+        {
+            if (m_pipeline == pipeline)
+                return false;
+
+            m_pipeline = pipeline;
+            return true;
+        }
+
+        bool SetDescriptorSets(vk::PipelineLayout                    pipeline_layout,
+                               uint32_t                              first_set,
+                               const std::vector<vk::DescriptorSet>& descriptor_sets,
+                               const std::vector<uint32_t>&          dynamic_offsets)
+        {
+            if (first_set + descriptor_sets.size() > k_max_descriptor_sets)
+                return true;
+
+            // sets bound with another layout may be disturbed, so forget all of them
+            if (m_pipeline_layout != pipeline_layout)
+            {
+                m_pipeline_layout = pipeline_layout;
+                m_descriptor_sets.fill(nullptr);
+                m_bind_set_counts.fill(0);
+            }
+
+            uint32_t set_count = static_cast<uint32_t>(descriptor_sets.size());
+
+            bool changed =
+                m_bind_set_counts[first_set] != set_count || m_dynamic_offsets[first_set] != dynamic_offsets;
+            for (uint32_t i = 0; i < set_count; ++i)
+            {
+                changed |= m_descriptor_sets[first_set + i] != descriptor_sets[i];
+            }
+
+            if (!changed)
+                return false;
+
+            // dynamic offsets are recorded per bind call, so forget every earlier call overlapping this one
+            for (uint32_t i = 0; i < first_set + set_count; ++i)
+            {
+                if (i + m_bind_set_counts[i] > first_set)
+                    m_bind_set_counts[i] = 0;
+            }
+
+            for (uint32_t i = 0; i < set_count; ++i)
+            {
+                m_descriptor_sets[first_set + i] = descriptor_sets[i];
+            }
+            m_bind_set_counts[first_set] = set_count;
+            m_dynamic_offsets[first_set] = dynamic_offsets;
+            return true;
+        }
+
+        bool SetMesh(const ModelMesh* mesh)
+        {
+            if (m_mesh == mesh)
+                return false;
+
+            m_mesh = mesh;
+            return true;
+        }
+
+    private:
+        vk::Pipeline       m_pipeline        = nullptr;
+        vk::PipelineLayout m_pipeline_layout = nullptr;
+
+        std::array<vk::DescriptorSet, k_max_descriptor_sets>     m_descriptor_sets {};
+        std::array<std::vector<uint32_t>, k_max_descriptor_sets> m_dynamic_offsets {};
+        std::array<uint32_t, k_max_descriptor_sets>              m_bind_set_counts {};
+
+        const ModelMesh* m_mesh = nullptr;
+    };
+} // namespace Meow
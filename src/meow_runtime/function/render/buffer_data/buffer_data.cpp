@@ -15,13 +15,13 @@ namespace Meow
         , usage_flags(usage)
         , property_flags(property_flags)
     {
-        device_memory = AllocateDeviceMemory(
-            logical_device, physical_device.getMemoryProperties(), buffer.getMemoryRequirements(), property_flags);
-        buffer.bindMemory(*device_memory, 0);
+        memory = AllocateResourceMemory(
+            physical_device, logical_device, buffer.getMemoryRequirements(), property_flags, ResourceTiling::Linear);
+        buffer.bindMemory(memory.GetMemory(), memory.GetOffset());
     }
 
     BufferData::BufferData(BufferData&& rhs)
-        : device_memory(std::exchange(rhs.device_memory, nullptr))
+        : memory(std::move(rhs.memory))
         , buffer(std::exchange(rhs.buffer, nullptr))
         , device_size(rhs.device_size)
         , usage_flags(rhs.usage_flags)
@@ -34,7 +34,7 @@ namespace Meow
         {
             clear();
 
-            device_memory  = std::exchange(rhs.device_memory, nullptr);
+            memory         = std::move(rhs.memory);
             buffer         = std::exchange(rhs.buffer, nullptr);
             device_size    = rhs.device_size;
             usage_flags    = rhs.usage_flags;
@@ -45,8 +45,8 @@ namespace Meow
 
     void BufferData::clear()
     {
-        device_memory = nullptr;
-        buffer        = nullptr;
+        buffer = nullptr;
+        memory.Free();
     }
 
     void BufferData::SetDebugName(const std::string& debug_name)
@@ -63,10 +63,12 @@ namespace Meow
             logical_device.setDebugUtilsObjectNameEXT(name_info);
         }
 
+        // blocks of device memory are shared by many buffers, so only dedicated memory is named
+        if (memory.IsDedicated())
         {
             vk::DebugUtilsObjectNameInfoEXT name_info = {
                 vk::ObjectType::eDeviceMemory,
-                NON_DISPATCHABLE_HANDLE_TO_UINT64_CAST(VkDeviceMemory, *device_memory),
+                NON_DISPATCHABLE_HANDLE_TO_UINT64_CAST(VkDeviceMemory, memory.GetMemory()),
                 debug_name.c_str()};
             logical_device.setDebugUtilsObjectNameEXT(name_info);
         }
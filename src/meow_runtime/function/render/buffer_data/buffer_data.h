@@ -1,16 +1,19 @@
 #pragma once
 
 #include "core/base/non_copyable.h"
+#include "function/render/allocator/device_memory_allocator.h"
+#include "function/render/upload/upload_manager.h"
 #include "function/render/utils/vulkan_initialization_utils.hpp"
 
 namespace Meow
 {
     struct BufferData : public NonCopyable
     {
-        // the DeviceMemory should be destroyed before the Buffer it is bound to; to get that order with the
-        // standard destructor of the BufferData, the order of DeviceMemory and Buffer here matters
-        vk::raii::DeviceMemory device_memory = nullptr;
-        vk::raii::Buffer       buffer        = nullptr;
+        // the range of memory may be given to another resource once it is freed, so it should be freed after the
+        // Buffer bound to it is destroyed; with the standard destructor of the BufferData, that order comes from
+        // the order of memory and Buffer here
+        DeviceMemoryAllocation memory;
+        vk::raii::Buffer       buffer = nullptr;
 
         vk::DeviceSize          device_size;
         vk::BufferUsageFlags    usage_flags;
@@ -43,9 +46,7 @@ namespace Meow
                    (property_flags & vk::MemoryPropertyFlagBits::eHostVisible));
             assert(sizeof(DataType) <= device_size);
 
-            void* data_ptr = device_memory.mapMemory(0, sizeof(DataType));
-            memcpy(data_ptr, &data, sizeof(DataType));
-            device_memory.unmapMemory();
+            memcpy(memory.GetMappedData(), &data, sizeof(DataType));
         }
 
         template<typename DataType>
@@ -56,16 +57,15 @@ namespace Meow
             size_t element_size = stride ? stride : sizeof(DataType);
             assert(sizeof(DataType) <= element_size);
 
-            CopyToDevice(device_memory, data.data(), data.size(), element_size);
+            CopyToDevice(memory.GetMappedData(), data.data(), data.size(), element_size);
         }
 
+        /**
+         * @brief Copy data into device local memory through a staging ring, without waiting for the copy. The buffer
+         * should outlive the returned ticket.
+         */
         template<typename DataType>
-        void Upload(vk::raii::PhysicalDevice const& physical_device,
-                    vk::raii::Device const&         logical_device,
-                    vk::raii::CommandPool const&    command_pool,
-                    vk::raii::Queue const&          queue,
-                    std::vector<DataType> const&    data,
-                    size_t                          stride)
+        UploadTicket Upload(UploadManager& upload_manager, std::vector<DataType> const& data, size_t stride)
         {
             if (!(usage_flags & vk::BufferUsageFlagBits::eTransferDst))
             {
@@ -82,12 +82,7 @@ namespace Meow
             size_t dataSize = data_number * element_size;
             assert(dataSize <= device_size);
 
-            BufferData staging_buffer(physical_device, logical_device, dataSize, vk::BufferUsageFlagBits::eTransferSrc);
-            CopyToDevice(staging_buffer.device_memory, data.data(), data.size(), element_size);
-
-            OneTimeSubmit(logical_device, command_pool, queue, [&](vk::raii::CommandBuffer const& command_buffer) {
-                command_buffer.copyBuffer(*staging_buffer.buffer, *this->buffer, vk::BufferCopy(0, 0, dataSize));
-            });
+            return upload_manager.UploadBuffer(*buffer, data.data(), data.size(), sizeof(DataType), element_size);
         }
 
         void SetDebugName(const std::string& debug_name);
@@ -135,9 +135,7 @@ namespace Meow
 
         const vk::raii::PhysicalDevice& physical_device = g_runtime_context.render_system->GetPhysicalDevice();
         const vk::raii::Device&         logical_device  = g_runtime_context.render_system->GetLogicalDevice();
-        const vk::raii::CommandPool&    onetime_submit_command_pool =
-            g_runtime_context.render_system->GetOneTimeSubmitCommandPool();
-        const vk::raii::Queue& graphics_queue = g_runtime_context.render_system->GetGraphicsQueue();
+        UploadManager&                  upload_manager  = g_runtime_context.render_system->GetUploadManager();
 
         auto image_data_ptr = std::make_shared<ImageData>(nullptr);
 
@@ -176,8 +174,6 @@ namespace Meow
         if (image_data_ptr->need_staging)
         {
             assert((format_properties.optimalTilingFeatures & format_feature_flags) == format_feature_flags);
-            image_data_ptr->staging_buffer_data = BufferData(
-                physical_device, logical_device, image_data_ptr->size, vk::BufferUsageFlagBits::eTransferSrc);
             image_tiling = vk::ImageTiling::eOptimal;
             usage_flags |= vk::ImageUsageFlagBits::eTransferDst;
             initial_layout = vk::ImageLayout::eUndefined;
@@ -205,67 +201,44 @@ namespace Meow
                                               initial_layout);
         image_data_ptr->image = vk::raii::Image(logical_device, image_create_info);
 
-        image_data_ptr->device_memory = AllocateDeviceMemory(logical_device,
-                                                             physical_device.getMemoryProperties(),
-                                                             image_data_ptr->image.getMemoryRequirements(),
-                                                             requirements);
-        image_data_ptr->image.bindMemory(*image_data_ptr->device_memory, 0);
+        image_data_ptr->memory = AllocateResourceMemory(
+            physical_device,
+            logical_device,
+            image_data_ptr->image.getMemoryRequirements(),
+            requirements,
+            image_tiling == vk::ImageTiling::eLinear ? ResourceTiling::Linear : ResourceTiling::Optimal);
+        image_data_ptr->image.bindMemory(image_data_ptr->memory.GetMemory(), image_data_ptr->memory.GetOffset());
         image_data_ptr->image_view = vk::raii::ImageView(
             logical_device,
             vk::ImageViewCreateInfo(
                 {}, *image_data_ptr->image, vk::ImageViewType::e2D, format, {}, {aspect_mask, 0, 1, 0, 1}));
 
-        // Read image from file to device memory
-
-        void* data = image_data_ptr->need_staging ?
-                         image_data_ptr->staging_buffer_data.device_memory.mapMemory(
-                             0, image_data_ptr->staging_buffer_data.buffer.getMemoryRequirements().size) :
-                         image_data_ptr->device_memory.mapMemory(0, image_data_ptr->image.getMemoryRequirements().size);
-
-        if (g_runtime_context.file_system->ReadImageRGBA(file_path, static_cast<uint8_t*>(data)) == 0)
-            return nullptr;
+        // Read image from file, into the staging ring or directly into device memory
 
-        image_data_ptr->need_staging ? image_data_ptr->staging_buffer_data.device_memory.unmapMemory() :
-                                       image_data_ptr->device_memory.unmapMemory();
+        if (image_data_ptr->need_staging)
+        {
+            std::vector<uint8_t> pixels(image_data_ptr->size);
+            if (g_runtime_context.file_system->ReadImageRGBA(file_path, pixels.data()) == 0)
+                return nullptr;
 
-        // Transit Layout
+            vk::BufferImageCopy copy_region(0,
+                                            image_data_ptr->extent.width,
+                                            image_data_ptr->extent.height,
+                                            vk::ImageSubresourceLayers(aspect_mask, 0, 0, 1),
+                                            vk::Offset3D(0, 0, 0),
+                                            vk::Extent3D(image_data_ptr->extent, 1));
+            image_data_ptr->upload_ticket = upload_manager.UploadImage(
+                *image_data_ptr, pixels.data(), pixels.size(), {copy_region}, {aspect_mask, 0, 1, 0, 1});
+        }
+        else
+        {
+            if (g_runtime_context.file_system->ReadImageRGBA(file_path, image_data_ptr->memory.GetMappedData()) == 0)
+                return nullptr;
 
-        OneTimeSubmit(logical_device,
-                      onetime_submit_command_pool,
-                      graphics_queue,
-                      [&](const vk::raii::CommandBuffer& command_buffer) {
-                          if (image_data_ptr->need_staging)
-                          {
-                              // Since we're going to blit to the texture image, set its layout to eTransferDstOptimal
-                              image_data_ptr->TransitLayout(command_buffer,
-                                                            vk::ImageLayout::eUndefined,
-                                                            vk::ImageLayout::eTransferDstOptimal,
-                                                            {aspect_mask, 0, 1, 0, 1});
-                              vk::BufferImageCopy copy_region(0,
-                                                              image_data_ptr->extent.width,
-                                                              image_data_ptr->extent.height,
-                                                              vk::ImageSubresourceLayers(aspect_mask, 0, 0, 1),
-                                                              vk::Offset3D(0, 0, 0),
-                                                              vk::Extent3D(image_data_ptr->extent, 1));
-                              command_buffer.copyBufferToImage(*image_data_ptr->staging_buffer_data.buffer,
-                                                               *image_data_ptr->image,
-                                                               vk::ImageLayout::eTransferDstOptimal,
-                                                               copy_region);
-                              // Set the layout for the texture image from eTransferDstOptimal to eShaderReadOnlyOptimal
-                              image_data_ptr->TransitLayout(command_buffer,
-                                                            vk::ImageLayout::eTransferDstOptimal,
-                                                            vk::ImageLayout::eShaderReadOnlyOptimal,
-                                                            {aspect_mask, 0, 1, 0, 1});
-                          }
-                          else
-                          {
-                              // If we can use the linear tiled image as a texture, just do it
-                              image_data_ptr->TransitLayout(command_buffer,
-                                                            vk::ImageLayout::ePreinitialized,
-                                                            vk::ImageLayout::eShaderReadOnlyOptimal,
-                                                            {aspect_mask, 0, 1, 0, 1});
-                          }
-                      });
+            // If we can use the linear tiled image as a texture, just do it
+            image_data_ptr->upload_ticket =
+                upload_manager.TransitHostWrittenImage(*image_data_ptr, {aspect_mask, 0, 1, 0, 1});
+        }
 
         return image_data_ptr;
     }
@@ -315,11 +288,13 @@ namespace Meow
                                               initial_layout);
         image_data_ptr->image = vk::raii::Image(logical_device, image_create_info);
 
-        image_data_ptr->device_memory = AllocateDeviceMemory(logical_device,
-                                                             physical_device.getMemoryProperties(),
-                                                             image_data_ptr->image.getMemoryRequirements(),
-                                                             requirements);
-        image_data_ptr->image.bindMemory(*image_data_ptr->device_memory, 0);
+        image_data_ptr->memory = AllocateResourceMemory(
+            physical_device,
+            logical_device,
+            image_data_ptr->image.getMemoryRequirements(),
+            requirements,
+            image_tiling == vk::ImageTiling::eLinear ? ResourceTiling::Linear : ResourceTiling::Optimal);
+        image_data_ptr->image.bindMemory(image_data_ptr->memory.GetMemory(), image_data_ptr->memory.GetOffset());
         image_data_ptr->image_view = vk::raii::ImageView(
             logical_device,
             vk::ImageViewCreateInfo(
@@ -406,11 +381,13 @@ namespace Meow
                                               initial_layout);
         image_data_ptr->image = vk::raii::Image(logical_device, image_create_info);
 
-        image_data_ptr->device_memory = AllocateDeviceMemory(logical_device,
-                                                             physical_device.getMemoryProperties(),
-                                                             image_data_ptr->image.getMemoryRequirements(),
-                                                             requirements);
-        image_data_ptr->image.bindMemory(*image_data_ptr->device_memory, 0);
+        image_data_ptr->memory = AllocateResourceMemory(
+            physical_device,
+            logical_device,
+            image_data_ptr->image.getMemoryRequirements(),
+            requirements,
+            image_tiling == vk::ImageTiling::eLinear ? ResourceTiling::Linear : ResourceTiling::Optimal);
+        image_data_ptr->image.bindMemory(image_data_ptr->memory.GetMemory(), image_data_ptr->memory.GetOffset());
         image_data_ptr->image_view = vk::raii::ImageView(
             logical_device,
             vk::ImageViewCreateInfo(
@@ -447,9 +424,7 @@ namespace Meow
 
         const vk::raii::PhysicalDevice& physical_device = g_runtime_context.render_system->GetPhysicalDevice();
         const vk::raii::Device&         logical_device  = g_runtime_context.render_system->GetLogicalDevice();
-        const vk::raii::CommandPool&    onetime_submit_command_pool =
-            g_runtime_context.render_system->GetOneTimeSubmitCommandPool();
-        const vk::raii::Queue& graphics_queue = g_runtime_context.render_system->GetGraphicsQueue();
+        UploadManager&                  upload_manager  = g_runtime_context.render_system->GetUploadManager();
 
         auto image_data_ptr = std::make_shared<ImageData>(nullptr);
 
@@ -488,11 +463,7 @@ namespace Meow
         if (image_data_ptr->need_staging)
         {
             assert((format_properties.optimalTilingFeatures & format_feature_flags) == format_feature_flags);
-            image_data_ptr->staging_buffer_data = BufferData(physical_device,
-                                                             logical_device,
-                                                             image_data_ptr->size * 6, // cubemap have 6 images
-                                                             vk::BufferUsageFlagBits::eTransferSrc);
-            image_tiling                        = vk::ImageTiling::eOptimal;
+            image_tiling = vk::ImageTiling::eOptimal;
             usage_flags |= vk::ImageUsageFlagBits::eTransferDst;
             initial_layout = vk::ImageLayout::eUndefined;
         }
@@ -519,11 +490,13 @@ namespace Meow
                                               initial_layout);
         image_data_ptr->image = vk::raii::Image(logical_device, image_create_info);
 
-        image_data_ptr->device_memory = AllocateDeviceMemory(logical_device,
-                                                             physical_device.getMemoryProperties(),
-                                                             image_data_ptr->image.getMemoryRequirements(),
-                                                             requirements);
-        image_data_ptr->image.bindMemory(*image_data_ptr->device_memory, 0);
+        image_data_ptr->memory = AllocateResourceMemory(
+            physical_device,
+            logical_device,
+            image_data_ptr->image.getMemoryRequirements(),
+            requirements,
+            image_tiling == vk::ImageTiling::eLinear ? ResourceTiling::Linear : ResourceTiling::Optimal);
+        image_data_ptr->image.bindMemory(image_data_ptr->memory.GetMemory(), image_data_ptr->memory.GetOffset());
         image_data_ptr->image_view =
             vk::raii::ImageView(logical_device,
                                 vk::ImageViewCreateInfo({},
@@ -533,65 +506,43 @@ namespace Meow
                                                         {},
                                                         {aspect_mask, 0, 1, 0, 6})); // cubemap have 6 images
 
-        // Read image from file to device memory
+        // Read image from file, into the staging ring or directly into device memory
 
-        void* data = image_data_ptr->need_staging ?
-                         image_data_ptr->staging_buffer_data.device_memory.mapMemory(
-                             0, image_data_ptr->staging_buffer_data.buffer.getMemoryRequirements().size) :
-                         image_data_ptr->device_memory.mapMemory(0, image_data_ptr->image.getMemoryRequirements().size);
+        std::vector<uint8_t> pixels;
+        uint8_t*             data = image_data_ptr->memory.GetMappedData();
+        if (image_data_ptr->need_staging)
+        {
+            pixels.resize(image_data_ptr->size * 6); // cubemap have 6 images
+            data = pixels.data();
+        }
 
         // cubemap have 6 images
         for (std::size_t i = 0; i < 6; ++i)
         {
-            if (g_runtime_context.file_system->ReadImageFloat(
-                    file_paths[i], static_cast<uint8_t*>(data) + image_data_ptr->size * i) == 0)
+            if (g_runtime_context.file_system->ReadImageFloat(file_paths[i], data + image_data_ptr->size * i) == 0)
                 return nullptr;
         }
 
-        image_data_ptr->need_staging ? image_data_ptr->staging_buffer_data.device_memory.unmapMemory() :
-                                       image_data_ptr->device_memory.unmapMemory();
-
-        // Transit Layout
-
-        OneTimeSubmit(logical_device,
-                      onetime_submit_command_pool,
-                      graphics_queue,
-                      [&](const vk::raii::CommandBuffer& command_buffer) {
-                          if (image_data_ptr->need_staging)
-                          {
-                              // Since we're going to blit to the texture image, set its layout to eTransferDstOptimal
-                              image_data_ptr->TransitLayout(command_buffer,
-                                                            vk::ImageLayout::eUndefined,
-                                                            vk::ImageLayout::eTransferDstOptimal,
-                                                            {aspect_mask, 0, 1, 0, 6});
-                              std::vector<vk::BufferImageCopy> copy_regions;
-                              // cubemap have 6 images
-                              for (std::size_t i = 0; i < 6; ++i)
-                                  copy_regions.emplace_back(image_data_ptr->size * i, /* bufferOffset */
-                                                            image_data_ptr->extent.width,
-                                                            image_data_ptr->extent.height,
-                                                            vk::ImageSubresourceLayers(aspect_mask, 0, i, 1),
-                                                            vk::Offset3D(0, 0, 0),
-                                                            vk::Extent3D(image_data_ptr->extent, 1));
-                              command_buffer.copyBufferToImage(*image_data_ptr->staging_buffer_data.buffer,
-                                                               *image_data_ptr->image,
-                                                               vk::ImageLayout::eTransferDstOptimal,
-                                                               copy_regions);
-                              // Set the layout for the texture image from eTransferDstOptimal to eShaderReadOnlyOptimal
-                              image_data_ptr->TransitLayout(command_buffer,
-                                                            vk::ImageLayout::eTransferDstOptimal,
-                                                            vk::ImageLayout::eShaderReadOnlyOptimal,
-                                                            {aspect_mask, 0, 1, 0, 6});
-                          }
-                          else
-                          {
-                              // If we can use the linear tiled image as a texture, just do it
-                              image_data_ptr->TransitLayout(command_buffer,
-                                                            vk::ImageLayout::ePreinitialized,
-                                                            vk::ImageLayout::eShaderReadOnlyOptimal,
-                                                            {aspect_mask, 0, 1, 0, 6});
-                          }
-                      });
+        if (image_data_ptr->need_staging)
+        {
+            std::vector<vk::BufferImageCopy> copy_regions;
+            // cubemap have 6 images
+            for (std::size_t i = 0; i < 6; ++i)
+                copy_regions.emplace_back(image_data_ptr->size * i, /* bufferOffset */
+                                          image_data_ptr->extent.width,
+                                          image_data_ptr->extent.height,
+                                          vk::ImageSubresourceLayers(aspect_mask, 0, i, 1),
+                                          vk::Offset3D(0, 0, 0),
+                                          vk::Extent3D(image_data_ptr->extent, 1));
+            image_data_ptr->upload_ticket = upload_manager.UploadImage(
+                *image_data_ptr, pixels.data(), pixels.size(), std::move(copy_regions), {aspect_mask, 0, 1, 0, 6});
+        }
+        else
+        {
+            // If we can use the linear tiled image as a texture, just do it
+            image_data_ptr->upload_ticket =
+                upload_manager.TransitHostWrittenImage(*image_data_ptr, {aspect_mask, 0, 1, 0, 6});
+        }
 
         return image_data_ptr;
     }
@@ -23,18 +23,22 @@ namespace Meow
         vk::ImageAspectFlags aspect_mask;
 
         /**
-         * @brief The `vk::raii::DeviceMemory` should be destroyed before the `vk::raii::Image` it is bound to; to get
-         * that order with the standard destructor of the `ImageData`, the order of `vk::raii::DeviceMemory` and
-         * `vk::raii::Image` here matters
+         * @brief The range of memory may be given to another resource once it is freed, so it should be freed after
+         * the `vk::raii::Image` bound to it is destroyed; to get that order with the standard destructor of the
+         * `ImageData`, the order of `DeviceMemoryAllocation` and `vk::raii::Image` here matters
          */
-        vk::raii::DeviceMemory device_memory = nullptr;
-        vk::raii::Image        image         = nullptr;
-        vk::raii::ImageView    image_view    = nullptr;
-        vk::raii::Sampler      sampler       = nullptr;
+        DeviceMemoryAllocation memory;
+        vk::raii::Image        image      = nullptr;
+        vk::raii::ImageView    image_view = nullptr;
+        vk::raii::Sampler      sampler    = nullptr;
         bool                   need_staging;
-        BufferData             staging_buffer_data = nullptr;
         vk::ImageLayout        layout;
 
+        /**
+         * @brief Textures are filled without waiting, so the image should outlive the copy, which this tells.
+         */
+        UploadTicket upload_ticket;
+
         ImageData(std::nullptr_t) {}
 
         /**
@@ -0,0 +1,130 @@
+#include "object_data_buffer.h"
+
+#include "pch.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Meow
+{
+    ObjectDataBuffer::ObjectDataBuffer(const vk::raii::PhysicalDevice& physical_device,
+                                       const vk::raii::Device&         logical_device,
+                                       uint32_t                        frame_count,
+                                       uint32_t                        initial_count,
+                                       uint32_t                        initial_instance_count)
+        : m_physical_device(&physical_device)
+        , m_logical_device(&logical_device)
+    {
+        m_frames.resize(frame_count);
+        for (auto& frame : m_frames)
+        {
+            frame.objects   = Allocate(initial_count, sizeof(PerObjectData));
+            frame.instances = Allocate(initial_instance_count, sizeof(uint32_t));
+            frame.states.resize(initial_count);
+        }
+    }
+
+    void ObjectDataBuffer::BeginFrame(uint32_t frame_index)
+    {
+        FUNCTION_TIMER();
+
+        FrameData& frame = m_frames[frame_index];
+
+        // retired buffers were last read by the previous submissions of this slot, whose fences the window waits for
+        // before beginning the frame
+        frame.retired_buffers.clear();
+        frame.instance_count = 0;
+        m_write_count        = 0;
+    }
+
+    uint32_t ObjectDataBuffer::Update(uint32_t         frame_index,
+                                      GameObjectHandle handle,
+                                      uint64_t         stamp,
+                                      const glm::mat4& model_matrix)
+    {
+        FrameData& frame = m_frames[frame_index];
+
+        uint32_t index = handle.index;
+        if (index >= frame.objects.capacity)
+        {
+            Grow(frame, frame.objects, index + 1, sizeof(PerObjectData));
+            frame.states.resize(frame.objects.capacity);
+        }
+
+        ElementState& state = frame.states[index];
+        if (state.handle == handle && state.stamp == stamp)
+            return index;
+
+        PerObjectData& data = reinterpret_cast<PerObjectData*>(frame.objects.mapped_data_ptr)[index];
+        data.model_matrix   = model_matrix;
+        data.normal_matrix  = glm::mat4(glm::transpose(glm::inverse(glm::mat3(model_matrix))));
+
+        state.handle = handle;
+        state.stamp  = stamp;
+        ++m_write_count;
+
+        return index;
+    }
+
+    uint32_t ObjectDataBuffer::AppendInstances(uint32_t frame_index, const uint32_t* object_indices, uint32_t count)
+    {
+        uint32_t first_instance = ReserveInstances(frame_index, count);
+
+        std::memcpy(m_frames[frame_index].instances.mapped_data_ptr + sizeof(uint32_t) * first_instance,
+                    object_indices,
+                    sizeof(uint32_t) * count);
+
+        return first_instance;
+    }
+
+    uint32_t ObjectDataBuffer::ReserveInstances(uint32_t frame_index, uint32_t count)
+    {
+        FrameData& frame = m_frames[frame_index];
+
+        uint32_t first_instance = frame.instance_count;
+        if (first_instance + count > frame.instances.capacity)
+            Grow(frame, frame.instances, first_instance + count, sizeof(uint32_t));
+
+        frame.instance_count += count;
+
+        return first_instance;
+    }
+
+    ObjectDataBuffer::MappedBuffer ObjectDataBuffer::Allocate(uint32_t capacity, uint32_t element_size) const
+    {
+        MappedBuffer mapped_buffer;
+
+        // transfer source for GPU culling validation, which copies out the instances it wrote
+        mapped_buffer.buffer = std::make_unique<BufferData>(
+            *m_physical_device,
+            *m_logical_device,
+            static_cast<vk::DeviceSize>(element_size) * capacity,
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+        mapped_buffer.mapped_data_ptr = mapped_buffer.buffer->memory.GetMappedData();
+        mapped_buffer.capacity        = capacity;
+
+        return mapped_buffer;
+    }
+
+    void ObjectDataBuffer::Grow(FrameData&    frame,
+                                MappedBuffer& mapped_buffer,
+                                uint32_t      required_count,
+                                uint32_t      element_size)
+    {
+        FUNCTION_TIMER();
+
+        uint32_t new_capacity = std::max(mapped_buffer.capacity * 2, required_count);
+
+        MappedBuffer new_buffer = Allocate(new_capacity, element_size);
+        std::memcpy(new_buffer.mapped_data_ptr,
+                    mapped_buffer.mapped_data_ptr,
+                    static_cast<size_t>(element_size) * mapped_buffer.capacity);
+
+        MEOW_INFO("Object data buffer grows from {} to {} elements.", mapped_buffer.capacity, new_capacity);
+
+        frame.retired_buffers.push_back(std::move(mapped_buffer.buffer));
+        mapped_buffer = std::move(new_buffer);
+        ++frame.version;
+    }
+} // namespace Meow
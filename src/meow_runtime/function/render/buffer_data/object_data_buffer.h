@@ -0,0 +1,136 @@
+#pragma once
+
+#include "buffer_data.h"
+#include "function/object/game_object_handle.h"
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Layout of one element in the object data storage buffer, matching PerObjectData in shaders (std430).
+     */
+    struct PerObjectData
+    {
+        glm::mat4 model_matrix;
+        glm::mat4 normal_matrix;
+    };
+
+    /**
+     * @brief Persistent storage buffer of per-object data, shared by all passes and indexed by game object handle.
+     *
+     * Element i belongs to the object whose handle index is i. Draws do not address it directly: every frame, passes
+     * append the object indices of their instances to the instance buffer, and an instanced draw covers a range of it
+     * through firstInstance and instanceCount. The shader reads objectData.objects[instanceData.objectIndices[
+     * gl_InstanceIndex]]. Descriptor sets are bound once per pass instead of once per draw.
+     *
+     * Every frame in flight owns one persistently mapped buffer of each kind. An object element is only written when
+     * the world transform stamp of its object differs from the one last written into that frame, so static objects
+     * cost nothing. When data does not fit, the buffer of the frame is replaced by a larger one in the same way as
+     * DynamicUniformAllocator, and its version is bumped so that materials rebind their descriptors.
+     */
+    class ObjectDataBuffer
+    {
+    public:
+        static constexpr const char* k_binding_name           = "objectData";
+        static constexpr const char* k_instance_binding_name  = "instanceData";
+        static constexpr uint32_t    k_default_initial_count  = 1024;
+        static constexpr uint32_t    k_default_instance_count = 4096;
+
+        ObjectDataBuffer(std::nullptr_t) {}
+
+        ObjectDataBuffer(const vk::raii::PhysicalDevice& physical_device,
+                         const vk::raii::Device&         logical_device,
+                         uint32_t                        frame_count,
+                         uint32_t                        initial_count          = k_default_initial_count,
+                         uint32_t                        initial_instance_count = k_default_instance_count);
+
+        ObjectDataBuffer(ObjectDataBuffer&& rhs) noexcept            = default;
+        ObjectDataBuffer& operator=(ObjectDataBuffer&& rhs) noexcept = default;
+
+        /**
+         * @brief Release buffers retired by this frame slot, and clear its instances.
+         *
+         * Like every write to the slot, call it only once the in-flight fences of the slot have been waited for.
+         */
+        void BeginFrame(uint32_t frame_index);
+
+        /**
+         * @brief Write object data if it is outdated in this frame, and return the element index of the object.
+         * Buffers of the slot are written in place, so the previous submission of the slot must have completed.
+         */
+        uint32_t Update(uint32_t frame_index, GameObjectHandle handle, uint64_t stamp, const glm::mat4& model_matrix);
+
+        /**
+         * @brief Append object element indices to the instance buffer of the frame, and return the position of the
+         * first one, which is used as firstInstance.
+         */
+        uint32_t AppendInstances(uint32_t frame_index, const uint32_t* object_indices, uint32_t count);
+
+        /**
+         * @brief Reserve count instances without writing them, for object indices written by GPU culling. Returns the
+         * position of the first one.
+         */
+        uint32_t ReserveInstances(uint32_t frame_index, uint32_t count);
+
+        const vk::raii::Buffer& GetBuffer(uint32_t frame_index) const
+        {
+            return m_frames[frame_index].objects.buffer->buffer;
+        }
+
+        const vk::raii::Buffer& GetInstanceBuffer(uint32_t frame_index) const
+        {
+            return m_frames[frame_index].instances.buffer->buffer;
+        }
+
+        /**
+         * @brief Bumped whenever a buffer of the frame is replaced.
+         */
+        uint32_t GetVersion(uint32_t frame_index) const { return m_frames[frame_index].version; }
+
+        /**
+         * @brief Number of object elements written in the last frame, for statistics.
+         */
+        uint32_t GetWriteCount() const { return m_write_count; }
+
+    private:
+        struct ElementState
+        {
+            GameObjectHandle handle;
+            uint64_t         stamp = 0;
+        };
+
+        struct MappedBuffer
+        {
+            std::unique_ptr<BufferData> buffer;
+            uint8_t*                    mapped_data_ptr = nullptr;
+            uint32_t                    capacity        = 0;
+        };
+
+        struct FrameData
+        {
+            MappedBuffer                             objects;
+            std::vector<ElementState>                states;
+            MappedBuffer                             instances;
+            uint32_t                                 instance_count = 0;
+            std::vector<std::unique_ptr<BufferData>> retired_buffers;
+            uint32_t                                 version = 0;
+        };
+
+        MappedBuffer Allocate(uint32_t capacity, uint32_t element_size) const;
+        void         Grow(FrameData&    frame,
+                          MappedBuffer& mapped_buffer,
+                          uint32_t      required_count,
+                          uint32_t      element_size);
+
+        const vk::raii::PhysicalDevice* m_physical_device = nullptr;
+        const vk::raii::Device*         m_logical_device  = nullptr;
+
+        std::vector<FrameData> m_frames;
+        uint32_t               m_write_count = 0;
+    };
+} // namespace Meow
@@ -17,11 +17,9 @@ namespace Meow
             return new_memory_start;
         }
 
-        // TODO: Scalable buffer size
-        // When the memory is running out, allocation return to the begin of memory
-        // It means overriding the old buffer data
-        // If the object number is very large, it definitely break the uniform data at this frame
-        // Here we push the problem aside
+        // Per-object data goes to DynamicUniformAllocator, which grows instead. A plain uniform buffer only holds one
+        // block of fixed size, so running out of memory here means the block is larger than the buffer.
+        MEOW_ERROR("Uniform buffer overflow, {} bytes requested but buffer size is {}.", size, device_size);
 
         allocated_memory = size;
         return 0;
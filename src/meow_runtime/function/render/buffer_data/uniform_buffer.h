@@ -27,13 +27,7 @@ namespace Meow
                          vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent)
         {
             min_alignment   = physical_device.getProperties().limits.minUniformBufferOffsetAlignment;
-            mapped_data_ptr = (uint8_t*)device_memory.mapMemory(0, VK_WHOLE_SIZE);
-        }
-
-        ~UniformBuffer() override
-        {
-            mapped_data_ptr = nullptr;
-            device_memory.unmapMemory();
+            mapped_data_ptr = memory.GetMappedData();
         }
 
         void ResetMemory();
@@ -11,15 +11,42 @@ namespace Meow
 {
     Material::Material(std::shared_ptr<Shader> shader) { this->shader = shader; }
 
+    void Material::AllocateDescriptorSets()
+    {
+        DescriptorAllocatorGrowable& descriptor_allocator = g_runtime_context.render_system->GetDescriptorAllocator();
+
+        const auto k_max_frames_in_flight = g_runtime_context.render_system->GetMaxFramesInFlight();
+
+        // the bindless set is shared by all materials, so a null set only keeps its place
+        std::vector<vk::DescriptorSetLayout> descriptor_set_layouts = shader->descriptor_set_layouts;
+        if (shader->bindless_set >= 0)
+            descriptor_set_layouts.erase(descriptor_set_layouts.begin() + shader->bindless_set);
+
+        m_descriptor_sets_per_frame.clear();
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            vk::raii::DescriptorSets descriptor_sets = descriptor_allocator.Allocate(descriptor_set_layouts);
+            if (shader->bindless_set >= 0)
+            {
+                descriptor_sets.insert(descriptor_sets.begin() + shader->bindless_set,
+                                       vk::raii::DescriptorSet(nullptr));
+            }
+            m_descriptor_sets_per_frame.push_back(std::move(descriptor_sets));
+        }
+    }
+
     void Material::CreateUniformBuffer()
     {
         const auto k_max_frames_in_flight = g_runtime_context.render_system->GetMaxFramesInFlight();
 
-        m_dynamic_uniform_buffer_per_frame.resize(k_max_frames_in_flight);
+        m_dynamic_uniform_buffer_versions.resize(k_max_frames_in_flight);
+        m_object_data_buffer_versions.resize(k_max_frames_in_flight);
 
         const vk::raii::PhysicalDevice& physical_device = g_runtime_context.render_system->GetPhysicalDevice();
         const vk::raii::Device&         logical_device  = g_runtime_context.render_system->GetLogicalDevice();
 
+        DynamicUniformAllocator& dynamic_allocator = g_runtime_context.render_system->GetDynamicUniformAllocator();
+
         for (auto it = shader->buffer_meta_map.begin(); it != shader->buffer_meta_map.end(); ++it)
         {
             if (it->second.descriptorType == vk::DescriptorType::eUniformBuffer)
@@ -35,16 +62,28 @@ namespace Meow
             }
             if (it->second.descriptorType == vk::DescriptorType::eUniformBufferDynamic)
             {
+                // per-object data of all materials goes to the buffer shared by the frame
                 for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
                 {
-                    if (!m_dynamic_uniform_buffer_per_frame[i])
-                        m_dynamic_uniform_buffer_per_frame[i] =
-                            std::move(std::make_unique<UniformBuffer>(physical_device, logical_device, 32 * 1024));
                     BindBufferToDescriptorSet(
-                        it->first, m_dynamic_uniform_buffer_per_frame[i]->buffer, VK_WHOLE_SIZE, nullptr, i);
+                        it->first, dynamic_allocator.GetBuffer(i).buffer, VK_WHOLE_SIZE, nullptr, i);
+                    m_dynamic_uniform_buffer_versions[i] = dynamic_allocator.GetVersion(i);
                 }
             }
         }
+
+        // per-object data of all passes lives in the persistent buffer shared by the frame, and is reached through
+        // instance indices, so both buffers are needed
+        m_uses_object_data_buffer = HasStorageBuffer(ObjectDataBuffer::k_binding_name) &&
+                                    HasStorageBuffer(ObjectDataBuffer::k_instance_binding_name);
+        if (m_uses_object_data_buffer)
+        {
+            m_object_data_set = shader->buffer_meta_map[ObjectDataBuffer::k_binding_name].set;
+            for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+            {
+                BindObjectDataBuffer(i);
+            }
+        }
     }
 
     void Material::BindPipeline(const vk::raii::CommandBuffer& command_buffer)
@@ -54,6 +93,12 @@ namespace Meow
         command_buffer.bindPipeline(m_bind_point, *m_pipeline);
     }
 
+    void Material::BindPipeline(const vk::raii::CommandBuffer& command_buffer, RenderStateCache& state_cache)
+    {
+        if (state_cache.SetPipeline(*m_pipeline))
+            BindPipeline(command_buffer);
+    }
+
     void Material::BindBufferToDescriptorSet(const std::string&          name,
                                              const vk::raii::Buffer&     buffer,
                                              vk::DeviceSize              range,
@@ -93,6 +138,12 @@ namespace Meow
             return;
         }
 
+        if (static_cast<int32_t>(meta->set) == shader->bindless_set)
+        {
+            MEOW_ERROR("Binding buffer failed, {} belongs to the bindless set!", name);
+            return;
+        }
+
         vk::DescriptorBufferInfo descriptor_buffer_info(*buffer, 0, range);
 
         // TODO: store buffer view in an vector
@@ -128,6 +179,11 @@ namespace Meow
         }
 
         auto bindInfo = it->second;
+        if (bindInfo.set == shader->bindless_set)
+        {
+            MEOW_ERROR("Binding image failed, {} belongs to the bindless set!", name);
+            return;
+        }
 
         vk::DescriptorImageInfo descriptor_image_info(
             *image_data.sampler, *image_data.image_view, vk::ImageLayout::eShaderReadOnlyOptimal);
@@ -146,6 +202,88 @@ namespace Meow
         logical_device.updateDescriptorSets(write_descriptor_set, nullptr);
     }
 
+    void Material::BindInputAttachmentToDescriptorSet(const std::string& name,
+                                                      vk::ImageView      image_view,
+                                                      vk::ImageLayout    layout,
+                                                      uint32_t           frame_index)
+    {
+        const vk::raii::Device& logical_device = g_runtime_context.render_system->GetLogicalDevice();
+
+        auto it = shader->set_layout_metas.binding_meta_map.find(name);
+        if (it == shader->set_layout_metas.binding_meta_map.end())
+        {
+            MEOW_ERROR("Binding input attachment failed, {} not found!", name);
+            return;
+        }
+
+        auto bindInfo = it->second;
+
+        vk::DescriptorImageInfo descriptor_image_info(nullptr, image_view, layout);
+
+        vk::WriteDescriptorSet write_descriptor_set(
+            *m_descriptor_sets_per_frame[frame_index][bindInfo.set],                    // dstSet
+            bindInfo.binding,                                                           // dstBinding
+            0,                                                                          // dstArrayElement
+            1,                                                                          // descriptorCount
+            shader->set_layout_metas.GetDescriptorType(bindInfo.set, bindInfo.binding), // descriptorType
+            &descriptor_image_info,                                                     // pImageInfo
+            nullptr,                                                                    // pBufferInfo
+            nullptr                                                                     // pTexelBufferView
+        );
+
+        logical_device.updateDescriptorSets(write_descriptor_set, nullptr);
+    }
+
+    void Material::BindImageToBindlessSlot(uint32_t slot, ImageData& image_data)
+    {
+        if (shader->bindless_set < 0)
+        {
+            MEOW_ERROR("Binding bindless image failed, shader doesn't use the bindless descriptor table!");
+            return;
+        }
+
+        auto it = shader->buffer_meta_map.find(BindlessDescriptorTable::k_texture_indices_binding_name);
+        if (it == shader->buffer_meta_map.end() || it->second.descriptorType != vk::DescriptorType::eUniformBuffer)
+        {
+            MEOW_ERROR("Binding bindless image failed, uniform buffer {} not found!",
+                       BindlessDescriptorTable::k_texture_indices_binding_name);
+            return;
+        }
+
+        // std140 packs the indices into uvec4s, so the block is read as a flat array of uint
+        uint32_t slot_count = it->second.size / sizeof(uint32_t);
+        if (slot >= slot_count)
+        {
+            MEOW_ERROR("Binding bindless image failed, slot {} exceeds {} slots!", slot, slot_count);
+            return;
+        }
+
+        uint32_t index = g_runtime_context.render_system->GetBindlessDescriptorTable().AddImage(image_data);
+        if (index == BindlessDescriptorTable::k_invalid_index)
+            return;
+
+        m_bindless_texture_indices.resize(slot_count, 0);
+        m_bindless_texture_indices[slot] = index;
+
+        const auto k_max_frames_in_flight = g_runtime_context.render_system->GetMaxFramesInFlight();
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            PopulateUniformBuffer(BindlessDescriptorTable::k_texture_indices_binding_name,
+                                  m_bindless_texture_indices.data(),
+                                  it->second.size,
+                                  i);
+        }
+    }
+
+    void Material::BindBindlessDescriptorSet(const vk::raii::CommandBuffer& command_buffer,
+                                             RenderStateCache*              state_cache)
+    {
+        if (shader->bindless_set < 0)
+            return;
+
+        BindDescriptorSetToPipeline(command_buffer, shader->bindless_set, 1, 0, false, 0, state_cache);
+    }
+
     void Material::BeginPopulatingDynamicUniformBufferPerFrame()
     {
         FUNCTION_TIMER();
@@ -160,10 +298,6 @@ namespace Meow
 
         m_obj_count = 0;
         m_per_obj_dynamic_offsets.clear();
-        for (auto& dynamic_uniform_buffer : m_dynamic_uniform_buffer_per_frame)
-        {
-            dynamic_uniform_buffer->ResetMemory();
-        }
     }
 
     void Material::EndPopulatingDynamicUniformBufferPerFrame()
@@ -234,8 +368,11 @@ namespace Meow
             return;
         }
 
+        DynamicUniformAllocator& dynamic_allocator = g_runtime_context.render_system->GetDynamicUniformAllocator();
+
         m_per_obj_dynamic_offsets[m_obj_count][it->second.dynamic_seq] =
-            static_cast<uint32_t>(m_dynamic_uniform_buffer_per_frame[frame_index]->Populate(data, it->second.size));
+            dynamic_allocator.Populate(frame_index, data, it->second.size);
+        m_dynamic_frame_index = frame_index;
     }
 
     void Material::PopulateUniformBuffer(const std::string& name, void* data, uint32_t size, uint32_t frame_index)
@@ -267,7 +404,8 @@ namespace Meow
                                                uint32_t                       set_count,
                                                uint32_t                       draw_call,
                                                bool                           is_dynamic,
-                                               uint32_t                       frame_index)
+                                               uint32_t                       frame_index,
+                                               RenderStateCache*              state_cache)
     {
         if (is_dynamic)
         {
@@ -276,11 +414,26 @@ namespace Meow
                 MEOW_ERROR("Draw call exceed dynamic offset count!");
                 return;
             }
+
+            frame_index = m_dynamic_frame_index;
+            RefreshDynamicUniformBufferBinding(frame_index);
         }
 
+        // calls binding other sets don't pass the current frame, and must not rewrite sets of frames in flight
+        bool binds_object_data_set = first_set <= m_object_data_set && m_object_data_set < first_set + set_count;
+        if (m_uses_object_data_buffer && binds_object_data_set)
+            RefreshObjectDataBufferBinding(frame_index);
+
         std::vector<vk::DescriptorSet> descriptor_sets_to_bind(set_count);
         for (uint32_t i = first_set; i < first_set + set_count; ++i)
         {
+            if (static_cast<int32_t>(i) == shader->bindless_set)
+            {
+                descriptor_sets_to_bind[i - first_set] =
+                    g_runtime_context.render_system->GetBindlessDescriptorTable().GetDescriptorSet();
+                continue;
+            }
+
             descriptor_sets_to_bind[i - first_set] = *m_descriptor_sets_per_frame[frame_index][i];
         }
 
@@ -288,10 +441,73 @@ namespace Meow
         if (is_dynamic)
             dynamic_offsets = m_per_obj_dynamic_offsets[draw_call];
 
+        if (state_cache)
+        {
+            bool needs_bind = state_cache->SetDescriptorSets(
+                *shader->pipeline_layout, first_set, descriptor_sets_to_bind, dynamic_offsets);
+            if (!needs_bind)
+                return;
+        }
+
         command_buffer.bindDescriptorSets(
             m_bind_point, *shader->pipeline_layout, first_set, descriptor_sets_to_bind, dynamic_offsets);
     }
 
+    void Material::RefreshDynamicUniformBufferBinding(uint32_t frame_index)
+    {
+        DynamicUniformAllocator& dynamic_allocator = g_runtime_context.render_system->GetDynamicUniformAllocator();
+
+        uint32_t version = dynamic_allocator.GetVersion(frame_index);
+        if (m_dynamic_uniform_buffer_versions[frame_index] == version)
+            return;
+
+        // buffer only grows while populating, so descriptors are updated before this frame binds them
+        for (auto it = shader->buffer_meta_map.begin(); it != shader->buffer_meta_map.end(); ++it)
+        {
+            if (it->second.descriptorType == vk::DescriptorType::eUniformBufferDynamic)
+            {
+                BindBufferToDescriptorSet(
+                    it->first, dynamic_allocator.GetBuffer(frame_index).buffer, VK_WHOLE_SIZE, nullptr, frame_index);
+            }
+        }
+
+        m_dynamic_uniform_buffer_versions[frame_index] = version;
+    }
+
+    void Material::RefreshObjectDataBufferBinding(uint32_t frame_index)
+    {
+        ObjectDataBuffer& object_data_buffer = g_runtime_context.render_system->GetObjectDataBuffer();
+
+        if (m_object_data_buffer_versions[frame_index] == object_data_buffer.GetVersion(frame_index))
+            return;
+
+        BindObjectDataBuffer(frame_index);
+    }
+
+    void Material::BindObjectDataBuffer(uint32_t frame_index)
+    {
+        ObjectDataBuffer& object_data_buffer = g_runtime_context.render_system->GetObjectDataBuffer();
+
+        BindBufferToDescriptorSet(ObjectDataBuffer::k_binding_name,
+                                  object_data_buffer.GetBuffer(frame_index),
+                                  VK_WHOLE_SIZE,
+                                  nullptr,
+                                  frame_index);
+        BindBufferToDescriptorSet(ObjectDataBuffer::k_instance_binding_name,
+                                  object_data_buffer.GetInstanceBuffer(frame_index),
+                                  VK_WHOLE_SIZE,
+                                  nullptr,
+                                  frame_index);
+
+        m_object_data_buffer_versions[frame_index] = object_data_buffer.GetVersion(frame_index);
+    }
+
+    bool Material::HasStorageBuffer(const std::string& name) const
+    {
+        auto it = shader->buffer_meta_map.find(name);
+        return it != shader->buffer_meta_map.end() && it->second.descriptorType == vk::DescriptorType::eStorageBuffer;
+    }
+
     void Material::SetDebugName(const std::string& debug_name, uint32_t frame_index)
     {
         if (debug_name.empty())
@@ -303,6 +519,10 @@ namespace Meow
         {
             for (size_t i = 0; i < m_descriptor_sets_per_frame[frame_index].size(); i++)
             {
+                // shared by all materials, so it isn't named after this one
+                if (static_cast<int32_t>(i) == shader->bindless_set)
+                    continue;
+
                 std::string descriptor_set_name =
                     std::format("{} DescriptorSet {} frame {}", debug_name, i, frame_index);
 
@@ -340,6 +560,11 @@ namespace Meow
         std::swap(lhs.m_per_obj_dynamic_offsets, rhs.m_per_obj_dynamic_offsets);
         std::swap(lhs.m_descriptor_sets_per_frame, rhs.m_descriptor_sets_per_frame);
         std::swap(lhs.m_uniform_buffers_per_frame, rhs.m_uniform_buffers_per_frame);
-        std::swap(lhs.m_dynamic_uniform_buffer_per_frame, rhs.m_dynamic_uniform_buffer_per_frame);
+        std::swap(lhs.m_dynamic_uniform_buffer_versions, rhs.m_dynamic_uniform_buffer_versions);
+        std::swap(lhs.m_dynamic_frame_index, rhs.m_dynamic_frame_index);
+        std::swap(lhs.m_object_data_buffer_versions, rhs.m_object_data_buffer_versions);
+        std::swap(lhs.m_uses_object_data_buffer, rhs.m_uses_object_data_buffer);
+        std::swap(lhs.m_object_data_set, rhs.m_object_data_set);
+        std::swap(lhs.m_bindless_texture_indices, rhs.m_bindless_texture_indices);
     }
 } // namespace Meow
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/base/non_copyable.h"
+#include "function/render/batch/render_state_cache.h"
 #include "function/render/buffer_data/uniform_buffer.h"
 #include "function/resource/resource_base.h"
 #include "shader.h"
@@ -37,6 +38,11 @@ namespace Meow
 
         void BindPipeline(const vk::raii::CommandBuffer& command_buffer);
 
+        /**
+         * @brief Skip the bind if the pipeline is already bound in the render pass being recorded.
+         */
+        void BindPipeline(const vk::raii::CommandBuffer& command_buffer, RenderStateCache& state_cache);
+
         void BindBufferToDescriptorSet(const std::string&          name,
                                        const vk::raii::Buffer&     buffer,
                                        vk::DeviceSize              range            = VK_WHOLE_SIZE,
@@ -45,6 +51,28 @@ namespace Meow
 
         void BindImageToDescriptorSet(const std::string& name, ImageData& image_data, uint32_t frame_index = 0);
 
+        /**
+         * @brief Bind an input attachment by its view, in the layout its subpass reads it in.
+         */
+        void BindInputAttachmentToDescriptorSet(const std::string& name,
+                                                vk::ImageView      image_view,
+                                                vk::ImageLayout    layout,
+                                                uint32_t           frame_index = 0);
+
+        /**
+         * @brief Add the image to the bindless descriptor table, and write its index into the given slot of the
+         * BindlessDescriptorTable::k_texture_indices_binding_name uniform block of every frame. Call it while setting
+         * up the material, as the block is not double buffered against frames in flight.
+         */
+        void BindImageToBindlessSlot(uint32_t slot, ImageData& image_data);
+
+        /**
+         * @brief Bind the set of the bindless descriptor table, if the shader declares it. The set is the same for all
+         * materials, so a state cache skips binding it again until the pipeline layout changes.
+         */
+        void BindBindlessDescriptorSet(const vk::raii::CommandBuffer& command_buffer,
+                                       RenderStateCache*              state_cache = nullptr);
+
         void BeginPopulatingDynamicUniformBufferPerFrame();
 
         void EndPopulatingDynamicUniformBufferPerFrame();
@@ -57,12 +85,30 @@ namespace Meow
 
         void PopulateUniformBuffer(const std::string& name, void* data, uint32_t size, uint32_t frame_index);
 
+        /**
+         * @brief When is_dynamic is true, sets of the frame whose per-object data is populated last are bound, since
+         * dynamic offsets point into the dynamic uniform buffer of that frame. With a state cache, sets and offsets
+         * already bound are not bound again.
+         */
         void BindDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer,
                                          uint32_t                       first_set,
                                          uint32_t                       set_count,
                                          uint32_t                       draw_call   = 0,
                                          bool                           is_dynamic  = false,
-                                         uint32_t                       frame_index = 0);
+                                         uint32_t                       frame_index = 0,
+                                         RenderStateCache*              state_cache = nullptr);
+
+        /**
+         * @brief If true, the shader reads per-object data from ObjectDataBuffer through its instance indices, and
+         * draws pass a range of instances instead of binding dynamic offsets.
+         */
+        bool UsesObjectDataBuffer() const { return m_uses_object_data_buffer; }
+
+        /**
+         * @brief Point object data descriptors to the current buffers of ObjectDataBuffer, if they have been replaced.
+         * Binding does this lazily, so call it before binding from several threads, which then only read.
+         */
+        void RefreshObjectDataBufferBinding(uint32_t frame_index);
 
         ShadingModelType GetShadingModelType() { return m_shading_model_type; }
 
@@ -73,8 +119,22 @@ namespace Meow
         std::shared_ptr<Shader> shader = nullptr;
 
     private:
+        /**
+         * @brief Allocate the sets of the shader for every frame in flight, except the bindless set.
+         */
+        void AllocateDescriptorSets();
+
         void CreateUniformBuffer();
 
+        /**
+         * @brief Point dynamic uniform descriptors to the current buffer of shared allocator, if it has been replaced.
+         */
+        void RefreshDynamicUniformBufferBinding(uint32_t frame_index);
+
+        void BindObjectDataBuffer(uint32_t frame_index);
+
+        bool HasStorageBuffer(const std::string& name) const;
+
         vk::raii::Pipeline m_pipeline = nullptr;
 
         // stored for binding descriptor set
@@ -84,7 +144,12 @@ namespace Meow
         std::vector<std::vector<uint32_t>>                                           m_per_obj_dynamic_offsets;
         std::vector<vk::raii::DescriptorSets>                                        m_descriptor_sets_per_frame;
         std::unordered_map<std::string, std::vector<std::unique_ptr<UniformBuffer>>> m_uniform_buffers_per_frame;
-        std::vector<std::unique_ptr<UniformBuffer>>                                  m_dynamic_uniform_buffer_per_frame;
+        std::vector<uint32_t>                                                        m_dynamic_uniform_buffer_versions;
+        uint32_t                                                                     m_dynamic_frame_index = 0;
+        std::vector<uint32_t>                                                        m_object_data_buffer_versions;
+        bool                                                                         m_uses_object_data_buffer = false;
+        uint32_t                                                                     m_object_data_set         = 0;
+        std::vector<uint32_t>                                                        m_bindless_texture_indices;
 
         ShadingModelType      m_shading_model_type;
         vk::PipelineBindPoint m_bind_point;
@@ -274,7 +274,8 @@ namespace Meow
 
         material_ptr->m_shading_model_type = m_shading_model_type;
 
-        vk::raii::PipelineCache        pipeline_cache(logical_device, vk::PipelineCacheCreateInfo());
+        const vk::raii::PipelineCache& pipeline_cache =
+            g_runtime_context.render_system->GetPipelineCache().GetPipelineCache();
         vk::GraphicsPipelineCreateInfo graphics_pipeline_create_info(
             vk::PipelineCreateFlags(),                          /* flags */
             context.pipeline_shader_stage_create_infos,         /* pStages */
@@ -293,17 +294,7 @@ namespace Meow
 
         material_ptr->m_pipeline = vk::raii::Pipeline(logical_device, pipeline_cache, graphics_pipeline_create_info);
 
-        DescriptorAllocatorGrowable& descriptor_allocator = g_runtime_context.render_system->GetDescriptorAllocator();
-
-        const auto k_max_frames_in_flight = g_runtime_context.render_system->GetMaxFramesInFlight();
-
-        material_ptr->m_descriptor_sets_per_frame.clear();
-        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
-        {
-            material_ptr->m_descriptor_sets_per_frame.push_back(
-                descriptor_allocator.Allocate(shader->descriptor_set_layouts));
-        }
-
+        material_ptr->AllocateDescriptorSets();
         material_ptr->CreateUniformBuffer();
 
         material_ptr->m_bind_point = vk::PipelineBindPoint::eGraphics;
@@ -318,19 +309,12 @@ namespace Meow
             context.pipeline_shader_stage_create_infos[0], /* pStages */
             *shader->pipeline_layout);                     /* layout */
 
-        material_ptr->m_pipeline = vk::raii::Pipeline(logical_device, nullptr, compute_pipeline_create_info);
+        const vk::raii::PipelineCache& pipeline_cache =
+            g_runtime_context.render_system->GetPipelineCache().GetPipelineCache();
 
-        DescriptorAllocatorGrowable& descriptor_allocator = g_runtime_context.render_system->GetDescriptorAllocator();
-
-        const auto k_max_frames_in_flight = g_runtime_context.render_system->GetMaxFramesInFlight();
-
-        material_ptr->m_descriptor_sets_per_frame.clear();
-        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
-        {
-            material_ptr->m_descriptor_sets_per_frame.push_back(
-                descriptor_allocator.Allocate(shader->descriptor_set_layouts));
-        }
+        material_ptr->m_pipeline = vk::raii::Pipeline(logical_device, pipeline_cache, compute_pipeline_create_info);
 
+        material_ptr->AllocateDescriptorSets();
         material_ptr->CreateUniformBuffer();
 
         material_ptr->m_bind_point = vk::PipelineBindPoint::eCompute;
@@ -0,0 +1,114 @@
+#include "pipeline_cache.h"
+
+#include "pch.h"
+
+#include "core/base/hash.h"
+#include "function/global/runtime_context.h"
+
+#include <cstring>
+#include <format>
+
+namespace Meow
+{
+    PipelineCache::PipelineCache(const vk::raii::PhysicalDevice& physical_device,
+                                 const vk::raii::Device&         logical_device)
+        : m_physical_device_properties(physical_device.getProperties())
+    {
+        FUNCTION_TIMER();
+
+        // one file per device, so that switching GPUs doesn't throw away the cache of the other one
+        std::string uuid_string;
+        for (uint8_t byte : m_physical_device_properties.pipelineCacheUUID)
+        {
+            uuid_string += std::format("{:02x}", byte);
+        }
+        m_file_path = "cache/pipeline_cache_" + uuid_string + ".bin";
+
+        auto [file_data_ptr, file_size] = g_runtime_context.file_system->ReadBinaryFile(m_file_path);
+
+        vk::PipelineCacheCreateInfo pipeline_cache_create_info;
+        if (file_data_ptr && IsValid(file_data_ptr, file_size))
+        {
+            pipeline_cache_create_info.initialDataSize = file_size - sizeof(FileHeader);
+            pipeline_cache_create_info.pInitialData    = file_data_ptr + sizeof(FileHeader);
+            MEOW_INFO("Pipeline cache loaded from {}.", m_file_path);
+        }
+        else if (file_data_ptr)
+        {
+            MEOW_WARN("Pipeline cache {} doesn't match the device, and is ignored.", m_file_path);
+        }
+
+        m_pipeline_cache = vk::raii::PipelineCache(logical_device, pipeline_cache_create_info);
+
+        delete[] file_data_ptr;
+    }
+
+    void PipelineCache::Save() const
+    {
+        FUNCTION_TIMER();
+
+        if (!*m_pipeline_cache)
+            return;
+
+        std::vector<uint8_t> data = m_pipeline_cache.getData();
+
+        FileHeader header = MakeFileHeader();
+        header.data_size  = data.size();
+        header.data_hash  = HashBytes(data.data(), data.size());
+
+        std::vector<uint8_t> file_data(sizeof(FileHeader) + data.size());
+        std::memcpy(file_data.data(), &header, sizeof(FileHeader));
+        std::memcpy(file_data.data() + sizeof(FileHeader), data.data(), data.size());
+
+        if (!g_runtime_context.file_system->WriteBinaryFile(m_file_path, file_data.data(), file_data.size()))
+        {
+            MEOW_WARN("Failed to save pipeline cache to {}.", m_file_path);
+        }
+    }
+
+    PipelineCache::FileHeader PipelineCache::MakeFileHeader() const
+    {
+        FileHeader header {};
+        header.magic          = k_magic;
+        header.version        = k_version;
+        header.vendor_id      = m_physical_device_properties.vendorID;
+        header.device_id      = m_physical_device_properties.deviceID;
+        header.driver_version = m_physical_device_properties.driverVersion;
+        std::memcpy(header.pipeline_cache_uuid, m_physical_device_properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+        return header;
+    }
+
+    bool PipelineCache::IsValid(const uint8_t* file_data_ptr, size_t file_size) const
+    {
+        if (file_size < sizeof(FileHeader) + sizeof(VkPipelineCacheHeaderVersionOne))
+            return false;
+
+        FileHeader header;
+        std::memcpy(&header, file_data_ptr, sizeof(FileHeader));
+
+        // a driver update keeps the UUID sometimes, while the data is still not compatible
+        FileHeader expected_header = MakeFileHeader();
+        if (header.magic != expected_header.magic || header.version != expected_header.version ||
+            header.vendor_id != expected_header.vendor_id || header.device_id != expected_header.device_id ||
+            header.driver_version != expected_header.driver_version ||
+            std::memcmp(header.pipeline_cache_uuid, expected_header.pipeline_cache_uuid, VK_UUID_SIZE) != 0)
+            return false;
+
+        const uint8_t* data_ptr = file_data_ptr + sizeof(FileHeader);
+        if (header.data_size != file_size - sizeof(FileHeader) ||
+            header.data_hash != HashBytes(data_ptr, header.data_size))
+            return false;
+
+        // the header the driver wrote itself
+        VkPipelineCacheHeaderVersionOne vulkan_header;
+        std::memcpy(&vulkan_header, data_ptr, sizeof(vulkan_header));
+
+        return vulkan_header.headerSize >= sizeof(vulkan_header) &&
+               vulkan_header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+               vulkan_header.vendorID == m_physical_device_properties.vendorID &&
+               vulkan_header.deviceID == m_physical_device_properties.deviceID &&
+               std::memcmp(vulkan_header.pipelineCacheUUID,
+                           m_physical_device_properties.pipelineCacheUUID.data(),
+                           VK_UUID_SIZE) == 0;
+    }
+} // namespace Meow
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <string>
+
+namespace Meow
+{
+    /**
+     * @brief vk::PipelineCache shared by every pipeline, loaded from and saved to a file of the device.
+     *
+     * The file name holds the pipeline cache UUID of the device, and a header in front of the Vulkan data holds the
+     * vendor, device and driver version. Files whose header, or whose Vulkan cache header, doesn't match the device
+     * are ignored, since drivers may crash on foreign data instead of rejecting it.
+     */
+    class PipelineCache
+    {
+    public:
+        PipelineCache(std::nullptr_t) {}
+
+        PipelineCache(const vk::raii::PhysicalDevice& physical_device, const vk::raii::Device& logical_device);
+
+        PipelineCache(PipelineCache&& rhs) noexcept            = default;
+        PipelineCache& operator=(PipelineCache&& rhs) noexcept = default;
+
+        /**
+         * @brief Write everything cached so far to the file. Call it while the device is still alive.
+         */
+        void Save() const;
+
+        const vk::raii::PipelineCache& GetPipelineCache() const { return m_pipeline_cache; }
+
+    private:
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t vendor_id;
+            uint32_t device_id;
+            uint32_t driver_version;
+            uint8_t  pipeline_cache_uuid[VK_UUID_SIZE];
+            uint64_t data_size;
+            uint64_t data_hash;
+        };
+
+        static constexpr uint32_t k_magic   = 0x43504d4d; // "MMPC"
+        static constexpr uint32_t k_version = 1;
+
+        FileHeader MakeFileHeader() const;
+
+        bool IsValid(const uint8_t* file_data_ptr, size_t file_size) const;
+
+        vk::PhysicalDeviceProperties m_physical_device_properties;
+        std::string                  m_file_path;
+        vk::raii::PipelineCache      m_pipeline_cache = nullptr;
+    };
+} // namespace Meow
@@ -8,6 +8,10 @@ namespace Meow
         {
             for (size_t i = 0; i < descriptor_set_layouts.size(); ++i)
             {
+                // owned by the bindless descriptor table
+                if (static_cast<int32_t>(i) == bindless_set)
+                    continue;
+
                 m_dispatcher->vkDestroyDescriptorSetLayout(
                     static_cast<VkDevice>(m_device),
                     static_cast<VkDescriptorSetLayout>(descriptor_set_layouts[i]),
@@ -4,8 +4,8 @@
 
 #include "function/render/buffer_data/image_data.h"
 #include "function/render/model/vertex_attribute.h"
+#include "function/resource/resource_base.h"
 
-#include <spirv_glsl.hpp>
 #include <vulkan/vulkan_raii.hpp>
 
 #include <cstdint>
@@ -153,7 +153,7 @@ namespace Meow
      * one parameter block uniform buffer, but the Material class still allocate 32KB ring buffer for it.
      * TODO: support un-dynamic
      */
-    struct Shader
+    struct Shader : public ResourceBase
     {
         using InputBindingsVector   = std::vector<vk::VertexInputBindingDescription>;
         using InputAttributesVector = std::vector<vk::VertexInputAttributeDescription>;
@@ -187,6 +187,11 @@ namespace Meow
         std::vector<vk::DescriptorSetLayout> descriptor_set_layouts;
         vk::raii::PipelineLayout             pipeline_layout = nullptr;
 
+        /**
+         * @brief Set declaring the arrays of BindlessDescriptorTable, whose layout belongs to the table, or -1.
+         */
+        int32_t bindless_set = -1;
+
         Shader() = default;
         ~Shader();
 
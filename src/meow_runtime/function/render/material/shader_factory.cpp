@@ -1,6 +1,8 @@
 #include "shader_factory.h"
 #include "function/global/runtime_context.h"
 
+#include <algorithm>
+
 namespace Meow
 {
     ShaderFactory& ShaderFactory::clear()
@@ -133,160 +135,132 @@ namespace Meow
 
         auto [data_ptr, data_size] = g_runtime_context.file_system.get()->ReadBinaryFile(shader_file_path);
 
+        // SPIR-V is a stream of 32-bit words, anything else would be read past its end
+        if (!data_ptr || data_size == 0 || data_size % sizeof(uint32_t) != 0)
+        {
+            MEOW_ERROR("Shader {} is missing or not SPIR-V!", shader_file_path);
+            delete[] data_ptr;
+            return false;
+        }
+
         shader_module = vk::raii::ShaderModule(
             logical_device, vk::ShaderModuleCreateInfo(vk::ShaderModuleCreateFlags(), data_size, (uint32_t*)data_ptr));
 
         pipeline_shader_stage_create_infos.emplace_back(
             vk::PipelineShaderStageCreateFlags(), stage, *shader_module, "main", nullptr);
 
-        spirv_cross::Compiler        compiler((uint32_t*)data_ptr, data_size / sizeof(uint32_t));
-        spirv_cross::ShaderResources resources = compiler.get_shader_resources();
+        ShaderReflection reflection = LoadOrReflect(shader_file_path, data_ptr, data_size);
 
-        GetAttachmentsMeta(shader, compiler, resources, stage);
-        GetUniformBuffersMeta(shader, compiler, resources, stage);
-        GetTexturesMeta(shader, compiler, resources, stage);
-        GetStorageImagesMeta(shader, compiler, resources, stage);
-        GetInputMeta(shader, compiler, resources, stage);
-        GetStorageBuffersMeta(shader, compiler, resources, stage);
+        GetDescriptorsMeta(shader, reflection, stage);
+        GetInputMeta(shader, reflection, stage);
 
         delete[] data_ptr;
         return true;
     }
 
-    void ShaderFactory::GetAttachmentsMeta(Shader&                       shader,
-                                           spirv_cross::Compiler&        compiler,
-                                           spirv_cross::ShaderResources& resources,
-                                           vk::ShaderStageFlags          stageFlags)
+    ShaderReflection
+    ShaderFactory::LoadOrReflect(const std::string& shader_file_path, const uint8_t* spirv_ptr, uint32_t spirv_size)
     {
-        for (size_t i = 0; i < resources.subpass_inputs.size(); ++i)
-        {
-            spirv_cross::Resource& res      = resources.subpass_inputs[i];
-            const std::string&     var_name = compiler.get_name(res.id);
+        FUNCTION_TIMER();
 
-            uint32_t set     = compiler.get_decoration(res.id, spv::DecorationDescriptorSet);
-            uint32_t binding = compiler.get_decoration(res.id, spv::DecorationBinding);
+        const std::string reflection_file_path = GetShaderReflectionPath(shader_file_path);
 
-            vk::DescriptorSetLayoutBinding set_layout_binding(
-                binding, vk::DescriptorType::eInputAttachment, 1, stageFlags, nullptr);
+        ShaderReflection reflection;
 
-            shader.set_layout_metas.AddDescriptorSetLayoutBinding(var_name, set, set_layout_binding);
+        auto [file_data_ptr, file_size] = g_runtime_context.file_system->ReadBinaryFile(reflection_file_path);
+        bool is_loaded =
+            file_data_ptr && DeserializeShaderReflection(file_data_ptr, file_size, spirv_ptr, spirv_size, reflection);
+        delete[] file_data_ptr;
 
-            auto it = shader.image_meta_map.find(var_name);
-            if (it == shader.image_meta_map.end())
-            {
-                ImageMeta image_meta;
-                image_meta.set            = set;
-                image_meta.binding        = binding;
-                image_meta.stageFlags     = stageFlags;
-                image_meta.descriptorType = set_layout_binding.descriptorType;
-                shader.image_meta_map.emplace(var_name, image_meta);
-            }
-            else
-            {
-                it->second.stageFlags |= stageFlags;
-            }
-        }
-    }
+        if (is_loaded)
+            return reflection;
 
-    void ShaderFactory::GetUniformBuffersMeta(Shader&                       shader,
-                                              spirv_cross::Compiler&        compiler,
-                                              spirv_cross::ShaderResources& resources,
-                                              vk::ShaderStageFlags          stageFlags)
-    {
-        for (size_t i = 0; i < resources.uniform_buffers.size(); ++i)
-        {
-            spirv_cross::Resource& res          = resources.uniform_buffers[i];
-            spirv_cross::SPIRType  type         = compiler.get_type(res.type_id);
-            const std::string&     var_name     = compiler.get_name(res.id);
-            const std::string&     type_name    = compiler.get_name(res.base_type_id);
-            uint32_t uniform_buffer_struct_size = static_cast<uint32_t>(compiler.get_declared_struct_size(type));
-
-            uint32_t set     = compiler.get_decoration(res.id, spv::DecorationDescriptorSet);
-            uint32_t binding = compiler.get_decoration(res.id, spv::DecorationBinding);
-
-            vk::DescriptorSetLayoutBinding set_layout_binding(binding,
-                                                              (type_name.find("Dynamic") != std::string::npos) ?
-                                                                  vk::DescriptorType::eUniformBufferDynamic :
-                                                                  vk::DescriptorType::eUniformBuffer,
-                                                              1,
-                                                              stageFlags,
-                                                              nullptr);
-
-            shader.set_layout_metas.AddDescriptorSetLayoutBinding(var_name, set, set_layout_binding);
-
-            auto it = shader.buffer_meta_map.find(var_name);
-            if (it == shader.buffer_meta_map.end())
-            {
-                BufferMeta buffer_meta;
-                buffer_meta.set            = set;
-                buffer_meta.binding        = binding;
-                buffer_meta.size           = uniform_buffer_struct_size;
-                buffer_meta.stageFlags     = stageFlags;
-                buffer_meta.descriptorType = set_layout_binding.descriptorType;
+        MEOW_INFO("Reflection of {} is missing or stale, reflecting with SPIRV-Cross.", shader_file_path);
 
-#ifdef MEOW_DEBUG
-                buffer_meta.var_name  = var_name;
-                buffer_meta.type_name = type_name;
-#endif
+        reflection = ReflectSpirv(reinterpret_cast<const uint32_t*>(spirv_ptr), spirv_size / sizeof(uint32_t));
 
-                shader.buffer_meta_map.emplace(var_name, buffer_meta);
-            }
-            else
-            {
-                it->second.stageFlags |= stageFlags;
-            }
+        std::vector<uint8_t> reflection_file_data = SerializeShaderReflection(reflection, spirv_ptr, spirv_size);
+        if (!g_runtime_context.file_system->WriteBinaryFile(
+                reflection_file_path, reflection_file_data.data(), reflection_file_data.size()))
+        {
+            MEOW_WARN("Failed to save shader reflection to {}.", reflection_file_path);
         }
+
+        return reflection;
     }
 
-    void ShaderFactory::GetTexturesMeta(Shader&                       shader,
-                                        spirv_cross::Compiler&        compiler,
-                                        spirv_cross::ShaderResources& resources,
-                                        vk::ShaderStageFlags          stageFlags)
+    void ShaderFactory::GetDescriptorsMeta(Shader&                 shader,
+                                           const ShaderReflection& reflection,
+                                           vk::ShaderStageFlags    stageFlags)
     {
-        for (size_t i = 0; i < resources.sampled_images.size(); ++i)
+        for (const ShaderResourceReflection& resource : reflection.resources)
         {
-            spirv_cross::Resource& res      = resources.sampled_images[i];
-            const std::string&     var_name = compiler.get_name(res.id);
-
-            uint32_t set     = compiler.get_decoration(res.id, spv::DecorationDescriptorSet);
-            uint32_t binding = compiler.get_decoration(res.id, spv::DecorationBinding);
+            const std::string& var_name = resource.var_name;
 
             vk::DescriptorSetLayoutBinding set_layout_binding(
-                binding, vk::DescriptorType::eCombinedImageSampler, 1, stageFlags, nullptr);
+                resource.binding, resource.descriptor_type, 1, stageFlags, nullptr);
+
+            shader.set_layout_metas.AddDescriptorSetLayoutBinding(var_name, resource.set, set_layout_binding);
 
-            shader.set_layout_metas.AddDescriptorSetLayoutBinding(var_name, set, set_layout_binding);
+            bool is_buffer = resource.descriptor_type == vk::DescriptorType::eUniformBuffer ||
+                             resource.descriptor_type == vk::DescriptorType::eUniformBufferDynamic ||
+                             resource.descriptor_type == vk::DescriptorType::eStorageBuffer;
 
-            auto it = shader.image_meta_map.find(var_name);
-            if (it == shader.image_meta_map.end())
+            if (is_buffer)
             {
-                ImageMeta image_meta;
-                image_meta.set            = set;
-                image_meta.binding        = binding;
-                image_meta.stageFlags     = stageFlags;
-                image_meta.descriptorType = set_layout_binding.descriptorType;
-                shader.image_meta_map.emplace(var_name, image_meta);
+                auto it = shader.buffer_meta_map.find(var_name);
+                if (it == shader.buffer_meta_map.end())
+                {
+                    BufferMeta buffer_meta;
+                    buffer_meta.set            = resource.set;
+                    buffer_meta.binding        = resource.binding;
+                    buffer_meta.size           = resource.size;
+                    buffer_meta.stageFlags     = stageFlags;
+                    buffer_meta.descriptorType = resource.descriptor_type;
+
+#ifdef MEOW_DEBUG
+                    buffer_meta.var_name  = var_name;
+                    buffer_meta.type_name = resource.type_name;
+#endif
+
+                    shader.buffer_meta_map.emplace(var_name, buffer_meta);
+                }
+                else
+                {
+                    it->second.stageFlags |= stageFlags;
+                }
             }
             else
             {
-                it->second.stageFlags |= stageFlags;
+                auto it = shader.image_meta_map.find(var_name);
+                if (it == shader.image_meta_map.end())
+                {
+                    ImageMeta image_meta;
+                    image_meta.set            = resource.set;
+                    image_meta.binding        = resource.binding;
+                    image_meta.stageFlags     = stageFlags;
+                    image_meta.descriptorType = resource.descriptor_type;
+                    shader.image_meta_map.emplace(var_name, image_meta);
+                }
+                else
+                {
+                    it->second.stageFlags |= stageFlags;
+                }
             }
         }
     }
 
-    void ShaderFactory::GetInputMeta(Shader&                       shader,
-                                     spirv_cross::Compiler&        compiler,
-                                     spirv_cross::ShaderResources& resources,
-                                     vk::ShaderStageFlags          stageFlags)
+    void ShaderFactory::GetInputMeta(Shader&                 shader,
+                                     const ShaderReflection& reflection,
+                                     vk::ShaderStageFlags    stageFlags)
     {
         if (stageFlags != vk::ShaderStageFlagBits::eVertex)
             return;
 
-        for (size_t i = 0; i < resources.stage_inputs.size(); ++i)
+        for (const ShaderInputReflection& input : reflection.stage_inputs)
         {
-            spirv_cross::Resource& res                  = resources.stage_inputs[i];
-            spirv_cross::SPIRType  type                 = compiler.get_type(res.type_id);
-            const std::string&     var_name             = compiler.get_name(res.id);
-            int32_t                input_attribute_size = type.vecsize;
+            const std::string& var_name             = input.var_name;
+            uint32_t           input_attribute_size = input.vec_size;
 
             size_t pos = var_name.find("in");
             if (pos == std::string::npos)
@@ -306,85 +280,13 @@ namespace Meow
                     attribute = VertexAttributeBit::InstanceFloat4;
             }
 
-            int32_t             location = compiler.get_decoration(res.id, spv::DecorationLocation);
             VertexAttributeMeta vertex_attribute_meta;
-            vertex_attribute_meta.location  = location;
+            vertex_attribute_meta.location  = input.location;
             vertex_attribute_meta.attribute = attribute;
             shader.vertex_attribute_metas.push_back(vertex_attribute_meta);
         }
     }
 
-    void ShaderFactory::GetStorageBuffersMeta(Shader&                       shader,
-                                              spirv_cross::Compiler&        compiler,
-                                              spirv_cross::ShaderResources& resources,
-                                              vk::ShaderStageFlags          stageFlags)
-    {
-        for (size_t i = 0; i < resources.storage_buffers.size(); ++i)
-        {
-            spirv_cross::Resource& res      = resources.storage_buffers[i];
-            const std::string&     var_name = compiler.get_name(res.id);
-
-            uint32_t set     = compiler.get_decoration(res.id, spv::DecorationDescriptorSet);
-            uint32_t binding = compiler.get_decoration(res.id, spv::DecorationBinding);
-
-            vk::DescriptorSetLayoutBinding set_layout_binding(
-                binding, vk::DescriptorType::eStorageBuffer, 1, stageFlags, nullptr);
-
-            shader.set_layout_metas.AddDescriptorSetLayoutBinding(var_name, set, set_layout_binding);
-
-            auto it = shader.buffer_meta_map.find(var_name);
-            if (it == shader.buffer_meta_map.end())
-            {
-                BufferMeta buffer_meta;
-                buffer_meta.set            = set;
-                buffer_meta.binding        = binding;
-                buffer_meta.size           = 0;
-                buffer_meta.stageFlags     = stageFlags;
-                buffer_meta.descriptorType = set_layout_binding.descriptorType;
-                shader.buffer_meta_map.emplace(var_name, buffer_meta);
-            }
-            else
-            {
-                it->second.stageFlags |= stageFlags;
-            }
-        }
-    }
-
-    void ShaderFactory::GetStorageImagesMeta(Shader&                       shader,
-                                             spirv_cross::Compiler&        compiler,
-                                             spirv_cross::ShaderResources& resources,
-                                             vk::ShaderStageFlags          stageFlags)
-    {
-        for (size_t i = 0; i < resources.storage_images.size(); ++i)
-        {
-            spirv_cross::Resource& res      = resources.storage_images[i];
-            const std::string&     var_name = compiler.get_name(res.id);
-
-            uint32_t set     = compiler.get_decoration(res.id, spv::DecorationDescriptorSet);
-            uint32_t binding = compiler.get_decoration(res.id, spv::DecorationBinding);
-
-            vk::DescriptorSetLayoutBinding set_layout_binding(
-                binding, vk::DescriptorType::eStorageImage, 1, stageFlags, nullptr);
-
-            shader.set_layout_metas.AddDescriptorSetLayoutBinding(var_name, set, set_layout_binding);
-
-            auto it = shader.image_meta_map.find(var_name);
-            if (it == shader.image_meta_map.end())
-            {
-                ImageMeta image_meta;
-                image_meta.set            = set;
-                image_meta.binding        = binding;
-                image_meta.stageFlags     = stageFlags;
-                image_meta.descriptorType = set_layout_binding.descriptorType;
-                shader.image_meta_map.emplace(var_name, image_meta);
-            }
-            else
-            {
-                it->second.stageFlags |= stageFlags;
-            }
-        }
-    }
-
     void ShaderFactory::GenerateInputInfo(Shader& shader)
     {
         std::sort(shader.vertex_attribute_metas.begin(),
@@ -472,6 +374,22 @@ namespace Meow
                       });
         }
 
+        // the set declaring the bindless arrays takes the layout of the table, which sizes them and allows updating
+        // them after binding
+        auto& binding_meta_map = shader.set_layout_metas.binding_meta_map;
+        auto  bindless_it      = binding_meta_map.find(BindlessDescriptorTable::k_sampled_images_binding_name);
+        if (bindless_it == binding_meta_map.end())
+            bindless_it = binding_meta_map.find(BindlessDescriptorTable::k_storage_buffers_binding_name);
+
+        shader.bindless_set = -1;
+        if (bindless_it != binding_meta_map.end())
+        {
+            if (g_runtime_context.render_system->GetBindlessSupported())
+                shader.bindless_set = bindless_it->second.set;
+            else
+                MEOW_ERROR("Shader declares bindless arrays, but descriptor indexing is not supported!");
+        }
+
         shader.descriptor_set_layouts.clear();
         if (metas.empty())
         {
@@ -482,6 +400,13 @@ namespace Meow
         {
             for (auto& set_layout_meta : metas)
             {
+                if (static_cast<int32_t>(set_layout_meta.set) == shader.bindless_set)
+                {
+                    shader.descriptor_set_layouts.push_back(
+                        g_runtime_context.render_system->GetBindlessDescriptorTable().GetDescriptorSetLayout());
+                    continue;
+                }
+
                 vk::DescriptorSetLayoutCreateInfo descriptor_set_layout_create_info(
                     vk::DescriptorSetLayoutCreateFlags(), set_layout_meta.bindings);
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "shader.h"
+#include "shader_reflection.h"
 
 namespace Meow
 {
@@ -28,35 +29,16 @@ namespace Meow
             vk::ShaderStageFlagBits                         stage,
             std::vector<vk::PipelineShaderStageCreateInfo>& pipeline_shader_stage_create_infos);
 
-        void GetAttachmentsMeta(Shader&                       shader,
-                                spirv_cross::Compiler&        compiler,
-                                spirv_cross::ShaderResources& resources,
-                                vk::ShaderStageFlags          stageFlags);
+        /**
+         * @brief Load the reflection file beside the SPIR-V file, or reflect the SPIR-V and write the file if it is
+         * missing or stale.
+         */
+        ShaderReflection
+        LoadOrReflect(const std::string& shader_file_path, const uint8_t* spirv_ptr, uint32_t spirv_size);
 
-        void GetUniformBuffersMeta(Shader&                       shader,
-                                   spirv_cross::Compiler&        compiler,
-                                   spirv_cross::ShaderResources& resources,
-                                   vk::ShaderStageFlags          stageFlags);
+        void GetDescriptorsMeta(Shader& shader, const ShaderReflection& reflection, vk::ShaderStageFlags stageFlags);
 
-        void GetTexturesMeta(Shader&                       shader,
-                             spirv_cross::Compiler&        compiler,
-                             spirv_cross::ShaderResources& resources,
-                             vk::ShaderStageFlags          stageFlags);
-
-        void GetInputMeta(Shader&                       shader,
-                          spirv_cross::Compiler&        compiler,
-                          spirv_cross::ShaderResources& resources,
-                          vk::ShaderStageFlags          stageFlags);
-
-        void GetStorageBuffersMeta(Shader&                       shader,
-                                   spirv_cross::Compiler&        compiler,
-                                   spirv_cross::ShaderResources& resources,
-                                   vk::ShaderStageFlags          stageFlags);
-
-        void GetStorageImagesMeta(Shader&                       shader,
-                                  spirv_cross::Compiler&        compiler,
-                                  spirv_cross::ShaderResources& resources,
-                                  vk::ShaderStageFlags          stageFlags);
+        void GetInputMeta(Shader& shader, const ShaderReflection& reflection, vk::ShaderStageFlags stageFlags);
 
         void GenerateInputInfo(Shader& shader);
         void GeneratePipelineLayout(Shader& shader);
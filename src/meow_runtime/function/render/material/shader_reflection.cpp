@@ -0,0 +1,220 @@
+#include "shader_reflection.h"
+
+#include "core/base/hash.h"
+
+#include <spirv_glsl.hpp>
+
+#include <cstring>
+
+namespace Meow
+{
+    namespace
+    {
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t spirv_size;
+            uint64_t spirv_hash;
+        };
+
+        constexpr uint32_t k_magic   = 0x52534d4d; // "MMSR"
+        constexpr uint32_t k_version = 1;
+
+        class Writer
+        {
+        public:
+            template<typename T>
+            void Write(const T& value)
+            {
+                const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+                data.insert(data.end(), bytes, bytes + sizeof(T));
+            }
+
+            void WriteString(const std::string& value)
+            {
+                Write(static_cast<uint32_t>(value.size()));
+                data.insert(data.end(), value.begin(), value.end());
+            }
+
+            std::vector<uint8_t> data;
+        };
+
+        class Reader
+        {
+        public:
+            Reader(const uint8_t* data_ptr, size_t data_size)
+                : m_data_ptr(data_ptr)
+                , m_data_size(data_size)
+            {}
+
+            template<typename T>
+            bool Read(T& value)
+            {
+                if (m_data_size - m_offset < sizeof(T))
+                    return false;
+
+                std::memcpy(&value, m_data_ptr + m_offset, sizeof(T));
+                m_offset += sizeof(T);
+                return true;
+            }
+
+            bool ReadString(std::string& value)
+            {
+                uint32_t size = 0;
+                if (!Read(size) || m_data_size - m_offset < size)
+                    return false;
+
+                value.assign(reinterpret_cast<const char*>(m_data_ptr + m_offset), size);
+                m_offset += size;
+                return true;
+            }
+
+            bool IsAtEnd() const { return m_offset == m_data_size; }
+
+        private:
+            const uint8_t* m_data_ptr  = nullptr;
+            size_t         m_data_size = 0;
+            size_t         m_offset    = 0;
+        };
+
+        void ReflectResources(spirv_cross::Compiler&                                 compiler,
+                              const spirv_cross::SmallVector<spirv_cross::Resource>& resources,
+                              vk::DescriptorType                                     descriptor_type,
+                              ShaderReflection&                                      reflection)
+        {
+            for (const spirv_cross::Resource& res : resources)
+            {
+                ShaderResourceReflection resource;
+                resource.descriptor_type = descriptor_type;
+                resource.set             = compiler.get_decoration(res.id, spv::DecorationDescriptorSet);
+                resource.binding         = compiler.get_decoration(res.id, spv::DecorationBinding);
+                resource.var_name        = compiler.get_name(res.id);
+                resource.type_name       = compiler.get_name(res.base_type_id);
+
+                if (descriptor_type == vk::DescriptorType::eUniformBuffer)
+                {
+                    const spirv_cross::SPIRType& type = compiler.get_type(res.type_id);
+                    resource.size = static_cast<uint32_t>(compiler.get_declared_struct_size(type));
+
+                    if (resource.type_name.find("Dynamic") != std::string::npos)
+                        resource.descriptor_type = vk::DescriptorType::eUniformBufferDynamic;
+                }
+
+                reflection.resources.push_back(std::move(resource));
+            }
+        }
+    } // namespace
+
+    ShaderReflection ReflectSpirv(const uint32_t* spirv_ptr, size_t spirv_word_count)
+    {
+        spirv_cross::Compiler        compiler(spirv_ptr, spirv_word_count);
+        spirv_cross::ShaderResources resources = compiler.get_shader_resources();
+
+        ShaderReflection reflection;
+        ReflectResources(compiler, resources.subpass_inputs, vk::DescriptorType::eInputAttachment, reflection);
+        ReflectResources(compiler, resources.uniform_buffers, vk::DescriptorType::eUniformBuffer, reflection);
+        ReflectResources(compiler, resources.sampled_images, vk::DescriptorType::eCombinedImageSampler, reflection);
+        ReflectResources(compiler, resources.storage_images, vk::DescriptorType::eStorageImage, reflection);
+        ReflectResources(compiler, resources.storage_buffers, vk::DescriptorType::eStorageBuffer, reflection);
+
+        for (const spirv_cross::Resource& res : resources.stage_inputs)
+        {
+            ShaderInputReflection input;
+            input.location = compiler.get_decoration(res.id, spv::DecorationLocation);
+            input.vec_size = compiler.get_type(res.type_id).vecsize;
+            input.var_name = compiler.get_name(res.id);
+            reflection.stage_inputs.push_back(std::move(input));
+        }
+
+        return reflection;
+    }
+
+    std::string GetShaderReflectionPath(const std::string& spirv_file_path) { return spirv_file_path + ".refl"; }
+
+    std::vector<uint8_t>
+    SerializeShaderReflection(const ShaderReflection& reflection, const uint8_t* spirv_ptr, size_t spirv_size)
+    {
+        FileHeader header {};
+        header.magic      = k_magic;
+        header.version    = k_version;
+        header.spirv_size = spirv_size;
+        header.spirv_hash = HashBytes(spirv_ptr, spirv_size);
+
+        Writer writer;
+        writer.Write(header);
+
+        writer.Write(static_cast<uint32_t>(reflection.resources.size()));
+        for (const ShaderResourceReflection& resource : reflection.resources)
+        {
+            writer.Write(static_cast<uint32_t>(resource.descriptor_type));
+            writer.Write(resource.set);
+            writer.Write(resource.binding);
+            writer.Write(resource.size);
+            writer.WriteString(resource.var_name);
+            writer.WriteString(resource.type_name);
+        }
+
+        writer.Write(static_cast<uint32_t>(reflection.stage_inputs.size()));
+        for (const ShaderInputReflection& input : reflection.stage_inputs)
+        {
+            writer.Write(input.location);
+            writer.Write(input.vec_size);
+            writer.WriteString(input.var_name);
+        }
+
+        return std::move(writer.data);
+    }
+
+    bool DeserializeShaderReflection(const uint8_t*    file_data_ptr,
+                                     size_t            file_size,
+                                     const uint8_t*    spirv_ptr,
+                                     size_t            spirv_size,
+                                     ShaderReflection& reflection)
+    {
+        Reader reader(file_data_ptr, file_size);
+
+        FileHeader header;
+        if (!reader.Read(header) || header.magic != k_magic || header.version != k_version ||
+            header.spirv_size != spirv_size || header.spirv_hash != HashBytes(spirv_ptr, spirv_size))
+            return false;
+
+        ShaderReflection result;
+
+        uint32_t resource_count = 0;
+        if (!reader.Read(resource_count))
+            return false;
+
+        for (uint32_t i = 0; i < resource_count; ++i)
+        {
+            ShaderResourceReflection resource;
+            uint32_t                 descriptor_type = 0;
+            if (!reader.Read(descriptor_type) || !reader.Read(resource.set) || !reader.Read(resource.binding) ||
+                !reader.Read(resource.size) || !reader.ReadString(resource.var_name) ||
+                !reader.ReadString(resource.type_name))
+                return false;
+
+            resource.descriptor_type = static_cast<vk::DescriptorType>(descriptor_type);
+            result.resources.push_back(std::move(resource));
+        }
+
+        uint32_t input_count = 0;
+        if (!reader.Read(input_count))
+            return false;
+
+        for (uint32_t i = 0; i < input_count; ++i)
+        {
+            ShaderInputReflection input;
+            if (!reader.Read(input.location) || !reader.Read(input.vec_size) || !reader.ReadString(input.var_name))
+                return false;
+
+            result.stage_inputs.push_back(std::move(input));
+        }
+
+        if (!reader.IsAtEnd())
+            return false;
+
+        reflection = std::move(result);
+        return true;
+    }
+} // namespace Meow
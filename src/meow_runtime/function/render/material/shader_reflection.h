@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief A descriptor used by one shader stage.
+     */
+    struct ShaderResourceReflection
+    {
+        vk::DescriptorType descriptor_type = vk::DescriptorType::eUniformBuffer;
+        uint32_t           set             = 0;
+        uint32_t           binding         = 0;
+        // declared size of uniform buffers, 0 for other descriptors
+        uint32_t    size = 0;
+        std::string var_name;
+        std::string type_name;
+    };
+
+    /**
+     * @brief An input variable of a vertex shader.
+     */
+    struct ShaderInputReflection
+    {
+        int32_t     location = 0;
+        uint32_t    vec_size = 0;
+        std::string var_name;
+    };
+
+    /**
+     * @brief Everything ShaderFactory needs from one SPIR-V module, so that SPIRV-Cross only runs when the module has
+     * no valid reflection file.
+     *
+     * Resources keep the order SPIRV-Cross lists them in: subpass inputs, uniform buffers, sampled images, storage
+     * images and storage buffers.
+     */
+    struct ShaderReflection
+    {
+        std::vector<ShaderResourceReflection> resources;
+        std::vector<ShaderInputReflection>    stage_inputs;
+    };
+
+    /**
+     * @brief Reflect a SPIR-V module with SPIRV-Cross.
+     */
+    ShaderReflection ReflectSpirv(const uint32_t* spirv_ptr, size_t spirv_word_count);
+
+    /**
+     * @brief Path of the reflection file stored beside a SPIR-V file.
+     */
+    std::string GetShaderReflectionPath(const std::string& spirv_file_path);
+
+    /**
+     * @brief Serialize reflection into the content of a reflection file, keyed by the hash of the SPIR-V it comes
+     * from.
+     */
+    std::vector<uint8_t>
+    SerializeShaderReflection(const ShaderReflection& reflection, const uint8_t* spirv_ptr, size_t spirv_size);
+
+    /**
+     * @brief Read the content of a reflection file.
+     *
+     * @return false The file is truncated, of another version, or was made from another SPIR-V, and reflection is
+     * left untouched.
+     */
+    bool DeserializeShaderReflection(const uint8_t*    file_data_ptr,
+                                     size_t            file_size,
+                                     const uint8_t*    spirv_ptr,
+                                     size_t            spirv_size,
+                                     ShaderReflection& reflection);
+} // namespace Meow
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 namespace Meow
@@ -9,4 +10,6 @@ namespace Meow
         Opaque      = 0,
         Translucent = 1,
     };
+
+    constexpr size_t k_shading_model_type_count = 2;
 } // namespace Meow
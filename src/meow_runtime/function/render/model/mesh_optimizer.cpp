@@ -0,0 +1,351 @@
+#include "mesh_optimizer.h"
+
+#include "pch.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+
+namespace Meow
+{
+    namespace
+    {
+        constexpr uint32_t k_invalid_vertex = 0xffffffff;
+
+        /**
+         * @brief FIFO cache of vertex indices, using time stamps instead of a queue: a vertex is cached if it entered
+         * less than cache_size misses ago.
+         */
+        class VertexCacheSimulator
+        {
+        public:
+            VertexCacheSimulator(size_t vertex_count, uint32_t cache_size)
+                : m_time_stamps(vertex_count, 0)
+                , m_cache_size(cache_size)
+                , m_time_stamp(cache_size + 1)
+            {}
+
+            /**
+             * @brief Return whether the vertex missed the cache.
+             */
+            bool Access(uint32_t vertex)
+            {
+                if (m_time_stamp - m_time_stamps[vertex] <= m_cache_size)
+                    return false;
+
+                m_time_stamps[vertex] = m_time_stamp++;
+                return true;
+            }
+
+            /**
+             * @brief Forget everything, as if the cache was flushed.
+             */
+            void Reset() { m_time_stamp += m_cache_size + 1; }
+
+        private:
+            std::vector<uint32_t> m_time_stamps;
+            uint32_t              m_cache_size;
+            uint32_t              m_time_stamp;
+        };
+
+        /**
+         * @brief Triangles using each vertex, as ranges of one array.
+         */
+        struct TriangleAdjacency
+        {
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> counts;
+            std::vector<uint32_t> triangles;
+
+            TriangleAdjacency(const std::vector<uint32_t>& indices, size_t vertex_count)
+                : offsets(vertex_count, 0)
+                , counts(vertex_count, 0)
+                , triangles(indices.size())
+            {
+                for (uint32_t index : indices)
+                    ++counts[index];
+
+                uint32_t offset = 0;
+                for (size_t i = 0; i < vertex_count; ++i)
+                {
+                    offsets[i] = offset;
+                    offset += counts[i];
+                }
+
+                std::vector<uint32_t> filled(vertex_count, 0);
+                for (size_t i = 0; i < indices.size(); ++i)
+                {
+                    uint32_t vertex = indices[i];
+                    triangles[offsets[vertex] + filled[vertex]++] = static_cast<uint32_t>(i / 3);
+                }
+            }
+        };
+
+        uint32_t SkipDeadEnd(std::vector<uint32_t>&       dead_end_stack,
+                             const std::vector<uint32_t>& live_triangles,
+                             uint32_t&                    cursor)
+        {
+            while (!dead_end_stack.empty())
+            {
+                uint32_t vertex = dead_end_stack.back();
+                dead_end_stack.pop_back();
+                if (live_triangles[vertex] > 0)
+                    return vertex;
+            }
+
+            for (; cursor < live_triangles.size(); ++cursor)
+            {
+                if (live_triangles[cursor] > 0)
+                    return cursor;
+            }
+
+            return k_invalid_vertex;
+        }
+    } // namespace
+
+    VertexCacheStatistics
+    AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size)
+    {
+        VertexCacheStatistics statistics;
+        if (indices.empty() || vertex_count == 0)
+            return statistics;
+
+        VertexCacheSimulator cache(vertex_count, cache_size);
+
+        size_t misses = 0;
+        for (uint32_t index : indices)
+            misses += cache.Access(index);
+
+        statistics.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+        statistics.atvr = static_cast<float>(misses) / static_cast<float>(vertex_count);
+        return statistics;
+    }
+
+    void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size)
+    {
+        FUNCTION_TIMER();
+
+        if (indices.size() < 3 || vertex_count == 0)
+            return;
+
+        size_t            triangle_count = indices.size() / 3;
+        TriangleAdjacency adjacency(indices, vertex_count);
+
+        std::vector<uint32_t> live_triangles = adjacency.counts;
+        std::vector<uint32_t> time_stamps(vertex_count, 0);
+        std::vector<uint8_t>  emitted(triangle_count, 0);
+        std::vector<uint32_t> dead_end_stack;
+        std::vector<uint32_t> candidates;
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+
+        uint32_t time_stamp = cache_size + 1;
+        uint32_t cursor     = 0;
+        uint32_t fan_vertex = SkipDeadEnd(dead_end_stack, live_triangles, cursor);
+
+        while (fan_vertex != k_invalid_vertex)
+        {
+            candidates.clear();
+
+            // emit every triangle around the fanning vertex
+            uint32_t begin = adjacency.offsets[fan_vertex];
+            for (uint32_t i = begin; i < begin + adjacency.counts[fan_vertex]; ++i)
+            {
+                uint32_t triangle = adjacency.triangles[i];
+                if (emitted[triangle])
+                    continue;
+
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    uint32_t vertex = indices[triangle * 3 + k];
+                    result.push_back(vertex);
+                    dead_end_stack.push_back(vertex);
+                    candidates.push_back(vertex);
+                    --live_triangles[vertex];
+
+                    if (time_stamp - time_stamps[vertex] > cache_size)
+                        time_stamps[vertex] = time_stamp++;
+                }
+                emitted[triangle] = 1;
+            }
+
+            // fan next around the candidate that is still in the cache once its remaining triangles are emitted,
+            // preferring the one that entered it first
+            uint32_t next_vertex   = k_invalid_vertex;
+            int64_t  best_priority = -1;
+            for (uint32_t vertex : candidates)
+            {
+                if (live_triangles[vertex] == 0)
+                    continue;
+
+                int64_t priority = 0;
+                if (time_stamp - time_stamps[vertex] + 2 * live_triangles[vertex] <= cache_size)
+                    priority = time_stamp - time_stamps[vertex];
+
+                if (priority > best_priority)
+                {
+                    best_priority = priority;
+                    next_vertex   = vertex;
+                }
+            }
+
+            if (next_vertex == k_invalid_vertex)
+                next_vertex = SkipDeadEnd(dead_end_stack, live_triangles, cursor);
+
+            fan_vertex = next_vertex;
+        }
+
+        indices = std::move(result);
+    }
+
+    void OptimizeOverdraw(std::vector<uint32_t>&    indices,
+                          const std::vector<float>& vertices,
+                          uint32_t                  vertex_stride,
+                          uint32_t                  position_offset,
+                          float                     threshold,
+                          uint32_t                  cache_size)
+    {
+        FUNCTION_TIMER();
+
+        size_t triangle_count = indices.size() / 3;
+        size_t vertex_count   = vertex_stride > 0 ? vertices.size() / vertex_stride : 0;
+        if (triangle_count < 2 || vertex_count == 0 || position_offset + 3 > vertex_stride)
+            return;
+
+        float mesh_acmr = AnalyzeVertexCache(indices, vertex_count, cache_size).acmr;
+
+        // hard boundaries where the optimizer jumped away, soft ones where a cluster has paid off its first misses
+        std::vector<size_t> cluster_begins;
+        {
+            VertexCacheSimulator hard_cache(vertex_count, cache_size);
+            VertexCacheSimulator soft_cache(vertex_count, cache_size);
+
+            size_t cluster_triangles = 0;
+            size_t cluster_misses    = 0;
+
+            for (size_t t = 0; t < triangle_count; ++t)
+            {
+                uint32_t hard_misses = 0;
+                for (uint32_t k = 0; k < 3; ++k)
+                    hard_misses += hard_cache.Access(indices[t * 3 + k]);
+
+                bool soft_boundary = cluster_triangles > 0 && static_cast<float>(cluster_misses) <=
+                                                                  threshold * mesh_acmr * cluster_triangles;
+                if (t == 0 || hard_misses == 3 || soft_boundary)
+                {
+                    cluster_begins.push_back(t);
+                    cluster_triangles = 0;
+                    cluster_misses    = 0;
+                    soft_cache.Reset();
+                }
+
+                for (uint32_t k = 0; k < 3; ++k)
+                    cluster_misses += soft_cache.Access(indices[t * 3 + k]);
+                ++cluster_triangles;
+            }
+        }
+
+        auto get_position = [&](uint32_t vertex) {
+            const float* position = &vertices[static_cast<size_t>(vertex) * vertex_stride + position_offset];
+            return glm::vec3(position[0], position[1], position[2]);
+        };
+
+        // area weighted centroids and normals of the clusters, the cross product being twice the area
+        std::vector<glm::vec3> cluster_centroids(cluster_begins.size(), glm::vec3(0.0f));
+        std::vector<glm::vec3> cluster_normals(cluster_begins.size(), glm::vec3(0.0f));
+        std::vector<float>     cluster_areas(cluster_begins.size(), 0.0f);
+        glm::vec3              mesh_centroid(0.0f);
+        float                  mesh_area = 0.0f;
+
+        for (size_t c = 0; c < cluster_begins.size(); ++c)
+        {
+            size_t end = c + 1 < cluster_begins.size() ? cluster_begins[c + 1] : triangle_count;
+            for (size_t t = cluster_begins[c]; t < end; ++t)
+            {
+                glm::vec3 p0 = get_position(indices[t * 3 + 0]);
+                glm::vec3 p1 = get_position(indices[t * 3 + 1]);
+                glm::vec3 p2 = get_position(indices[t * 3 + 2]);
+
+                glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                float     area   = glm::length(normal);
+
+                cluster_centroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+                cluster_normals[c] += normal;
+                cluster_areas[c] += area;
+            }
+
+            mesh_centroid += cluster_centroids[c];
+            mesh_area += cluster_areas[c];
+        }
+
+        if (mesh_area <= 0.0f)
+            return;
+
+        mesh_centroid /= mesh_area;
+
+        // clusters facing away from the center are in front of the others from most views
+        std::vector<float> cluster_sort_keys(cluster_begins.size(), 0.0f);
+        for (size_t c = 0; c < cluster_begins.size(); ++c)
+        {
+            float normal_length = glm::length(cluster_normals[c]);
+            if (cluster_areas[c] <= 0.0f || normal_length <= 0.0f)
+                continue;
+
+            glm::vec3 centroid   = cluster_centroids[c] / cluster_areas[c];
+            cluster_sort_keys[c] = glm::dot(centroid - mesh_centroid, cluster_normals[c] / normal_length);
+        }
+
+        std::vector<size_t> cluster_order(cluster_begins.size());
+        for (size_t c = 0; c < cluster_order.size(); ++c)
+            cluster_order[c] = c;
+
+        std::stable_sort(cluster_order.begin(), cluster_order.end(), [&](size_t lhs, size_t rhs) {
+            return cluster_sort_keys[lhs] > cluster_sort_keys[rhs];
+        });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (size_t c : cluster_order)
+        {
+            size_t end = c + 1 < cluster_begins.size() ? cluster_begins[c + 1] : triangle_count;
+            result.insert(result.end(), indices.begin() + cluster_begins[c] * 3, indices.begin() + end * 3);
+        }
+
+        indices = std::move(result);
+    }
+
+    size_t OptimizeVertexFetch(std::vector<uint32_t>& indices, std::vector<float>& vertices, uint32_t vertex_stride)
+    {
+        FUNCTION_TIMER();
+
+        if (vertex_stride == 0)
+            return 0;
+
+        size_t vertex_count = vertices.size() / vertex_stride;
+
+        std::vector<uint32_t> remap(vertex_count, k_invalid_vertex);
+        uint32_t              next_vertex = 0;
+        for (uint32_t& index : indices)
+        {
+            if (remap[index] == k_invalid_vertex)
+                remap[index] = next_vertex++;
+
+            index = remap[index];
+        }
+
+        std::vector<float> result(static_cast<size_t>(next_vertex) * vertex_stride);
+        for (size_t i = 0; i < vertex_count; ++i)
+        {
+            if (remap[i] == k_invalid_vertex)
+                continue;
+
+            std::copy_n(vertices.begin() + i * vertex_stride,
+                        vertex_stride,
+                        result.begin() + static_cast<size_t>(remap[i]) * vertex_stride);
+        }
+
+        vertices = std::move(result);
+        return next_vertex;
+    }
+} // namespace Meow
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Post-transform vertex cache size the optimizations assume. GPUs differ, but orders good for 16 entries
+     * stay good for other sizes.
+     */
+    constexpr uint32_t k_vertex_cache_size = 16;
+
+    struct VertexCacheStatistics
+    {
+        // average cache miss ratio: transformed vertices per triangle, 0.5 at best and 3 at worst
+        float acmr = 0.0f;
+        // average transform to vertex ratio: transformed vertices per vertex, 1 at best
+        float atvr = 0.0f;
+    };
+
+    /**
+     * @brief Simulate a FIFO vertex cache over the triangle list.
+     */
+    VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32_t>& indices,
+                                             size_t                       vertex_count,
+                                             uint32_t                     cache_size = k_vertex_cache_size);
+
+    /**
+     * @brief Reorder triangles so that vertices are reused while still in the cache, using Tipsify from "Fast
+     * Triangle Reordering for Vertex Locality and Reduced Overdraw" (Sander et al. 2007).
+     */
+    void OptimizeVertexCache(std::vector<uint32_t>& indices,
+                             size_t                 vertex_count,
+                             uint32_t               cache_size = k_vertex_cache_size);
+
+    /**
+     * @brief Reorder clusters of an index buffer already optimized for the vertex cache, so that outward facing
+     * clusters draw first and hide what is behind them from any view. Clusters are split where the cache misses stay
+     * below threshold times the ACMR of the whole mesh, which bounds how much cache efficiency is given up.
+     *
+     * @param vertex_stride Floats per vertex
+     * @param position_offset Floats from the start of a vertex to its position
+     */
+    void OptimizeOverdraw(std::vector<uint32_t>&    indices,
+                          const std::vector<float>& vertices,
+                          uint32_t                  vertex_stride,
+                          uint32_t                  position_offset,
+                          float                     threshold  = 1.05f,
+                          uint32_t                  cache_size = k_vertex_cache_size);
+
+    /**
+     * @brief Renumber vertices in the order the triangles first use them, so that vertex fetches walk memory
+     * linearly. Vertices no triangle uses are dropped.
+     *
+     * @param vertex_stride Floats per vertex
+     * @return Vertex count after the remap
+     */
+    size_t OptimizeVertexFetch(std::vector<uint32_t>& indices, std::vector<float>& vertices, uint32_t vertex_stride);
+} // namespace Meow
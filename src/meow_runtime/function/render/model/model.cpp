@@ -4,6 +4,7 @@
 
 #include "core/math/assimp_glm_helper.h"
 #include "function/global/runtime_context.h"
+#include "mesh_optimizer.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
@@ -16,11 +17,15 @@
 
 namespace Meow
 {
-    Model::Model(const std::string& file_path, const std::vector<VertexAttributeBit>& attributes)
+    Model::Model(const std::string&                     file_path,
+                 const std::vector<VertexAttributeBit>& attributes,
+                 bool                                   optimize_overdraw)
     {
-        this->attributes = attributes;
+        this->attributes       = attributes;
+        this->optimizeOverdraw = optimize_overdraw;
 
-        int assimpFlags = aiProcess_Triangulate | aiProcess_FlipUVs;
+        // without joining, every triangle gets vertices of its own and nothing can be reused from the vertex cache
+        int assimpFlags = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices;
 
         for (size_t i = 0; i < attributes.size(); ++i)
         {
@@ -84,13 +89,43 @@ namespace Meow
         GotoAnimation(animation.time);
     }
 
-    BoundingBox Model::GetBounding()
+    const BoundingBox& Model::GetBounding()
     {
-        BoundingBox bounding;
+        if (!m_bounding_dirty)
+            return m_bounding;
 
-        for (const auto& node : linear_nodes)
+        // root node merges bounds of all its children
+        m_bounding       = root_node ? root_node->GetBounds() : BoundingBox();
+        m_bounding_dirty = false;
+
+        return m_bounding;
+    }
+
+    BoundingBox Model::CalculatePositionBounding(const std::vector<float>&              vertices,
+                                                 const std::vector<VertexAttributeBit>& attributes)
+    {
+        uint32_t position_offset = 0;
+        bool     has_position    = false;
+        for (auto attribute : attributes)
         {
-            bounding.Merge(node->GetBounds());
+            if (attribute == VertexAttributeBit::Position)
+            {
+                has_position = true;
+                break;
+            }
+            position_offset += VertexAttributeToSize(attribute) / sizeof(float);
+        }
+
+        uint32_t stride = VertexAttributesToSize(attributes) / sizeof(float);
+        if (!has_position || stride == 0 || vertices.size() < stride)
+            return BoundingBox();
+
+        BoundingBox bounding(glm::vec3(std::numeric_limits<float>::max()),
+                             glm::vec3(-std::numeric_limits<float>::max()));
+        for (size_t i = position_offset; i + 2 < vertices.size(); i += stride)
+        {
+            glm::vec3 position(vertices[i], vertices[i + 1], vertices[i + 2]);
+            bounding.Merge(position, position);
         }
 
         return bounding;
@@ -264,8 +299,10 @@ namespace Meow
         // load indices
         LoadIndices(mesh->indices, ai_mesh, ai_scene);
 
+        mesh->vertex_count = ai_mesh->mNumVertices;
+        OptimizeMesh(mesh, ai_mesh);
+
         mesh->RefreshBuffer();
-        mesh->vertex_count   = ai_mesh->mNumVertices;
         mesh->triangle_count = (size_t)mesh->indices.size() / 3;
 
         return mesh;
@@ -538,6 +575,45 @@ namespace Meow
         }
     }
 
+    void Model::OptimizeMesh(ModelMesh* mesh, const aiMesh* ai_mesh)
+    {
+        FUNCTION_TIMER();
+
+        uint32_t stride = VertexAttributesToSize(attributes) / sizeof(float);
+        if (stride == 0 || mesh->indices.empty())
+            return;
+
+        uint32_t position_offset = 0;
+        bool     has_position    = false;
+        for (auto attribute : attributes)
+        {
+            if (attribute == VertexAttributeBit::Position)
+            {
+                has_position = true;
+                break;
+            }
+            position_offset += VertexAttributeToSize(attribute) / sizeof(float);
+        }
+
+        VertexCacheStatistics before = AnalyzeVertexCache(mesh->indices, mesh->vertex_count);
+
+        OptimizeVertexCache(mesh->indices, mesh->vertex_count);
+        if (optimizeOverdraw && has_position)
+        {
+            OptimizeOverdraw(mesh->indices, mesh->vertices, stride, position_offset);
+        }
+        mesh->vertex_count = OptimizeVertexFetch(mesh->indices, mesh->vertices, stride);
+
+        VertexCacheStatistics after = AnalyzeVertexCache(mesh->indices, mesh->vertex_count);
+
+        MEOW_INFO("Mesh {} optimized: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}.",
+                  ai_mesh->mName.C_Str(),
+                  before.acmr,
+                  after.acmr,
+                  before.atvr,
+                  after.atvr);
+    }
+
     void Model::LoadAnim(const aiScene* ai_scene)
     {
         for (size_t i = 0; i < (size_t)ai_scene->mNumAnimations; ++i)
@@ -649,13 +725,15 @@ namespace Meow
             }
         }
 
+        UploadManager& upload_manager = g_runtime_context.render_system->GetUploadManager();
+
         new_mesh->vertex_buffer_ptr = std::make_shared<VertexBuffer>(
             physical_device, device, command_pool, queue, new_mesh->vertices.size() * sizeof(float));
-        new_mesh->vertex_buffer_ptr->Upload(physical_device, device, command_pool, queue, new_mesh->vertices, 0);
+        new_mesh->vertex_buffer_ptr->Upload(upload_manager, new_mesh->vertices, 0);
 
         new_mesh->index_buffer_ptr = std::make_shared<IndexBuffer>(
             physical_device, device, command_pool, queue, new_mesh->indices.size() * sizeof(uint32_t));
-        new_mesh->index_buffer_ptr->Upload(physical_device, device, command_pool, queue, new_mesh->indices, 0);
+        new_mesh->index_buffer_ptr->Upload(upload_manager, new_mesh->indices, 0);
 
         delete root_node;
         root_node       = new_node;
@@ -666,6 +744,8 @@ namespace Meow
         linear_nodes.clear();
         linear_nodes.push_back(new_node);
 
+        m_bounding_dirty = true;
+
         for (size_t i = 0; i < bones.size(); ++i)
         {
             delete bones[i];
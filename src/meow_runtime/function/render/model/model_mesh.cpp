@@ -13,6 +13,7 @@ namespace Meow
         const vk::raii::CommandPool&    onetime_submit_command_pool =
             g_runtime_context.render_system->GetOneTimeSubmitCommandPool();
         const vk::raii::Queue& graphics_queue = g_runtime_context.render_system->GetGraphicsQueue();
+        UploadManager&         upload_manager = g_runtime_context.render_system->GetUploadManager();
 
         if (!vertices.empty())
         {
@@ -21,8 +22,7 @@ namespace Meow
                                                                onetime_submit_command_pool,
                                                                graphics_queue,
                                                                vertices.size() * sizeof(float));
-            vertex_buffer_ptr->Upload(
-                physical_device, logical_device, onetime_submit_command_pool, graphics_queue, vertices, 0);
+            vertex_buffer_ptr->Upload(upload_manager, vertices, 0);
         }
         if (!indices.empty())
         {
@@ -31,8 +31,7 @@ namespace Meow
                                                              onetime_submit_command_pool,
                                                              graphics_queue,
                                                              indices.size() * sizeof(uint32_t));
-            index_buffer_ptr->Upload(
-                physical_device, logical_device, onetime_submit_command_pool, graphics_queue, indices, 0);
+            index_buffer_ptr->Upload(upload_manager, indices, 0);
         }
     }
 
@@ -56,21 +55,25 @@ namespace Meow
         }
     }
 
-    void ModelMesh::DrawOnly(const vk::raii::CommandBuffer& command_buffer)
+    void ModelMesh::DrawOnly(const vk::raii::CommandBuffer& command_buffer,
+                             uint32_t                       instance_count,
+                             uint32_t                       first_instance)
     {
         FUNCTION_TIMER();
 
         if (vertex_buffer_ptr && index_buffer_ptr)
         {
-            command_buffer.drawIndexed(index_buffer_ptr->data_number, 1, 0, 0, 0);
+            command_buffer.drawIndexed(index_buffer_ptr->data_number, instance_count, 0, 0, first_instance);
         }
         else if (vertex_buffer_ptr)
         {
-            command_buffer.draw(vertex_count, 1, 0, 0);
+            command_buffer.draw(vertex_count, instance_count, 0, first_instance);
         }
     }
 
-    void ModelMesh::BindDrawCmd(const vk::raii::CommandBuffer& command_buffer)
+    void ModelMesh::BindDrawCmd(const vk::raii::CommandBuffer& command_buffer,
+                                uint32_t                       instance_count,
+                                uint32_t                       first_instance)
     {
         FUNCTION_TIMER();
 
@@ -81,6 +84,24 @@ namespace Meow
         }
 
         BindOnly(command_buffer);
-        DrawOnly(command_buffer);
+        DrawOnly(command_buffer, instance_count, first_instance);
+    }
+
+    void ModelMesh::BindDrawCmd(const vk::raii::CommandBuffer& command_buffer,
+                                RenderStateCache&              state_cache,
+                                uint32_t                       instance_count,
+                                uint32_t                       first_instance)
+    {
+        FUNCTION_TIMER();
+
+        if (!vertex_buffer_ptr)
+        {
+            MEOW_ERROR("Doesn't have vertex buffer!");
+            return;
+        }
+
+        if (state_cache.SetMesh(this))
+            BindOnly(command_buffer);
+        DrawOnly(command_buffer, instance_count, first_instance);
     }
 }; // namespace Meow
\ No newline at end of file
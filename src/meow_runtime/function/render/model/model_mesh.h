@@ -1,9 +1,11 @@
 #pragma once
 
 #include "core/math/bounding_box.h"
+#include "function/render/batch/render_state_cache.h"
 #include "function/render/buffer_data/index_buffer.h"
 #include "function/render/buffer_data/vertex_buffer.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -30,15 +32,38 @@ namespace Meow
         std::vector<size_t> bones;
         bool                isSkin = false;
 
+        /**
+         * @brief Unique per mesh, used as the mesh field of render queue sort keys.
+         */
+        uint32_t sort_id = m_mesh_count++;
+
         void RefreshBuffer();
 
         void BindOnly(const vk::raii::CommandBuffer& command_buffer);
 
-        void DrawOnly(const vk::raii::CommandBuffer& command_buffer);
+        /**
+         * @brief Shaders reading ObjectDataBuffer get first_instance + i as gl_InstanceIndex of instance i.
+         */
+        void DrawOnly(const vk::raii::CommandBuffer& command_buffer,
+                      uint32_t                       instance_count = 1,
+                      uint32_t                       first_instance = 0);
+
+        void BindDrawCmd(const vk::raii::CommandBuffer& command_buffer,
+                         uint32_t                       instance_count = 1,
+                         uint32_t                       first_instance = 0);
 
-        void BindDrawCmd(const vk::raii::CommandBuffer& command_buffer);
+        /**
+         * @brief Skip binding buffers if this mesh is the last one bound in the render pass being recorded.
+         */
+        void BindDrawCmd(const vk::raii::CommandBuffer& command_buffer,
+                         RenderStateCache&              state_cache,
+                         uint32_t                       instance_count = 1,
+                         uint32_t                       first_instance = 0);
 
         ~ModelMesh() { link_node = nullptr; }
+
+    private:
+        inline static std::atomic<uint32_t> m_mesh_count {0};
     };
 
 } // namespace Meow
@@ -0,0 +1,967 @@
+#include "render_graph.h"
+
+#include "pch.h"
+
+#include "function/global/runtime_context.h"
+#include "function/render/utils/vulkan_debug_utils.h"
+
+#include <algorithm>
+#include <map>
+
+namespace Meow
+{
+    namespace
+    {
+        struct AccessInfo
+        {
+            vk::ImageLayout     layout;
+            vk::AccessFlags     access;
+            vk::ImageUsageFlags usage;
+            bool                write;
+            bool                attachment;
+        };
+
+        const vk::raii::RenderPass k_null_render_pass = nullptr;
+
+        constexpr vk::AccessFlags k_write_access =
+            vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite |
+            vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eTransferWrite | vk::AccessFlagBits::eMemoryWrite;
+
+        bool IsDepthFormat(vk::Format format)
+        {
+            switch (format)
+            {
+                case vk::Format::eD16Unorm:
+                case vk::Format::eX8D24UnormPack32:
+                case vk::Format::eD32Sfloat:
+                case vk::Format::eD16UnormS8Uint:
+                case vk::Format::eD24UnormS8Uint:
+                case vk::Format::eD32SfloatS8Uint:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        bool HasStencil(vk::Format format)
+        {
+            return format == vk::Format::eS8Uint || format == vk::Format::eD16UnormS8Uint ||
+                   format == vk::Format::eD24UnormS8Uint || format == vk::Format::eD32SfloatS8Uint;
+        }
+
+        AccessInfo GetAccessInfo(RenderGraphAccess access, vk::Format format)
+        {
+            vk::ImageLayout read_only_layout =
+                IsDepthFormat(format) ? vk::ImageLayout::eDepthStencilReadOnlyOptimal :
+                                        vk::ImageLayout::eShaderReadOnlyOptimal;
+
+            switch (access)
+            {
+                case RenderGraphAccess::ColorAttachment:
+                case RenderGraphAccess::ResolveAttachment:
+                    return {vk::ImageLayout::eColorAttachmentOptimal,
+                            vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite,
+                            vk::ImageUsageFlagBits::eColorAttachment,
+                            true,
+                            true};
+                case RenderGraphAccess::DepthAttachment:
+                    return {vk::ImageLayout::eDepthStencilAttachmentOptimal,
+                            vk::AccessFlagBits::eDepthStencilAttachmentRead |
+                                vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+                            vk::ImageUsageFlagBits::eDepthStencilAttachment,
+                            true,
+                            true};
+                case RenderGraphAccess::DepthRead:
+                    return {vk::ImageLayout::eDepthStencilReadOnlyOptimal,
+                            vk::AccessFlagBits::eDepthStencilAttachmentRead,
+                            vk::ImageUsageFlagBits::eDepthStencilAttachment,
+                            false,
+                            true};
+                case RenderGraphAccess::InputAttachment:
+                    return {read_only_layout,
+                            vk::AccessFlagBits::eInputAttachmentRead,
+                            vk::ImageUsageFlagBits::eInputAttachment,
+                            false,
+                            true};
+                case RenderGraphAccess::SampledImage:
+                    return {read_only_layout,
+                            vk::AccessFlagBits::eShaderRead,
+                            vk::ImageUsageFlagBits::eSampled,
+                            false,
+                            false};
+                case RenderGraphAccess::StorageRead:
+                    return {vk::ImageLayout::eGeneral,
+                            vk::AccessFlagBits::eShaderRead,
+                            vk::ImageUsageFlagBits::eStorage,
+                            false,
+                            false};
+                case RenderGraphAccess::StorageWrite:
+                default:
+                    return {vk::ImageLayout::eGeneral,
+                            vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite,
+                            vk::ImageUsageFlagBits::eStorage,
+                            true,
+                            false};
+            }
+        }
+    } // namespace
+
+    RenderGraphPass& RenderGraphPass::WriteColor(RenderGraphResource                resource,
+                                                 std::optional<vk::ClearColorValue> clear_value)
+    {
+        return AddUsage(resource,
+                        RenderGraphAccess::ColorAttachment,
+                        vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                        clear_value ? std::optional<vk::ClearValue>(*clear_value) : std::nullopt);
+    }
+
+    RenderGraphPass& RenderGraphPass::ResolveColor(RenderGraphResource resource)
+    {
+        return AddUsage(
+            resource, RenderGraphAccess::ResolveAttachment, vk::PipelineStageFlagBits::eColorAttachmentOutput);
+    }
+
+    RenderGraphPass& RenderGraphPass::WriteDepth(RenderGraphResource                       resource,
+                                                 std::optional<vk::ClearDepthStencilValue> clear_value)
+    {
+        return AddUsage(resource,
+                        RenderGraphAccess::DepthAttachment,
+                        vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+                        clear_value ? std::optional<vk::ClearValue>(*clear_value) : std::nullopt);
+    }
+
+    RenderGraphPass& RenderGraphPass::ReadDepth(RenderGraphResource resource)
+    {
+        return AddUsage(resource,
+                        RenderGraphAccess::DepthRead,
+                        vk::PipelineStageFlagBits::eEarlyFragmentTests |
+                            vk::PipelineStageFlagBits::eLateFragmentTests);
+    }
+
+    RenderGraphPass& RenderGraphPass::ReadInputAttachment(RenderGraphResource resource)
+    {
+        return AddUsage(resource, RenderGraphAccess::InputAttachment, vk::PipelineStageFlagBits::eFragmentShader);
+    }
+
+    RenderGraphPass& RenderGraphPass::ReadTexture(RenderGraphResource resource, vk::PipelineStageFlags stages)
+    {
+        return AddUsage(resource, RenderGraphAccess::SampledImage, stages);
+    }
+
+    RenderGraphPass& RenderGraphPass::ReadStorage(RenderGraphResource resource, vk::PipelineStageFlags stages)
+    {
+        return AddUsage(resource, RenderGraphAccess::StorageRead, stages);
+    }
+
+    RenderGraphPass& RenderGraphPass::WriteStorage(RenderGraphResource resource, vk::PipelineStageFlags stages)
+    {
+        return AddUsage(resource, RenderGraphAccess::StorageWrite, stages);
+    }
+
+    RenderGraphPass& RenderGraphPass::SetSideEffects()
+    {
+        m_side_effects = true;
+        return *this;
+    }
+
+    RenderGraphPass& RenderGraphPass::SetExecute(ExecuteFunc execute)
+    {
+        m_execute = std::move(execute);
+        return *this;
+    }
+
+    RenderGraphPass& RenderGraphPass::SetSecondaryCommandBuffers(bool enabled)
+    {
+        m_secondary_command_buffers = enabled;
+        return *this;
+    }
+
+    RenderGraphPass& RenderGraphPass::AddUsage(RenderGraphResource           resource,
+                                               RenderGraphAccess             access,
+                                               vk::PipelineStageFlags        stages,
+                                               std::optional<vk::ClearValue> clear_value)
+    {
+        if (resource == k_invalid_render_graph_resource)
+        {
+            MEOW_ERROR("Render graph pass {} uses an invalid resource!", m_name);
+            return *this;
+        }
+
+        m_usages.push_back({resource, access, stages, clear_value});
+        return *this;
+    }
+
+    RenderGraphResource RenderGraph::CreateImage(const std::string& name, const RenderGraphImageDesc& desc)
+    {
+        Resource resource;
+        resource.name = name;
+        resource.desc = desc;
+
+        m_resources.push_back(std::move(resource));
+        return static_cast<RenderGraphResource>(m_resources.size() - 1);
+    }
+
+    RenderGraphResource RenderGraph::ImportImage(const std::string&                name,
+                                                 const RenderGraphImageDesc&       desc,
+                                                 const std::vector<vk::Image>&     images,
+                                                 const std::vector<vk::ImageView>& image_views,
+                                                 vk::ImageLayout                   initial_layout,
+                                                 vk::ImageLayout                   final_layout)
+    {
+        if (image_views.empty() || (!images.empty() && images.size() != image_views.size()))
+        {
+            MEOW_ERROR("Render graph image {} should be imported with one view per image!", name);
+            return k_invalid_render_graph_resource;
+        }
+
+        Resource resource;
+        resource.name                 = name;
+        resource.desc                 = desc;
+        resource.imported             = true;
+        resource.imported_images      = images;
+        resource.imported_image_views = image_views;
+        resource.initial_layout       = initial_layout;
+        resource.final_layout         = final_layout;
+
+        m_resources.push_back(std::move(resource));
+        return static_cast<RenderGraphResource>(m_resources.size() - 1);
+    }
+
+    void RenderGraph::MarkOutput(RenderGraphResource resource)
+    {
+        if (resource >= m_resources.size())
+        {
+            MEOW_ERROR("Render graph resource {} doesn't exist!", resource);
+            return;
+        }
+
+        m_resources[resource].output = true;
+    }
+
+    RenderGraphPass& RenderGraph::AddPass(const std::string& name)
+    {
+        return m_passes.emplace_back(static_cast<uint32_t>(m_passes.size()), name);
+    }
+
+    void RenderGraph::Compile()
+    {
+        FUNCTION_TIMER();
+
+        // drop what an earlier compile made, images before the memory they are placed in
+        m_groups.clear();
+        m_final_barriers.clear();
+        for (Resource& resource : m_resources)
+        {
+            resource.image_view      = nullptr;
+            resource.image           = nullptr;
+            resource.first_group     = k_no_group;
+            resource.last_group      = 0;
+            resource.only_attachment = true;
+            resource.usage_flags     = resource.desc.usage_flags;
+            resource.alias_predecessors.clear();
+            resource.dedicated_memory.Free();
+        }
+        m_transient_memory.Free();
+        m_transient_memory_size = 0;
+        m_unaliased_memory_size = 0;
+
+        BuildGroups();
+        CreateTransientImages();
+        BuildBarriers();
+
+        uint32_t render_pass_count = 0;
+        for (uint32_t i = 0; i < m_groups.size(); ++i)
+        {
+            if (m_groups[i].attachments.empty())
+                continue;
+
+            CreateRenderPass(i);
+            ++render_pass_count;
+        }
+
+        uint32_t alive_count = static_cast<uint32_t>(std::count(m_pass_alive.begin(), m_pass_alive.end(), 1));
+        MEOW_INFO("Render graph keeps {} of {} passes in {} render passes, transient images take {} KiB instead of {} "
+                  "KiB.",
+                  alive_count,
+                  m_passes.size(),
+                  render_pass_count,
+                  m_transient_memory_size / 1024,
+                  m_unaliased_memory_size / 1024);
+    }
+
+    void RenderGraph::BuildGroups()
+    {
+        std::vector<RenderGraphSchedulePass>     schedule_passes(m_passes.size());
+        std::vector<RenderGraphScheduleResource> schedule_resources(m_resources.size());
+
+        for (size_t i = 0; i < m_resources.size(); ++i)
+        {
+            const Resource& resource = m_resources[i];
+            schedule_resources[i]    = {
+                   resource.desc.extent.width, resource.desc.extent.height, resource.imported, resource.output};
+        }
+
+        for (size_t i = 0; i < m_passes.size(); ++i)
+        {
+            schedule_passes[i].side_effects = m_passes[i].m_side_effects;
+            for (const auto& usage : m_passes[i].m_usages)
+            {
+                AccessInfo info      = GetAccessInfo(usage.access, m_resources[usage.resource].desc.format);
+                bool       overwrite = usage.clear_value || usage.access == RenderGraphAccess::ResolveAttachment;
+                schedule_passes[i].usages.push_back({usage.resource, info.write, info.attachment, overwrite});
+            }
+        }
+
+        RenderGraphSchedule schedule = ScheduleRenderGraph(schedule_passes, schedule_resources);
+
+        m_pass_alive     = std::move(schedule.pass_alive);
+        m_pass_groups    = std::move(schedule.pass_groups);
+        m_pass_subpasses = std::move(schedule.pass_subpasses);
+
+        for (RenderGraphResource i = 0; i < m_resources.size(); ++i)
+        {
+            m_resources[i].first_group     = schedule.first_groups[i];
+            m_resources[i].last_group      = schedule.last_groups[i];
+            m_resources[i].only_attachment = schedule.only_attachment[i];
+        }
+
+        for (const RenderGraphScheduleGroup& schedule_group : schedule.groups)
+        {
+            Group& group      = m_groups.emplace_back();
+            group.passes      = schedule_group.passes;
+            group.attachments = schedule_group.attachments;
+            group.extent      = vk::Extent2D(schedule_group.width, schedule_group.height);
+
+            for (uint32_t pass_index : group.passes)
+            {
+                const RenderGraphPass& pass = m_passes[pass_index];
+                for (const auto& usage : pass.m_usages)
+                {
+                    Resource&  resource = m_resources[usage.resource];
+                    AccessInfo info     = GetAccessInfo(usage.access, resource.desc.format);
+                    resource.usage_flags |= info.usage;
+
+                    if (info.attachment && resource.desc.extent != group.extent)
+                    {
+                        MEOW_ERROR("Render graph pass {} has attachments of different extents!", pass.m_name);
+                    }
+                }
+            }
+        }
+    }
+
+    bool RenderGraph::IsTransitionedByRenderPass(const Resource& resource) const
+    {
+        return resource.imported && resource.only_attachment && resource.first_group != k_no_group &&
+               resource.first_group == resource.last_group;
+    }
+
+    void RenderGraph::CreateTransientImages()
+    {
+        const vk::raii::PhysicalDevice& physical_device = g_runtime_context.render_system->GetPhysicalDevice();
+        const vk::raii::Device&         logical_device  = g_runtime_context.render_system->GetLogicalDevice();
+
+        std::vector<RenderGraphResource> transient_resources;
+
+        for (RenderGraphResource i = 0; i < m_resources.size(); ++i)
+        {
+            Resource& resource = m_resources[i];
+
+            resource.aspect_mask = vk::ImageAspectFlagBits::eColor;
+            if (IsDepthFormat(resource.desc.format))
+            {
+                resource.aspect_mask = vk::ImageAspectFlagBits::eDepth;
+                if (HasStencil(resource.desc.format))
+                    resource.aspect_mask |= vk::ImageAspectFlagBits::eStencil;
+            }
+
+            if (resource.imported || resource.first_group == k_no_group)
+                continue;
+
+            vk::ImageCreateInfo image_create_info(vk::ImageCreateFlags(),
+                                                  vk::ImageType::e2D,
+                                                  resource.desc.format,
+                                                  vk::Extent3D(resource.desc.extent, 1),
+                                                  1,
+                                                  1,
+                                                  resource.desc.sample_count,
+                                                  vk::ImageTiling::eOptimal,
+                                                  resource.usage_flags,
+                                                  vk::SharingMode::eExclusive,
+                                                  {},
+                                                  vk::ImageLayout::eUndefined);
+            resource.image               = vk::raii::Image(logical_device, image_create_info);
+            resource.memory_requirements = resource.image.getMemoryRequirements();
+
+            m_unaliased_memory_size += resource.memory_requirements.size;
+            transient_resources.push_back(i);
+        }
+
+        std::vector<RenderGraphAliasImage> alias_images;
+        for (RenderGraphResource i : transient_resources)
+        {
+            const Resource&               resource     = m_resources[i];
+            const vk::MemoryRequirements& requirements = resource.memory_requirements;
+            alias_images.push_back({requirements.size,
+                                    requirements.alignment,
+                                    requirements.memoryTypeBits,
+                                    resource.first_group,
+                                    resource.last_group});
+        }
+
+        RenderGraphAliasPlacement placement = PlaceRenderGraphImages(alias_images);
+
+        if (placement.heap_size > 0)
+        {
+            vk::MemoryRequirements heap_requirements(
+                placement.heap_size, placement.heap_alignment, placement.memory_type_bits);
+            m_transient_memory = AllocateResourceMemory(physical_device,
+                                                        logical_device,
+                                                        heap_requirements,
+                                                        vk::MemoryPropertyFlagBits::eDeviceLocal,
+                                                        ResourceTiling::Optimal);
+            m_transient_memory_size += placement.heap_size;
+        }
+
+        for (uint32_t k = 0; k < transient_resources.size(); ++k)
+        {
+            Resource& resource = m_resources[transient_resources[k]];
+
+            if (placement.dedicated[k])
+            {
+                resource.dedicated_memory = AllocateResourceMemory(physical_device,
+                                                                   logical_device,
+                                                                   resource.memory_requirements,
+                                                                   vk::MemoryPropertyFlagBits::eDeviceLocal,
+                                                                   ResourceTiling::Optimal);
+                resource.image.bindMemory(resource.dedicated_memory.GetMemory(), resource.dedicated_memory.GetOffset());
+                m_transient_memory_size += resource.memory_requirements.size;
+                continue;
+            }
+
+            resource.memory_offset = placement.offsets[k];
+            resource.image.bindMemory(m_transient_memory.GetMemory(),
+                                      m_transient_memory.GetOffset() + resource.memory_offset);
+
+            for (uint32_t predecessor : placement.predecessors[k])
+                resource.alias_predecessors.push_back(transient_resources[predecessor]);
+        }
+
+        for (RenderGraphResource i : transient_resources)
+        {
+            Resource& resource = m_resources[i];
+
+            vk::ImageViewCreateInfo image_view_create_info(vk::ImageViewCreateFlags(),
+                                                           *resource.image,
+                                                           vk::ImageViewType::e2D,
+                                                           resource.desc.format,
+                                                           {},
+                                                           {resource.aspect_mask, 0, 1, 0, 1});
+            resource.image_view = vk::raii::ImageView(logical_device, image_view_create_info);
+
+#if defined(VKB_DEBUG) || defined(VKB_VALIDATION_LAYERS)
+            vk::DebugUtilsObjectNameInfoEXT name_info = {
+                vk::ObjectType::eImage,
+                NON_DISPATCHABLE_HANDLE_TO_UINT64_CAST(VkImage, *resource.image),
+                resource.name.c_str()};
+            logical_device.setDebugUtilsObjectNameEXT(name_info);
+#endif
+        }
+    }
+
+    void RenderGraph::BuildBarriers()
+    {
+        std::vector<ImageState> states(m_resources.size());
+        for (size_t i = 0; i < m_resources.size(); ++i)
+        {
+            // whatever happened to an imported image before the frame is unknown
+            if (m_resources[i].imported)
+                states[i] = {m_resources[i].initial_layout,
+                             vk::PipelineStageFlagBits::eAllCommands,
+                             vk::AccessFlagBits::eMemoryWrite};
+        }
+
+        for (uint32_t group_index = 0; group_index < m_groups.size(); ++group_index)
+        {
+            Group&                           group = m_groups[group_index];
+            std::vector<RenderGraphResource> touched_resources;
+
+            for (uint32_t pass_index : group.passes)
+            {
+                for (const auto& usage : m_passes[pass_index].m_usages)
+                {
+                    Resource&   resource = m_resources[usage.resource];
+                    AccessInfo  info     = GetAccessInfo(usage.access, resource.desc.format);
+                    ImageState& state    = states[usage.resource];
+
+                    // later accesses inside a render pass are ordered by subpass dependencies
+                    if (std::find(touched_resources.begin(), touched_resources.end(), usage.resource) !=
+                        touched_resources.end())
+                    {
+                        state.layout = info.layout;
+                        state.stages |= usage.stages;
+                        state.access |= info.access;
+                        continue;
+                    }
+                    touched_resources.push_back(usage.resource);
+
+                    // the render pass moves the image out of its initial layout, see CreateRenderPass()
+                    if (IsTransitionedByRenderPass(resource))
+                    {
+                        state = {info.layout, usage.stages, info.access};
+                        continue;
+                    }
+
+                    ImageState src = state;
+                    ImageState dst = {info.layout, usage.stages, info.access};
+
+                    // contents of a transient image don't survive the frame, but its memory may be shared with
+                    // images used earlier
+                    if (!resource.imported && resource.first_group == group_index)
+                    {
+                        src = {vk::ImageLayout::eUndefined, vk::PipelineStageFlagBits::eTopOfPipe, {}};
+                        for (RenderGraphResource predecessor : resource.alias_predecessors)
+                        {
+                            src.stages |= states[predecessor].stages;
+                            src.access |= states[predecessor].access;
+                        }
+                    }
+
+                    bool needs_barrier = src.layout != dst.layout || (src.access & k_write_access) ||
+                                         ((dst.access & k_write_access) && src.access);
+                    if (needs_barrier && resource.imported && resource.imported_images.empty())
+                        MEOW_ERROR("Render graph image {} needs a barrier, but was imported without images!",
+                                   resource.name);
+                    else if (needs_barrier)
+                        group.barriers.push_back({usage.resource, src, dst});
+
+                    state = dst;
+                }
+            }
+        }
+
+        for (RenderGraphResource i = 0; i < m_resources.size(); ++i)
+        {
+            const Resource& resource = m_resources[i];
+            if (!resource.imported || IsTransitionedByRenderPass(resource) || states[i].layout == resource.final_layout)
+                continue;
+
+            if (resource.imported_images.empty())
+            {
+                MEOW_ERROR("Render graph image {} needs a barrier, but was imported without images!", resource.name);
+                continue;
+            }
+
+            m_final_barriers.push_back(
+                {i,
+                 states[i],
+                 {resource.final_layout, vk::PipelineStageFlagBits::eAllCommands, vk::AccessFlagBits::eMemoryRead}});
+        }
+    }
+
+    void RenderGraph::CreateRenderPass(uint32_t group_index)
+    {
+        const vk::raii::Device& logical_device = g_runtime_context.render_system->GetLogicalDevice();
+
+        Group& group = m_groups[group_index];
+
+        // index of the attachment in the group, and whether each subpass uses it
+        auto get_attachment_index = [&group](RenderGraphResource resource) {
+            return static_cast<uint32_t>(std::find(group.attachments.begin(), group.attachments.end(), resource) -
+                                         group.attachments.begin());
+        };
+        std::vector<std::vector<uint8_t>> subpass_uses(group.passes.size(),
+                                                       std::vector<uint8_t>(group.attachments.size(), 0));
+
+        std::vector<vk::AttachmentDescription> attachment_descriptions;
+        group.clear_values.assign(group.attachments.size(), vk::ClearValue());
+
+        for (uint32_t a = 0; a < group.attachments.size(); ++a)
+        {
+            RenderGraphResource resource_index = group.attachments[a];
+            const Resource&     resource       = m_resources[resource_index];
+
+            const RenderGraphPass::Usage* first_usage = nullptr;
+            const RenderGraphPass::Usage* last_usage  = nullptr;
+            for (uint32_t s = 0; s < group.passes.size(); ++s)
+            {
+                for (const auto& usage : m_passes[group.passes[s]].m_usages)
+                {
+                    if (usage.resource != resource_index)
+                        continue;
+
+                    if (!first_usage)
+                        first_usage = &usage;
+                    last_usage         = &usage;
+                    subpass_uses[s][a] = 1;
+                }
+            }
+
+            // contents are undefined when the frame first touches a transient image, or an imported one in
+            // eUndefined
+            bool contents_defined =
+                resource.first_group != group_index ||
+                (resource.imported && resource.initial_layout != vk::ImageLayout::eUndefined);
+
+            vk::AttachmentLoadOp load_op = vk::AttachmentLoadOp::eLoad;
+            if (first_usage->clear_value)
+            {
+                load_op               = vk::AttachmentLoadOp::eClear;
+                group.clear_values[a] = *first_usage->clear_value;
+            }
+            else if (!contents_defined || first_usage->access == RenderGraphAccess::ResolveAttachment)
+            {
+                load_op = vk::AttachmentLoadOp::eDontCare;
+            }
+
+            // nothing reads the image after the group, so tiled GPUs don't have to write it out
+            bool                  stored   = resource.imported || resource.output || resource.last_group > group_index;
+            vk::AttachmentStoreOp store_op = stored ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare;
+
+            bool has_stencil = HasStencil(resource.desc.format);
+
+            vk::ImageLayout initial_layout = GetAccessInfo(first_usage->access, resource.desc.format).layout;
+            vk::ImageLayout final_layout   = GetAccessInfo(last_usage->access, resource.desc.format).layout;
+            if (IsTransitionedByRenderPass(resource))
+            {
+                initial_layout = resource.initial_layout;
+                if (resource.final_layout != vk::ImageLayout::eUndefined)
+                    final_layout = resource.final_layout;
+            }
+
+            attachment_descriptions.emplace_back(vk::AttachmentDescriptionFlags(),
+                                                 resource.desc.format,
+                                                 resource.desc.sample_count,
+                                                 load_op,
+                                                 store_op,
+                                                 has_stencil ? load_op : vk::AttachmentLoadOp::eDontCare,
+                                                 has_stencil ? store_op : vk::AttachmentStoreOp::eDontCare,
+                                                 initial_layout,
+                                                 final_layout);
+        }
+
+        struct SubpassReferences
+        {
+            std::vector<vk::AttachmentReference>   colors;
+            std::vector<vk::AttachmentReference>   resolves;
+            std::vector<vk::AttachmentReference>   inputs;
+            std::optional<vk::AttachmentReference> depth;
+            std::vector<uint32_t>                  preserves;
+        };
+
+        std::vector<SubpassReferences>      subpass_references(group.passes.size());
+        std::vector<vk::SubpassDescription> subpass_descriptions;
+
+        // dependencies keyed by (src subpass, dst subpass)
+        std::map<std::pair<uint32_t, uint32_t>, vk::SubpassDependency> dependencies;
+
+        for (uint32_t s = 0; s < group.passes.size(); ++s)
+        {
+            const RenderGraphPass& pass       = m_passes[group.passes[s]];
+            SubpassReferences&     references = subpass_references[s];
+
+            for (const auto& usage : pass.m_usages)
+            {
+                AccessInfo info = GetAccessInfo(usage.access, m_resources[usage.resource].desc.format);
+                if (!info.attachment)
+                    continue;
+
+                uint32_t                attachment_index = get_attachment_index(usage.resource);
+                vk::AttachmentReference reference(attachment_index, info.layout);
+
+                switch (usage.access)
+                {
+                    case RenderGraphAccess::ColorAttachment:
+                        references.colors.push_back(reference);
+                        break;
+                    case RenderGraphAccess::ResolveAttachment:
+                        references.resolves.push_back(reference);
+                        break;
+                    case RenderGraphAccess::DepthAttachment:
+                    case RenderGraphAccess::DepthRead:
+                        references.depth = reference;
+                        break;
+                    default:
+                        references.inputs.push_back(reference);
+                        break;
+                }
+
+                // wait for the last earlier subpass touching the image if either of them writes it
+                for (uint32_t p = s; p-- > 0;)
+                {
+                    if (!subpass_uses[p][attachment_index])
+                        continue;
+
+                    for (const auto& other : m_passes[group.passes[p]].m_usages)
+                    {
+                        if (other.resource != usage.resource)
+                            continue;
+
+                        AccessInfo other_info = GetAccessInfo(other.access, m_resources[other.resource].desc.format);
+                        if (!info.write && !other_info.write)
+                            continue;
+
+                        vk::SubpassDependency& dependency = dependencies[{p, s}];
+                        dependency.srcSubpass             = p;
+                        dependency.dstSubpass             = s;
+                        dependency.srcStageMask |= other.stages;
+                        dependency.dstStageMask |= usage.stages;
+                        dependency.srcAccessMask |= other_info.access;
+                        dependency.dstAccessMask |= info.access;
+                        dependency.dependencyFlags = vk::DependencyFlagBits::eByRegion;
+                    }
+                    break;
+                }
+            }
+
+            if (references.resolves.size() > references.colors.size())
+            {
+                MEOW_ERROR("Render graph pass {} resolves more attachments than it writes!", pass.m_name);
+                references.resolves.resize(references.colors.size());
+            }
+            if (!references.resolves.empty())
+                references.resolves.resize(references.colors.size(),
+                                           vk::AttachmentReference(VK_ATTACHMENT_UNUSED, vk::ImageLayout::eUndefined));
+
+            // keep attachments used before and after this subpass
+            for (uint32_t a = 0; a < group.attachments.size(); ++a)
+            {
+                if (subpass_uses[s][a])
+                    continue;
+
+                bool used_before = false;
+                bool used_after  = false;
+                for (uint32_t p = 0; p < s; ++p)
+                    used_before = used_before || subpass_uses[p][a];
+                for (uint32_t p = s + 1; p < group.passes.size(); ++p)
+                    used_after = used_after || subpass_uses[p][a];
+
+                if (used_before && used_after)
+                    references.preserves.push_back(a);
+            }
+        }
+
+        // imported images transitioned here wait for whatever used them before the frame, like the barriers of
+        // BuildBarriers() would, and are made available to whatever uses them after
+        for (uint32_t a = 0; a < group.attachments.size(); ++a)
+        {
+            RenderGraphResource resource_index = group.attachments[a];
+            if (!IsTransitionedByRenderPass(m_resources[resource_index]))
+                continue;
+
+            uint32_t first_subpass = static_cast<uint32_t>(group.passes.size());
+            uint32_t last_subpass  = 0;
+            for (uint32_t s = 0; s < group.passes.size(); ++s)
+            {
+                if (!subpass_uses[s][a])
+                    continue;
+
+                first_subpass = std::min(first_subpass, s);
+                last_subpass  = s;
+            }
+
+            for (const auto& usage : m_passes[group.passes[first_subpass]].m_usages)
+            {
+                if (usage.resource != resource_index)
+                    continue;
+
+                vk::SubpassDependency& dependency = dependencies[{VK_SUBPASS_EXTERNAL, first_subpass}];
+                dependency.srcSubpass             = VK_SUBPASS_EXTERNAL;
+                dependency.dstSubpass             = first_subpass;
+                dependency.srcStageMask |= vk::PipelineStageFlagBits::eAllCommands;
+                dependency.dstStageMask |= usage.stages;
+                dependency.srcAccessMask |= vk::AccessFlagBits::eMemoryWrite;
+                dependency.dstAccessMask |= GetAccessInfo(usage.access, m_resources[resource_index].desc.format).access;
+            }
+
+            for (const auto& usage : m_passes[group.passes[last_subpass]].m_usages)
+            {
+                if (usage.resource != resource_index)
+                    continue;
+
+                vk::SubpassDependency& dependency = dependencies[{last_subpass, VK_SUBPASS_EXTERNAL}];
+                dependency.srcSubpass             = last_subpass;
+                dependency.dstSubpass             = VK_SUBPASS_EXTERNAL;
+                dependency.srcStageMask |= usage.stages;
+                dependency.dstStageMask |= vk::PipelineStageFlagBits::eAllCommands;
+                dependency.srcAccessMask |= GetAccessInfo(usage.access, m_resources[resource_index].desc.format).access;
+                dependency.dstAccessMask |= vk::AccessFlagBits::eMemoryRead;
+            }
+        }
+
+        for (const SubpassReferences& references : subpass_references)
+        {
+            subpass_descriptions.emplace_back(vk::SubpassDescriptionFlags(),
+                                              vk::PipelineBindPoint::eGraphics,
+                                              references.inputs,
+                                              references.colors,
+                                              references.resolves,
+                                              references.depth ? &*references.depth : nullptr,
+                                              references.preserves);
+        }
+
+        std::vector<vk::SubpassDependency> subpass_dependencies;
+        for (const auto& [key, dependency] : dependencies)
+        {
+            subpass_dependencies.push_back(dependency);
+        }
+
+        vk::RenderPassCreateInfo render_pass_create_info(
+            vk::RenderPassCreateFlags(), attachment_descriptions, subpass_descriptions, subpass_dependencies);
+        group.render_pass = vk::raii::RenderPass(logical_device, render_pass_create_info);
+
+        // one framebuffer per view of the imported attachments, e.g. per swapchain image
+        size_t framebuffer_count = 1;
+        for (RenderGraphResource resource_index : group.attachments)
+        {
+            framebuffer_count = std::max(framebuffer_count, m_resources[resource_index].imported_image_views.size());
+        }
+
+        group.framebuffers.reserve(framebuffer_count);
+        for (uint32_t i = 0; i < framebuffer_count; ++i)
+        {
+            std::vector<vk::ImageView> image_views;
+            for (RenderGraphResource resource_index : group.attachments)
+            {
+                image_views.push_back(GetImageView(resource_index, i));
+            }
+
+            vk::FramebufferCreateInfo framebuffer_create_info(vk::FramebufferCreateFlags(),
+                                                              *group.render_pass,
+                                                              image_views,
+                                                              group.extent.width,
+                                                              group.extent.height,
+                                                              1);
+            group.framebuffers.push_back(vk::raii::Framebuffer(logical_device, framebuffer_create_info));
+        }
+    }
+
+    void RenderGraph::RecordBarriers(const vk::raii::CommandBuffer& command_buffer,
+                                     const std::vector<Barrier>&    barriers,
+                                     uint32_t                       image_index) const
+    {
+        if (barriers.empty())
+            return;
+
+        vk::PipelineStageFlags              src_stages;
+        vk::PipelineStageFlags              dst_stages;
+        std::vector<vk::ImageMemoryBarrier> image_memory_barriers;
+        image_memory_barriers.reserve(barriers.size());
+
+        for (const Barrier& barrier : barriers)
+        {
+            src_stages |= barrier.src.stages;
+            dst_stages |= barrier.dst.stages;
+
+            image_memory_barriers.emplace_back(
+                barrier.src.access,
+                barrier.dst.access,
+                barrier.src.layout,
+                barrier.dst.layout,
+                VK_QUEUE_FAMILY_IGNORED,
+                VK_QUEUE_FAMILY_IGNORED,
+                GetImage(barrier.resource, image_index),
+                vk::ImageSubresourceRange(m_resources[barrier.resource].aspect_mask, 0, 1, 0, 1));
+        }
+
+        command_buffer.pipelineBarrier(
+            src_stages, dst_stages, vk::DependencyFlags(), nullptr, nullptr, image_memory_barriers);
+    }
+
+    void RenderGraph::Execute(const vk::raii::CommandBuffer& command_buffer,
+                              uint32_t                       frame_index,
+                              uint32_t                       image_index) const
+    {
+        FUNCTION_TIMER();
+
+        for (const Group& group : m_groups)
+        {
+            RecordBarriers(command_buffer, group.barriers, image_index);
+
+            if (group.attachments.empty())
+            {
+                const RenderGraphPass& pass = m_passes[group.passes[0]];
+                if (pass.m_execute)
+                    pass.m_execute(command_buffer, frame_index);
+                continue;
+            }
+
+            const vk::raii::Framebuffer& framebuffer = group.framebuffers[image_index % group.framebuffers.size()];
+
+            vk::RenderPassBeginInfo render_pass_begin_info(
+                *group.render_pass, *framebuffer, vk::Rect2D({0, 0}, group.extent), group.clear_values);
+
+            for (uint32_t s = 0; s < group.passes.size(); ++s)
+            {
+                const RenderGraphPass& pass     = m_passes[group.passes[s]];
+                vk::SubpassContents    contents = pass.m_secondary_command_buffers ?
+                                                      vk::SubpassContents::eSecondaryCommandBuffers :
+                                                      vk::SubpassContents::eInline;
+
+                if (s == 0)
+                    command_buffer.beginRenderPass(render_pass_begin_info, contents);
+                else
+                    command_buffer.nextSubpass(contents);
+
+                if (pass.m_execute)
+                    pass.m_execute(command_buffer, frame_index);
+            }
+
+            command_buffer.endRenderPass();
+        }
+
+        RecordBarriers(command_buffer, m_final_barriers, image_index);
+    }
+
+    void RenderGraph::Clear()
+    {
+        m_groups.clear();
+        m_final_barriers.clear();
+        m_pass_alive.clear();
+        m_pass_groups.clear();
+        m_pass_subpasses.clear();
+        m_passes.clear();
+        m_resources.clear();
+        m_transient_memory.Free();
+        m_transient_memory_size = 0;
+        m_unaliased_memory_size = 0;
+    }
+
+    bool RenderGraph::IsCulled(uint32_t pass_index) const
+    {
+        return pass_index >= m_pass_alive.size() || !m_pass_alive[pass_index];
+    }
+
+    const vk::raii::RenderPass& RenderGraph::GetRenderPass(uint32_t pass_index) const
+    {
+        if (IsCulled(pass_index))
+            return k_null_render_pass;
+
+        return m_groups[m_pass_groups[pass_index]].render_pass;
+    }
+
+    uint32_t RenderGraph::GetSubpass(uint32_t pass_index) const
+    {
+        return IsCulled(pass_index) ? 0 : m_pass_subpasses[pass_index];
+    }
+
+    vk::Image RenderGraph::GetImage(RenderGraphResource resource, uint32_t image_index) const
+    {
+        const Resource& r = m_resources[resource];
+        if (r.imported && r.imported_images.empty())
+            return nullptr;
+        if (r.imported)
+            return r.imported_images[image_index % r.imported_images.size()];
+
+        return *r.image;
+    }
+
+    vk::ImageView RenderGraph::GetImageView(RenderGraphResource resource, uint32_t image_index) const
+    {
+        const Resource& r = m_resources[resource];
+        if (r.imported)
+            return r.imported_image_views[image_index % r.imported_image_views.size()];
+
+        return *r.image_view;
+    }
+} // namespace Meow
@@ -0,0 +1,318 @@
+#pragma once
+
+#include "core/base/non_copyable.h"
+#include "function/render/allocator/device_memory_allocator.h"
+#include "render_graph_schedule.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Meow
+{
+    using RenderGraphResource = uint32_t;
+
+    constexpr RenderGraphResource k_invalid_render_graph_resource = 0xffffffff;
+
+    /**
+     * @brief How a pass touches an image. Each access implies the layout, pipeline stages, access mask and image
+     * usage the graph derives barriers and render passes from.
+     */
+    enum class RenderGraphAccess
+    {
+        ColorAttachment,
+        ResolveAttachment,
+        DepthAttachment,
+        DepthRead,
+        InputAttachment,
+        SampledImage,
+        StorageRead,
+        StorageWrite,
+    };
+
+    struct RenderGraphImageDesc
+    {
+        vk::Format              format       = vk::Format::eUndefined;
+        vk::Extent2D            extent       = {0, 0};
+        vk::SampleCountFlagBits sample_count = vk::SampleCountFlagBits::e1;
+        // added to the usage derived from the accesses, e.g. eTransferSrc for images read back
+        vk::ImageUsageFlags usage_flags;
+    };
+
+    class RenderGraph;
+
+    /**
+     * @brief A node of the graph, declaring what it reads and writes, and the function recording it.
+     */
+    class RenderGraphPass
+    {
+    public:
+        using ExecuteFunc = std::function<void(const vk::raii::CommandBuffer&, uint32_t)>;
+
+        /**
+         * @brief Write a color attachment, cleared to clear_value if given, otherwise its contents are loaded.
+         */
+        RenderGraphPass& WriteColor(RenderGraphResource                resource,
+                                    std::optional<vk::ClearColorValue> clear_value = std::nullopt);
+
+        /**
+         * @brief Resolve the multisampled color attachment declared at the same position into the resource.
+         */
+        RenderGraphPass& ResolveColor(RenderGraphResource resource);
+
+        RenderGraphPass& WriteDepth(RenderGraphResource                       resource,
+                                    std::optional<vk::ClearDepthStencilValue> clear_value = std::nullopt);
+
+        /**
+         * @brief Depth test against the resource without writing it.
+         */
+        RenderGraphPass& ReadDepth(RenderGraphResource resource);
+
+        /**
+         * @brief Read the pixel under the fragment, written by an earlier pass, which lets both passes become
+         * subpasses of one render pass.
+         */
+        RenderGraphPass& ReadInputAttachment(RenderGraphResource resource);
+
+        RenderGraphPass& ReadTexture(RenderGraphResource    resource,
+                                     vk::PipelineStageFlags stages = vk::PipelineStageFlagBits::eFragmentShader);
+
+        RenderGraphPass& ReadStorage(RenderGraphResource    resource,
+                                     vk::PipelineStageFlags stages = vk::PipelineStageFlagBits::eComputeShader);
+
+        RenderGraphPass& WriteStorage(RenderGraphResource    resource,
+                                      vk::PipelineStageFlags stages = vk::PipelineStageFlagBits::eComputeShader);
+
+        /**
+         * @brief Keep the pass even if nothing reads what it writes, e.g. when it writes buffers the graph doesn't
+         * track.
+         */
+        RenderGraphPass& SetSideEffects();
+
+        RenderGraphPass& SetExecute(ExecuteFunc execute);
+
+        /**
+         * @brief Whether the execute function only executes secondary command buffers, recorded against
+         * GetRenderPass() and GetSubpass(). Render passes don't depend on it, so it may change between frames.
+         */
+        RenderGraphPass& SetSecondaryCommandBuffers(bool enabled);
+
+        uint32_t           GetIndex() const { return m_index; }
+        const std::string& GetName() const { return m_name; }
+        bool               HasSecondaryCommandBuffers() const { return m_secondary_command_buffers; }
+
+        // passes are made by RenderGraph::AddPass()
+        RenderGraphPass(uint32_t index, std::string name)
+            : m_index(index)
+            , m_name(std::move(name))
+        {}
+
+    private:
+        friend class RenderGraph;
+
+        struct Usage
+        {
+            RenderGraphResource           resource;
+            RenderGraphAccess             access;
+            vk::PipelineStageFlags        stages;
+            std::optional<vk::ClearValue> clear_value;
+        };
+
+        RenderGraphPass& AddUsage(RenderGraphResource           resource,
+                                  RenderGraphAccess             access,
+                                  vk::PipelineStageFlags        stages,
+                                  std::optional<vk::ClearValue> clear_value = std::nullopt);
+
+        uint32_t           m_index;
+        std::string        m_name;
+        std::vector<Usage> m_usages;
+        ExecuteFunc        m_execute;
+        bool               m_side_effects              = false;
+        bool               m_secondary_command_buffers = false;
+    };
+
+    /**
+     * @brief Frame graph of passes declaring the images they read and write, compiled into render passes and
+     * barriers.
+     *
+     * Passes are added in execution order, then Compile():
+     * - culls passes whose writes nothing reads, unless they are imported, marked as output or have side effects,
+     * - merges consecutive graphics passes with the same extent into subpasses of one vk::RenderPass, as long as they
+     *   only share images as attachments,
+     * - derives load and store ops, layout transitions and barriers from the declared accesses,
+     * - creates transient images and places those whose lifetimes don't overlap at the same memory.
+     *
+     * Culling, grouping and placement don't touch the device and live in render_graph_schedule.h.
+     *
+     * Imported images, like the swapchain, are owned outside and may have one view per swapchain image, selected by
+     * the image index given to Execute(). Pipelines are created against GetRenderPass() and GetSubpass() of their
+     * pass. Compiling again, e.g. after a resize, makes compatible render passes as long as formats, sample counts
+     * and passes stay the same, so pipelines stay valid.
+     */
+    class RenderGraph : public NonCopyable
+    {
+    public:
+        RenderGraph() {}
+        RenderGraph(std::nullptr_t) {}
+
+        ~RenderGraph() override = default;
+
+        /**
+         * @brief Declare an image whose contents only live during the frame, created and placed by the graph.
+         */
+        RenderGraphResource CreateImage(const std::string& name, const RenderGraphImageDesc& desc);
+
+        /**
+         * @brief Declare an image owned outside. It is expected in initial_layout when the frame begins, and left in
+         * final_layout when it ends.
+         *
+         * An image only used as attachment of one render pass is transitioned by that render pass instead of
+         * barriers, so images may be left empty for it.
+         */
+        RenderGraphResource ImportImage(const std::string&                name,
+                                        const RenderGraphImageDesc&       desc,
+                                        const std::vector<vk::Image>&     images,
+                                        const std::vector<vk::ImageView>& image_views,
+                                        vk::ImageLayout                   initial_layout,
+                                        vk::ImageLayout                   final_layout);
+
+        /**
+         * @brief Keep the passes writing the transient image, e.g. when it is read back after the frame.
+         */
+        void MarkOutput(RenderGraphResource resource);
+
+        /**
+         * @brief The reference stays valid until Clear().
+         */
+        RenderGraphPass& AddPass(const std::string& name);
+
+        RenderGraphPass& GetPass(uint32_t pass_index) { return m_passes[pass_index]; }
+
+        void Compile();
+
+        /**
+         * @brief Record every pass that survived culling, with the barriers in between.
+         */
+        void Execute(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index, uint32_t image_index) const;
+
+        /**
+         * @brief Drop passes, resources and everything compiled. The images must not be in use by the device anymore.
+         */
+        void Clear();
+
+        bool IsCulled(uint32_t pass_index) const;
+
+        /**
+         * @brief Render pass of the pass after Compile(), or nullptr for passes without attachments.
+         */
+        const vk::raii::RenderPass& GetRenderPass(uint32_t pass_index) const;
+        uint32_t                    GetSubpass(uint32_t pass_index) const;
+
+        vk::Image     GetImage(RenderGraphResource resource, uint32_t image_index = 0) const;
+        vk::ImageView GetImageView(RenderGraphResource resource, uint32_t image_index = 0) const;
+
+        /**
+         * @brief Bytes of device memory taken by transient images, and what they would take without aliasing.
+         */
+        vk::DeviceSize GetTransientMemorySize() const { return m_transient_memory_size; }
+        vk::DeviceSize GetUnaliasedMemorySize() const { return m_unaliased_memory_size; }
+
+    private:
+        static constexpr uint32_t k_no_group = k_render_graph_no_group;
+
+        struct ImageState
+        {
+            vk::ImageLayout        layout = vk::ImageLayout::eUndefined;
+            vk::PipelineStageFlags stages;
+            vk::AccessFlags        access;
+        };
+
+        struct Resource
+        {
+            std::string          name;
+            RenderGraphImageDesc desc;
+            bool                 imported = false;
+            bool                 output   = false;
+
+            std::vector<vk::Image>     imported_images;
+            std::vector<vk::ImageView> imported_image_views;
+            vk::ImageLayout            initial_layout = vk::ImageLayout::eUndefined;
+            vk::ImageLayout            final_layout   = vk::ImageLayout::eUndefined;
+
+            // compiled
+            vk::ImageUsageFlags    usage_flags;
+            vk::ImageAspectFlags   aspect_mask;
+            vk::MemoryRequirements memory_requirements;
+            vk::DeviceSize         memory_offset   = 0;
+            uint32_t               first_group     = k_no_group;
+            uint32_t               last_group      = 0;
+            bool                   only_attachment = true;
+            // transient images sharing memory with this one, used before it
+            std::vector<RenderGraphResource> alias_predecessors;
+
+            // the memory is declared first, so that it is freed after the image bound to it
+            DeviceMemoryAllocation dedicated_memory;
+            vk::raii::Image        image      = nullptr;
+            vk::raii::ImageView    image_view = nullptr;
+        };
+
+        struct Barrier
+        {
+            RenderGraphResource resource;
+            ImageState          src;
+            ImageState          dst;
+        };
+
+        /**
+         * @brief Passes recorded together: either the subpasses of one render pass, or a single pass outside any.
+         */
+        struct Group
+        {
+            std::vector<uint32_t> passes;
+            std::vector<Barrier>  barriers;
+
+            vk::raii::RenderPass               render_pass = nullptr;
+            std::vector<vk::raii::Framebuffer> framebuffers;
+            std::vector<RenderGraphResource>   attachments;
+            std::vector<vk::ClearValue>        clear_values;
+            vk::Extent2D                       extent;
+        };
+
+        /**
+         * @brief Cull passes and merge them into groups with ScheduleRenderGraph().
+         */
+        void BuildGroups();
+        void CreateTransientImages();
+        void BuildBarriers();
+        void CreateRenderPass(uint32_t group_index);
+
+        /**
+         * @brief Whether the render pass using the imported image moves it from and to the layouts it was imported
+         * with, so that no barrier touches it.
+         */
+        bool IsTransitionedByRenderPass(const Resource& resource) const;
+
+        void RecordBarriers(const vk::raii::CommandBuffer& command_buffer,
+                            const std::vector<Barrier>&    barriers,
+                            uint32_t                       image_index) const;
+
+        // transient images are placed in this memory, so it is declared before them to be freed after them
+        DeviceMemoryAllocation m_transient_memory;
+        vk::DeviceSize         m_transient_memory_size = 0;
+        vk::DeviceSize         m_unaliased_memory_size = 0;
+
+        std::deque<RenderGraphPass> m_passes;
+        std::vector<Resource>       m_resources;
+
+        // compiled
+        std::vector<uint8_t>  m_pass_alive;
+        std::vector<uint32_t> m_pass_groups;
+        std::vector<uint32_t> m_pass_subpasses;
+        std::vector<Group>    m_groups;
+        std::vector<Barrier>  m_final_barriers;
+    };
+} // namespace Meow
@@ -0,0 +1,233 @@
+#include "render_graph_schedule.h"
+
+#include "pch.h"
+
+#include "core/base/alignment.h"
+
+#include <algorithm>
+
+namespace Meow
+{
+    namespace
+    {
+        bool LifetimesOverlap(uint32_t first_a, uint32_t last_a, uint32_t first_b, uint32_t last_b)
+        {
+            return first_a <= last_b && first_b <= last_a;
+        }
+
+        bool RangesOverlap(uint64_t offset_a, uint64_t size_a, uint64_t offset_b, uint64_t size_b)
+        {
+            return offset_a < offset_b + size_b && offset_b < offset_a + size_a;
+        }
+    } // namespace
+
+    std::vector<uint8_t> CullRenderGraphPasses(const std::vector<RenderGraphSchedulePass>&     passes,
+                                               const std::vector<RenderGraphScheduleResource>& resources)
+    {
+        std::vector<uint8_t> pass_alive(passes.size(), 0);
+
+        // whether a later pass that is kept reads the current contents of the image
+        std::vector<uint8_t> needed(resources.size(), 0);
+        for (size_t i = 0; i < resources.size(); ++i)
+        {
+            needed[i] = resources[i].imported || resources[i].output;
+        }
+
+        for (size_t i = passes.size(); i-- > 0;)
+        {
+            const RenderGraphSchedulePass& pass = passes[i];
+
+            bool alive = pass.side_effects;
+            for (const auto& usage : pass.usages)
+            {
+                alive = alive || (usage.write && needed[usage.resource]);
+            }
+
+            if (!alive)
+                continue;
+
+            pass_alive[i] = 1;
+
+            // images cleared or resolved here don't need what earlier passes wrote, anything else is loaded or read
+            for (const auto& usage : pass.usages)
+            {
+                if (usage.overwrite)
+                    needed[usage.resource] = 0;
+            }
+            for (const auto& usage : pass.usages)
+            {
+                if (!usage.overwrite)
+                    needed[usage.resource] = 1;
+            }
+        }
+
+        return pass_alive;
+    }
+
+    bool CanMergeRenderGraphPass(const RenderGraphScheduleGroup&                 group,
+                                 const RenderGraphSchedulePass&                  pass,
+                                 const std::vector<RenderGraphSchedulePass>&     passes,
+                                 const std::vector<RenderGraphScheduleResource>& resources)
+    {
+        if (group.attachments.empty())
+            return false;
+
+        // images shared with the group other than as attachments would need a barrier in between, which can't
+        // happen inside a render pass
+        for (const auto& usage : pass.usages)
+        {
+            const RenderGraphScheduleResource& resource = resources[usage.resource];
+            if (usage.attachment && (resource.width != group.width || resource.height != group.height))
+                return false;
+
+            for (uint32_t pass_index : group.passes)
+            {
+                for (const auto& other : passes[pass_index].usages)
+                {
+                    if (other.resource == usage.resource && (!usage.attachment || !other.attachment))
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    RenderGraphSchedule ScheduleRenderGraph(const std::vector<RenderGraphSchedulePass>&     passes,
+                                            const std::vector<RenderGraphScheduleResource>& resources)
+    {
+        RenderGraphSchedule schedule;
+        schedule.pass_alive = CullRenderGraphPasses(passes, resources);
+        schedule.pass_groups.assign(passes.size(), k_render_graph_no_group);
+        schedule.pass_subpasses.assign(passes.size(), 0);
+        schedule.first_groups.assign(resources.size(), k_render_graph_no_group);
+        schedule.last_groups.assign(resources.size(), 0);
+        schedule.only_attachment.assign(resources.size(), 1);
+
+        std::vector<RenderGraphScheduleGroup>& groups = schedule.groups;
+
+        for (uint32_t i = 0; i < passes.size(); ++i)
+        {
+            if (!schedule.pass_alive[i])
+                continue;
+
+            const RenderGraphSchedulePass& pass = passes[i];
+
+            auto first_attachment_usage =
+                std::find_if(pass.usages.begin(), pass.usages.end(), [](const RenderGraphScheduleUsage& usage) {
+                    return usage.attachment;
+                });
+            bool has_attachments = first_attachment_usage != pass.usages.end();
+
+            if (!has_attachments || groups.empty() || !CanMergeRenderGraphPass(groups.back(), pass, passes, resources))
+            {
+                groups.emplace_back();
+                if (has_attachments)
+                {
+                    groups.back().width  = resources[first_attachment_usage->resource].width;
+                    groups.back().height = resources[first_attachment_usage->resource].height;
+                }
+            }
+
+            uint32_t                  group_index = static_cast<uint32_t>(groups.size() - 1);
+            RenderGraphScheduleGroup& group       = groups.back();
+
+            schedule.pass_groups[i]    = group_index;
+            schedule.pass_subpasses[i] = static_cast<uint32_t>(group.passes.size());
+            group.passes.push_back(i);
+
+            for (const auto& usage : pass.usages)
+            {
+                schedule.first_groups[usage.resource] = std::min(schedule.first_groups[usage.resource], group_index);
+                schedule.last_groups[usage.resource]  = std::max(schedule.last_groups[usage.resource], group_index);
+
+                if (!usage.attachment)
+                {
+                    schedule.only_attachment[usage.resource] = 0;
+                    continue;
+                }
+
+                if (std::find(group.attachments.begin(), group.attachments.end(), usage.resource) ==
+                    group.attachments.end())
+                    group.attachments.push_back(usage.resource);
+            }
+        }
+
+        return schedule;
+    }
+
+    RenderGraphAliasPlacement PlaceRenderGraphImages(const std::vector<RenderGraphAliasImage>& images)
+    {
+        RenderGraphAliasPlacement placement;
+        placement.offsets.assign(images.size(), 0);
+        placement.dedicated.assign(images.size(), 0);
+        placement.predecessors.resize(images.size());
+
+        std::vector<uint32_t> order(images.size());
+        for (uint32_t i = 0; i < images.size(); ++i)
+        {
+            order[i] = i;
+        }
+
+        // largest first, ties keep the order of declaration so that placement doesn't change between compiles
+        std::stable_sort(order.begin(), order.end(), [&images](uint32_t lhs, uint32_t rhs) {
+            return images[lhs].size > images[rhs].size;
+        });
+
+        std::vector<uint32_t> placed;
+        for (uint32_t i : order)
+        {
+            const RenderGraphAliasImage& image = images[i];
+
+            // an image no memory type of the others suits gets memory of its own
+            if ((placement.memory_type_bits & image.memory_type_bits) == 0)
+            {
+                placement.dedicated[i] = 1;
+                continue;
+            }
+
+            placement.memory_type_bits &= image.memory_type_bits;
+            placement.heap_alignment = std::max(placement.heap_alignment, image.alignment);
+
+            // move past every image alive at the same time that overlaps, until none does
+            uint64_t offset = 0;
+            bool     moved  = true;
+            while (moved)
+            {
+                moved = false;
+                for (uint32_t j : placed)
+                {
+                    const RenderGraphAliasImage& other = images[j];
+                    if (!LifetimesOverlap(image.first_group, image.last_group, other.first_group, other.last_group))
+                        continue;
+
+                    if (RangesOverlap(offset, image.size, placement.offsets[j], other.size))
+                    {
+                        offset = Align(placement.offsets[j] + other.size, image.alignment);
+                        moved  = true;
+                    }
+                }
+            }
+
+            placement.offsets[i] = offset;
+            placement.heap_size  = std::max(placement.heap_size, offset + image.size);
+
+            // images placed at the same memory have to be done with it before the next one uses it
+            for (uint32_t j : placed)
+            {
+                const RenderGraphAliasImage& other = images[j];
+                if (!RangesOverlap(offset, image.size, placement.offsets[j], other.size))
+                    continue;
+
+                if (other.last_group < image.first_group)
+                    placement.predecessors[i].push_back(j);
+                else
+                    placement.predecessors[j].push_back(i);
+            }
+
+            placed.push_back(i);
+        }
+
+        return placement;
+    }
+} // namespace Meow
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Meow
+{
+    // the steps of RenderGraph::Compile() that don't need a device, passes and resources are indices into the graph
+    constexpr uint32_t k_render_graph_no_group = 0xffffffff;
+
+    /**
+     * @brief How a pass touches an image, reduced to what culling and grouping look at.
+     */
+    struct RenderGraphScheduleUsage
+    {
+        uint32_t resource   = 0;
+        bool     write      = false;
+        bool     attachment = false;
+        // cleared or resolved, so what earlier passes wrote isn't needed
+        bool overwrite = false;
+    };
+
+    struct RenderGraphSchedulePass
+    {
+        std::vector<RenderGraphScheduleUsage> usages;
+        bool                                  side_effects = false;
+    };
+
+    struct RenderGraphScheduleResource
+    {
+        uint32_t width    = 0;
+        uint32_t height   = 0;
+        bool     imported = false;
+        bool     output   = false;
+    };
+
+    /**
+     * @brief Passes recorded together: either the subpasses of one render pass, or a single pass outside any.
+     */
+    struct RenderGraphScheduleGroup
+    {
+        std::vector<uint32_t> passes;
+        // images used as attachments, in the order the passes first use them
+        std::vector<uint32_t> attachments;
+        uint32_t              width  = 0;
+        uint32_t              height = 0;
+    };
+
+    struct RenderGraphSchedule
+    {
+        std::vector<RenderGraphScheduleGroup> groups;
+
+        // per pass
+        std::vector<uint8_t>  pass_alive;
+        std::vector<uint32_t> pass_groups;
+        std::vector<uint32_t> pass_subpasses;
+
+        // per resource, first group is k_render_graph_no_group for images no kept pass uses
+        std::vector<uint32_t> first_groups;
+        std::vector<uint32_t> last_groups;
+        std::vector<uint8_t>  only_attachment;
+    };
+
+    /**
+     * @brief Walk the passes backwards, keeping those that have side effects or write an image which is imported,
+     * marked as output or read by a later pass that is kept.
+     */
+    std::vector<uint8_t> CullRenderGraphPasses(const std::vector<RenderGraphSchedulePass>&     passes,
+                                               const std::vector<RenderGraphScheduleResource>& resources);
+
+    /**
+     * @brief Whether the pass can become the next subpass of the group: its attachments match the extent of the
+     * group, and it shares images with the group only as attachments, since a barrier can't happen inside a render
+     * pass.
+     */
+    bool CanMergeRenderGraphPass(const RenderGraphScheduleGroup&                 group,
+                                 const RenderGraphSchedulePass&                  pass,
+                                 const std::vector<RenderGraphSchedulePass>&     passes,
+                                 const std::vector<RenderGraphScheduleResource>& resources);
+
+    /**
+     * @brief Cull the passes, then put consecutive passes that CanMergeRenderGraphPass() into one group, and track
+     * which groups use each image.
+     */
+    RenderGraphSchedule ScheduleRenderGraph(const std::vector<RenderGraphSchedulePass>&     passes,
+                                            const std::vector<RenderGraphScheduleResource>& resources);
+
+    struct RenderGraphAliasImage
+    {
+        uint64_t size             = 0;
+        uint64_t alignment        = 1;
+        uint32_t memory_type_bits = 0xffffffff;
+        uint32_t first_group      = 0;
+        uint32_t last_group       = 0;
+    };
+
+    struct RenderGraphAliasPlacement
+    {
+        // per image
+        std::vector<uint64_t> offsets;
+        std::vector<uint8_t>  dedicated;
+        // images sharing memory with the image, used before it
+        std::vector<std::vector<uint32_t>> predecessors;
+
+        // memory shared by every image which isn't dedicated
+        uint64_t heap_size        = 0;
+        uint64_t heap_alignment   = 1;
+        uint32_t memory_type_bits = 0xffffffff;
+    };
+
+    /**
+     * @brief Place the largest images first, each at the lowest offset not taken by an image used by the same
+     * groups. An image whose memory types don't suit those placed before it gets dedicated memory instead.
+     */
+    RenderGraphAliasPlacement PlaceRenderGraphImages(const std::vector<RenderGraphAliasImage>& images);
+} // namespace Meow
@@ -21,10 +21,8 @@ namespace Meow
     void DeferredPassBase::CreateMaterial()
     {
         const vk::raii::PhysicalDevice& physical_device = g_runtime_context.render_system->GetPhysicalDevice();
-        const vk::raii::Device&         logical_device  = g_runtime_context.render_system->GetLogicalDevice();
 
-        ShaderFactory   shader_factory;
-        MaterialFactory material_factory;
+        ShaderFactory shader_factory;
 
         auto obj_shader = shader_factory.clear()
                               .SetVertexShader("builtin/shaders/obj.vert.spv")
@@ -33,10 +31,6 @@ namespace Meow
 
         m_obj2attachment_material = std::make_shared<Material>(obj_shader);
         g_runtime_context.resource_system->Register(m_obj2attachment_material);
-        material_factory.Init(obj_shader.get(), vk::FrontFace::eClockwise);
-        material_factory.SetOpaque(true, 3);
-        material_factory.CreatePipeline(
-            logical_device, render_pass, obj_shader.get(), m_obj2attachment_material.get(), 0);
 
         auto quad_shader = shader_factory.clear()
                                .SetVertexShader("builtin/shaders/quad.vert.spv")
@@ -45,9 +39,6 @@ namespace Meow
 
         m_quad_material = std::make_shared<Material>(quad_shader);
         g_runtime_context.resource_system->Register(m_quad_material);
-        material_factory.Init(quad_shader.get(), vk::FrontFace::eClockwise);
-        material_factory.SetOpaque(false, 1);
-        material_factory.CreatePipeline(logical_device, render_pass, quad_shader.get(), m_quad_material.get(), 1);
 
         // Create quad model
         std::vector<float>    vertices = {-1.0f, 1.0f,  0.0f, 0.0f, 0.0f, 1.0f,  1.0f,  0.0f, 1.0f, 0.0f,
@@ -86,12 +77,9 @@ namespace Meow
 
         m_skybox_material = std::make_shared<Material>(skybox_shader);
         g_runtime_context.resource_system->Register(m_skybox_material);
-        material_factory.Init(skybox_shader.get(), vk::FrontFace::eCounterClockwise);
-        material_factory.SetOpaque(true, 1);
-        material_factory.CreatePipeline(logical_device, render_pass, skybox_shader.get(), m_skybox_material.get(), 2);
 
         {
-            auto texture_ptr = ImageData::CreateCubemap({
+            m_skybox_texture = ImageData::CreateCubemap({
                 "builtin/textures/cubemap/skybox_specular_X+.hdr",
                 "builtin/textures/cubemap/skybox_specular_X-.hdr",
                 "builtin/textures/cubemap/skybox_specular_Z+.hdr",
@@ -99,13 +87,12 @@ namespace Meow
                 "builtin/textures/cubemap/skybox_specular_Y+.hdr",
                 "builtin/textures/cubemap/skybox_specular_Y-.hdr",
             });
-            if (texture_ptr)
+            if (m_skybox_texture)
             {
-                g_runtime_context.resource_system->Register(texture_ptr);
-                m_skybox_material->BindImageToDescriptorSet("environmentMap", *texture_ptr);
+                g_runtime_context.resource_system->Register(m_skybox_texture);
             }
 
-            texture_ptr->SetDebugName("Skybox Texture");
+            m_skybox_texture->SetDebugName("Skybox Texture");
         }
 
         GeometryFactory geometry_factory;
@@ -115,88 +102,120 @@ namespace Meow
             std::move(Model(cube_vertices, std::vector<uint32_t> {}, skybox_shader->per_vertex_attributes));
     }
 
+    void DeferredPassBase::CreatePipelines()
+    {
+        const vk::raii::Device& logical_device = g_runtime_context.render_system->GetLogicalDevice();
+
+        MaterialFactory material_factory;
+
+        material_factory.Init(m_obj2attachment_material->shader.get(), vk::FrontFace::eClockwise);
+        material_factory.SetOpaque(true, 3);
+        material_factory.CreatePipeline(logical_device,
+                                        m_render_graph->GetRenderPass(k_gbuffer_pass),
+                                        m_obj2attachment_material->shader.get(),
+                                        m_obj2attachment_material.get(),
+                                        m_render_graph->GetSubpass(k_gbuffer_pass));
+
+        material_factory.Init(m_quad_material->shader.get(), vk::FrontFace::eClockwise);
+        material_factory.SetOpaque(false, 1);
+        material_factory.CreatePipeline(logical_device,
+                                        m_render_graph->GetRenderPass(k_lighting_pass),
+                                        m_quad_material->shader.get(),
+                                        m_quad_material.get(),
+                                        m_render_graph->GetSubpass(k_lighting_pass));
+
+        material_factory.Init(m_skybox_material->shader.get(), vk::FrontFace::eCounterClockwise);
+        material_factory.SetOpaque(true, 1);
+        material_factory.CreatePipeline(logical_device,
+                                        m_render_graph->GetRenderPass(k_skybox_pass),
+                                        m_skybox_material->shader.get(),
+                                        m_skybox_material.get(),
+                                        m_render_graph->GetSubpass(k_skybox_pass));
+
+        // the descriptor sets are allocated with the pipeline
+        if (m_skybox_texture)
+            m_skybox_material->BindImageToDescriptorSet("environmentMap", *m_skybox_texture);
+
+        m_pipelines_created = true;
+    }
+
     void DeferredPassBase::RefreshFrameBuffers(const std::vector<vk::ImageView>& output_image_views,
                                                const vk::Extent2D&               extent)
     {
-        const vk::raii::Device& logical_device = g_runtime_context.render_system->GetLogicalDevice();
+        if (!m_render_graph)
+            m_render_graph = std::make_unique<RenderGraph>();
+
+        m_render_graph->Clear();
+        m_extent = extent;
+
+        // Declare attachments
+
+        RenderGraphResource output = m_render_graph->ImportImage("Deferred Output",
+                                                                 {m_color_format, extent},
+                                                                 {},
+                                                                 output_image_views,
+                                                                 m_output_initial_layout,
+                                                                 m_output_final_layout);
+
+        RenderGraphResource color = m_render_graph->CreateImage("Deferred Color Attachment", {m_color_format, extent});
+        RenderGraphResource normal =
+            m_render_graph->CreateImage("Deferred Normal Attachment", {vk::Format::eR8G8B8A8Unorm, extent});
+        RenderGraphResource position =
+            m_render_graph->CreateImage("Deferred Position Attachment", {vk::Format::eR16G16B16A16Sfloat, extent});
+        RenderGraphResource depth = m_render_graph->CreateImage("Deferred Depth Attachment", {m_depth_format, extent});
+
+        // Declare passes, in the order of k_gbuffer_pass, k_lighting_pass and k_skybox_pass
+
+        vk::ClearColorValue clear_color(0.6f, 0.6f, 0.6f, 1.0f);
+
+        m_render_graph->AddPass("Deferred GBuffer")
+            .WriteColor(color, clear_color)
+            .WriteColor(normal, clear_color)
+            .WriteColor(position, clear_color)
+            .WriteDepth(depth, vk::ClearDepthStencilValue(1.0f, 0))
+            .SetExecute([this](const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) {
+                if (!m_render_graph->GetPass(k_gbuffer_pass).HasSecondaryCommandBuffers())
+                {
+                    RecordGBufferSubpass(command_buffer, frame_index);
+                    return;
+                }
 
-        // clear
-
-        framebuffers.clear();
-
-        m_color_attachment    = nullptr;
-        m_normal_attachment   = nullptr;
-        m_position_attachment = nullptr;
-        m_depth_attachment    = nullptr;
-
-        // Create attachment
-
-        m_color_attachment = ImageData::CreateAttachment(m_color_format,
-                                                         extent,
-                                                         vk::ImageUsageFlagBits::eColorAttachment |
-                                                             vk::ImageUsageFlagBits::eInputAttachment,
-                                                         vk::ImageAspectFlagBits::eColor,
-                                                         {},
-                                                         false);
-
-        m_normal_attachment = ImageData::CreateAttachment(vk::Format::eR8G8B8A8Unorm,
-                                                          extent,
-                                                          vk::ImageUsageFlagBits::eColorAttachment |
-                                                              vk::ImageUsageFlagBits::eInputAttachment,
-                                                          vk::ImageAspectFlagBits::eColor,
-                                                          {},
-                                                          false);
-
-        m_position_attachment = ImageData::CreateAttachment(vk::Format::eR16G16B16A16Sfloat,
-                                                            extent,
-                                                            vk::ImageUsageFlagBits::eColorAttachment |
-                                                                vk::ImageUsageFlagBits::eInputAttachment,
-                                                            vk::ImageAspectFlagBits::eColor,
-                                                            {},
-                                                            false);
-
-        m_depth_attachment = ImageData::CreateAttachment(m_depth_format,
-                                                         extent,
-                                                         vk::ImageUsageFlagBits::eDepthStencilAttachment |
-                                                             vk::ImageUsageFlagBits::eInputAttachment,
-                                                         vk::ImageAspectFlagBits::eDepth,
-                                                         {},
-                                                         false);
-
-        m_color_attachment->SetDebugName("Deferred Color Attachment");
-        m_normal_attachment->SetDebugName("Deferred Normal Attachment");
-        m_position_attachment->SetDebugName("Deferred Position Attachment");
-        m_depth_attachment->SetDebugName("Deferred Depth Attachment");
-
-        // Provide attachment information to frame buffer
-
-        vk::ImageView attachments[5];
-        attachments[1] = *m_color_attachment->image_view;
-        attachments[2] = *m_normal_attachment->image_view;
-        attachments[3] = *m_position_attachment->image_view;
-        attachments[4] = *m_depth_attachment->image_view;
-
-        vk::FramebufferCreateInfo framebuffer_create_info(vk::FramebufferCreateFlags(), /* flags */
-                                                          *render_pass,                 /* renderPass */
-                                                          5,                            /* attachmentCount */
-                                                          attachments,                  /* pAttachments */
-                                                          extent.width,                 /* width */
-                                                          extent.height,                /* height */
-                                                          1);                           /* layers */
-
-        framebuffers.reserve(output_image_views.size());
-        for (const auto& imageView : output_image_views)
-        {
-            attachments[0] = imageView;
-            framebuffers.push_back(vk::raii::Framebuffer(logical_device, framebuffer_create_info));
-        }
+                if (!m_secondary_command_buffers.empty())
+                    command_buffer.executeCommands(m_secondary_command_buffers);
+            });
+
+        m_render_graph->AddPass("Deferred Lighting")
+            .ReadInputAttachment(color)
+            .ReadInputAttachment(normal)
+            .ReadInputAttachment(position)
+            .ReadInputAttachment(depth)
+            .WriteColor(output, clear_color)
+            .SetExecute([this](const vk::raii::CommandBuffer& command_buffer, uint32_t) {
+                RecordLightingSubpass(command_buffer);
+            });
+
+        m_render_graph->AddPass("Deferred Skybox")
+            .WriteColor(output)
+            .WriteDepth(depth)
+            .SetExecute([this](const vk::raii::CommandBuffer& command_buffer, uint32_t) {
+                RecordSkyboxSubpass(command_buffer);
+            });
+
+        m_render_graph->Compile();
+
+        if (!m_pipelines_created)
+            CreatePipelines();
 
         // Update descriptor set
 
-        m_quad_material->BindImageToDescriptorSet("inputColor", *m_color_attachment);
-        m_quad_material->BindImageToDescriptorSet("inputNormal", *m_normal_attachment);
-        m_quad_material->BindImageToDescriptorSet("inputPosition", *m_position_attachment);
-        m_quad_material->BindImageToDescriptorSet("inputDepth", *m_depth_attachment);
+        m_quad_material->BindInputAttachmentToDescriptorSet(
+            "inputColor", m_render_graph->GetImageView(color), vk::ImageLayout::eShaderReadOnlyOptimal);
+        m_quad_material->BindInputAttachmentToDescriptorSet(
+            "inputNormal", m_render_graph->GetImageView(normal), vk::ImageLayout::eShaderReadOnlyOptimal);
+        m_quad_material->BindInputAttachmentToDescriptorSet(
+            "inputPosition", m_render_graph->GetImageView(position), vk::ImageLayout::eShaderReadOnlyOptimal);
+        m_quad_material->BindInputAttachmentToDescriptorSet(
+            "inputDepth", m_render_graph->GetImageView(depth), vk::ImageLayout::eDepthStencilReadOnlyOptimal);
     }
 
     void DeferredPassBase::UpdateUniformBuffer(uint32_t frame_index)
@@ -210,9 +229,9 @@ namespace Meow
 
         std::shared_ptr<GameObject>           main_camera = level->GetGameObjectByID(level->GetMainCameraID()).lock();
         std::shared_ptr<Transform3DComponent> main_camera_transfrom_component =
-            main_camera->TryGetComponent<Transform3DComponent>("Transform3DComponent");
+            main_camera->TryGetComponent<Transform3DComponent>();
         std::shared_ptr<Camera3DComponent> main_camera_component =
-            main_camera->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+            main_camera->TryGetComponent<Camera3DComponent>();
 
         if (!main_camera)
             MEOW_ERROR("shared ptr is invalid!");
@@ -228,6 +247,8 @@ namespace Meow
                                 main_camera_transfrom_component->position + forward,
                                 glm::vec3(0.0f, 1.0f, 0.0f));
 
+        SortView sort_view {main_camera_transfrom_component->position, forward, main_camera_component->far_plane};
+
         PerSceneData per_scene_data;
         per_scene_data.view = view;
         per_scene_data.projection =
@@ -241,34 +262,24 @@ namespace Meow
 
         // Update mesh uniform
 
-        m_obj2attachment_material->BeginPopulatingDynamicUniformBufferPerFrame();
         const auto* visibles_opaque_ptr = level->GetVisiblesPerShadingModel(ShadingModelType::Opaque);
-        if (visibles_opaque_ptr)
+        if (visibles_opaque_ptr && m_obj2attachment_material->UsesObjectDataBuffer())
         {
+            m_obj_batcher.Build(*visibles_opaque_ptr, frame_index, sort_view);
+        }
+        else if (visibles_opaque_ptr)
+        {
+            m_obj2attachment_material->BeginPopulatingDynamicUniformBufferPerFrame();
             const auto& visibles_opaque = *visibles_opaque_ptr;
             for (const auto& visible : visibles_opaque)
             {
-                std::shared_ptr<GameObject>           current_gameobject = visible.lock();
-                std::shared_ptr<Transform3DComponent> current_gameobject_transfrom_component =
-                    current_gameobject->TryGetComponent<Transform3DComponent>("Transform3DComponent");
-                std::shared_ptr<ModelComponent> current_gameobject_model_component =
-                    current_gameobject->TryGetComponent<ModelComponent>("ModelComponent");
-
-                if (!current_gameobject_transfrom_component || !current_gameobject_model_component)
+                auto* model_resource = visible.model;
+                if (!model_resource)
                     continue;
 
-#ifdef MEOW_DEBUG
-                if (!current_gameobject)
-                    MEOW_ERROR("shared ptr is invalid!");
-                if (!current_gameobject_transfrom_component)
-                    MEOW_ERROR("shared ptr is invalid!");
-                if (!current_gameobject_model_component)
-                    MEOW_ERROR("shared ptr is invalid!");
-#endif
-
-                auto model = current_gameobject_transfrom_component->GetTransform();
+                auto model = visible.transform;
 
-                for (uint32_t i = 0; i < current_gameobject_model_component->model.lock()->meshes.size(); ++i)
+                for (uint32_t i = 0; i < model_resource->meshes.size(); ++i)
                 {
                     m_obj2attachment_material->BeginPopulatingDynamicUniformBufferPerObject();
                     m_obj2attachment_material->PopulateDynamicUniformBuffer(
@@ -305,23 +316,124 @@ namespace Meow
             draw_call[i] = 0;
         }
 
-        RenderPassBase::Start(command_buffer, extent, image_index);
+        // the render graph begins the render pass
+        m_image_index = image_index;
+        m_render_graph->GetPass(k_gbuffer_pass).SetSecondaryCommandBuffers(false);
+    }
 
-        command_buffer.setViewport(0,
-                                   vk::Viewport(0.0f,
-                                                static_cast<float>(extent.height),
-                                                static_cast<float>(extent.width),
-                                                -static_cast<float>(extent.height),
-                                                0.0f,
-                                                1.0f));
-        command_buffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), extent));
+    void DeferredPassBase::RecordGraphicsCommand(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index)
+    {
+        FUNCTION_TIMER();
+
+        m_state_cache.Reset();
+        m_render_graph->Execute(command_buffer, frame_index, m_image_index);
     }
 
-    void DeferredPassBase::RenderGBuffer(const vk::raii::CommandBuffer& command_buffer)
+    bool DeferredPassBase::RecordSecondaryCommands(vk::Extent2D extent, uint32_t frame_index)
     {
         FUNCTION_TIMER();
 
-        m_obj2attachment_material->BindDescriptorSetToPipeline(command_buffer, 0, 1);
+        for (int i = 0; i < 2; i++)
+        {
+            draw_call[i] = 0;
+        }
+
+        m_secondary_command_buffers.clear();
+        m_frame_index = frame_index;
+
+        const vk::raii::RenderPass& gbuffer_render_pass = m_render_graph->GetRenderPass(k_gbuffer_pass);
+        uint32_t                    gbuffer_subpass     = m_render_graph->GetSubpass(k_gbuffer_pass);
+
+        // draws using dynamic offsets, which are assigned in draw order, are recorded in order into one buffer
+        if (!m_obj2attachment_material->UsesObjectDataBuffer())
+        {
+            RecordSecondaryCommandBuffers(
+                frame_index,
+                *gbuffer_render_pass,
+                gbuffer_subpass,
+                extent,
+                1,
+                [&](const vk::raii::CommandBuffer& command_buffer, uint32_t) {
+                    m_state_cache.Reset();
+                    m_obj2attachment_material->BindPipeline(command_buffer, m_state_cache);
+                    RenderGBuffer(command_buffer, frame_index);
+                });
+            return true;
+        }
+
+        m_obj2attachment_material->RefreshObjectDataBufferBinding(frame_index);
+
+        uint32_t draw_count = static_cast<uint32_t>(m_obj_batcher.GetDraws().size());
+        uint32_t buffer_count =
+            (draw_count + k_draws_per_secondary_command_buffer - 1) / k_draws_per_secondary_command_buffer;
+
+        RecordSecondaryCommandBuffers(
+            frame_index,
+            *gbuffer_render_pass,
+            gbuffer_subpass,
+            extent,
+            buffer_count,
+            [&](const vk::raii::CommandBuffer& command_buffer, uint32_t buffer_index) {
+                uint32_t begin = buffer_index * k_draws_per_secondary_command_buffer;
+                uint32_t end   = std::min(begin + k_draws_per_secondary_command_buffer, draw_count);
+
+                RenderStateCache state_cache;
+                m_obj2attachment_material->BindPipeline(command_buffer, state_cache);
+                RecordGBufferDraws(command_buffer, state_cache, frame_index, begin, end);
+            });
+
+        draw_call[0] = draw_count;
+        return true;
+    }
+
+    void DeferredPassBase::ExecuteSecondaryCommands(const vk::raii::CommandBuffer& command_buffer,
+                                                    vk::Extent2D                   extent,
+                                                    uint32_t                       image_index)
+    {
+        FUNCTION_TIMER();
+
+        m_render_graph->GetPass(k_gbuffer_pass).SetSecondaryCommandBuffers(true);
+
+        m_state_cache.Reset();
+        m_render_graph->Execute(command_buffer, m_frame_index, image_index);
+    }
+
+    void DeferredPassBase::RecordGBufferSubpass(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index)
+    {
+        SetViewportAndScissor(command_buffer, m_extent);
+
+        m_obj2attachment_material->BindPipeline(command_buffer, m_state_cache);
+        RenderGBuffer(command_buffer, frame_index);
+    }
+
+    void DeferredPassBase::RecordLightingSubpass(const vk::raii::CommandBuffer& command_buffer)
+    {
+        // dynamic state doesn't carry over from secondary command buffers
+        SetViewportAndScissor(command_buffer, m_extent);
+
+        m_quad_material->BindPipeline(command_buffer, m_state_cache);
+        RenderOpaqueMeshes(command_buffer);
+    }
+
+    void DeferredPassBase::RecordSkyboxSubpass(const vk::raii::CommandBuffer& command_buffer)
+    {
+        m_skybox_material->BindPipeline(command_buffer, m_state_cache);
+        RenderSkybox(command_buffer);
+    }
+
+    void DeferredPassBase::RenderGBuffer(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index)
+    {
+        FUNCTION_TIMER();
+
+        if (m_obj2attachment_material->UsesObjectDataBuffer())
+        {
+            uint32_t draw_count = static_cast<uint32_t>(m_obj_batcher.GetDraws().size());
+            RecordGBufferDraws(command_buffer, m_state_cache, frame_index, 0, draw_count);
+            draw_call[0] += draw_count;
+            return;
+        }
+
+        m_obj2attachment_material->BindDescriptorSetToPipeline(command_buffer, 0, 1, 0, false, 0, &m_state_cache);
 
         std::shared_ptr<Level> level               = g_runtime_context.level_system->GetCurrentActiveLevel().lock();
         const auto*            visibles_opaque_ptr = level->GetVisiblesPerShadingModel(ShadingModelType::Opaque);
@@ -330,23 +442,15 @@ namespace Meow
             const auto& visibles_opaque = *visibles_opaque_ptr;
             for (const auto& visible : visibles_opaque)
             {
-                std::shared_ptr<GameObject> current_gameobject = visible.lock();
-                if (!current_gameobject)
-                    continue;
-
-                std::shared_ptr<ModelComponent> current_gameobject_model_component =
-                    current_gameobject->TryGetComponent<ModelComponent>("ModelComponent");
-                if (!current_gameobject_model_component)
-                    continue;
-
-                auto model_resource = current_gameobject_model_component->model.lock();
+                auto* model_resource = visible.model;
                 if (!model_resource)
                     continue;
 
                 for (uint32_t i = 0; i < model_resource->meshes.size(); ++i)
                 {
-                    m_obj2attachment_material->BindDescriptorSetToPipeline(command_buffer, 1, 1, draw_call[0], true);
-                    model_resource->meshes[i]->BindDrawCmd(command_buffer);
+                    m_obj2attachment_material->BindDescriptorSetToPipeline(
+                        command_buffer, 1, 1, draw_call[0], true, 0, &m_state_cache);
+                    model_resource->meshes[i]->BindDrawCmd(command_buffer, m_state_cache);
 
                     ++draw_call[0];
                 }
@@ -358,10 +462,10 @@ namespace Meow
     {
         FUNCTION_TIMER();
 
-        m_quad_material->BindDescriptorSetToPipeline(command_buffer, 0, 1);
+        m_quad_material->BindDescriptorSetToPipeline(command_buffer, 0, 1, 0, false, 0, &m_state_cache);
         for (int32_t i = 0; i < m_quad_model.meshes.size(); ++i)
         {
-            m_quad_model.meshes[i]->BindDrawCmd(command_buffer);
+            m_quad_model.meshes[i]->BindDrawCmd(command_buffer, m_state_cache);
 
             ++draw_call[1];
         }
@@ -371,9 +475,26 @@ namespace Meow
     {
         FUNCTION_TIMER();
 
-        m_skybox_material->BindDescriptorSetToPipeline(command_buffer, 0, 2);
+        m_skybox_material->BindDescriptorSetToPipeline(command_buffer, 0, 2, 0, false, 0, &m_state_cache);
 
-        m_skybox_model.meshes[0]->BindDrawCmd(command_buffer);
+        m_skybox_model.meshes[0]->BindDrawCmd(command_buffer, m_state_cache);
+    }
+
+    void DeferredPassBase::RecordGBufferDraws(const vk::raii::CommandBuffer& command_buffer,
+                                              RenderStateCache&              state_cache,
+                                              uint32_t                       frame_index,
+                                              uint32_t                       begin,
+                                              uint32_t                       end)
+    {
+        m_obj2attachment_material->BindDescriptorSetToPipeline(command_buffer, 0, 1, 0, false, 0, &state_cache);
+        m_obj2attachment_material->BindDescriptorSetToPipeline(
+            command_buffer, 1, 1, 0, false, frame_index, &state_cache);
+
+        const auto& draws = m_obj_batcher.GetDraws();
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            draws[i].mesh->BindDrawCmd(command_buffer, state_cache, draws[i].instance_count, draws[i].first_instance);
+        }
     }
 
     void swap(DeferredPassBase& lhs, DeferredPassBase& rhs)
@@ -383,20 +504,25 @@ namespace Meow
         swap(static_cast<RenderPassBase&>(lhs), static_cast<RenderPassBase&>(rhs));
 
         swap(lhs.m_obj2attachment_material, rhs.m_obj2attachment_material);
+        swap(lhs.m_obj_batcher, rhs.m_obj_batcher);
         swap(lhs.m_quad_material, rhs.m_quad_material);
         swap(lhs.m_quad_model, rhs.m_quad_model);
         swap(lhs.m_skybox_material, rhs.m_skybox_material);
         swap(lhs.m_skybox_model, rhs.m_skybox_model);
 
-        swap(lhs.m_color_attachment, rhs.m_color_attachment);
-        swap(lhs.m_normal_attachment, rhs.m_normal_attachment);
-        swap(lhs.m_position_attachment, rhs.m_position_attachment);
+        swap(lhs.m_skybox_texture, rhs.m_skybox_texture);
+
+        swap(lhs.m_render_graph, rhs.m_render_graph);
+        swap(lhs.m_output_initial_layout, rhs.m_output_initial_layout);
+        swap(lhs.m_output_final_layout, rhs.m_output_final_layout);
+        swap(lhs.m_extent, rhs.m_extent);
+        swap(lhs.m_frame_index, rhs.m_frame_index);
+        swap(lhs.m_image_index, rhs.m_image_index);
+        swap(lhs.m_pipelines_created, rhs.m_pipelines_created);
 
         swap(lhs.m_LightDatas, rhs.m_LightDatas);
         swap(lhs.m_LightInfos, rhs.m_LightInfos);
 
-        swap(lhs.m_depth_attachment, rhs.m_depth_attachment);
-
         swap(lhs.m_pass_names, rhs.m_pass_names);
         swap(lhs.draw_call, rhs.draw_call);
     }
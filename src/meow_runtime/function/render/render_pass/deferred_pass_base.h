@@ -1,8 +1,10 @@
 #pragma once
 
+#include "function/render/batch/instance_batcher.h"
 #include "function/render/material/material.h"
 #include "function/render/material/shader.h"
 #include "function/render/model/model.hpp"
+#include "function/render/render_graph/render_graph.h"
 #include "function/render/render_pass/render_pass_base.h"
 
 namespace Meow
@@ -28,6 +30,10 @@ namespace Meow
         PointLight lights[k_num_lights];
     };
 
+    /**
+     * @brief G-buffer, lighting and skybox passes on a RenderGraph, which merges them into subpasses of one render
+     * pass and keeps the G-buffer in transient attachments.
+     */
     class DeferredPassBase : public RenderPassBase
     {
     public:
@@ -69,7 +75,24 @@ namespace Meow
 
         void Start(const vk::raii::CommandBuffer& command_buffer, vk::Extent2D extent, uint32_t image_index) override;
 
-        void RenderGBuffer(const vk::raii::CommandBuffer& command_buffer);
+        void RecordGraphicsCommand(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) override;
+
+        /**
+         * @brief The render graph ends its render passes.
+         */
+        void End(const vk::raii::CommandBuffer& command_buffer) override {}
+
+        /**
+         * @brief Only the G-buffer subpass is recorded into secondary command buffers, the lighting and skybox
+         * subpasses draw a few meshes and are recorded inline by ExecuteSecondaryCommands.
+         */
+        bool RecordSecondaryCommands(vk::Extent2D extent, uint32_t frame_index) override;
+
+        void ExecuteSecondaryCommands(const vk::raii::CommandBuffer& command_buffer,
+                                      vk::Extent2D                   extent,
+                                      uint32_t                       image_index) override;
+
+        void RenderGBuffer(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index);
 
         void RenderOpaqueMeshes(const vk::raii::CommandBuffer& command_buffer);
 
@@ -80,21 +103,53 @@ namespace Meow
         friend void swap(DeferredPassBase& lhs, DeferredPassBase& rhs);
 
     protected:
+        static constexpr uint32_t k_gbuffer_pass  = 0;
+        static constexpr uint32_t k_lighting_pass = 1;
+        static constexpr uint32_t k_skybox_pass   = 2;
+
+        /**
+         * @brief Create the pipelines against the render passes of the first compiled graph. Later compiles make
+         * compatible render passes, and creating pipelines again would reallocate the descriptor sets.
+         */
+        void CreatePipelines();
+
+        virtual void RecordGBufferSubpass(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index);
+
+        virtual void RecordLightingSubpass(const vk::raii::CommandBuffer& command_buffer);
+
+        virtual void RecordSkyboxSubpass(const vk::raii::CommandBuffer& command_buffer);
+
+        /**
+         * @brief Record instanced G-buffer draws in [begin, end), with the G-buffer pipeline already bound.
+         */
+        void RecordGBufferDraws(const vk::raii::CommandBuffer& command_buffer,
+                                RenderStateCache&              state_cache,
+                                uint32_t                       frame_index,
+                                uint32_t                       begin,
+                                uint32_t                       end);
+
         std::shared_ptr<Material> m_obj2attachment_material = nullptr;
+        InstanceBatcher           m_obj_batcher;
         std::shared_ptr<Material> m_quad_material           = nullptr;
         Model                     m_quad_model              = nullptr;
         std::shared_ptr<Material> m_skybox_material         = nullptr;
         Model                     m_skybox_model            = nullptr;
 
-        std::shared_ptr<ImageData> m_color_attachment    = nullptr;
-        std::shared_ptr<ImageData> m_normal_attachment   = nullptr;
-        std::shared_ptr<ImageData> m_position_attachment = nullptr;
+        std::shared_ptr<ImageData> m_skybox_texture = nullptr;
+
+        // the passes call back into the pass building the graph, so it is built by RefreshFrameBuffers once the pass
+        // is in place
+        std::unique_ptr<RenderGraph> m_render_graph          = nullptr;
+        vk::ImageLayout              m_output_initial_layout = vk::ImageLayout::eUndefined;
+        vk::ImageLayout              m_output_final_layout   = vk::ImageLayout::ePresentSrcKHR;
+        vk::Extent2D                 m_extent;
+        uint32_t                     m_frame_index       = 0;
+        uint32_t                     m_image_index       = 0;
+        bool                         m_pipelines_created = false;
 
         LightDataBlock  m_LightDatas;
         LightSpawnBlock m_LightInfos;
 
-        std::shared_ptr<ImageData> m_depth_attachment = nullptr;
-
         std::string m_pass_names[2];
         int         draw_call[2] = {0, 0};
     };
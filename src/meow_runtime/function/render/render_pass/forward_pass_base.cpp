@@ -25,10 +25,21 @@ namespace Meow
         ShaderFactory   shader_factory;
         MaterialFactory material_factory;
 
-        auto opaque_shader = shader_factory.clear()
-                                 .SetVertexShader("builtin/shaders/pbr.vert.spv")
-                                 .SetFragmentShader("builtin/shaders/pbr.frag.spv")
-                                 .Create();
+        const std::string bindless_frag_shader_path = "builtin/shaders/pbr_bindless.frag.spv";
+
+        // opaque textures are read from the bindless descriptor table when the device supports it
+        bool bindless_enabled = g_runtime_context.render_system->GetBindlessSupported();
+        if (bindless_enabled && !g_runtime_context.file_system->Exists(bindless_frag_shader_path))
+        {
+            MEOW_WARN("{} is missing, opaque textures are bound per material.", bindless_frag_shader_path);
+            bindless_enabled = false;
+        }
+
+        auto opaque_shader =
+            shader_factory.clear()
+                .SetVertexShader("builtin/shaders/pbr.vert.spv")
+                .SetFragmentShader(bindless_enabled ? bindless_frag_shader_path : "builtin/shaders/pbr.frag.spv")
+                .Create();
 
         m_opaque_material = std::make_shared<Material>(opaque_shader);
         g_runtime_context.resource_system->Register(m_opaque_material);
@@ -40,6 +51,14 @@ namespace Meow
 
         input_vertex_attributes = m_opaque_material->shader->per_vertex_attributes;
 
+        // slots of pbr_bindless.frag
+        auto bind_opaque_texture = [&](const std::string& name, uint32_t bindless_slot, ImageData& image_data) {
+            if (bindless_enabled)
+                m_opaque_material->BindImageToBindlessSlot(bindless_slot, image_data);
+            else
+                m_opaque_material->BindImageToDescriptorSet(name, image_data);
+        };
+
         UUID albedo_image_id(0);
         UUID normal_image_id(0);
         UUID metallic_image_id(0);
@@ -52,7 +71,7 @@ namespace Meow
             if (texture_ptr)
             {
                 albedo_image_id = g_runtime_context.resource_system->Register(texture_ptr);
-                m_opaque_material->BindImageToDescriptorSet("albedoMap", *texture_ptr);
+                bind_opaque_texture("albedoMap", 0, *texture_ptr);
             }
 
             texture_ptr->SetDebugName("Albedo Texture");
@@ -63,7 +82,7 @@ namespace Meow
             if (texture_ptr)
             {
                 normal_image_id = g_runtime_context.resource_system->Register(texture_ptr);
-                m_opaque_material->BindImageToDescriptorSet("normalMap", *texture_ptr);
+                bind_opaque_texture("normalMap", 1, *texture_ptr);
             }
 
             texture_ptr->SetDebugName("Normal Texture");
@@ -74,7 +93,7 @@ namespace Meow
             if (texture_ptr)
             {
                 metallic_image_id = g_runtime_context.resource_system->Register(texture_ptr);
-                m_opaque_material->BindImageToDescriptorSet("metallicMap", *texture_ptr);
+                bind_opaque_texture("metallicMap", 2, *texture_ptr);
             }
 
             texture_ptr->SetDebugName("Metallic Texture");
@@ -85,7 +104,7 @@ namespace Meow
             if (texture_ptr)
             {
                 roughness_image_id = g_runtime_context.resource_system->Register(texture_ptr);
-                m_opaque_material->BindImageToDescriptorSet("roughnessMap", *texture_ptr);
+                bind_opaque_texture("roughnessMap", 3, *texture_ptr);
             }
 
             texture_ptr->SetDebugName("Roughness Texture");
@@ -96,7 +115,7 @@ namespace Meow
             if (texture_ptr)
             {
                 ao_image_id = g_runtime_context.resource_system->Register(texture_ptr);
-                m_opaque_material->BindImageToDescriptorSet("aoMap", *texture_ptr);
+                bind_opaque_texture("aoMap", 4, *texture_ptr);
             }
 
             texture_ptr->SetDebugName("AO Texture");
@@ -226,15 +245,14 @@ namespace Meow
     {
         std::shared_ptr<Level> level = g_runtime_context.level_system->GetCurrentActiveLevel().lock();
 
-        const auto& all_gameobjects_map = level->GetAllGameObjects();
-        for (auto& kv : all_gameobjects_map)
+        for (GameObject* gameobject : level->GetDirectionalLights())
         {
             std::shared_ptr<DirectionalLightComponent> directional_light_comp_ptr =
-                kv.second->TryGetComponent<DirectionalLightComponent>("DirectionalLightComponent");
+                gameobject->TryGetComponent<DirectionalLightComponent>();
             if (directional_light_comp_ptr)
             {
                 std::shared_ptr<Transform3DComponent> directional_light_transform =
-                    kv.second->TryGetComponent<Transform3DComponent>("Transform3DComponent");
+                    gameobject->TryGetComponent<Transform3DComponent>();
 
                 if (!directional_light_transform)
                 {
@@ -383,9 +401,9 @@ namespace Meow
 
         std::shared_ptr<GameObject>           main_camera = level->GetGameObjectByID(level->GetMainCameraID()).lock();
         std::shared_ptr<Transform3DComponent> main_camera_transfrom_component =
-            main_camera->TryGetComponent<Transform3DComponent>("Transform3DComponent");
+            main_camera->TryGetComponent<Transform3DComponent>();
         std::shared_ptr<Camera3DComponent> main_camera_component =
-            main_camera->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+            main_camera->TryGetComponent<Camera3DComponent>();
 
         if (!main_camera)
             MEOW_ERROR("shared ptr is invalid!");
@@ -401,6 +419,8 @@ namespace Meow
                                 main_camera_transfrom_component->position + forward,
                                 glm::vec3(0.0f, 1.0f, 0.0f));
 
+        SortView sort_view {main_camera_transfrom_component->position, forward, main_camera_component->far_plane};
+
         const auto* visibles_opaque_ptr = level->GetVisiblesPerShadingModel(ShadingModelType::Opaque);
 
         // Opaque
@@ -439,33 +459,25 @@ namespace Meow
 
         // Update mesh uniform
 
-        m_opaque_material->BeginPopulatingDynamicUniformBufferPerFrame();
-        if (visibles_opaque_ptr)
+        if (visibles_opaque_ptr && m_opaque_material->UsesObjectDataBuffer())
         {
+            // with GPU culling, object data and instances are written when culling is dispatched
+            if (!m_gpu_culling_enabled)
+                m_opaque_batcher.Build(*visibles_opaque_ptr, frame_index, sort_view);
+        }
+        else if (visibles_opaque_ptr)
+        {
+            m_opaque_material->BeginPopulatingDynamicUniformBufferPerFrame();
             const auto& visibles_opaque = *visibles_opaque_ptr;
             for (const auto& visible : visibles_opaque)
             {
-                std::shared_ptr<GameObject> current_gameobject = visible.lock();
-                if (!current_gameobject)
-                    continue;
-                std::shared_ptr<Transform3DComponent> current_gameobject_transfrom_component =
-                    current_gameobject->TryGetComponent<Transform3DComponent>("Transform3DComponent");
-                std::shared_ptr<ModelComponent> current_gameobject_model_component =
-                    current_gameobject->TryGetComponent<ModelComponent>("ModelComponent");
-
-                if (!current_gameobject_transfrom_component || !current_gameobject_model_component)
+                auto* model_resource = visible.model;
+                if (!model_resource)
                     continue;
 
-                if (!current_gameobject)
-                    MEOW_ERROR("shared ptr is invalid!");
-                if (!current_gameobject_transfrom_component)
-                    MEOW_ERROR("shared ptr is invalid!");
-                if (!current_gameobject_model_component)
-                    MEOW_ERROR("shared ptr is invalid!");
-
-                auto model = current_gameobject_transfrom_component->GetTransform();
+                auto model = visible.transform;
 
-                for (uint32_t i = 0; i < current_gameobject_model_component->model.lock()->meshes.size(); ++i)
+                for (uint32_t i = 0; i < model_resource->meshes.size(); ++i)
                 {
                     m_opaque_material->BeginPopulatingDynamicUniformBufferPerObject();
                     m_opaque_material->PopulateDynamicUniformBuffer("objData", &model, sizeof(model), frame_index);
@@ -493,50 +505,72 @@ namespace Meow
             "sceneData", &per_scene_data, sizeof(per_scene_data), frame_index);
         m_translucent_material->PopulateUniformBuffer("lights", &lights, sizeof(lights), frame_index);
         m_translucent_material->BeginPopulatingDynamicUniformBufferPerFrame();
+        m_translucent_queue.Clear();
         const auto* visibles_translucent_ptr = level->GetVisiblesPerShadingModel(ShadingModelType::Translucent);
         if (visibles_translucent_ptr)
         {
             const auto& visibles_translucent = *visibles_translucent_ptr;
 
+            m_translucent_queue.PushVisibles(visibles_translucent,
+                                             static_cast<uint32_t>(ShadingModelType::Translucent),
+                                             SortOrder::BackToFront,
+                                             sort_view);
+            m_translucent_queue.Sort();
+
             int visibles_size = visibles_translucent.size();
 
-            for (int obj_index = 0; obj_index < visibles_size; obj_index++)
+            // dynamic offsets are consumed by draw index, so per-object data is populated in draw order
+            for (const RenderItem& item : m_translucent_queue.GetItems())
             {
-                const auto&                 visible            = visibles_translucent[obj_index];
-                std::shared_ptr<GameObject> current_gameobject = visible.lock();
-                if (!current_gameobject)
-                    continue;
-                std::shared_ptr<Transform3DComponent> current_gameobject_transfrom_component =
-                    current_gameobject->TryGetComponent<Transform3DComponent>("Transform3DComponent");
-                std::shared_ptr<ModelComponent> current_gameobject_model_component =
-                    current_gameobject->TryGetComponent<ModelComponent>("ModelComponent");
-
-                if (!current_gameobject_transfrom_component || !current_gameobject_model_component)
-                    continue;
-
-                if (!current_gameobject)
-                    MEOW_ERROR("shared ptr is invalid!");
-                if (!current_gameobject_transfrom_component)
-                    MEOW_ERROR("shared ptr is invalid!");
-                if (!current_gameobject_model_component)
-                    MEOW_ERROR("shared ptr is invalid!");
+                const auto& visible = visibles_translucent[item.visible_index];
 
                 TranslucentObjectData translucent_obj_data;
 
-                translucent_obj_data.model = current_gameobject_transfrom_component->GetTransform();
-                translucent_obj_data.alpha = static_cast<float>(obj_index) / visibles_size;
-                for (uint32_t i = 0; i < current_gameobject_model_component->model.lock()->meshes.size(); ++i)
-                {
-                    m_translucent_material->BeginPopulatingDynamicUniformBufferPerObject();
-                    m_translucent_material->PopulateDynamicUniformBuffer(
-                        "objData", &translucent_obj_data, sizeof(translucent_obj_data), frame_index);
-                    m_translucent_material->EndPopulatingDynamicUniformBufferPerObject();
-                }
+                translucent_obj_data.model = visible.transform;
+                translucent_obj_data.alpha = static_cast<float>(item.visible_index) / visibles_size;
+
+                m_translucent_material->BeginPopulatingDynamicUniformBufferPerObject();
+                m_translucent_material->PopulateDynamicUniformBuffer(
+                    "objData", &translucent_obj_data, sizeof(translucent_obj_data), frame_index);
+                m_translucent_material->EndPopulatingDynamicUniformBufferPerObject();
             }
             m_translucent_material->EndPopulatingDynamicUniformBufferPerFrame();
         }
     }
 
+    void ForwardPassBase::RecordPrePassCommands(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index)
+    {
+        if (!m_gpu_culling_enabled)
+            return;
+
+        FUNCTION_TIMER();
+
+        std::shared_ptr<Level> level = g_runtime_context.level_system->GetCurrentActiveLevel().lock();
+        if (!level)
+        {
+            MEOW_ERROR("shared ptr is invalid!");
+            return;
+        }
+
+        std::shared_ptr<GameObject> main_camera = level->GetGameObjectByID(level->GetMainCameraID()).lock();
+        if (!main_camera)
+        {
+            MEOW_ERROR("shared ptr is invalid!");
+            return;
+        }
+
+        std::shared_ptr<Camera3DComponent> main_camera_component =
+            main_camera->TryGetComponent<Camera3DComponent>();
+        if (!main_camera_component)
+        {
+            MEOW_ERROR("shared ptr is invalid!");
+            return;
+        }
+
+        m_opaque_gpu_culler->Dispatch(
+            command_buffer, frame_index, *level, ShadingModelType::Opaque, main_camera_component->GetFrustum());
+    }
+
     void
     ForwardPassBase::Start(const vk::raii::CommandBuffer& command_buffer, vk::Extent2D extent, uint32_t image_index)
     {
@@ -547,22 +581,97 @@ namespace Meow
 
         RenderPassBase::Start(command_buffer, extent, image_index);
 
-        command_buffer.setViewport(0,
-                                   vk::Viewport(0.0f,
-                                                static_cast<float>(extent.height),
-                                                static_cast<float>(extent.width),
-                                                -static_cast<float>(extent.height),
-                                                0.0f,
-                                                1.0f));
-        command_buffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), extent));
+        SetViewportAndScissor(command_buffer, extent);
     }
 
-    void ForwardPassBase::RenderOpaqueMeshes(const vk::raii::CommandBuffer& command_buffer)
+    bool ForwardPassBase::RecordSecondaryCommands(vk::Extent2D extent, uint32_t frame_index)
     {
         FUNCTION_TIMER();
 
-        m_opaque_material->BindDescriptorSetToPipeline(command_buffer, 0, 2);
-        m_opaque_material->BindDescriptorSetToPipeline(command_buffer, 3, 1);
+        for (int i = 0; i < 3; i++)
+        {
+            draw_call[i] = 0;
+        }
+
+        m_secondary_command_buffers.clear();
+
+        // instanced opaque draws are split over workers, while draws using dynamic offsets, which are assigned in draw
+        // order, are recorded in order into the last buffer
+        uint32_t opaque_draw_count   = 0;
+        uint32_t opaque_buffer_count = 0;
+        if (m_opaque_material->UsesObjectDataBuffer())
+        {
+            m_opaque_material->RefreshObjectDataBufferBinding(frame_index);
+
+            // indirect draws of GPU culling are one per mesh, so they are few enough to stay in the last buffer
+            if (!m_gpu_culling_enabled)
+            {
+                opaque_draw_count   = static_cast<uint32_t>(m_opaque_batcher.GetDraws().size());
+                opaque_buffer_count = (opaque_draw_count + k_draws_per_secondary_command_buffer - 1) /
+                                      k_draws_per_secondary_command_buffer;
+            }
+        }
+
+        RecordSecondaryCommandBuffers(
+            frame_index,
+            *render_pass,
+            0,
+            extent,
+            opaque_buffer_count + 1,
+            [&](const vk::raii::CommandBuffer& command_buffer, uint32_t buffer_index) {
+                if (buffer_index < opaque_buffer_count)
+                {
+                    uint32_t begin = buffer_index * k_draws_per_secondary_command_buffer;
+                    uint32_t end   = std::min(begin + k_draws_per_secondary_command_buffer, opaque_draw_count);
+
+                    RenderStateCache state_cache;
+                    m_opaque_material->BindPipeline(command_buffer, state_cache);
+                    RecordOpaqueDraws(command_buffer, state_cache, frame_index, begin, end);
+                    return;
+                }
+
+                // only this buffer uses the pass's own cache
+                m_state_cache.Reset();
+
+                if (opaque_buffer_count == 0)
+                {
+                    m_opaque_material->BindPipeline(command_buffer, m_state_cache);
+                    RenderOpaqueMeshes(command_buffer, frame_index);
+                }
+
+                m_skybox_material->BindPipeline(command_buffer, m_state_cache);
+                RenderSkybox(command_buffer);
+
+                m_translucent_material->BindPipeline(command_buffer, m_state_cache);
+                RenderTranslucentMeshes(command_buffer);
+            });
+
+        draw_call[0] += opaque_draw_count;
+        return true;
+    }
+
+    void ForwardPassBase::RenderOpaqueMeshes(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index)
+    {
+        FUNCTION_TIMER();
+
+        if (m_gpu_culling_enabled)
+        {
+            BindOpaqueDescriptorSets(command_buffer, m_state_cache, frame_index);
+            draw_call[0] += m_opaque_gpu_culler->Draw(command_buffer, m_state_cache, frame_index);
+            return;
+        }
+
+        if (m_opaque_material->UsesObjectDataBuffer())
+        {
+            uint32_t draw_count = static_cast<uint32_t>(m_opaque_batcher.GetDraws().size());
+            RecordOpaqueDraws(command_buffer, m_state_cache, frame_index, 0, draw_count);
+            draw_call[0] += draw_count;
+            return;
+        }
+
+        m_opaque_material->BindDescriptorSetToPipeline(command_buffer, 0, 2, 0, false, 0, &m_state_cache);
+        m_opaque_material->BindDescriptorSetToPipeline(command_buffer, 3, 1, 0, false, 0, &m_state_cache);
+        m_opaque_material->BindBindlessDescriptorSet(command_buffer, &m_state_cache);
 
         std::shared_ptr<Level> level               = g_runtime_context.level_system->GetCurrentActiveLevel().lock();
         const auto*            visibles_opaque_ptr = level->GetVisiblesPerShadingModel(ShadingModelType::Opaque);
@@ -571,23 +680,15 @@ namespace Meow
             const auto& visibles_opaque = *visibles_opaque_ptr;
             for (const auto& visible : visibles_opaque)
             {
-                std::shared_ptr<GameObject> current_gameobject = visible.lock();
-                if (!current_gameobject)
-                    continue;
-
-                std::shared_ptr<ModelComponent> current_gameobject_model_component =
-                    current_gameobject->TryGetComponent<ModelComponent>("ModelComponent");
-                if (!current_gameobject_model_component)
-                    continue;
-
-                auto model_resource = current_gameobject_model_component->model.lock();
+                auto* model_resource = visible.model;
                 if (!model_resource)
                     continue;
 
                 for (uint32_t i = 0; i < model_resource->meshes.size(); ++i)
                 {
-                    m_opaque_material->BindDescriptorSetToPipeline(command_buffer, 2, 1, draw_call[0], true);
-                    model_resource->meshes[i]->BindDrawCmd(command_buffer);
+                    m_opaque_material->BindDescriptorSetToPipeline(
+                        command_buffer, 2, 1, draw_call[0], true, 0, &m_state_cache);
+                    model_resource->meshes[i]->BindDrawCmd(command_buffer, m_state_cache);
 
                     ++draw_call[0];
                 }
@@ -599,9 +700,9 @@ namespace Meow
     {
         FUNCTION_TIMER();
 
-        m_skybox_material->BindDescriptorSetToPipeline(command_buffer, 0, 2);
+        m_skybox_material->BindDescriptorSetToPipeline(command_buffer, 0, 2, 0, false, 0, &m_state_cache);
 
-        m_skybox_model.meshes[0]->BindDrawCmd(command_buffer);
+        m_skybox_model.meshes[0]->BindDrawCmd(command_buffer, m_state_cache);
         ++draw_call[1];
     }
 
@@ -609,68 +710,45 @@ namespace Meow
     {
         FUNCTION_TIMER();
 
-        m_translucent_material->BindDescriptorSetToPipeline(command_buffer, 0, 2);
-        m_translucent_material->BindDescriptorSetToPipeline(command_buffer, 3, 1);
-
-        std::shared_ptr<Level> level = g_runtime_context.level_system->GetCurrentActiveLevel().lock();
+        m_translucent_material->BindDescriptorSetToPipeline(command_buffer, 0, 2, 0, false, 0, &m_state_cache);
+        m_translucent_material->BindDescriptorSetToPipeline(command_buffer, 3, 1, 0, false, 0, &m_state_cache);
 
-        std::shared_ptr<GameObject>           main_camera = level->GetGameObjectByID(level->GetMainCameraID()).lock();
-        std::shared_ptr<Transform3DComponent> camera_transform_ptr =
-            main_camera->TryGetComponent<Transform3DComponent>("Transform3DComponent");
-        if (!camera_transform_ptr)
-            return;
-
-        glm::vec3 camera_pos     = camera_transform_ptr->position;
-        glm::vec3 camera_forward = camera_transform_ptr->rotation * glm::vec3(0.0f, 0.0f, 1.0f);
-
-        auto* visibles_translucent_ptr = level->GetVisiblesPerShadingModel(ShadingModelType::Translucent);
-        if (visibles_translucent_ptr)
+        // queue was sorted back to front when its per-object data was populated
+        for (const RenderItem& item : m_translucent_queue.GetItems())
         {
-            auto& visibles_translucent = *visibles_translucent_ptr; // std::vector<std::weak_ptr<Meow::GameObject>>
-
-            std::sort(visibles_translucent.begin(),
-                      visibles_translucent.end(),
-                      [&](const std::weak_ptr<GameObject>& a, const std::weak_ptr<GameObject>& b) {
-                          auto a_ptr = a.lock();
-                          auto b_ptr = b.lock();
-                          if (!a_ptr || !b_ptr)
-                              return false;
-
-                          auto a_transform = a_ptr->TryGetComponent<Transform3DComponent>("Transform3DComponent");
-                          auto b_transform = b_ptr->TryGetComponent<Transform3DComponent>("Transform3DComponent");
-                          if (!a_transform || !b_transform)
-                              return false;
-
-                          float dist_a = glm::dot(a_transform->position - camera_pos, camera_forward);
-                          float dist_b = glm::dot(b_transform->position - camera_pos, camera_forward);
-
-                          return dist_a > dist_b;
-                      });
+            m_translucent_material->BindDescriptorSetToPipeline(
+                command_buffer, 2, 1, draw_call[2], true, 0, &m_state_cache);
+            item.mesh->BindDrawCmd(command_buffer, m_state_cache);
 
-            for (const auto& visible : visibles_translucent)
-            {
-                std::shared_ptr<GameObject> current_gameobject = visible.lock();
-                if (!current_gameobject)
-                    continue;
+            ++draw_call[2];
+        }
+    }
 
-                std::shared_ptr<ModelComponent> current_gameobject_model_component =
-                    current_gameobject->TryGetComponent<ModelComponent>("ModelComponent");
-                if (!current_gameobject_model_component)
-                    continue;
+    void ForwardPassBase::RecordOpaqueDraws(const vk::raii::CommandBuffer& command_buffer,
+                                            RenderStateCache&              state_cache,
+                                            uint32_t                       frame_index,
+                                            uint32_t                       begin,
+                                            uint32_t                       end)
+    {
+        BindOpaqueDescriptorSets(command_buffer, state_cache, frame_index);
 
-                auto model_resource = current_gameobject_model_component->model.lock();
-                if (!model_resource)
-                    continue;
+        const auto& draws = m_opaque_batcher.GetDraws();
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            draws[i].mesh->BindDrawCmd(command_buffer, state_cache, draws[i].instance_count, draws[i].first_instance);
+        }
+    }
 
-                for (uint32_t i = 0; i < model_resource->meshes.size(); ++i)
-                {
-                    m_translucent_material->BindDescriptorSetToPipeline(command_buffer, 2, 1, draw_call[2], true);
-                    model_resource->meshes[i]->BindDrawCmd(command_buffer);
+    void ForwardPassBase::BindOpaqueDescriptorSets(const vk::raii::CommandBuffer& command_buffer,
+                                                   RenderStateCache&              state_cache,
+                                                   uint32_t                       frame_index)
+    {
+        m_opaque_material->BindDescriptorSetToPipeline(command_buffer, 0, 2, 0, false, 0, &state_cache);
+        m_opaque_material->BindDescriptorSetToPipeline(command_buffer, 3, 1, 0, false, 0, &state_cache);
+        m_opaque_material->BindBindlessDescriptorSet(command_buffer, &state_cache);
 
-                    ++draw_call[2];
-                }
-            }
-        }
+        // object data is reached by instance index, so its set is bound once and each mesh is drawn once
+        m_opaque_material->BindDescriptorSetToPipeline(command_buffer, 2, 1, 0, false, frame_index, &state_cache);
     }
 
     void ForwardPassBase::SetMSAAEnabled(bool enabled)
@@ -683,6 +761,34 @@ namespace Meow
         m_msaa_enabled = enabled;
     }
 
+    void ForwardPassBase::SetGPUCullingEnabled(bool enabled)
+    {
+        if (m_gpu_culling_enabled == enabled)
+            return;
+
+        if (enabled && !g_runtime_context.render_system->GetGPUCullingSupported())
+        {
+            MEOW_WARN("GPU culling is not supported by the device.");
+            return;
+        }
+
+        if (enabled && !m_opaque_material->UsesObjectDataBuffer())
+        {
+            MEOW_WARN("GPU culling needs an opaque material reading object data.");
+            return;
+        }
+
+        if (enabled && !m_opaque_gpu_culler)
+        {
+            m_opaque_gpu_culler = std::make_unique<GPUCuller>(g_runtime_context.render_system->GetMaxFramesInFlight());
+#ifdef MEOW_DEBUG
+            m_opaque_gpu_culler->SetValidationEnabled(true);
+#endif
+        }
+
+        m_gpu_culling_enabled = enabled;
+    }
+
     void swap(ForwardPassBase& lhs, ForwardPassBase& rhs)
     {
         using std::swap;
@@ -693,6 +799,10 @@ namespace Meow
         swap(lhs.m_skybox_material, rhs.m_skybox_material);
         swap(lhs.m_skybox_model, rhs.m_skybox_model);
         swap(lhs.m_translucent_material, rhs.m_translucent_material);
+        swap(lhs.m_opaque_batcher, rhs.m_opaque_batcher);
+        swap(lhs.m_gpu_culling_enabled, rhs.m_gpu_culling_enabled);
+        swap(lhs.m_opaque_gpu_culler, rhs.m_opaque_gpu_culler);
+        swap(lhs.m_translucent_queue, rhs.m_translucent_queue);
 
         swap(lhs.m_depth_attachment, rhs.m_depth_attachment);
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "function/render/batch/gpu_culler.h"
+#include "function/render/batch/instance_batcher.h"
+#include "function/render/batch/render_queue.h"
 #include "function/render/material/material.h"
 #include "function/render/material/shader.h"
 #include "function/render/model/model.hpp"
@@ -51,9 +54,13 @@ namespace Meow
 
         void UpdateUniformBuffer(uint32_t frame_index) override;
 
+        void RecordPrePassCommands(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) override;
+
         void Start(const vk::raii::CommandBuffer& command_buffer, vk::Extent2D extent, uint32_t image_index) override;
 
-        void RenderOpaqueMeshes(const vk::raii::CommandBuffer& command_buffer);
+        bool RecordSecondaryCommands(vk::Extent2D extent, uint32_t frame_index) override;
+
+        void RenderOpaqueMeshes(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index);
 
         void RenderSkybox(const vk::raii::CommandBuffer& command_buffer);
 
@@ -61,18 +68,43 @@ namespace Meow
 
         void SetMSAAEnabled(bool enabled);
 
+        /**
+         * @brief Cull opaque objects in a compute shader and draw them indirectly, instead of drawing the instances
+         * batched from CPU culling. Needs drawIndirectCount and an opaque material reading ObjectDataBuffer.
+         */
+        void SetGPUCullingEnabled(bool enabled);
+        bool IsGPUCullingEnabled() const { return m_gpu_culling_enabled; }
+
         UUID GetForwardMatID() { return m_opaque_material->uuid(); }
         UUID GetTranslucentMatID() { return m_translucent_material->uuid(); }
 
         friend void swap(ForwardPassBase& lhs, ForwardPassBase& rhs);
 
     protected:
+        /**
+         * @brief Record instanced opaque draws in [begin, end), with the opaque pipeline already bound.
+         */
+        void RecordOpaqueDraws(const vk::raii::CommandBuffer& command_buffer,
+                               RenderStateCache&              state_cache,
+                               uint32_t                       frame_index,
+                               uint32_t                       begin,
+                               uint32_t                       end);
+
+        void BindOpaqueDescriptorSets(const vk::raii::CommandBuffer& command_buffer,
+                                      RenderStateCache&              state_cache,
+                                      uint32_t                       frame_index);
+
         std::shared_ptr<Material> m_opaque_material = nullptr;
+        InstanceBatcher           m_opaque_batcher;
+
+        bool                       m_gpu_culling_enabled = false;
+        std::unique_ptr<GPUCuller> m_opaque_gpu_culler   = nullptr;
 
         std::shared_ptr<Material> m_skybox_material = nullptr;
         Model                     m_skybox_model    = nullptr;
 
         std::shared_ptr<Material> m_translucent_material = nullptr;
+        RenderQueue               m_translucent_queue;
 
         bool                       m_msaa_enabled          = true;
         std::shared_ptr<ImageData> m_color_msaa_attachment = nullptr;
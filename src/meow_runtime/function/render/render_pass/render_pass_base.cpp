@@ -17,9 +17,7 @@ namespace Meow
     {
         FUNCTION_TIMER();
 
-        vk::RenderPassBeginInfo render_pass_begin_info(
-            *render_pass, *framebuffers[image_index], vk::Rect2D(vk::Offset2D(0, 0), extent), clear_values);
-        command_buffer.beginRenderPass(render_pass_begin_info, vk::SubpassContents::eInline);
+        BeginRenderPass(command_buffer, extent, image_index, vk::SubpassContents::eInline);
     }
 
     void RenderPassBase::End(const vk::raii::CommandBuffer& command_buffer)
@@ -29,8 +27,74 @@ namespace Meow
         command_buffer.endRenderPass();
     }
 
+    void RenderPassBase::ExecuteSecondaryCommands(const vk::raii::CommandBuffer& command_buffer,
+                                                  vk::Extent2D                   extent,
+                                                  uint32_t                       image_index)
+    {
+        FUNCTION_TIMER();
+
+        BeginRenderPass(command_buffer, extent, image_index, vk::SubpassContents::eSecondaryCommandBuffers);
+        if (!m_secondary_command_buffers.empty())
+            command_buffer.executeCommands(m_secondary_command_buffers);
+        End(command_buffer);
+    }
+
     void RenderPassBase::AfterPresent() {}
 
+    void RenderPassBase::BeginRenderPass(const vk::raii::CommandBuffer& command_buffer,
+                                         vk::Extent2D                   extent,
+                                         uint32_t                       image_index,
+                                         vk::SubpassContents            contents)
+    {
+        vk::RenderPassBeginInfo render_pass_begin_info(
+            *render_pass, *framebuffers[image_index], vk::Rect2D(vk::Offset2D(0, 0), extent), clear_values);
+        command_buffer.beginRenderPass(render_pass_begin_info, contents);
+
+        m_state_cache.Reset();
+    }
+
+    void RenderPassBase::SetViewportAndScissor(const vk::raii::CommandBuffer& command_buffer, vk::Extent2D extent)
+    {
+        command_buffer.setViewport(0,
+                                   vk::Viewport(0.0f,
+                                                static_cast<float>(extent.height),
+                                                static_cast<float>(extent.width),
+                                                -static_cast<float>(extent.height),
+                                                0.0f,
+                                                1.0f));
+        command_buffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), extent));
+    }
+
+    void RenderPassBase::RecordSecondaryCommandBuffers(uint32_t                   frame_index,
+                                                       vk::RenderPass             parent_render_pass,
+                                                       uint32_t                   subpass,
+                                                       vk::Extent2D               extent,
+                                                       uint32_t                   buffer_count,
+                                                       const SecondaryRecordFunc& record)
+    {
+        FUNCTION_TIMER();
+
+        SecondaryCommandBufferAllocator& allocator =
+            g_runtime_context.render_system->GetSecondaryCommandBufferAllocator();
+
+        size_t first_buffer = m_secondary_command_buffers.size();
+        m_secondary_command_buffers.resize(first_buffer + buffer_count);
+
+        // every buffer is written by one job, so the vector doesn't need a lock
+        g_runtime_context.job_system->ParallelFor(buffer_count, 1, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                const vk::raii::CommandBuffer& command_buffer =
+                    allocator.Begin(frame_index, parent_render_pass, subpass);
+                SetViewportAndScissor(command_buffer, extent);
+                record(command_buffer, i);
+                command_buffer.end();
+
+                m_secondary_command_buffers[first_buffer + i] = *command_buffer;
+            }
+        });
+    }
+
     void swap(RenderPassBase& lhs, RenderPassBase& rhs)
     {
         using std::swap;
@@ -42,5 +106,7 @@ namespace Meow
 
         swap(lhs.m_color_format, rhs.m_color_format);
         swap(lhs.m_depth_format, rhs.m_depth_format);
+        swap(lhs.m_state_cache, rhs.m_state_cache);
+        swap(lhs.m_secondary_command_buffers, rhs.m_secondary_command_buffers);
     }
 } // namespace Meow
\ No newline at end of file
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "core/base/non_copyable.h"
+#include "function/render/batch/render_state_cache.h"
 #include "function/render/buffer_data/image_data.h"
 #include "function/render/buffer_data/surface_data.h"
 #include "function/render/model/vertex_attribute.h"
 
 #include <vulkan/vulkan_raii.hpp>
 
+#include <functional>
+#include <vector>
+
 namespace Meow
 {
     class RenderPassBase : public NonCopyable
@@ -37,6 +41,13 @@ namespace Meow
 
         virtual void UpdateUniformBuffer(uint32_t frame_index) {}
 
+        /**
+         * @brief Record work outside render passes, e.g. compute dispatches producing indirect draws, before any pass
+         * of the frame begins and before secondary command buffers are recorded. It runs on the calling thread, after
+         * the fence of the frame slot has been waited for.
+         */
+        virtual void RecordPrePassCommands(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) {}
+
         virtual void Start(const vk::raii::CommandBuffer& command_buffer, vk::Extent2D extent, uint32_t image_index);
 
         virtual void RecordComputeCommand(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) {}
@@ -44,6 +55,20 @@ namespace Meow
 
         virtual void End(const vk::raii::CommandBuffer& command_buffer);
 
+        /**
+         * @brief Record the pass into secondary command buffers, which may be spread over job workers, so that passes
+         * can be recorded at the same time. Returns false if the pass only records inline, then it is recorded by
+         * Start, RecordGraphicsCommand and End as usual.
+         */
+        virtual bool RecordSecondaryCommands(vk::Extent2D extent, uint32_t frame_index) { return false; }
+
+        /**
+         * @brief Begin the render pass and execute what RecordSecondaryCommands recorded.
+         */
+        virtual void ExecuteSecondaryCommands(const vk::raii::CommandBuffer& command_buffer,
+                                              vk::Extent2D                   extent,
+                                              uint32_t                       image_index);
+
         virtual void AfterPresent();
 
         friend void swap(RenderPassBase& lhs, RenderPassBase& rhs);
@@ -54,7 +79,33 @@ namespace Meow
         std::vector<VertexAttributeBit>    input_vertex_attributes;
 
     protected:
+        using SecondaryRecordFunc = std::function<void(const vk::raii::CommandBuffer&, uint32_t)>;
+
+        static constexpr uint32_t k_draws_per_secondary_command_buffer = 256;
+
+        void BeginRenderPass(const vk::raii::CommandBuffer& command_buffer,
+                             vk::Extent2D                   extent,
+                             uint32_t                       image_index,
+                             vk::SubpassContents            contents);
+
+        void SetViewportAndScissor(const vk::raii::CommandBuffer& command_buffer, vk::Extent2D extent);
+
+        /**
+         * @brief Record buffer_count secondary command buffers of a subpass of parent_render_pass on job workers, and
+         * append them to m_secondary_command_buffers in index order. record(command_buffer, index) fills one of them,
+         * with viewport and scissor already set, and may run on any thread.
+         */
+        void RecordSecondaryCommandBuffers(uint32_t                   frame_index,
+                                           vk::RenderPass             parent_render_pass,
+                                           uint32_t                   subpass,
+                                           vk::Extent2D               extent,
+                                           uint32_t                   buffer_count,
+                                           const SecondaryRecordFunc& record);
+
         vk::Format m_color_format;
         vk::Format m_depth_format = vk::Format::eD16Unorm;
+
+        RenderStateCache               m_state_cache;
+        std::vector<vk::CommandBuffer> m_secondary_command_buffers;
     };
 } // namespace Meow
\ No newline at end of file
@@ -172,9 +172,9 @@ namespace Meow
 
         std::shared_ptr<GameObject>           main_camera = level->GetGameObjectByID(level->GetMainCameraID()).lock();
         std::shared_ptr<Transform3DComponent> main_camera_transfrom_component =
-            main_camera->TryGetComponent<Transform3DComponent>("Transform3DComponent");
+            main_camera->TryGetComponent<Transform3DComponent>();
         std::shared_ptr<Camera3DComponent> main_camera_component =
-            main_camera->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+            main_camera->TryGetComponent<Camera3DComponent>();
 
         if (!main_camera)
             MEOW_ERROR("shared ptr is invalid!");
@@ -188,19 +188,21 @@ namespace Meow
                                 main_camera_transfrom_component->position + forward,
                                 glm::vec3(0.0f, 1.0f, 0.0f));
 
-        const auto* visibles_opaque_ptr = level->GetVisiblesPerShadingModel(ShadingModelType::Opaque);
+        m_shadow_casters.clear();
+
+        // casters are drawn front to back from the light
+        SortView sort_view;
 
         // Shadow map
 
-        const auto& all_gameobjects_map = level->GetAllGameObjects();
-        for (auto& kv : all_gameobjects_map)
+        for (GameObject* gameobject : level->GetDirectionalLights())
         {
             std::shared_ptr<DirectionalLightComponent> directional_light_comp_ptr =
-                kv.second->TryGetComponent<DirectionalLightComponent>("DirectionalLightComponent");
+                gameobject->TryGetComponent<DirectionalLightComponent>();
             if (directional_light_comp_ptr)
             {
                 std::shared_ptr<Transform3DComponent> directional_light_transform =
-                    kv.second->TryGetComponent<Transform3DComponent>("Transform3DComponent");
+                    gameobject->TryGetComponent<Transform3DComponent>();
 
                 if (!directional_light_transform)
                 {
@@ -214,52 +216,52 @@ namespace Meow
                 per_light_data.view = lookAt(directional_light_transform->position,
                                              directional_light_transform->position + forward,
                                              glm::vec3(0.0f, 1.0f, 0.0f));
-                per_light_data.projection =
-                    Math::perspective_vk(directional_light_comp_ptr->field_of_view,
-                                         static_cast<float>(m_shadow_map->extent.width) / m_shadow_map->extent.height,
-                                         directional_light_comp_ptr->near_plane,
-                                         directional_light_comp_ptr->far_plane);
+                float aspect_ratio = static_cast<float>(m_shadow_map->extent.width) / m_shadow_map->extent.height;
+                per_light_data.projection = Math::perspective_vk(directional_light_comp_ptr->field_of_view,
+                                                                 aspect_ratio,
+                                                                 directional_light_comp_ptr->near_plane,
+                                                                 directional_light_comp_ptr->far_plane);
                 m_shadow_map_material->PopulateUniformBuffer(
                     "lightData", &per_light_data, sizeof(per_light_data), frame_index);
+
+                // only objects inside light frustum can cast shadows into the shadow map
+                Frustum light_frustum;
+                light_frustum.updatePlanes(directional_light_transform->position,
+                                           directional_light_transform->rotation,
+                                           directional_light_comp_ptr->field_of_view,
+                                           aspect_ratio,
+                                           directional_light_comp_ptr->near_plane,
+                                           directional_light_comp_ptr->far_plane);
+                level->CullVisibles(light_frustum, ShadingModelType::Opaque, m_shadow_casters);
+                sort_view = {directional_light_transform->position, forward, directional_light_comp_ptr->far_plane};
                 break;
             }
         }
 
-        m_shadow_map_material->BeginPopulatingDynamicUniformBufferPerFrame();
-        if (visibles_opaque_ptr)
+        if (m_shadow_map_material->UsesObjectDataBuffer())
         {
-            const auto& visibles_opaque = *visibles_opaque_ptr;
-            for (const auto& visible : visibles_opaque)
-            {
-                std::shared_ptr<GameObject> current_gameobject = visible.lock();
-                if (!current_gameobject)
-                    continue;
-                std::shared_ptr<Transform3DComponent> current_gameobject_transfrom_component =
-                    current_gameobject->TryGetComponent<Transform3DComponent>("Transform3DComponent");
-                std::shared_ptr<ModelComponent> current_gameobject_model_component =
-                    current_gameobject->TryGetComponent<ModelComponent>("ModelComponent");
-
-                if (!current_gameobject_transfrom_component || !current_gameobject_model_component)
-                    continue;
+            // object data of casters also visible to the camera is only written once per frame
+            m_shadow_caster_batcher.Build(m_shadow_casters, frame_index, sort_view);
+            return;
+        }
 
-                if (!current_gameobject)
-                    MEOW_ERROR("shared ptr is invalid!");
-                if (!current_gameobject_transfrom_component)
-                    MEOW_ERROR("shared ptr is invalid!");
-                if (!current_gameobject_model_component)
-                    MEOW_ERROR("shared ptr is invalid!");
+        m_shadow_map_material->BeginPopulatingDynamicUniformBufferPerFrame();
+        for (const auto& visible : m_shadow_casters)
+        {
+            auto* model_resource = visible.model;
+            if (!model_resource)
+                continue;
 
-                auto model = current_gameobject_transfrom_component->GetTransform();
+            auto model = visible.transform;
 
-                for (uint32_t i = 0; i < current_gameobject_model_component->model.lock()->meshes.size(); ++i)
-                {
-                    m_shadow_map_material->BeginPopulatingDynamicUniformBufferPerObject();
-                    m_shadow_map_material->PopulateDynamicUniformBuffer("objData", &model, sizeof(model), frame_index);
-                    m_shadow_map_material->EndPopulatingDynamicUniformBufferPerObject();
-                }
+            for (uint32_t i = 0; i < model_resource->meshes.size(); ++i)
+            {
+                m_shadow_map_material->BeginPopulatingDynamicUniformBufferPerObject();
+                m_shadow_map_material->PopulateDynamicUniformBuffer("objData", &model, sizeof(model), frame_index);
+                m_shadow_map_material->EndPopulatingDynamicUniformBufferPerObject();
             }
-            m_shadow_map_material->EndPopulatingDynamicUniformBufferPerFrame();
         }
+        m_shadow_map_material->EndPopulatingDynamicUniformBufferPerFrame();
     }
 
     void ShadowMapPass::Start(const vk::raii::CommandBuffer& command_buffer, vk::Extent2D extent, uint32_t image_index)
@@ -268,62 +270,106 @@ namespace Meow
 
         RenderPassBase::Start(command_buffer, m_shadow_map->extent, image_index);
 
-        command_buffer.setViewport(0,
-                                   vk::Viewport(0.0f,
-                                                static_cast<float>(m_shadow_map->extent.height),
-                                                static_cast<float>(m_shadow_map->extent.width),
-                                                -static_cast<float>(m_shadow_map->extent.height),
-                                                0.0f,
-                                                1.0f));
-        command_buffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), m_shadow_map->extent));
+        SetViewportAndScissor(command_buffer, m_shadow_map->extent);
     }
 
     void ShadowMapPass::RecordGraphicsCommand(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index)
     {
         FUNCTION_TIMER();
 
-        m_shadow_map_material->BindPipeline(command_buffer);
+        m_shadow_map_material->BindPipeline(command_buffer, m_state_cache);
 
-        RenderShadowMap(command_buffer);
+        RenderShadowMap(command_buffer, frame_index);
     }
 
-    void ShadowMapPass::RenderShadowMap(const vk::raii::CommandBuffer& command_buffer)
+    bool ShadowMapPass::RecordSecondaryCommands(vk::Extent2D extent, uint32_t frame_index)
     {
         FUNCTION_TIMER();
 
-        m_shadow_map_material->BindDescriptorSetToPipeline(command_buffer, 0, 1);
+        // dynamic offsets are assigned in draw order, so only instanced draws can be split
+        if (!m_shadow_map_material->UsesObjectDataBuffer())
+            return false;
+
+        m_shadow_map_material->RefreshObjectDataBufferBinding(frame_index);
+        m_secondary_command_buffers.clear();
+
+        uint32_t draw_count = static_cast<uint32_t>(m_shadow_caster_batcher.GetDraws().size());
+        uint32_t buffer_count =
+            (draw_count + k_draws_per_secondary_command_buffer - 1) / k_draws_per_secondary_command_buffer;
+
+        RecordSecondaryCommandBuffers(
+            frame_index,
+            *render_pass,
+            0,
+            m_shadow_map->extent,
+            buffer_count,
+            [&](const vk::raii::CommandBuffer& command_buffer, uint32_t buffer_index) {
+                uint32_t begin = buffer_index * k_draws_per_secondary_command_buffer;
+                uint32_t end   = std::min(begin + k_draws_per_secondary_command_buffer, draw_count);
+
+                RenderStateCache state_cache;
+                m_shadow_map_material->BindPipeline(command_buffer, state_cache);
+                RecordShadowCasterDraws(command_buffer, state_cache, frame_index, begin, end);
+            });
+
+        draw_call[0] = draw_count;
+        return true;
+    }
 
-        std::shared_ptr<Level> level               = g_runtime_context.level_system->GetCurrentActiveLevel().lock();
-        const auto*            visibles_opaque_ptr = level->GetVisiblesPerShadingModel(ShadingModelType::Opaque);
-        if (visibles_opaque_ptr)
-        {
-            const auto& visibles_opaque = *visibles_opaque_ptr;
-            for (const auto& visible : visibles_opaque)
-            {
-                std::shared_ptr<GameObject> current_gameobject = visible.lock();
-                if (!current_gameobject)
-                    continue;
+    void ShadowMapPass::ExecuteSecondaryCommands(const vk::raii::CommandBuffer& command_buffer,
+                                                 vk::Extent2D                   extent,
+                                                 uint32_t                       image_index)
+    {
+        RenderPassBase::ExecuteSecondaryCommands(command_buffer, m_shadow_map->extent, image_index);
+    }
 
-                std::shared_ptr<ModelComponent> current_gameobject_model_component =
-                    current_gameobject->TryGetComponent<ModelComponent>("ModelComponent");
-                if (!current_gameobject_model_component)
-                    continue;
+    void ShadowMapPass::RenderShadowMap(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index)
+    {
+        FUNCTION_TIMER();
 
-                auto model_resource = current_gameobject_model_component->model.lock();
-                if (!model_resource)
-                    continue;
+        m_shadow_map_material->BindDescriptorSetToPipeline(command_buffer, 0, 1, 0, false, 0, &m_state_cache);
 
-                for (uint32_t i = 0; i < model_resource->meshes.size(); ++i)
-                {
-                    m_shadow_map_material->BindDescriptorSetToPipeline(command_buffer, 1, 1, draw_call[0], true);
-                    model_resource->meshes[i]->BindDrawCmd(command_buffer);
+        if (m_shadow_map_material->UsesObjectDataBuffer())
+        {
+            uint32_t draw_count = static_cast<uint32_t>(m_shadow_caster_batcher.GetDraws().size());
+            RecordShadowCasterDraws(command_buffer, m_state_cache, frame_index, 0, draw_count);
+            draw_call[0] += draw_count;
+            return;
+        }
 
-                    ++draw_call[0];
-                }
+        for (const auto& visible : m_shadow_casters)
+        {
+            auto* model_resource = visible.model;
+            if (!model_resource)
+                continue;
+
+            for (uint32_t i = 0; i < model_resource->meshes.size(); ++i)
+            {
+                m_shadow_map_material->BindDescriptorSetToPipeline(
+                    command_buffer, 1, 1, draw_call[0], true, 0, &m_state_cache);
+                model_resource->meshes[i]->BindDrawCmd(command_buffer, m_state_cache);
+
+                ++draw_call[0];
             }
         }
     }
 
+    void ShadowMapPass::RecordShadowCasterDraws(const vk::raii::CommandBuffer& command_buffer,
+                                                RenderStateCache&              state_cache,
+                                                uint32_t                       frame_index,
+                                                uint32_t                       begin,
+                                                uint32_t                       end)
+    {
+        m_shadow_map_material->BindDescriptorSetToPipeline(command_buffer, 0, 1, 0, false, 0, &state_cache);
+        m_shadow_map_material->BindDescriptorSetToPipeline(command_buffer, 1, 1, 0, false, frame_index, &state_cache);
+
+        const auto& draws = m_shadow_caster_batcher.GetDraws();
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            draws[i].mesh->BindDrawCmd(command_buffer, state_cache, draws[i].instance_count, draws[i].first_instance);
+        }
+    }
+
     void swap(ShadowMapPass& lhs, ShadowMapPass& rhs)
     {
         using std::swap;
@@ -332,6 +378,8 @@ namespace Meow
 
         swap(lhs.m_shadow_map_material, rhs.m_shadow_map_material);
         swap(lhs.m_shadow_map, rhs.m_shadow_map);
+        swap(lhs.m_shadow_casters, rhs.m_shadow_casters);
+        swap(lhs.m_shadow_caster_batcher, rhs.m_shadow_caster_batcher);
 
         swap(lhs.draw_call, rhs.draw_call);
     }
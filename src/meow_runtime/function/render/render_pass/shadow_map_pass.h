@@ -1,9 +1,11 @@
 #pragma once
 
+#include "function/render/batch/instance_batcher.h"
 #include "function/render/material/material.h"
 #include "function/render/material/shader.h"
 #include "function/render/model/model.hpp"
 #include "function/render/render_pass/render_pass_base.h"
+#include "function/level/level.h"
 #include "function/render/utils/vulkan_debug_utils.h"
 
 namespace Meow
@@ -50,16 +52,34 @@ namespace Meow
 
         void RecordGraphicsCommand(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) override;
 
-        void RenderShadowMap(const vk::raii::CommandBuffer& command_buffer);
+        bool RecordSecondaryCommands(vk::Extent2D extent, uint32_t frame_index) override;
+
+        void ExecuteSecondaryCommands(const vk::raii::CommandBuffer& command_buffer,
+                                      vk::Extent2D                   extent,
+                                      uint32_t                       image_index) override;
+
+        void RenderShadowMap(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index);
 
         std::shared_ptr<ImageData> GetShadowMap() { return m_shadow_map; }
 
         friend void swap(ShadowMapPass& lhs, ShadowMapPass& rhs);
 
     protected:
+        /**
+         * @brief Record instanced shadow caster draws in [begin, end), with the pipeline already bound.
+         */
+        void RecordShadowCasterDraws(const vk::raii::CommandBuffer& command_buffer,
+                                     RenderStateCache&              state_cache,
+                                     uint32_t                       frame_index,
+                                     uint32_t                       begin,
+                                     uint32_t                       end);
+
         std::shared_ptr<Material>  m_shadow_map_material = nullptr;
         std::shared_ptr<ImageData> m_shadow_map          = nullptr;
 
+        std::vector<VisibleObject> m_shadow_casters;
+        InstanceBatcher            m_shadow_caster_batcher;
+
         std::string m_pass_names[1];
         int         draw_call[1] = {0};
     };
@@ -19,15 +19,31 @@ namespace Meow
         CreateVulkanInstance();
         CreatePhysicalDevice();
         CreateLogicalDevice();
+        CreateDeviceMemoryAllocator();
+        CreatePipelineCache();
         CreateCommandPool();
+        CreateUploadManager();
         CreateDescriptorAllocator();
+        CreateBindlessDescriptorTable();
+        CreateDynamicUniformAllocator();
+        CreateObjectDataBuffer();
+        CreateSecondaryCommandBufferAllocator();
     }
 
     RenderSystem::~RenderSystem()
     {
+        m_upload_manager                     = nullptr;
+        m_secondary_command_buffer_allocator = nullptr;
+
+        m_object_data_buffer          = nullptr;
+        m_dynamic_uniform_allocator   = nullptr;
+        m_bindless_descriptor_table   = nullptr;
         m_descriptor_allocator        = nullptr;
+        m_device_memory_allocator     = nullptr;
+        m_pipeline_cache              = nullptr;
         m_command_pool                = nullptr;
         m_onetime_submit_command_pool = nullptr;
+        m_transfer_queue              = nullptr;
         m_present_queue               = nullptr;
         m_graphics_queue              = nullptr;
         m_logical_device              = nullptr;
@@ -35,7 +51,13 @@ namespace Meow
         m_vulkan_instance             = nullptr;
     }
 
-    void RenderSystem::Shutdown() { m_logical_device.waitIdle(); }
+    void RenderSystem::Shutdown()
+    {
+        m_logical_device.waitIdle();
+
+        // every pipeline has been created by now, so the next start compiles none of them
+        m_pipeline_cache.Save();
+    }
 
     void RenderSystem::CreateVulkanInstance()
     {
@@ -169,17 +191,77 @@ namespace Meow
         m_graphics_queue_family_index = indexs.first;
         m_present_queue_family_index  = indexs.second;
 
-        // Create a device with one queue
-        float                      queue_priority = 1.0f;
-        vk::DeviceQueueCreateInfo  queue_info({}, m_graphics_queue_family_index, 1, &queue_priority);
         vk::PhysicalDeviceFeatures physical_device_feature;
         physical_device_feature.pipelineStatisticsQuery = vk::True;
 
-        vk::DeviceCreateInfo device_info({},                           /* flags */
-                                         queue_info,                   /* queueCreateInfoCount */
-                                         {},                           /* ppEnabledLayerNames */
-                                         k_required_device_extensions, /* ppEnabledExtensionNames */
-                                         &physical_device_feature);    /* pEnabledFeatures */
+        // optional features of GPU culling
+        std::vector<const char*> enabled_device_extensions     = k_required_device_extensions;
+        std::vector<const char*> draw_indirect_count_extension = {VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME};
+
+        bool draw_indirect_count_supported = ValidateExtensions(draw_indirect_count_extension, device_extensions);
+        if (draw_indirect_count_supported)
+        {
+            enabled_device_extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+        }
+        physical_device_feature.drawIndirectFirstInstance = m_physical_device.getFeatures().drawIndirectFirstInstance;
+        m_gpu_culling_supported = draw_indirect_count_supported && physical_device_feature.drawIndirectFirstInstance;
+
+        // heap budgets are read through vkGetPhysicalDeviceMemoryProperties2, which is core since 1.1
+        std::vector<const char*> memory_budget_extension = {VK_EXT_MEMORY_BUDGET_EXTENSION_NAME};
+        m_memory_budget_supported = ValidateExtensions(memory_budget_extension, device_extensions) &&
+                                    m_physical_device.getProperties().apiVersion >= VK_API_VERSION_1_1;
+        if (m_memory_budget_supported)
+        {
+            enabled_device_extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+
+        // timeline semaphores let the graphics queue wait for uploads on the transfer queue, and descriptor indexing
+        // makes bindless descriptors, both core since 1.2
+        if (m_physical_device.getProperties().apiVersion >= VK_API_VERSION_1_2)
+        {
+            auto features = m_physical_device.getFeatures2<vk::PhysicalDeviceFeatures2,
+                                                           vk::PhysicalDeviceTimelineSemaphoreFeatures,
+                                                           vk::PhysicalDeviceDescriptorIndexingFeatures>();
+            m_timeline_semaphore_supported =
+                features.get<vk::PhysicalDeviceTimelineSemaphoreFeatures>().timelineSemaphore;
+            m_bindless_supported =
+                BindlessDescriptorTable::IsSupported(features.get<vk::PhysicalDeviceDescriptorIndexingFeatures>());
+        }
+
+        // Create a device with one graphics queue, and one transfer queue if a family is dedicated to transfers
+        m_transfer_queue_family_index = m_graphics_queue_family_index;
+        if (m_timeline_semaphore_supported)
+        {
+            m_transfer_queue_family_index =
+                FindTransferQueueFamilyIndex(m_physical_device, m_graphics_queue_family_index);
+        }
+
+        float                                  queue_priority = 1.0f;
+        std::vector<vk::DeviceQueueCreateInfo> queue_infos    = {
+            vk::DeviceQueueCreateInfo({}, m_graphics_queue_family_index, 1, &queue_priority)};
+        if (m_transfer_queue_family_index != m_graphics_queue_family_index)
+        {
+            queue_infos.emplace_back(vk::DeviceQueueCreateFlags(), m_transfer_queue_family_index, 1, &queue_priority);
+        }
+
+        vk::DeviceCreateInfo device_info({},                        /* flags */
+                                         queue_infos,               /* queueCreateInfoCount */
+                                         {},                        /* ppEnabledLayerNames */
+                                         enabled_device_extensions, /* ppEnabledExtensionNames */
+                                         &physical_device_feature); /* pEnabledFeatures */
+        vk::PhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore_feature(vk::True);
+        if (m_timeline_semaphore_supported)
+        {
+            timeline_semaphore_feature.pNext = const_cast<void*>(device_info.pNext);
+            device_info.pNext                = &timeline_semaphore_feature;
+        }
+        vk::PhysicalDeviceDescriptorIndexingFeatures descriptor_indexing_feature =
+            BindlessDescriptorTable::GetRequiredFeatures();
+        if (m_bindless_supported)
+        {
+            descriptor_indexing_feature.pNext = const_cast<void*>(device_info.pNext);
+            device_info.pNext                 = &descriptor_indexing_feature;
+        }
         m_logical_device = vk::raii::Device(m_physical_device, device_info);
 
 #if defined(VK_USE_PLATFORM_DISPLAY_KHR)
@@ -191,8 +273,11 @@ namespace Meow
         m_graphics_queue = vk::raii::Queue(m_logical_device, m_graphics_queue_family_index, 0);
         m_present_queue  = vk::raii::Queue(m_logical_device, m_present_queue_family_index, 0);
         m_compute_queue  = vk::raii::Queue(m_logical_device, m_compute_queue_family_index, 0);
+        m_transfer_queue = vk::raii::Queue(m_logical_device, m_transfer_queue_family_index, 0);
     }
 
+    void RenderSystem::CreatePipelineCache() { m_pipeline_cache = PipelineCache(m_physical_device, m_logical_device); }
+
     void RenderSystem::CreateCommandPool()
     {
         {
@@ -225,6 +310,56 @@ namespace Meow
                                                           {vk::DescriptorType::eUniformBufferDynamic, 1000},
                                                           {vk::DescriptorType::eStorageBufferDynamic, 1000},
                                                           {vk::DescriptorType::eInputAttachment, 1000}};
-        m_descriptor_allocator = DescriptorAllocatorGrowable(m_logical_device, 1000, pool_sizes);
+
+        // transient pools per job worker, plus one for the main thread
+        uint32_t thread_count = g_runtime_context.job_system->GetWorkerCount() + 1;
+
+        m_descriptor_allocator =
+            DescriptorAllocatorGrowable(m_logical_device, 1000, pool_sizes, k_max_frames_in_flight, thread_count);
+    }
+
+    void RenderSystem::CreateBindlessDescriptorTable()
+    {
+        if (!m_bindless_supported)
+            return;
+
+        m_bindless_descriptor_table = std::make_unique<BindlessDescriptorTable>(m_physical_device, m_logical_device);
+    }
+
+    void RenderSystem::CreateDeviceMemoryAllocator()
+    {
+        m_device_memory_allocator =
+            std::make_unique<DeviceMemoryAllocator>(m_physical_device, m_logical_device, m_memory_budget_supported);
+    }
+
+    void RenderSystem::CreateUploadManager()
+    {
+        m_upload_manager = std::make_unique<UploadManager>(m_physical_device,
+                                                           m_logical_device,
+                                                           m_graphics_queue,
+                                                           m_graphics_queue_family_index,
+                                                           m_transfer_queue,
+                                                           m_transfer_queue_family_index,
+                                                           m_timeline_semaphore_supported);
+    }
+
+    void RenderSystem::CreateDynamicUniformAllocator()
+    {
+        m_dynamic_uniform_allocator =
+            DynamicUniformAllocator(m_physical_device, m_logical_device, k_max_frames_in_flight);
+    }
+
+    void RenderSystem::CreateObjectDataBuffer()
+    {
+        m_object_data_buffer = ObjectDataBuffer(m_physical_device, m_logical_device, k_max_frames_in_flight);
+    }
+
+    void RenderSystem::CreateSecondaryCommandBufferAllocator()
+    {
+        // one pool per job worker, plus one for the main thread
+        uint32_t thread_count = g_runtime_context.job_system->GetWorkerCount() + 1;
+
+        m_secondary_command_buffer_allocator = SecondaryCommandBufferAllocator(
+            m_logical_device, m_graphics_queue_family_index, k_max_frames_in_flight, thread_count);
     }
 } // namespace Meow
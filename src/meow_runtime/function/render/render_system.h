@@ -1,9 +1,16 @@
 #pragma once
 
 #include "core/base/bitmask.hpp"
+#include "function/render/allocator/bindless_descriptor_table.h"
 #include "function/render/allocator/descriptor_allocator_growable.h"
+#include "function/render/allocator/device_memory_allocator.h"
+#include "function/render/allocator/dynamic_uniform_allocator.h"
+#include "function/render/allocator/secondary_command_buffer_allocator.h"
 #include "function/render/buffer_data/image_data.h"
+#include "function/render/buffer_data/object_data_buffer.h"
+#include "function/render/material/pipeline_cache.h"
 #include "function/render/model/model.hpp"
+#include "function/render/upload/upload_manager.h"
 #include "function/system.h"
 #include "function/window/window.h"
 
@@ -33,6 +40,21 @@ namespace Meow
         const vk::raii::CommandPool&    GetOneTimeSubmitCommandPool() const { return m_onetime_submit_command_pool; }
         const vk::raii::CommandPool&    GetCommandPool() const { return m_command_pool; }
         DescriptorAllocatorGrowable&    GetDescriptorAllocator() { return m_descriptor_allocator; }
+        DeviceMemoryAllocator&          GetDeviceMemoryAllocator() { return *m_device_memory_allocator; }
+        DynamicUniformAllocator&        GetDynamicUniformAllocator() { return m_dynamic_uniform_allocator; }
+        ObjectDataBuffer&               GetObjectDataBuffer() { return m_object_data_buffer; }
+        const PipelineCache&            GetPipelineCache() const { return m_pipeline_cache; }
+        UploadManager&                  GetUploadManager() { return *m_upload_manager; }
+
+        /**
+         * @brief Only exists if GetBindlessSupported() is true.
+         */
+        BindlessDescriptorTable& GetBindlessDescriptorTable() { return *m_bindless_descriptor_table; }
+
+        SecondaryCommandBufferAllocator& GetSecondaryCommandBufferAllocator()
+        {
+            return m_secondary_command_buffer_allocator;
+        }
 
         const uint32_t                GetGraphicsQueueFamiliyIndex() const { return m_graphics_queue_family_index; }
         const uint32_t                GetPresentQueueFamilyIndex() const { return m_present_queue_family_index; }
@@ -40,14 +62,23 @@ namespace Meow
         const bool     GetDepthWritebackResolveSupported() const { return m_depth_writeback_resolve_supported; }
         const bool     GetResolveDepthOnWriteback() const { return m_resolve_depth_on_writeback; }
         const bool     GetPostProcessRunning() const { return m_postprocess_running; }
+        const bool     GetGPUCullingSupported() const { return m_gpu_culling_supported; }
+        const bool     GetBindlessSupported() const { return m_bindless_supported; }
         const uint32_t GetMaxFramesInFlight() const { return k_max_frames_in_flight; }
 
     private:
         void CreateVulkanInstance();
         void CreatePhysicalDevice();
         void CreateLogicalDevice();
+        void CreateDeviceMemoryAllocator();
+        void CreatePipelineCache();
         void CreateCommandPool();
+        void CreateUploadManager();
         void CreateDescriptorAllocator();
+        void CreateBindlessDescriptorTable();
+        void CreateDynamicUniformAllocator();
+        void CreateObjectDataBuffer();
+        void CreateSecondaryCommandBufferAllocator();
 
         vk::raii::Context           m_vulkan_context;
         vk::raii::Instance          m_vulkan_instance             = nullptr;
@@ -56,9 +87,20 @@ namespace Meow
         vk::raii::Queue             m_graphics_queue              = nullptr;
         vk::raii::Queue             m_present_queue               = nullptr;
         vk::raii::Queue             m_compute_queue               = nullptr;
+        vk::raii::Queue             m_transfer_queue              = nullptr;
         vk::raii::CommandPool       m_onetime_submit_command_pool = nullptr;
         vk::raii::CommandPool       m_command_pool                = nullptr;
+        PipelineCache               m_pipeline_cache              = nullptr;
         DescriptorAllocatorGrowable m_descriptor_allocator        = nullptr;
+        DynamicUniformAllocator     m_dynamic_uniform_allocator   = nullptr;
+        ObjectDataBuffer            m_object_data_buffer          = nullptr;
+
+        SecondaryCommandBufferAllocator m_secondary_command_buffer_allocator = nullptr;
+
+        // allocations point to the allocator, so it is kept from moving
+        std::unique_ptr<DeviceMemoryAllocator>   m_device_memory_allocator   = nullptr;
+        std::unique_ptr<UploadManager>           m_upload_manager            = nullptr;
+        std::unique_ptr<BindlessDescriptorTable> m_bindless_descriptor_table = nullptr;
 
         vk::SampleCountFlagBits m_msaa_samples;
 
@@ -97,9 +139,31 @@ namespace Meow
          */
         bool m_postprocess_running = false;
 
+        /**
+         * @brief If true, indirect draws may use firstInstance and take their count from a buffer
+         *        (VK_KHR_draw_indirect_count), which GPU culling needs.
+         */
+        bool m_gpu_culling_supported = false;
+
+        /**
+         * @brief If true, VK_EXT_memory_budget is enabled, so that device memory blocks can stay inside heap budgets.
+         */
+        bool m_memory_budget_supported = false;
+
+        /**
+         * @brief If true, timeline semaphores are enabled, so that uploads may run on a dedicated transfer queue.
+         */
+        bool m_timeline_semaphore_supported = false;
+
+        /**
+         * @brief If true, descriptor indexing is enabled, and materials may read textures from the bindless table.
+         */
+        bool m_bindless_supported = false;
+
         uint32_t m_graphics_queue_family_index = 0;
         uint32_t m_present_queue_family_index  = 0;
         uint32_t m_compute_queue_family_index  = 0;
+        uint32_t m_transfer_queue_family_index = 0;
 
         const uint32_t k_max_frames_in_flight = 2;
     };
@@ -0,0 +1,441 @@
+#include "upload_manager.h"
+
+#include "pch.h"
+
+#include "function/render/buffer_data/buffer_data.h"
+#include "function/render/buffer_data/image_data.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Meow
+{
+    namespace
+    {
+        // everything that reads uploaded buffers: vertex and index fetch, indirect commands and shaders
+        constexpr vk::PipelineStageFlags k_buffer_read_stages =
+            vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput |
+            vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader |
+            vk::PipelineStageFlagBits::eComputeShader;
+        constexpr vk::AccessFlags k_buffer_read_access =
+            vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eIndexRead |
+            vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eUniformRead |
+            vk::AccessFlagBits::eShaderRead;
+
+        vk::DeviceSize AlignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    } // namespace
+
+    UploadManager::UploadManager(const vk::raii::PhysicalDevice& physical_device,
+                                 const vk::raii::Device&         logical_device,
+                                 const vk::raii::Queue&          graphics_queue,
+                                 uint32_t                        graphics_queue_family_index,
+                                 const vk::raii::Queue&          transfer_queue,
+                                 uint32_t                        transfer_queue_family_index,
+                                 bool                            timeline_semaphore_supported)
+        : m_physical_device(&physical_device)
+        , m_logical_device(&logical_device)
+        , m_graphics_queue(&graphics_queue)
+        , m_transfer_queue(&transfer_queue)
+        , m_graphics_queue_family_index(graphics_queue_family_index)
+        , m_transfer_queue_family_index(transfer_queue_family_index)
+        , m_timeline_semaphore_supported(timeline_semaphore_supported)
+    {
+        // the acquire on the graphics queue has to wait for the transfer queue without the CPU
+        m_transfer_queue_dedicated =
+            timeline_semaphore_supported && transfer_queue_family_index != graphics_queue_family_index;
+        if (!m_transfer_queue_dedicated)
+        {
+            m_transfer_queue              = &graphics_queue;
+            m_transfer_queue_family_index = graphics_queue_family_index;
+        }
+
+        // texel sizes of uploaded formats divide 16
+        m_copy_alignment =
+            std::max<vk::DeviceSize>(16, physical_device.getProperties().limits.optimalBufferCopyOffsetAlignment);
+
+        m_command_pool = vk::raii::CommandPool(
+            logical_device,
+            vk::CommandPoolCreateInfo(vk::CommandPoolCreateFlagBits::eTransient, m_transfer_queue_family_index));
+
+        if (m_timeline_semaphore_supported)
+        {
+            vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfo> semaphore_create_info(
+                {}, {vk::SemaphoreType::eTimeline, 0});
+            m_timeline_semaphore = vk::raii::Semaphore(logical_device, semaphore_create_info.get());
+
+            if (m_transfer_queue_dedicated)
+            {
+                m_transfer_timeline_semaphore = vk::raii::Semaphore(logical_device, semaphore_create_info.get());
+                m_acquire_command_pool        = vk::raii::CommandPool(
+                    logical_device,
+                    vk::CommandPoolCreateInfo(vk::CommandPoolCreateFlagBits::eTransient, graphics_queue_family_index));
+            }
+        }
+
+        m_staging_ring = std::make_unique<BufferData>(
+            physical_device, logical_device, k_staging_ring_size, vk::BufferUsageFlagBits::eTransferSrc);
+    }
+
+    UploadManager::~UploadManager()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // destinations may be destroyed right after, so copies in flight are finished, and the rest dropped
+        while (!m_in_flight.empty())
+        {
+            WaitForBatch(m_in_flight.front());
+            RetireBatches();
+        }
+    }
+
+    UploadTicket UploadManager::UploadBuffer(vk::Buffer  dst_buffer,
+                                             const void* data,
+                                             size_t      element_count,
+                                             size_t      element_size,
+                                             size_t      stride)
+    {
+        FUNCTION_TIMER();
+
+        vk::DeviceSize size = static_cast<vk::DeviceSize>(element_count) * stride;
+        if (size == 0)
+            return {};
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        StagingRange range = AllocateStaging(size);
+
+        if (element_size == stride)
+        {
+            std::memcpy(range.data_ptr, data, size);
+        }
+        else
+        {
+            const uint8_t* src_ptr = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < element_count; ++i)
+            {
+                std::memcpy(range.data_ptr + i * stride, src_ptr + i * element_size, element_size);
+            }
+        }
+
+        BeginBatch();
+        m_recording.command_buffer.copyBuffer(range.buffer, dst_buffer, vk::BufferCopy(range.offset, 0, size));
+        m_recording.has_buffer_copies = true;
+
+        if (m_transfer_queue_dedicated)
+        {
+            vk::BufferMemoryBarrier release_barrier(vk::AccessFlagBits::eTransferWrite,
+                                                    {},
+                                                    m_transfer_queue_family_index,
+                                                    m_graphics_queue_family_index,
+                                                    dst_buffer,
+                                                    0,
+                                                    VK_WHOLE_SIZE);
+            m_recording.command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                                       vk::PipelineStageFlagBits::eBottomOfPipe,
+                                                       {},
+                                                       nullptr,
+                                                       release_barrier,
+                                                       nullptr);
+
+            vk::BufferMemoryBarrier acquire_barrier({},
+                                                    k_buffer_read_access,
+                                                    m_transfer_queue_family_index,
+                                                    m_graphics_queue_family_index,
+                                                    dst_buffer,
+                                                    0,
+                                                    VK_WHOLE_SIZE);
+            m_recording.acquire_command_buffer.pipelineBarrier(
+                vk::PipelineStageFlagBits::eTopOfPipe, k_buffer_read_stages, {}, nullptr, acquire_barrier, nullptr);
+        }
+
+        return {m_recording.value};
+    }
+
+    UploadTicket UploadManager::UploadImage(ImageData&                       image_data,
+                                            const uint8_t*                   data,
+                                            vk::DeviceSize                   size,
+                                            std::vector<vk::BufferImageCopy> regions,
+                                            const vk::ImageSubresourceRange& subresource_range)
+    {
+        FUNCTION_TIMER();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        StagingRange range = AllocateStaging(size);
+        std::memcpy(range.data_ptr, data, size);
+        for (vk::BufferImageCopy& region : regions)
+        {
+            region.bufferOffset += range.offset;
+        }
+
+        BeginBatch();
+        image_data.TransitLayout(m_recording.command_buffer,
+                                 vk::ImageLayout::eUndefined,
+                                 vk::ImageLayout::eTransferDstOptimal,
+                                 subresource_range);
+        m_recording.command_buffer.copyBufferToImage(
+            range.buffer, *image_data.image, vk::ImageLayout::eTransferDstOptimal, regions);
+
+        if (!m_transfer_queue_dedicated)
+        {
+            image_data.TransitLayout(m_recording.command_buffer,
+                                     vk::ImageLayout::eTransferDstOptimal,
+                                     vk::ImageLayout::eShaderReadOnlyOptimal,
+                                     subresource_range);
+            return {m_recording.value};
+        }
+
+        // the layout changes once, between the release and the acquire
+        vk::ImageMemoryBarrier release_barrier(vk::AccessFlagBits::eTransferWrite,
+                                               {},
+                                               vk::ImageLayout::eTransferDstOptimal,
+                                               vk::ImageLayout::eShaderReadOnlyOptimal,
+                                               m_transfer_queue_family_index,
+                                               m_graphics_queue_family_index,
+                                               *image_data.image,
+                                               subresource_range);
+        m_recording.command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                                   vk::PipelineStageFlagBits::eBottomOfPipe,
+                                                   {},
+                                                   nullptr,
+                                                   nullptr,
+                                                   release_barrier);
+
+        vk::ImageMemoryBarrier acquire_barrier({},
+                                               vk::AccessFlagBits::eShaderRead,
+                                               vk::ImageLayout::eTransferDstOptimal,
+                                               vk::ImageLayout::eShaderReadOnlyOptimal,
+                                               m_transfer_queue_family_index,
+                                               m_graphics_queue_family_index,
+                                               *image_data.image,
+                                               subresource_range);
+        m_recording.acquire_command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                                                           vk::PipelineStageFlagBits::eFragmentShader |
+                                                               vk::PipelineStageFlagBits::eComputeShader,
+                                                           {},
+                                                           nullptr,
+                                                           nullptr,
+                                                           acquire_barrier);
+        image_data.layout = vk::ImageLayout::eShaderReadOnlyOptimal;
+
+        return {m_recording.value};
+    }
+
+    UploadTicket UploadManager::TransitHostWrittenImage(ImageData&                       image_data,
+                                                        const vk::ImageSubresourceRange& subresource_range)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // the transfer queue never touches the image, so it stays owned by the graphics queue
+        BeginBatch();
+        image_data.TransitLayout(m_transfer_queue_dedicated ? m_recording.acquire_command_buffer :
+                                                              m_recording.command_buffer,
+                                 vk::ImageLayout::ePreinitialized,
+                                 vk::ImageLayout::eShaderReadOnlyOptimal,
+                                 subresource_range);
+
+        return {m_recording.value};
+    }
+
+    void UploadManager::Flush()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        FlushLocked();
+    }
+
+    bool UploadManager::IsComplete(UploadTicket ticket)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        RetireBatches();
+        return ticket.value <= m_completed_value;
+    }
+
+    void UploadManager::Wait(UploadTicket ticket)
+    {
+        FUNCTION_TIMER();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (ticket.value > m_submitted_value)
+            FlushLocked();
+
+        RetireBatches();
+        while (ticket.value > m_completed_value)
+        {
+            WaitForBatch(m_in_flight.front());
+            RetireBatches();
+        }
+    }
+
+    void UploadManager::BeginBatch()
+    {
+        if (*m_recording.command_buffer)
+            return;
+
+        const vk::raii::Device& logical_device = *m_logical_device;
+
+        m_recording.value = m_submitted_value + 1;
+
+        m_recording.command_buffer = std::move(
+            vk::raii::CommandBuffers(logical_device, {*m_command_pool, vk::CommandBufferLevel::ePrimary, 1}).front());
+        m_recording.command_buffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+        if (m_transfer_queue_dedicated)
+        {
+            m_recording.acquire_command_buffer = std::move(
+                vk::raii::CommandBuffers(logical_device,
+                                         {*m_acquire_command_pool, vk::CommandBufferLevel::ePrimary, 1})
+                    .front());
+            m_recording.acquire_command_buffer.begin(
+                vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        }
+    }
+
+    UploadManager::StagingRange UploadManager::AllocateStaging(vk::DeviceSize size)
+    {
+        if (size > k_staging_ring_size)
+        {
+            BeginBatch();
+
+            auto staging_buffer = std::make_unique<BufferData>(
+                *m_physical_device, *m_logical_device, size, vk::BufferUsageFlagBits::eTransferSrc);
+            StagingRange range {staging_buffer->memory.GetMappedData(), *staging_buffer->buffer, 0};
+            m_recording.oversized_staging_buffers.push_back(std::move(staging_buffer));
+
+            return range;
+        }
+
+        while (true)
+        {
+            RetireBatches();
+
+            // nothing in the ring is in use, so start over from its beginning
+            if (m_in_flight.empty() && m_ring_head == m_ring_tail)
+            {
+                m_ring_head = 0;
+                m_ring_tail = 0;
+            }
+
+            // a range never wraps around the end of the ring
+            uint64_t offset = AlignUp(m_ring_head, m_copy_alignment);
+            if (offset % k_staging_ring_size + size > k_staging_ring_size)
+                offset = AlignUp(offset, k_staging_ring_size);
+
+            if (offset + size - m_ring_tail <= k_staging_ring_size)
+            {
+                m_ring_head = offset + size;
+                return {m_staging_ring->memory.GetMappedData() + offset % k_staging_ring_size,
+                        *m_staging_ring->buffer,
+                        offset % k_staging_ring_size};
+            }
+
+            // the ring is full, so the oldest batch is waited for, after submitting what is recorded if needed
+            if (m_in_flight.empty())
+                FlushLocked();
+            WaitForBatch(m_in_flight.front());
+        }
+    }
+
+    void UploadManager::FlushLocked()
+    {
+        if (!*m_recording.command_buffer)
+            return;
+
+        FUNCTION_TIMER();
+
+        // on the graphics queue, one barrier covers the copies into all buffers
+        if (!m_transfer_queue_dedicated && m_recording.has_buffer_copies)
+        {
+            vk::MemoryBarrier memory_barrier(vk::AccessFlagBits::eTransferWrite, k_buffer_read_access);
+            m_recording.command_buffer.pipelineBarrier(
+                vk::PipelineStageFlagBits::eTransfer, k_buffer_read_stages, {}, memory_barrier, nullptr, nullptr);
+        }
+        m_recording.command_buffer.end();
+
+        if (m_transfer_queue_dedicated)
+        {
+            m_recording.acquire_command_buffer.end();
+
+            {
+                vk::TimelineSemaphoreSubmitInfo timeline_info(nullptr, m_recording.value);
+                vk::SubmitInfo                  submit_info(nullptr,
+                                           nullptr,
+                                           *m_recording.command_buffer,
+                                           *m_transfer_timeline_semaphore,
+                                           &timeline_info);
+                m_transfer_queue->submit(submit_info);
+            }
+
+            {
+                vk::PipelineStageFlags          wait_stage_mask(vk::PipelineStageFlagBits::eAllCommands);
+                vk::TimelineSemaphoreSubmitInfo timeline_info(m_recording.value, m_recording.value);
+                vk::SubmitInfo                  submit_info(*m_transfer_timeline_semaphore,
+                                           wait_stage_mask,
+                                           *m_recording.acquire_command_buffer,
+                                           *m_timeline_semaphore,
+                                           &timeline_info);
+                m_graphics_queue->submit(submit_info);
+            }
+        }
+        else if (m_timeline_semaphore_supported)
+        {
+            vk::TimelineSemaphoreSubmitInfo timeline_info(nullptr, m_recording.value);
+            vk::SubmitInfo                  submit_info(
+                nullptr, nullptr, *m_recording.command_buffer, *m_timeline_semaphore, &timeline_info);
+            m_graphics_queue->submit(submit_info);
+        }
+        else
+        {
+            m_recording.fence = vk::raii::Fence(*m_logical_device, vk::FenceCreateInfo());
+
+            vk::SubmitInfo submit_info({}, {}, *m_recording.command_buffer);
+            m_graphics_queue->submit(submit_info, *m_recording.fence);
+        }
+
+        m_recording.ring_end = m_ring_head;
+        m_submitted_value    = m_recording.value;
+        m_in_flight.push_back(std::move(m_recording));
+        m_recording = Batch();
+    }
+
+    void UploadManager::WaitForBatch(const Batch& batch)
+    {
+        FUNCTION_TIMER();
+
+        if (m_timeline_semaphore_supported)
+        {
+            vk::SemaphoreWaitInfo wait_info({}, *m_timeline_semaphore, batch.value);
+            while (vk::Result::eTimeout == m_logical_device->waitSemaphores(wait_info, UINT64_MAX))
+                ;
+        }
+        else
+        {
+            while (vk::Result::eTimeout == m_logical_device->waitForFences({*batch.fence}, VK_TRUE, UINT64_MAX))
+                ;
+        }
+    }
+
+    void UploadManager::RetireBatches()
+    {
+        uint64_t completed_value = m_timeline_semaphore_supported ? m_timeline_semaphore.getCounterValue() : 0;
+
+        while (!m_in_flight.empty())
+        {
+            const Batch& batch = m_in_flight.front();
+
+            bool completed = m_timeline_semaphore_supported ? batch.value <= completed_value :
+                                                              batch.fence.getStatus() == vk::Result::eSuccess;
+            if (!completed)
+                break;
+
+            m_ring_tail       = batch.ring_end;
+            m_completed_value = batch.value;
+            m_in_flight.pop_front();
+        }
+    }
+} // namespace Meow
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Meow
+{
+    struct BufferData;
+    struct ImageData;
+
+    /**
+     * @brief Completion of an upload, to be checked with UploadManager. A default ticket is already complete.
+     */
+    struct UploadTicket
+    {
+        uint64_t value = 0;
+    };
+
+    /**
+     * @brief Copies data into device local buffers and images through a persistently mapped staging ring, without
+     * waiting for the copies.
+     *
+     * Copies are recorded into an open batch, and Flush() submits the batch as a whole. With a queue family dedicated
+     * to transfers and timeline semaphores, batches run on the transfer queue, and every resource is released there
+     * and acquired on the graphics queue after waiting on a timeline semaphore. Otherwise batches run on the graphics
+     * queue. Either way a batch ends with barriers on the graphics queue, so frames submitted after Flush() read the
+     * data without the CPU waiting for it.
+     *
+     * Tickets tell when the copies of a batch have completed, e.g. before a destination is destroyed. Ranges of the
+     * ring are reused once their batch completes, and data larger than the ring gets a staging buffer of its own.
+     *
+     * Batches are submitted to the graphics queue, so uploads and Flush() belong to the thread submitting frames.
+     */
+    class UploadManager
+    {
+    public:
+        static constexpr vk::DeviceSize k_staging_ring_size = 64ull * 1024 * 1024;
+
+        UploadManager(const vk::raii::PhysicalDevice& physical_device,
+                      const vk::raii::Device&         logical_device,
+                      const vk::raii::Queue&          graphics_queue,
+                      uint32_t                        graphics_queue_family_index,
+                      const vk::raii::Queue&          transfer_queue,
+                      uint32_t                        transfer_queue_family_index,
+                      bool                            timeline_semaphore_supported);
+
+        ~UploadManager();
+
+        UploadManager(const UploadManager&)            = delete;
+        UploadManager& operator=(const UploadManager&) = delete;
+
+        /**
+         * @brief Copy element_count elements of element_size bytes into dst_buffer, placed stride bytes apart.
+         */
+        UploadTicket UploadBuffer(vk::Buffer  dst_buffer,
+                                  const void* data,
+                                  size_t      element_count,
+                                  size_t      element_size,
+                                  size_t      stride);
+
+        /**
+         * @brief Copy regions of data into an optimal image, and leave it in eShaderReadOnlyOptimal. The bufferOffset
+         * of each region is relative to data.
+         */
+        UploadTicket UploadImage(ImageData&                       image_data,
+                                 const uint8_t*                   data,
+                                 vk::DeviceSize                   size,
+                                 std::vector<vk::BufferImageCopy> regions,
+                                 const vk::ImageSubresourceRange& subresource_range);
+
+        /**
+         * @brief Make a linear image, already written through its mapped memory, readable by shaders.
+         */
+        UploadTicket TransitHostWrittenImage(ImageData& image_data, const vk::ImageSubresourceRange& subresource_range);
+
+        /**
+         * @brief Submit the copies recorded since the last flush. Frames submitted later see their data.
+         */
+        void Flush();
+
+        bool IsComplete(UploadTicket ticket);
+
+        /**
+         * @brief Block until the copies of the ticket complete, flushing them first if needed.
+         */
+        void Wait(UploadTicket ticket);
+
+        bool IsTransferQueueDedicated() const { return m_transfer_queue_dedicated; }
+
+    private:
+        struct Batch
+        {
+            // runs on the transfer queue if it is dedicated, otherwise on the graphics queue
+            vk::raii::CommandBuffer command_buffer = nullptr;
+            // acquires resources on the graphics queue, only if the transfer queue is dedicated
+            vk::raii::CommandBuffer acquire_command_buffer = nullptr;
+            // tells completion when timeline semaphores are not supported
+            vk::raii::Fence fence = nullptr;
+
+            std::vector<std::unique_ptr<BufferData>> oversized_staging_buffers;
+
+            uint64_t value             = 0;
+            uint64_t ring_end          = 0;
+            bool     has_buffer_copies = false;
+        };
+
+        struct StagingRange
+        {
+            uint8_t*       data_ptr = nullptr;
+            vk::Buffer     buffer;
+            vk::DeviceSize offset = 0;
+        };
+
+        void BeginBatch();
+
+        StagingRange AllocateStaging(vk::DeviceSize size);
+
+        void FlushLocked();
+
+        void WaitForBatch(const Batch& batch);
+
+        /**
+         * @brief Pop completed batches in order, giving their ranges of the ring back.
+         */
+        void RetireBatches();
+
+        const vk::raii::PhysicalDevice* m_physical_device = nullptr;
+        const vk::raii::Device*         m_logical_device  = nullptr;
+        const vk::raii::Queue*          m_graphics_queue  = nullptr;
+        const vk::raii::Queue*          m_transfer_queue  = nullptr;
+
+        uint32_t m_graphics_queue_family_index  = 0;
+        uint32_t m_transfer_queue_family_index  = 0;
+        bool     m_transfer_queue_dedicated     = false;
+        bool     m_timeline_semaphore_supported = false;
+
+        vk::DeviceSize m_copy_alignment = 16;
+
+        std::mutex m_mutex;
+
+        // pools outlive the command buffers of batches
+        vk::raii::CommandPool m_command_pool         = nullptr;
+        vk::raii::CommandPool m_acquire_command_pool = nullptr;
+
+        // signaled by the transfer queue with the value of a batch, only if the transfer queue is dedicated
+        vk::raii::Semaphore m_transfer_timeline_semaphore = nullptr;
+        // signaled with the value of a batch once the graphics queue may read its data
+        vk::raii::Semaphore m_timeline_semaphore = nullptr;
+
+        std::unique_ptr<BufferData> m_staging_ring;
+        // ever increasing, so that the position in the ring is the offset modulo k_staging_ring_size
+        uint64_t m_ring_head = 0;
+        uint64_t m_ring_tail = 0;
+
+        Batch             m_recording;
+        std::deque<Batch> m_in_flight;
+        uint64_t          m_submitted_value = 0;
+        uint64_t          m_completed_value = 0;
+    };
+} // namespace Meow
@@ -463,6 +463,24 @@ namespace Meow
         return static_cast<uint32_t>(std::distance(queue_family_properties.cbegin(), compute_queue_family_property));
     }
 
+    uint32_t FindTransferQueueFamilyIndex(vk::raii::PhysicalDevice const& physical_device,
+                                          uint32_t                        graphics_queue_family_index)
+    {
+        std::vector<vk::QueueFamilyProperties> queue_family_properties = physical_device.getQueueFamilyProperties();
+        assert(queue_family_properties.size() < std::numeric_limits<uint32_t>::max());
+
+        // get the first index into queueFamiliyProperties which supports transfer, but neither graphics nor compute
+        std::vector<vk::QueueFamilyProperties>::const_iterator transfer_queue_family_property = std::find_if(
+            queue_family_properties.begin(), queue_family_properties.end(), [](vk::QueueFamilyProperties const& qfp) {
+                return (qfp.queueFlags & vk::QueueFlagBits::eTransfer) &&
+                       !(qfp.queueFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute));
+            });
+        if (transfer_queue_family_property == queue_family_properties.end())
+            return graphics_queue_family_index;
+
+        return static_cast<uint32_t>(std::distance(queue_family_properties.cbegin(), transfer_queue_family_property));
+    }
+
     vk::SurfaceFormatKHR PickSurfaceFormat(std::vector<vk::SurfaceFormatKHR> const& formats)
     {
         assert(!formats.empty());
@@ -541,17 +559,6 @@ namespace Meow
         return type_index;
     }
 
-    vk::raii::DeviceMemory AllocateDeviceMemory(vk::raii::Device const&                   device,
-                                                vk::PhysicalDeviceMemoryProperties const& memory_properties,
-                                                vk::MemoryRequirements const&             memory_requirements,
-                                                vk::MemoryPropertyFlags                   memory_property_flags)
-    {
-        uint32_t memory_type_index =
-            FindMemoryType(memory_properties, memory_requirements.memoryTypeBits, memory_property_flags);
-        vk::MemoryAllocateInfo memory_allocate_info(memory_requirements.size, memory_type_index);
-        return vk::raii::DeviceMemory(device, memory_allocate_info);
-    }
-
     std::pair<vk::Result, uint32_t> SwapchainNextImageWrapper(const vk::raii::SwapchainKHR& swapchain,
                                                               uint64_t                      timeout,
                                                               vk::Semaphore                 semaphore,
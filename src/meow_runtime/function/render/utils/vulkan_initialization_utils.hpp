@@ -65,6 +65,13 @@ namespace Meow
 
     uint32_t FindComputeQueueFamilyIndex(vk::raii::PhysicalDevice const& physical_device);
 
+    /**
+     * @brief The first queue family dedicated to transfers, which usually maps to DMA engines, or the graphics queue
+     * family if there is none.
+     */
+    uint32_t FindTransferQueueFamilyIndex(vk::raii::PhysicalDevice const& physical_device,
+                                          uint32_t                        graphics_queue_family_index);
+
     vk::SurfaceFormatKHR PickSurfaceFormat(std::vector<vk::SurfaceFormatKHR> const& formats);
 
     vk::PresentModeKHR PickPresentMode(std::vector<vk::PresentModeKHR> const& present_modes);
@@ -73,19 +80,14 @@ namespace Meow
                             uint32_t                                  type_bits,
                             vk::MemoryPropertyFlags                   requirements_mask);
 
-    vk::raii::DeviceMemory AllocateDeviceMemory(vk::raii::Device const&                   device,
-                                                vk::PhysicalDeviceMemoryProperties const& memory_properties,
-                                                vk::MemoryRequirements const&             memory_requirements,
-                                                vk::MemoryPropertyFlags                   memory_property_flags);
-
+    /**
+     * @brief Copy to host visible memory, which is mapped persistently by DeviceMemoryAllocator.
+     */
     template<typename T>
-    void CopyToDevice(vk::raii::DeviceMemory const& device_memory,
-                      T const*                      p_data,
-                      size_t                        count,
-                      vk::DeviceSize                stride = sizeof(T))
+    void CopyToDevice(uint8_t* mapped_data, T const* p_data, size_t count, vk::DeviceSize stride = sizeof(T))
     {
         assert(sizeof(T) <= stride);
-        uint8_t* device_data = static_cast<uint8_t*>(device_memory.mapMemory(0, count * stride));
+        uint8_t* device_data = mapped_data;
         if (stride == sizeof(T))
         {
             memcpy(device_data, p_data, count * sizeof(T));
@@ -98,13 +100,12 @@ namespace Meow
                 device_data += stride;
             }
         }
-        device_memory.unmapMemory();
     }
 
     template<typename T>
-    void CopyToDevice(vk::raii::DeviceMemory const& device_memory, T const& data)
+    void CopyToDevice(uint8_t* mapped_data, T const& data)
     {
-        CopyToDevice<T>(device_memory, &data, 1);
+        CopyToDevice<T>(mapped_data, &data, 1);
     }
 
     template<typename Func>
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Meow
+{
+    /**
+     * @brief Typed 32-bit handle into a resource pool, packing slot index and generation.
+     *
+     * Handles of different resource types can not be mixed up, and a handle becomes invalid once its resource is
+     * released.
+     */
+    template<typename ResourceType>
+    struct ResourceHandle
+    {
+        static constexpr uint32_t k_index_bits      = 20;
+        static constexpr uint32_t k_generation_bits = 32 - k_index_bits;
+        static constexpr uint32_t k_index_mask      = (1u << k_index_bits) - 1;
+        static constexpr uint32_t k_generation_mask = (1u << k_generation_bits) - 1;
+        static constexpr uint32_t k_invalid_value   = static_cast<uint32_t>(-1);
+
+        uint32_t value = k_invalid_value;
+
+        static ResourceHandle Make(uint32_t index, uint32_t generation)
+        {
+            return {(index & k_index_mask) | ((generation & k_generation_mask) << k_index_bits)};
+        }
+
+        uint32_t GetIndex() const { return value & k_index_mask; }
+        uint32_t GetGeneration() const { return value >> k_index_bits; }
+
+        bool IsValid() const { return value != k_invalid_value; }
+
+        bool operator==(const ResourceHandle& rhs) const = default;
+    };
+} // namespace Meow
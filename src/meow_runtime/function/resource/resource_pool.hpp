@@ -0,0 +1,161 @@
+#pragma once
+
+#include "core/uuid/uuid.h"
+#include "resource_handle.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Resources of one type stored in slots, addressed by typed handles.
+     *
+     * Resolving a handle is an array index plus a generation check, without hashing, RTTI or touching the atomic
+     * count of shared_ptr. Lifetime is controlled by an explicit reference count: a resource is released when the
+     * count drops to zero, and its slot is reused with a new generation. UUID lookup is kept for serialization.
+     *
+     * Not thread safe. Resources are registered on main thread, and ResourceSystem drops released references in its
+     * own tick.
+     */
+    template<typename ResourceType>
+    class ResourcePool
+    {
+    public:
+        using Handle = ResourceHandle<ResourceType>;
+
+        /**
+         * @brief Add a resource with reference count 1. Adding an existing UUID replaces the resource and keeps the
+         * handle.
+         */
+        Handle Add(UUID uuid, std::shared_ptr<ResourceType> resource)
+        {
+            auto iter = m_handles_by_uuid.find(uuid);
+            if (iter != m_handles_by_uuid.end())
+            {
+                m_slots[iter->second.GetIndex()].resource = std::move(resource);
+                return iter->second;
+            }
+
+            uint32_t index;
+            if (m_free_head != k_invalid_index)
+            {
+                index       = m_free_head;
+                m_free_head = m_slots[index].next_free;
+            }
+            else
+            {
+                index = static_cast<uint32_t>(m_slots.size());
+                ASSERT(index < Handle::k_index_mask);
+                m_slots.emplace_back();
+            }
+
+            Slot& slot     = m_slots[index];
+            slot.resource  = std::move(resource);
+            slot.uuid      = uuid;
+            slot.ref_count = 1;
+            slot.next_free = k_invalid_index;
+
+            Handle handle           = Handle::Make(index, slot.generation);
+            m_handles_by_uuid[uuid] = handle;
+            return handle;
+        }
+
+        Handle Find(UUID uuid) const
+        {
+            auto iter = m_handles_by_uuid.find(uuid);
+            if (iter == m_handles_by_uuid.end())
+                return {};
+
+            return iter->second;
+        }
+
+        bool Contains(Handle handle) const
+        {
+            return handle.IsValid() && handle.GetIndex() < m_slots.size() &&
+                   m_slots[handle.GetIndex()].ref_count > 0 &&
+                   m_slots[handle.GetIndex()].generation == handle.GetGeneration();
+        }
+
+        /**
+         * @brief Returns nullptr if handle is stale. The pointer stays valid until the resource is released.
+         */
+        ResourceType* Get(Handle handle) const
+        {
+            if (!Contains(handle))
+                return nullptr;
+
+            return m_slots[handle.GetIndex()].resource.get();
+        }
+
+        std::shared_ptr<ResourceType> GetShared(Handle handle) const
+        {
+            if (!Contains(handle))
+                return nullptr;
+
+            return m_slots[handle.GetIndex()].resource;
+        }
+
+        UUID GetUUID(Handle handle) const
+        {
+            if (!Contains(handle))
+                return 0;
+
+            return m_slots[handle.GetIndex()].uuid;
+        }
+
+        void AddRef(Handle handle)
+        {
+            if (!Contains(handle))
+                return;
+
+            ++m_slots[handle.GetIndex()].ref_count;
+        }
+
+        void Release(Handle handle)
+        {
+            if (!Contains(handle))
+                return;
+
+            Slot& slot = m_slots[handle.GetIndex()];
+            if (--slot.ref_count > 0)
+                return;
+
+            m_handles_by_uuid.erase(slot.uuid);
+            slot.resource.reset();
+
+            // bump generation so that old handles fail validation, and push slot to free list
+            slot.generation = (slot.generation + 1) & Handle::k_generation_mask;
+            slot.next_free  = m_free_head;
+            m_free_head     = handle.GetIndex();
+        }
+
+        uint32_t GetRefCount(Handle handle) const
+        {
+            if (!Contains(handle))
+                return 0;
+
+            return m_slots[handle.GetIndex()].ref_count;
+        }
+
+        size_t Size() const { return m_handles_by_uuid.size(); }
+
+    private:
+        static constexpr uint32_t k_invalid_index = static_cast<uint32_t>(-1);
+
+        struct Slot
+        {
+            std::shared_ptr<ResourceType> resource;
+            UUID                          uuid       = 0;
+            uint32_t                      generation = 0;
+            uint32_t                      ref_count  = 0;
+            uint32_t                      next_free  = k_invalid_index;
+        };
+
+        std::vector<Slot>                m_slots;
+        std::unordered_map<UUID, Handle> m_handles_by_uuid;
+        uint32_t                         m_free_head = k_invalid_index;
+    };
+} // namespace Meow
@@ -0,0 +1,105 @@
+#include "resource_system.hpp"
+
+#include "pch.h"
+
+#include "core/base/hash.h"
+#include "function/global/runtime_context.h"
+
+namespace Meow
+{
+    void ResourceSystem::Tick(float dt)
+    {
+        FUNCTION_TIMER();
+
+        // a frame records what level culled one tick earlier, and the last of the frames in flight is waited for only
+        // when its slot comes round again
+        const uint64_t release_delay = g_runtime_context.render_system->GetMaxFramesInFlight() + 1;
+
+        std::vector<PendingRelease> due_releases;
+        {
+            std::lock_guard<std::mutex> lock(m_pending_releases_mutex);
+
+            ++m_tick_index;
+            while (!m_pending_releases.empty() && m_pending_releases.front().tick_index + release_delay <= m_tick_index)
+            {
+                due_releases.push_back(std::move(m_pending_releases.front()));
+                m_pending_releases.pop_front();
+            }
+        }
+
+        for (auto& pending_release : due_releases)
+        {
+            pending_release.release();
+        }
+    }
+
+    ResourceHandle<Model> ResourceSystem::LoadModel(std::vector<float>                     vertices,
+                                                    std::vector<uint32_t>                  indices,
+                                                    const std::vector<VertexAttributeBit>& attributes)
+    {
+        FUNCTION_TIMER();
+
+        // sizes are hashed first, so that payloads split differently between vertices and indices do not collide
+        size_t   sizes[2] = {vertices.size(), indices.size()};
+        uint64_t hash     = HashBytes(sizes, sizeof(sizes));
+        hash              = HashBytes(attributes.data(), sizeof(VertexAttributeBit) * attributes.size(), hash);
+        hash              = HashBytes(vertices.data(), sizeof(float) * vertices.size(), hash);
+        hash              = HashBytes(indices.data(), sizeof(uint32_t) * indices.size(), hash);
+
+        auto& handles = m_models_by_content_hash[hash];
+        for (auto iter = handles.begin(); iter != handles.end();)
+        {
+            Model* model = m_model_pool.Get(*iter);
+            if (!model)
+            {
+                iter = handles.erase(iter);
+                continue;
+            }
+
+            // equal hash is only a candidate, compare payloads to rule out a collision
+            if (model->meshes.size() == 1 && model->attributes == attributes &&
+                model->meshes[0]->vertices == vertices && model->meshes[0]->indices == indices)
+            {
+                AcquireModel(*iter);
+                return *iter;
+            }
+
+            ++iter;
+        }
+
+        auto                  model  = std::make_shared<Model>(std::move(vertices), std::move(indices), attributes);
+        ResourceHandle<Model> handle = m_model_pool.Add(model->uuid(), std::move(model));
+        handles.push_back(handle);
+        return handle;
+    }
+
+    ResourceHandle<Model> ResourceSystem::LoadModel(const std::string&                     file_path,
+                                                    const std::vector<VertexAttributeBit>& attributes)
+    {
+        FUNCTION_TIMER();
+
+        std::string key = g_runtime_context.file_system->GetAbsolutePath(file_path);
+        for (VertexAttributeBit attribute : attributes)
+        {
+            key += std::format("|{}", static_cast<uint32_t>(attribute));
+        }
+
+        auto iter = m_models_by_file.find(key);
+        if (iter != m_models_by_file.end() && AcquireModel(iter->second))
+            return iter->second;
+
+        auto                  model  = std::make_shared<Model>(file_path, attributes);
+        ResourceHandle<Model> handle = m_model_pool.Add(model->uuid(), std::move(model));
+        m_models_by_file[key]        = handle;
+        return handle;
+    }
+
+    bool ResourceSystem::AcquireModel(ResourceHandle<Model> handle)
+    {
+        if (!m_model_pool.Contains(handle))
+            return false;
+
+        m_model_pool.AddRef(handle);
+        return true;
+    }
+} // namespace Meow
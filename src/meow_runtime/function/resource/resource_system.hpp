@@ -2,13 +2,21 @@
 
 #include "core/uuid/uuid.h"
 #include "function/render/buffer_data/image_data.h"
+#include "function/render/material/material.h"
 #include "function/render/material/shader.h"
 #include "function/render/material/shading_model_type.h"
 #include "function/render/model/model.hpp"
 #include "function/system.h"
 #include "resource_base.h"
+#include "resource_pool.hpp"
 
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 namespace Meow
 {
@@ -29,6 +37,14 @@ namespace Meow
      * 3. Reloading from disk
      *
      * When engine is running, it will auto detect all resource files and reload the updated files.
+     *
+     * Models created by LoadModel are shared by content: vertex and index data are hashed, and imports are keyed by
+     * file path, both together with the vertex layout.
+     *
+     * Each resource type lives in its own pool. Per-frame code should keep ResourceHandle and resolve it by Get(),
+     * which is an array index, while UUID stays the persistent identity used by serialization.
+     *
+     * Released references are dropped in Tick() once the frames in flight which may use the resource are done.
      */
     class ResourceSystem final : public System
     {
@@ -38,26 +54,122 @@ namespace Meow
 
         void Start() override {}
 
-        void Tick(float dt) override {}
+        void Tick(float dt) override;
 
+        /**
+         * @brief Register a resource with reference count 1, which is owned by resource system.
+         */
         template<typename ResourceType>
         UUID Register(std::shared_ptr<ResourceType> resource)
         {
-            m_resources[resource->uuid()] = resource;
-            return resource->uuid();
+            UUID uuid = resource->uuid();
+            GetPool<ResourceType>().Add(uuid, std::move(resource));
+            return uuid;
+        }
+
+        template<typename ResourceType>
+        ResourceHandle<ResourceType> GetHandle(UUID uuid) const
+        {
+            return GetPool<ResourceType>().Find(uuid);
+        }
+
+        /**
+         * @brief O(1) lookup without hashing, RTTI or reference counting. Returns nullptr if handle is stale.
+         */
+        template<typename ResourceType>
+        ResourceType* Get(ResourceHandle<ResourceType> handle) const
+        {
+            return GetPool<ResourceType>().Get(handle);
+        }
+
+        template<typename ResourceType>
+        std::shared_ptr<ResourceType> GetResource(UUID uuid) const
+        {
+            const auto& pool = GetPool<ResourceType>();
+            return pool.GetShared(pool.Find(uuid));
+        }
+
+        template<typename ResourceType>
+        void AddRef(ResourceHandle<ResourceType> handle)
+        {
+            GetPool<ResourceType>().AddRef(handle);
         }
 
+        /**
+         * @brief Drop one reference. Resource is destroyed when no reference is left, which is deferred until frames
+         * in flight are done with it, so raw pointers returned by Get() stay valid for the frame they are resolved in.
+         *
+         * Thread safe, e.g. components release their resources when their game object is deleted on a level worker.
+         */
         template<typename ResourceType>
-        std::shared_ptr<ResourceType> GetResource(UUID uuid)
+        void Release(ResourceHandle<ResourceType> handle)
         {
-            auto it = m_resources.find(uuid);
-            if (it == m_resources.end())
-                return nullptr;
+            if (!handle.IsValid())
+                return;
 
-            return std::dynamic_pointer_cast<ResourceType>(it->second);
+            std::lock_guard<std::mutex> lock(m_pending_releases_mutex);
+            m_pending_releases.push_back(
+                {m_tick_index, [this, handle]() { GetPool<ResourceType>().Release(handle); }});
         }
 
+        /**
+         * @brief Create a model from vertex and index data, or return the registered one with the same data and vertex
+         * layout, so that its GPU buffers are shared. Each call holds one reference, which the caller releases.
+         */
+        ResourceHandle<Model> LoadModel(std::vector<float>                     vertices,
+                                        std::vector<uint32_t>                  indices,
+                                        const std::vector<VertexAttributeBit>& attributes);
+
+        /**
+         * @brief Import a model file, or return the registered one imported from the same file with the same vertex
+         * layout. Each call holds one reference, which the caller releases.
+         */
+        ResourceHandle<Model> LoadModel(const std::string&                     file_path,
+                                        const std::vector<VertexAttributeBit>& attributes);
+
     private:
-        std::unordered_map<UUID, std::shared_ptr<ResourceBase>> m_resources;
+        struct PendingRelease
+        {
+            uint64_t              tick_index;
+            std::function<void()> release;
+        };
+
+        /**
+         * @brief Add a reference to the model behind a cached handle, and return whether it is still alive.
+         */
+        bool AcquireModel(ResourceHandle<Model> handle);
+
+        template<typename ResourceType>
+        ResourcePool<ResourceType>& GetPool()
+        {
+            if constexpr (std::is_same_v<ResourceType, Model>)
+                return m_model_pool;
+            else if constexpr (std::is_same_v<ResourceType, Material>)
+                return m_material_pool;
+            else if constexpr (std::is_same_v<ResourceType, ImageData>)
+                return m_image_pool;
+            else if constexpr (std::is_same_v<ResourceType, Shader>)
+                return m_shader_pool;
+            else
+                static_assert(sizeof(ResourceType) == 0, "Unsupported resource type!");
+        }
+
+        template<typename ResourceType>
+        const ResourcePool<ResourceType>& GetPool() const
+        {
+            return const_cast<ResourceSystem*>(this)->GetPool<ResourceType>();
+        }
+
+        ResourcePool<Model>     m_model_pool;
+        ResourcePool<Material>  m_material_pool;
+        ResourcePool<ImageData> m_image_pool;
+        ResourcePool<Shader>    m_shader_pool;
+
+        std::unordered_map<uint64_t, std::vector<ResourceHandle<Model>>> m_models_by_content_hash;
+        std::unordered_map<std::string, ResourceHandle<Model>>           m_models_by_file;
+
+        std::mutex                 m_pending_releases_mutex;
+        std::deque<PendingRelease> m_pending_releases;
+        uint64_t                   m_tick_index = 0;
     };
 } // namespace Meow
@@ -1,5 +1,7 @@
 #include "graphics_window.h"
 
+#include "pch.h"
+
 #include "function/global/runtime_context.h"
 
 #include "function/render/utils/vulkan_debug_utils.h"
@@ -89,6 +91,53 @@ namespace Meow
         SetDebugName();
     }
 
+    void GraphicsWindow::RecordRenderPasses(const vk::raii::CommandBuffer&      command_buffer,
+                                            const std::vector<RenderPassBase*>& render_passes,
+                                            uint32_t                            image_index)
+    {
+        FUNCTION_TIMER();
+
+        // the fences of the frame slot have been waited for, so its transient descriptor sets are free again
+        g_runtime_context.render_system->GetDescriptorAllocator().BeginFrame(m_frame_index);
+
+        for (RenderPassBase* render_pass : render_passes)
+        {
+            render_pass->RecordPrePassCommands(command_buffer, m_frame_index);
+        }
+
+        // not vector<bool>, since jobs write neighbouring elements at the same time
+        std::vector<uint8_t> recorded(render_passes.size(), 0);
+
+        if (m_parallel_recording_enabled)
+        {
+            g_runtime_context.render_system->GetSecondaryCommandBufferAllocator().BeginFrame(m_frame_index);
+
+            JobCounter counter;
+            for (size_t i = 0; i < render_passes.size(); ++i)
+            {
+                g_runtime_context.job_system->Schedule(
+                    [&, i]() {
+                        recorded[i] = render_passes[i]->RecordSecondaryCommands(m_surface_data.extent, m_frame_index);
+                    },
+                    &counter);
+            }
+            g_runtime_context.job_system->Wait(counter);
+        }
+
+        for (size_t i = 0; i < render_passes.size(); ++i)
+        {
+            if (recorded[i])
+            {
+                render_passes[i]->ExecuteSecondaryCommands(command_buffer, m_surface_data.extent, image_index);
+                continue;
+            }
+
+            render_passes[i]->Start(command_buffer, m_surface_data.extent, image_index);
+            render_passes[i]->RecordGraphicsCommand(command_buffer, m_frame_index);
+            render_passes[i]->End(command_buffer);
+        }
+    }
+
     void GraphicsWindow::SetDebugName() const
     {
 #if defined(VKB_DEBUG) || defined(VKB_VALIDATION_LAYERS)
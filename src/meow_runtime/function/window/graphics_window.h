@@ -5,6 +5,9 @@
 #include "function/render/buffer_data/per_frame_data.h"
 #include "function/render/buffer_data/surface_data.h"
 #include "function/render/buffer_data/swapchain_data.h"
+#include "function/render/render_pass/render_pass_base.h"
+
+#include <vector>
 
 namespace Meow
 {
@@ -30,6 +33,15 @@ namespace Meow
 
         void SetDebugName() const;
 
+        /**
+         * @brief Record render passes into the command buffer in order. With parallel recording, passes are first
+         * recorded into secondary command buffers on job workers at the same time, and passes that can't be are
+         * recorded inline.
+         */
+        void RecordRenderPasses(const vk::raii::CommandBuffer&      command_buffer,
+                                const std::vector<RenderPassBase*>& render_passes,
+                                uint32_t                            image_index);
+
         SurfaceData                        m_surface_data = nullptr;
         vk::Format                         m_color_format;
         SwapChainData                      m_swapchain_data = nullptr;
@@ -43,5 +55,7 @@ namespace Meow
         const uint64_t k_fence_timeout         = 100000000;
         uint32_t       m_frame_index           = 0;
         uint32_t       m_image_semaphore_index = 0;
+
+        bool m_parallel_recording_enabled = true;
     };
 } // namespace Meow
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "function/object/component_type_id.h"
+
+namespace Meow
+{
+    class Camera3DComponent;
+    class DirectionalLightComponent;
+    class ModelComponent;
+    class Transform3DComponent;
+
+    template<>
+    struct ComponentTypeTraits<Camera3DComponent>
+    {
+        static constexpr ComponentTypeID id   = 0;
+        static constexpr const char*     name = "Camera3DComponent";
+    };
+
+    template<>
+    struct ComponentTypeTraits<DirectionalLightComponent>
+    {
+        static constexpr ComponentTypeID id   = 1;
+        static constexpr const char*     name = "DirectionalLightComponent";
+    };
+
+    template<>
+    struct ComponentTypeTraits<ModelComponent>
+    {
+        static constexpr ComponentTypeID id   = 2;
+        static constexpr const char*     name = "ModelComponent";
+    };
+
+    template<>
+    struct ComponentTypeTraits<Transform3DComponent>
+    {
+        static constexpr ComponentTypeID id   = 3;
+        static constexpr const char*     name = "Transform3DComponent";
+    };
+
+    inline constexpr ComponentTypeID k_component_type_count = 4;
+
+    static_assert(k_component_type_count <= k_max_component_types, "Too many component types for ComponentMask");
+
+    inline constexpr const char* k_component_type_names[] = {"Camera3DComponent", "DirectionalLightComponent", "ModelComponent", "Transform3DComponent"};
+} // namespace Meow
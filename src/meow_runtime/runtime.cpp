@@ -17,7 +17,7 @@ namespace Meow
     {
         RegisterAll();
 
-        // TODO: Init Dependencies graph
+        g_runtime_context.job_system      = std::make_shared<JobSystem>();
         g_runtime_context.time_system     = std::make_shared<TimeSystem>();
         g_runtime_context.file_system     = std::make_shared<FileSystem>();
         g_runtime_context.resource_system = std::make_shared<ResourceSystem>();
@@ -45,26 +45,22 @@ namespace Meow
         g_runtime_context.input_system->Start();
         g_runtime_context.particle_system->Start();
 
+        BuildTickGraph();
+
         return true;
     }
 
     void MeowRuntime::Tick(float dt)
     {
-        // TODO: Update Dependencies graph
-        g_runtime_context.time_system->Tick(dt);
-        g_runtime_context.resource_system->Tick(dt);
-        g_runtime_context.window_system->Tick(dt);
-        g_runtime_context.input_system->Tick(dt);
-        g_runtime_context.render_system->Tick(dt);
-        g_runtime_context.level_system->Tick(dt);
-        g_runtime_context.particle_system->Tick(dt);
+        m_tick_dt = dt;
+        m_tick_graph.Run(*g_runtime_context.job_system);
 
         TimerSingleton::Get().Clear();
     }
 
     void MeowRuntime::ShutDown()
     {
-        // TODO: ShutDown Dependencies graph
+        m_tick_graph.Clear();
 
         g_runtime_context.render_system->Shutdown();
 
@@ -76,5 +72,41 @@ namespace Meow
         g_runtime_context.render_system   = nullptr;
         g_runtime_context.file_system     = nullptr;
         g_runtime_context.time_system     = nullptr;
+
+        // after all systems, they may still wait for jobs when shutting down
+        g_runtime_context.job_system = nullptr;
+    }
+
+    /**
+     * @brief Systems without dependency between them tick in parallel.
+     *
+     * Window system polls events and renders through glfw and imgui, so it stays on the main thread. Level system
+     * writes the data which window system reads when rendering, so it ticks after window system.
+     */
+    void MeowRuntime::BuildTickGraph()
+    {
+        m_tick_graph.Clear();
+
+        auto add_system_task = [this](const std::string& name, System* system, bool main_thread_only = false) {
+            return m_tick_graph.AddTask(name, [this, system]() { system->Tick(m_tick_dt); }, main_thread_only);
+        };
+
+        TaskID time_task     = add_system_task("Time", g_runtime_context.time_system.get());
+        TaskID resource_task = add_system_task("Resource", g_runtime_context.resource_system.get());
+        TaskID input_task    = add_system_task("Input", g_runtime_context.input_system.get(), true);
+        TaskID window_task   = add_system_task("Window", g_runtime_context.window_system.get(), true);
+        TaskID render_task   = add_system_task("Render", g_runtime_context.render_system.get());
+        TaskID level_task    = add_system_task("Level", g_runtime_context.level_system.get());
+        TaskID particle_task = add_system_task("Particle", g_runtime_context.particle_system.get());
+
+        m_tick_graph.AddDependency(time_task, resource_task);
+        m_tick_graph.AddDependency(time_task, input_task);
+        m_tick_graph.AddDependency(time_task, particle_task);
+        m_tick_graph.AddDependency(resource_task, window_task);
+        m_tick_graph.AddDependency(input_task, window_task);
+        m_tick_graph.AddDependency(window_task, render_task);
+        m_tick_graph.AddDependency(window_task, level_task);
+
+        m_tick_graph.Compile();
     }
 } // namespace Meow
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/base/non_copyable.h"
+#include "core/job/task_graph.h"
 #include "function/system.h"
 
 #include <memory>
@@ -29,6 +30,11 @@ namespace Meow
         void SetRunning(bool running) { m_running = running; }
 
     private:
+        void BuildTickGraph();
+
         bool m_running = true;
+
+        TaskGraph m_tick_graph;
+        float     m_tick_dt = 0.0f;
     };
 } // namespace Meow
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "function/render/material/shader_reflection.h"
+
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace Meow;
+
+// Writes the reflection file beside each SPIR-V file given, so that the runtime doesn't run SPIRV-Cross at startup.
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "[ShaderReflector] Usage: ShaderReflector <spirv_file>..." << std::endl;
+        return 1;
+    }
+
+    bool has_error = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        fs::path spirv_file_path(argv[i]);
+
+        std::ifstream ifs(spirv_file_path, std::ios::binary);
+        if (!ifs)
+        {
+            std::cerr << "[ShaderReflector] Can't read " << std::quoted(spirv_file_path.string()) << "!" << std::endl;
+            has_error = true;
+            continue;
+        }
+
+        std::vector<uint8_t> spirv((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        if (spirv.empty() || spirv.size() % sizeof(uint32_t) != 0)
+        {
+            std::cerr << "[ShaderReflector] " << std::quoted(spirv_file_path.string()) << " is not SPIR-V!"
+                      << std::endl;
+            has_error = true;
+            continue;
+        }
+
+        // SPIR-V is made of words, copy it to get their alignment
+        std::vector<uint32_t> spirv_words(spirv.size() / sizeof(uint32_t));
+        std::memcpy(spirv_words.data(), spirv.data(), spirv.size());
+
+        ShaderReflection reflection;
+        try
+        {
+            reflection = ReflectSpirv(spirv_words.data(), spirv_words.size());
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "[ShaderReflector] Failed to reflect " << std::quoted(spirv_file_path.string()) << ": "
+                      << e.what() << std::endl;
+            has_error = true;
+            continue;
+        }
+
+        std::vector<uint8_t> reflection_file_data = SerializeShaderReflection(reflection, spirv.data(), spirv.size());
+
+        std::string   reflection_file_path = GetShaderReflectionPath(spirv_file_path.string());
+        std::ofstream ofs(reflection_file_path, std::ios::binary | std::ios::trunc);
+        if (!ofs || !ofs.write(reinterpret_cast<const char*>(reflection_file_data.data()), reflection_file_data.size()))
+        {
+            std::cerr << "[ShaderReflector] Can't write " << std::quoted(reflection_file_path) << "!" << std::endl;
+            has_error = true;
+            continue;
+        }
+
+        std::cout << "[ShaderReflector] Wrote " << reflection_file_path << std::endl;
+    }
+
+    return has_error ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+#include "core/base/buddy_allocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using Meow::BuddyAllocator;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++g_failure_count; \
+        } \
+    } while (false)
+
+namespace
+{
+    int g_failure_count = 0;
+
+    constexpr uint64_t k_size           = 1024;
+    constexpr uint64_t k_min_block_size = 16;
+
+    void TestAlignment()
+    {
+        BuddyAllocator allocator(k_size, k_min_block_size);
+
+        // sizes round up to a power of two, and blocks sit at multiples of their size
+        uint64_t a = allocator.Allocate(24, 8);
+        uint64_t b = allocator.Allocate(100, 4);
+        uint64_t c = allocator.Allocate(8, 256);
+        CHECK(a != BuddyAllocator::k_invalid_offset);
+        CHECK(b != BuddyAllocator::k_invalid_offset);
+        CHECK(c != BuddyAllocator::k_invalid_offset);
+        CHECK(a % 32 == 0);
+        CHECK(b % 128 == 0);
+        CHECK(c % 256 == 0);
+
+        // alignment larger than the size takes a block of the alignment
+        CHECK(allocator.GetAllocatedSize() == 32 + 128 + 256);
+
+        // tiny requests still take a whole minimum block
+        uint64_t d = allocator.Allocate(1, 1);
+        CHECK(d % k_min_block_size == 0);
+        CHECK(allocator.GetAllocatedSize() == 32 + 128 + 256 + k_min_block_size);
+    }
+
+    void TestSplitting()
+    {
+        BuddyAllocator allocator(k_size, k_min_block_size);
+        CHECK(allocator.GetLargestFreeBlockSize() == k_size);
+
+        // the first minimum block splits the region at every level, keeping lower halves
+        CHECK(allocator.Allocate(k_min_block_size, 1) == 0);
+        CHECK(allocator.GetLargestFreeBlockSize() == k_size / 2);
+
+        // its buddy is left free by the split, so it is taken next without splitting again
+        CHECK(allocator.Allocate(k_min_block_size, 1) == k_min_block_size);
+        CHECK(allocator.Allocate(2 * k_min_block_size, 1) == 2 * k_min_block_size);
+        CHECK(allocator.Allocate(k_size / 2, 1) == k_size / 2);
+        CHECK(allocator.GetAllocationCount() == 4);
+    }
+
+    void TestCoalescing()
+    {
+        BuddyAllocator allocator(k_size, k_min_block_size);
+
+        uint64_t quarters[4];
+        for (uint64_t& quarter : quarters)
+        {
+            quarter = allocator.Allocate(k_size / 4, 1);
+        }
+        CHECK(allocator.GetLargestFreeBlockSize() == 0);
+
+        // 1 and 2 are neighbours but not buddies, so they must not merge
+        allocator.Free(quarters[1]);
+        allocator.Free(quarters[2]);
+        CHECK(allocator.GetLargestFreeBlockSize() == k_size / 4);
+        CHECK(allocator.Allocate(k_size / 2, 1) == BuddyAllocator::k_invalid_offset);
+
+        // freeing their buddies merges the halves, and then the whole region
+        allocator.Free(quarters[0]);
+        CHECK(allocator.GetLargestFreeBlockSize() == k_size / 2);
+        allocator.Free(quarters[3]);
+        CHECK(allocator.GetLargestFreeBlockSize() == k_size);
+        CHECK(allocator.IsEmpty());
+        CHECK(allocator.GetAllocatedSize() == 0);
+
+        CHECK(allocator.Allocate(k_size, 1) == 0);
+    }
+
+    void TestOutOfMemory()
+    {
+        BuddyAllocator allocator(k_size, k_min_block_size);
+
+        CHECK(allocator.Allocate(0, 1) == BuddyAllocator::k_invalid_offset);
+        CHECK(allocator.Allocate(k_size + 1, 1) == BuddyAllocator::k_invalid_offset);
+        CHECK(allocator.Allocate(1, 2 * k_size) == BuddyAllocator::k_invalid_offset);
+
+        std::vector<uint64_t> offsets;
+        for (uint64_t i = 0; i < k_size / k_min_block_size; ++i)
+        {
+            offsets.push_back(allocator.Allocate(k_min_block_size, 1));
+            CHECK(offsets.back() == i * k_min_block_size);
+        }
+
+        CHECK(allocator.Allocate(1, 1) == BuddyAllocator::k_invalid_offset);
+        CHECK(allocator.GetAllocatedSize() == k_size);
+
+        allocator.Free(offsets[5]);
+        CHECK(allocator.Allocate(k_min_block_size, 1) == offsets[5]);
+    }
+
+    void TestRandomOperations()
+    {
+        BuddyAllocator    allocator(k_size, k_min_block_size);
+        std::mt19937      engine(42);
+        std::vector<bool> used(k_size, false);
+
+        // offset and block size of every allocation, to check that blocks never overlap
+        std::vector<std::pair<uint64_t, uint64_t>> live;
+
+        for (int step = 0; step < 10000; ++step)
+        {
+            if (live.empty() || engine() % 2 == 0)
+            {
+                uint64_t size      = 1 + engine() % 200;
+                uint64_t alignment = uint64_t(1) << (engine() % 7);
+                uint64_t offset    = allocator.Allocate(size, alignment);
+                if (offset == BuddyAllocator::k_invalid_offset)
+                    continue;
+
+                uint64_t block_size = std::max({std::bit_ceil(size), alignment, k_min_block_size});
+                CHECK(offset % block_size == 0);
+                CHECK(offset + block_size <= k_size);
+                for (uint64_t byte = offset; byte < offset + block_size; ++byte)
+                {
+                    CHECK(!used[byte]);
+                    used[byte] = true;
+                }
+                live.push_back({offset, block_size});
+            }
+            else
+            {
+                size_t index = engine() % live.size();
+                allocator.Free(live[index].first);
+                for (uint64_t byte = live[index].first; byte < live[index].first + live[index].second; ++byte)
+                {
+                    used[byte] = false;
+                }
+                live[index] = live.back();
+                live.pop_back();
+            }
+
+            uint64_t allocated_size = 0;
+            for (const auto& allocation : live)
+            {
+                allocated_size += allocation.second;
+            }
+            CHECK(allocator.GetAllocatedSize() == allocated_size);
+            CHECK(allocator.GetAllocationCount() == live.size());
+        }
+
+        for (const auto& allocation : live)
+        {
+            allocator.Free(allocation.first);
+        }
+        CHECK(allocator.IsEmpty());
+        CHECK(allocator.GetLargestFreeBlockSize() == k_size);
+    }
+} // namespace
+
+int main()
+{
+    TestAlignment();
+    TestSplitting();
+    TestCoalescing();
+    TestOutOfMemory();
+    TestRandomOperations();
+
+    if (g_failure_count > 0)
+    {
+        std::printf("%d checks failed\n", g_failure_count);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+    return 0;
+}
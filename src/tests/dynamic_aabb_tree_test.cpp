@@ -0,0 +1,287 @@
+#include "core/math/dynamic_aabb_tree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace Meow;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++g_failure_count; \
+        } \
+    } while (false)
+
+namespace
+{
+    int g_failure_count = 0;
+
+    constexpr float    k_margin        = 0.5f;
+    constexpr float    k_world_extent  = 100.0f;
+    constexpr uint32_t k_initial_count = 1000;
+    constexpr uint32_t k_step_count    = 4000;
+
+    /**
+     * @brief What the tree should hold for a proxy, enlarged box tracked the same way MoveProxy does.
+     */
+    struct Proxy
+    {
+        BoundingBox box;
+        BoundingBox fat_box;
+        uint32_t    user_data;
+    };
+
+    BoundingBox Enlarge(const BoundingBox& box, float margin)
+    {
+        return BoundingBox(box.min - glm::vec3(margin), box.max + glm::vec3(margin));
+    }
+
+    bool Contains(const BoundingBox& outer, const BoundingBox& inner)
+    {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+               inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+
+    class Scene
+    {
+    public:
+        Scene()
+            : m_tree(k_margin)
+            , m_engine(7)
+        {}
+
+        BoundingBox RandomBox()
+        {
+            std::uniform_real_distribution<float> position(-k_world_extent, k_world_extent);
+            std::uniform_real_distribution<float> size(0.1f, 5.0f);
+
+            glm::vec3 min(position(m_engine), position(m_engine), position(m_engine));
+            return BoundingBox(min, min + glm::vec3(size(m_engine), size(m_engine), size(m_engine)));
+        }
+
+        void Create()
+        {
+            BoundingBox box   = RandomBox();
+            int32_t     proxy = m_tree.CreateProxy(box, m_next_user_data);
+
+            CHECK(m_proxies.find(proxy) == m_proxies.end());
+            m_proxies[proxy] = {box, Enlarge(box, k_margin), m_next_user_data};
+            m_next_user_data++;
+        }
+
+        void Destroy()
+        {
+            int32_t proxy = PickProxy();
+            m_tree.DestroyProxy(proxy);
+            m_proxies.erase(proxy);
+        }
+
+        void Move()
+        {
+            int32_t proxy = PickProxy();
+            Proxy&  state = m_proxies[proxy];
+
+            // mostly small steps that stay inside the enlarged box, sometimes a jump across the world
+            BoundingBox box;
+            if (std::uniform_int_distribution<int>(0, 3)(m_engine) == 0)
+            {
+                box = RandomBox();
+            }
+            else
+            {
+                std::uniform_real_distribution<float> step(-0.4f, 0.4f);
+                glm::vec3                             offset(step(m_engine), step(m_engine), step(m_engine));
+                box = BoundingBox(state.box.min + offset, state.box.max + offset);
+            }
+
+            bool expect_reinsert = !Contains(state.fat_box, box);
+            CHECK(m_tree.MoveProxy(proxy, box) == expect_reinsert);
+
+            state.box = box;
+            if (expect_reinsert)
+                state.fat_box = Enlarge(box, k_margin);
+        }
+
+        void Step()
+        {
+            int operation = std::uniform_int_distribution<int>(0, 9)(m_engine);
+            if (m_proxies.empty() || operation < 2)
+                Create();
+            else if (operation < 4)
+                Destroy();
+            else
+                Move();
+        }
+
+        void CheckProxies() const
+        {
+            CHECK(m_tree.GetProxyCount() == m_proxies.size());
+            for (const auto& [proxy, state] : m_proxies)
+                CHECK(m_tree.GetUserData(proxy) == state.user_data);
+
+            // balanced by rotations, so far below the worst case of one level per proxy
+            int32_t height_limit = 2 * static_cast<int32_t>(std::log2(m_proxies.size() + 1.0)) + 2;
+            CHECK(m_tree.GetHeight() <= height_limit);
+        }
+
+        void CheckQueryAABB(const BoundingBox& query) const
+        {
+            std::vector<int32_t> found;
+            m_tree.QueryAABB(query, [&](int32_t proxy) { found.push_back(proxy); });
+
+            std::vector<int32_t> expected;
+            for (const auto& [proxy, state] : m_proxies)
+            {
+                if (DynamicAABBTree::Overlaps(state.fat_box.min, state.fat_box.max, query.min, query.max))
+                    expected.push_back(proxy);
+            }
+
+            std::sort(found.begin(), found.end());
+            std::sort(expected.begin(), expected.end());
+            CHECK(found == expected);
+        }
+
+        /**
+         * @brief Returns the number of proxies reported, so the caller can tell the frustum wasn't empty.
+         */
+        size_t CheckQueryFrustum(const Frustum& frustum) const
+        {
+            std::vector<std::pair<int32_t, bool>> found;
+            m_tree.QueryFrustum(frustum, [&](int32_t proxy, bool fully_inside) {
+                found.push_back({proxy, fully_inside});
+            });
+
+            std::vector<std::pair<int32_t, bool>> expected;
+            for (const auto& [proxy, state] : m_proxies)
+            {
+                FrustumTestResult result = frustum.Classify(state.fat_box.min, state.fat_box.max);
+                if (result != FrustumTestResult::Outside)
+                    expected.push_back({proxy, result == FrustumTestResult::Inside});
+            }
+
+            std::sort(found.begin(), found.end());
+            std::sort(expected.begin(), expected.end());
+            CHECK(found == expected);
+
+            return found.size();
+        }
+
+        void CheckQueryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const
+        {
+            std::vector<int32_t> found;
+            m_tree.QueryRay(origin, direction, max_distance, [&](int32_t proxy) { found.push_back(proxy); });
+
+            glm::vec3 inv_direction(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+            std::vector<int32_t> expected;
+            for (const auto& [proxy, state] : m_proxies)
+            {
+                if (DynamicAABBTree::RayIntersects(
+                        origin, inv_direction, max_distance, state.fat_box.min, state.fat_box.max))
+                    expected.push_back(proxy);
+            }
+
+            std::sort(found.begin(), found.end());
+            std::sort(expected.begin(), expected.end());
+            CHECK(found == expected);
+        }
+
+        size_t GetProxyCount() const { return m_proxies.size(); }
+
+    private:
+        int32_t PickProxy()
+        {
+            auto it = m_proxies.begin();
+            std::advance(it, std::uniform_int_distribution<size_t>(0, m_proxies.size() - 1)(m_engine));
+            return it->first;
+        }
+
+        DynamicAABBTree                    m_tree;
+        std::unordered_map<int32_t, Proxy> m_proxies;
+        std::mt19937                       m_engine;
+        uint32_t                           m_next_user_data = 0;
+    };
+
+    void TestRandomUpdates()
+    {
+        Scene scene;
+        for (uint32_t i = 0; i < k_initial_count; ++i)
+            scene.Create();
+        scene.CheckProxies();
+
+        Frustum frustum;
+        frustum.updatePlanes(glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), 1.0f, 16.0f / 9.0f, 0.1f, 80.0f);
+
+        size_t frustum_total = 0;
+        for (uint32_t i = 0; i < k_step_count; ++i)
+        {
+            scene.Step();
+
+            if (i % 200 == 0)
+            {
+                scene.CheckProxies();
+                scene.CheckQueryAABB(BoundingBox(glm::vec3(-20.0f), glm::vec3(20.0f)));
+                scene.CheckQueryAABB(BoundingBox(glm::vec3(50.0f, -100.0f, -5.0f), glm::vec3(100.0f, 100.0f, 5.0f)));
+                frustum_total += scene.CheckQueryFrustum(frustum);
+                scene.CheckQueryRay(
+                    glm::vec3(-100.0f, 1.0f, 2.0f), glm::normalize(glm::vec3(1.0f, 0.1f, 0.0f)), 200.0f);
+                scene.CheckQueryRay(glm::vec3(3.0f, -100.0f, 3.0f), glm::vec3(0.0f, 1.0f, 0.0f), 150.0f);
+            }
+        }
+        scene.CheckProxies();
+
+        // the frustum covers part of the world, so queries above compared a non trivial set
+        CHECK(frustum_total > 0);
+        CHECK(frustum_total < scene.GetProxyCount() * (k_step_count / 200));
+    }
+
+    void TestEmpty()
+    {
+        DynamicAABBTree tree;
+
+        int calls = 0;
+        tree.QueryAABB(BoundingBox(glm::vec3(-1.0f), glm::vec3(1.0f)), [&](int32_t) { calls++; });
+        CHECK(calls == 0);
+
+        // destroying every proxy leaves an empty tree that can be filled again
+        int32_t a = tree.CreateProxy(BoundingBox(glm::vec3(0.0f), glm::vec3(1.0f)), 1);
+        int32_t b = tree.CreateProxy(BoundingBox(glm::vec3(2.0f), glm::vec3(3.0f)), 2);
+        tree.DestroyProxy(a);
+        tree.DestroyProxy(b);
+        CHECK(tree.GetProxyCount() == 0);
+        CHECK(tree.GetHeight() == 0);
+
+        tree.QueryAABB(BoundingBox(glm::vec3(-10.0f), glm::vec3(10.0f)), [&](int32_t) { calls++; });
+        CHECK(calls == 0);
+
+        int32_t c = tree.CreateProxy(BoundingBox(glm::vec3(0.0f), glm::vec3(1.0f)), 3);
+        tree.QueryAABB(BoundingBox(glm::vec3(-10.0f), glm::vec3(10.0f)), [&](int32_t proxy) {
+            CHECK(proxy == c);
+            calls++;
+        });
+        CHECK(calls == 1);
+        CHECK(tree.GetUserData(c) == 3);
+    }
+} // namespace
+
+int main()
+{
+    TestRandomUpdates();
+    TestEmpty();
+
+    if (g_failure_count > 0)
+    {
+        std::printf("%d checks failed\n", g_failure_count);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+    return 0;
+}
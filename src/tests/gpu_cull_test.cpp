@@ -0,0 +1,488 @@
+#include "core/math/frustum.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace Meow;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++g_failure_count; \
+        } \
+    } while (false)
+
+namespace
+{
+    int g_failure_count = 0;
+
+    // returned when there is no device, so that ctest reports the test as skipped
+    constexpr int k_skip_return_code = 77;
+
+    constexpr uint32_t k_object_count = 3000;
+    constexpr uint32_t k_mesh_count   = 4;
+    constexpr uint32_t k_group_size   = 64;
+
+    // boxes this close to a plane may be classified differently by the GPU, due to rounding
+    constexpr float k_ambiguous_distance = 1e-3f;
+
+    /**
+     * @brief Layouts of gpu_cull.comp (std430 and std140), same as GPUCuller.
+     */
+    struct PerObjectData
+    {
+        glm::mat4 model_matrix;
+        glm::mat4 normal_matrix;
+    };
+
+    struct CullObject
+    {
+        glm::vec4 bounds_min;
+        glm::vec4 bounds_max;
+        uint32_t  object_index;
+        uint32_t  command_index;
+        uint32_t  padding[2];
+    };
+
+    struct CullData
+    {
+        glm::vec4 frustum_planes[6];
+        uint32_t  object_count;
+        uint32_t  padding[3];
+    };
+
+    struct Scene
+    {
+        std::vector<PerObjectData>                 objects;
+        std::vector<CullObject>                    cull_objects;
+        std::vector<uint32_t>                      instance_offsets;
+        uint32_t                                   instance_capacity = 0;
+        std::vector<std::pair<uint32_t, uint32_t>> expected;
+        std::vector<std::pair<uint32_t, uint32_t>> ambiguous;
+    };
+
+    std::vector<uint32_t> ReadSpirv(const std::filesystem::path& path)
+    {
+        std::ifstream        file(path, std::ios::binary);
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        std::vector<uint32_t> words(bytes.size() / sizeof(uint32_t));
+        std::memcpy(words.data(), bytes.data(), words.size() * sizeof(uint32_t));
+        return words;
+    }
+
+    /**
+     * @brief Smallest signed distance of the p-vertex to the planes, negative when the box is outside.
+     */
+    float GetPlaneDistance(const std::array<glm::vec4, 6>& planes, const BoundingBox& box)
+    {
+        float distance = INFINITY;
+        for (const glm::vec4& plane : planes)
+        {
+            glm::vec3 p_vertex(plane.x >= 0.0f ? box.max.x : box.min.x,
+                               plane.y >= 0.0f ? box.max.y : box.min.y,
+                               plane.z >= 0.0f ? box.max.z : box.min.z);
+            distance = std::min(distance, glm::dot(glm::vec3(plane), p_vertex) + plane.w);
+        }
+        return distance;
+    }
+
+    /**
+     * @brief Random objects, each drawing one or two meshes, and which of them the CPU culler of Level keeps.
+     */
+    Scene CreateScene(const Frustum& frustum)
+    {
+        Scene        scene;
+        std::mt19937 engine(5);
+
+        std::uniform_real_distribution<float>   position(-60.0f, 60.0f);
+        std::uniform_real_distribution<float>   angle(0.0f, 6.2831853f);
+        std::uniform_real_distribution<float>   scale(0.2f, 3.0f);
+        std::uniform_real_distribution<float>   extent(0.1f, 2.0f);
+        std::uniform_int_distribution<uint32_t> mesh(0, k_mesh_count - 1);
+
+        std::array<glm::vec4, 6>           planes = frustum.GetPlaneEquations();
+        std::vector<std::vector<uint32_t>> mesh_objects(k_mesh_count);
+        BoundingBoxColumns                 world_bounds;
+        std::vector<uint32_t>              world_bounds_objects;
+
+        for (uint32_t i = 0; i < k_object_count; ++i)
+        {
+            glm::mat4 model_matrix =
+                glm::translate(glm::mat4(1.0f), glm::vec3(position(engine), position(engine), position(engine)));
+            model_matrix = glm::rotate(
+                model_matrix, angle(engine), glm::normalize(glm::vec3(position(engine), 1.0f, position(engine))));
+            model_matrix = glm::scale(model_matrix, glm::vec3(scale(engine), scale(engine), scale(engine)));
+            scene.objects.push_back({model_matrix, glm::mat4(1.0f)});
+
+            glm::vec3   center(position(engine) * 0.02f, position(engine) * 0.02f, position(engine) * 0.02f);
+            glm::vec3   half_extents(extent(engine), extent(engine), extent(engine));
+            BoundingBox bounds(center - half_extents, center + half_extents);
+
+            uint32_t first_mesh = mesh(engine);
+            uint32_t last_mesh  = std::min(first_mesh + i % 2, k_mesh_count - 1);
+            for (uint32_t m = first_mesh; m <= last_mesh; ++m)
+            {
+                scene.cull_objects.push_back({glm::vec4(bounds.min, 1.0f), glm::vec4(bounds.max, 1.0f), i, m, {0, 0}});
+                mesh_objects[m].push_back(i);
+            }
+
+            // as Level::UpdateSpatialIndex and Level::CullVisibles do
+            BoundingBox world_box = bounds.Transform(model_matrix);
+            world_bounds.PushBack(world_box);
+            world_bounds_objects.push_back(i);
+
+            if (std::abs(GetPlaneDistance(planes, world_box)) < k_ambiguous_distance)
+            {
+                for (uint32_t m = first_mesh; m <= last_mesh; ++m)
+                    scene.ambiguous.push_back({i, m});
+            }
+        }
+
+        std::vector<uint8_t> visibilities;
+        frustum.CheckIfInside(world_bounds, visibilities);
+
+        for (const CullObject& cull_object : scene.cull_objects)
+        {
+            if (visibilities[cull_object.object_index])
+                scene.expected.push_back({cull_object.object_index, cull_object.command_index});
+        }
+
+        for (uint32_t m = 0; m < k_mesh_count; ++m)
+        {
+            scene.instance_offsets.push_back(scene.instance_capacity);
+            scene.instance_capacity += static_cast<uint32_t>(mesh_objects[m].size());
+        }
+
+        return scene;
+    }
+
+    class ComputeDevice
+    {
+    public:
+        bool Create()
+        {
+            vk::ApplicationInfo application_info("GPUCullTest", 1, "Meow", 1, VK_API_VERSION_1_1);
+
+            // validation is used when the layer is installed, and any error it reports fails the test
+            std::vector<const char*> layers;
+            std::vector<const char*> extensions;
+            for (const vk::LayerProperties& layer : m_context.enumerateInstanceLayerProperties())
+            {
+                if (std::strcmp(layer.layerName, "VK_LAYER_KHRONOS_validation") == 0)
+                {
+                    layers.push_back("VK_LAYER_KHRONOS_validation");
+                    extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+                }
+            }
+
+            m_instance =
+                vk::raii::Instance(m_context, vk::InstanceCreateInfo({}, &application_info, layers, extensions));
+
+            if (!layers.empty())
+            {
+                vk::DebugUtilsMessengerCreateInfoEXT messenger_create_info(
+                    {},
+                    vk::DebugUtilsMessageSeverityFlagBitsEXT::eError,
+                    vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral | vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation,
+                    &OnValidationMessage);
+                m_messenger = vk::raii::DebugUtilsMessengerEXT(m_instance, messenger_create_info);
+            }
+
+            // any device works, e.g. lavapipe selected by VK_ICD_FILENAMES on machines without a GPU
+            for (vk::raii::PhysicalDevice& physical_device : vk::raii::PhysicalDevices(m_instance))
+            {
+                std::vector<vk::QueueFamilyProperties> families = physical_device.getQueueFamilyProperties();
+                for (uint32_t i = 0; i < families.size(); ++i)
+                {
+                    if (!(families[i].queueFlags & vk::QueueFlagBits::eCompute))
+                        continue;
+
+                    m_physical_device    = std::move(physical_device);
+                    m_queue_family_index = i;
+                    break;
+                }
+                if (m_queue_family_index)
+                    break;
+            }
+
+            if (!m_queue_family_index)
+                return false;
+
+            std::printf("Running on %s\n", m_physical_device.getProperties().deviceName.data());
+
+            float                     queue_priority = 1.0f;
+            vk::DeviceQueueCreateInfo queue_create_info({}, *m_queue_family_index, 1, &queue_priority);
+            m_device = vk::raii::Device(m_physical_device, vk::DeviceCreateInfo({}, queue_create_info));
+            m_queue  = m_device.getQueue(*m_queue_family_index, 0);
+            return true;
+        }
+
+        struct Buffer
+        {
+            vk::raii::Buffer       buffer = nullptr;
+            vk::raii::DeviceMemory memory = nullptr;
+            void*                  mapped = nullptr;
+            vk::DeviceSize         size   = 0;
+        };
+
+        Buffer CreateBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, const void* data = nullptr)
+        {
+            Buffer result;
+            result.size   = size;
+            result.buffer = vk::raii::Buffer(m_device, vk::BufferCreateInfo({}, size, usage));
+
+            vk::MemoryRequirements             requirements = result.buffer.getMemoryRequirements();
+            vk::PhysicalDeviceMemoryProperties properties   = m_physical_device.getMemoryProperties();
+            vk::MemoryPropertyFlags            flags =
+                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+            uint32_t memory_type_index = 0;
+            while (memory_type_index < properties.memoryTypeCount &&
+                   (!(requirements.memoryTypeBits & (1u << memory_type_index)) ||
+                    (properties.memoryTypes[memory_type_index].propertyFlags & flags) != flags))
+                ++memory_type_index;
+
+            result.memory =
+                vk::raii::DeviceMemory(m_device, vk::MemoryAllocateInfo(requirements.size, memory_type_index));
+            result.buffer.bindMemory(*result.memory, 0);
+            result.mapped = result.memory.mapMemory(0, size);
+
+            if (data)
+                std::memcpy(result.mapped, data, size);
+            else
+                std::memset(result.mapped, 0, size);
+
+            return result;
+        }
+
+        const vk::raii::Device& GetDevice() const { return m_device; }
+
+        void Submit(const std::function<void(const vk::raii::CommandBuffer&)>& record)
+        {
+            vk::raii::CommandPool    pool(m_device, vk::CommandPoolCreateInfo({}, *m_queue_family_index));
+            vk::raii::CommandBuffers command_buffers(
+                m_device, vk::CommandBufferAllocateInfo(*pool, vk::CommandBufferLevel::ePrimary, 1));
+            const vk::raii::CommandBuffer& command_buffer = command_buffers[0];
+
+            command_buffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+            record(command_buffer);
+            command_buffer.end();
+
+            vk::raii::Fence fence(m_device, vk::FenceCreateInfo());
+            vk::SubmitInfo  submit_info({}, {}, *command_buffer);
+            m_queue.submit(submit_info, *fence);
+            CHECK(m_device.waitForFences(*fence, VK_TRUE, UINT64_MAX) == vk::Result::eSuccess);
+        }
+
+    private:
+        static VKAPI_ATTR VkBool32 VKAPI_CALL OnValidationMessage(VkDebugUtilsMessageSeverityFlagBitsEXT,
+                                                                  VkDebugUtilsMessageTypeFlagsEXT,
+                                                                  const VkDebugUtilsMessengerCallbackDataEXT* data,
+                                                                  void*)
+        {
+            std::printf("Validation: %s\n", data->pMessage);
+            ++g_failure_count;
+            return VK_FALSE;
+        }
+
+        vk::raii::Context                m_context;
+        vk::raii::Instance               m_instance        = nullptr;
+        vk::raii::DebugUtilsMessengerEXT m_messenger       = nullptr;
+        vk::raii::PhysicalDevice         m_physical_device = nullptr;
+        std::optional<uint32_t>          m_queue_family_index;
+        vk::raii::Device                 m_device = nullptr;
+        vk::raii::Queue                  m_queue  = nullptr;
+    };
+
+    /**
+     * @brief Run gpu_cull.comp over the scene, and compare the objects it appends per mesh with the CPU culler.
+     */
+    void TestCulling(ComputeDevice& compute_device)
+    {
+        const vk::raii::Device& device = compute_device.GetDevice();
+
+        Frustum frustum;
+        frustum.updatePlanes(glm::vec3(5.0f, 2.0f, -3.0f),
+                             glm::angleAxis(0.6f, glm::normalize(glm::vec3(0.2f, 1.0f, 0.1f))),
+                             glm::radians(60.0f),
+                             16.0f / 9.0f,
+                             0.1f,
+                             70.0f);
+
+        Scene scene = CreateScene(frustum);
+
+        std::vector<vk::DrawIndexedIndirectCommand> commands;
+        for (uint32_t m = 0; m < k_mesh_count; ++m)
+            commands.emplace_back(36, 0, 0, 0, scene.instance_offsets[m]);
+
+        CullData                 cull_data {};
+        std::array<glm::vec4, 6> planes = frustum.GetPlaneEquations();
+        std::copy(planes.begin(), planes.end(), cull_data.frustum_planes);
+        cull_data.object_count = static_cast<uint32_t>(scene.cull_objects.size());
+
+        vk::BufferUsageFlags  storage = vk::BufferUsageFlagBits::eStorageBuffer;
+        ComputeDevice::Buffer object_buffer =
+            compute_device.CreateBuffer(sizeof(PerObjectData) * scene.objects.size(), storage, scene.objects.data());
+        ComputeDevice::Buffer instance_buffer =
+            compute_device.CreateBuffer(sizeof(uint32_t) * scene.instance_capacity, storage);
+        ComputeDevice::Buffer cull_object_buffer = compute_device.CreateBuffer(
+            sizeof(CullObject) * scene.cull_objects.size(), storage, scene.cull_objects.data());
+        ComputeDevice::Buffer command_buffer_data = compute_device.CreateBuffer(
+            sizeof(vk::DrawIndexedIndirectCommand) * commands.size(), storage, commands.data());
+        ComputeDevice::Buffer count_buffer = compute_device.CreateBuffer(sizeof(uint32_t) * k_mesh_count, storage);
+        ComputeDevice::Buffer cull_data_buffer =
+            compute_device.CreateBuffer(sizeof(CullData), vk::BufferUsageFlagBits::eUniformBuffer, &cull_data);
+
+        std::array<const ComputeDevice::Buffer*, 6> buffers = {&object_buffer,
+                                                               &instance_buffer,
+                                                               &cull_object_buffer,
+                                                               &command_buffer_data,
+                                                               &count_buffer,
+                                                               &cull_data_buffer};
+
+        std::vector<vk::DescriptorSetLayoutBinding> bindings;
+        for (uint32_t i = 0; i < buffers.size(); ++i)
+        {
+            vk::DescriptorType type = i == 5 ? vk::DescriptorType::eUniformBuffer : vk::DescriptorType::eStorageBuffer;
+            bindings.emplace_back(i, type, 1, vk::ShaderStageFlagBits::eCompute);
+        }
+
+        vk::raii::DescriptorSetLayout set_layout(device, vk::DescriptorSetLayoutCreateInfo({}, bindings));
+        vk::raii::PipelineLayout      pipeline_layout(device, vk::PipelineLayoutCreateInfo({}, *set_layout));
+
+        std::vector<uint32_t> code = ReadSpirv(ENGINE_ROOT_DIR "/builtin/shaders/gpu_cull.comp.spv");
+        CHECK(!code.empty());
+        if (code.empty())
+            return;
+
+        vk::raii::ShaderModule shader_module(device, vk::ShaderModuleCreateInfo({}, code));
+        vk::raii::Pipeline     pipeline(
+            device,
+            nullptr,
+            vk::ComputePipelineCreateInfo(
+                {},
+                vk::PipelineShaderStageCreateInfo({}, vk::ShaderStageFlagBits::eCompute, *shader_module, "main"),
+                *pipeline_layout));
+
+        std::array<vk::DescriptorPoolSize, 2> pool_sizes = {
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 5),
+            vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, 1)};
+        vk::raii::DescriptorPool descriptor_pool(
+            device, vk::DescriptorPoolCreateInfo(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet, 1, pool_sizes));
+        vk::raii::DescriptorSets descriptor_sets(device, vk::DescriptorSetAllocateInfo(*descriptor_pool, *set_layout));
+
+        std::vector<vk::DescriptorBufferInfo> buffer_infos;
+        for (const ComputeDevice::Buffer* buffer : buffers)
+            buffer_infos.emplace_back(*buffer->buffer, 0, VK_WHOLE_SIZE);
+
+        std::vector<vk::WriteDescriptorSet> writes;
+        for (uint32_t i = 0; i < buffers.size(); ++i)
+            writes.emplace_back(*descriptor_sets[0], i, 0, 1, bindings[i].descriptorType, nullptr, &buffer_infos[i]);
+        device.updateDescriptorSets(writes, nullptr);
+
+        compute_device.Submit([&](const vk::raii::CommandBuffer& command_buffer) {
+            command_buffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+            command_buffer.bindDescriptorSets(
+                vk::PipelineBindPoint::eCompute, *pipeline_layout, 0, *descriptor_sets[0], nullptr);
+            command_buffer.dispatch((cull_data.object_count + k_group_size - 1) / k_group_size, 1, 1);
+
+            vk::MemoryBarrier barrier(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eHostRead);
+            command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                                           vk::PipelineStageFlagBits::eHost,
+                                           {},
+                                           barrier,
+                                           nullptr,
+                                           nullptr);
+        });
+
+        // same comparison as GPUCuller::ValidateResults
+        const auto* results    = static_cast<const vk::DrawIndexedIndirectCommand*>(command_buffer_data.mapped);
+        const auto* counts     = static_cast<const uint32_t*>(count_buffer.mapped);
+        const auto* object_ids = static_cast<const uint32_t*>(instance_buffer.mapped);
+
+        std::vector<std::pair<uint32_t, uint32_t>> visibles;
+        for (uint32_t m = 0; m < k_mesh_count; ++m)
+        {
+            uint32_t begin = scene.instance_offsets[m];
+            uint32_t end   = m + 1 < k_mesh_count ? scene.instance_offsets[m + 1] : scene.instance_capacity;
+
+            CHECK(results[m].instanceCount <= end - begin);
+            CHECK(counts[m] == (results[m].instanceCount > 0 ? 1u : 0u));
+            CHECK(results[m].firstInstance == begin);
+
+            uint32_t instance_count = std::min(results[m].instanceCount, end - begin);
+            for (uint32_t k = begin; k < begin + instance_count; ++k)
+                visibles.push_back({object_ids[k], m});
+        }
+
+        auto drop_ambiguous = [&scene](std::vector<std::pair<uint32_t, uint32_t>>& pairs) {
+            std::sort(pairs.begin(), pairs.end());
+            std::vector<std::pair<uint32_t, uint32_t>> kept;
+            std::set_difference(
+                pairs.begin(), pairs.end(), scene.ambiguous.begin(), scene.ambiguous.end(), std::back_inserter(kept));
+            pairs = kept;
+        };
+        std::sort(scene.ambiguous.begin(), scene.ambiguous.end());
+        drop_ambiguous(visibles);
+        drop_ambiguous(scene.expected);
+
+        std::printf("%zu visible instances of %zu, %zu near a plane\n",
+                    visibles.size(),
+                    scene.cull_objects.size(),
+                    scene.ambiguous.size());
+
+        // a non trivial part of the scene is visible
+        CHECK(!scene.expected.empty());
+        CHECK(scene.expected.size() < scene.cull_objects.size());
+        CHECK(visibles == scene.expected);
+    }
+} // namespace
+
+int main()
+{
+    // the loader is opened by vk::raii::Context, which throws if there is none
+    std::optional<ComputeDevice> compute_device;
+    try
+    {
+        compute_device.emplace();
+        if (!compute_device->Create())
+        {
+            std::printf("No Vulkan device with a compute queue, skipped\n");
+            return k_skip_return_code;
+        }
+    }
+    catch (const std::exception& exception)
+    {
+        // no loader or no driver
+        std::printf("Vulkan is not available (%s), skipped\n", exception.what());
+        return k_skip_return_code;
+    }
+
+    TestCulling(*compute_device);
+
+    if (g_failure_count > 0)
+    {
+        std::printf("%d checks failed\n", g_failure_count);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include "function/render/model/mesh_optimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Meow;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++g_failure_count; \
+        } \
+    } while (false)
+
+namespace
+{
+    int g_failure_count = 0;
+
+    constexpr uint32_t k_grid_size     = 32;
+    constexpr uint32_t k_vertex_stride = 5; // position and uv
+
+    struct Mesh
+    {
+        std::vector<float>    vertices;
+        std::vector<uint32_t> indices;
+    };
+
+    /**
+     * @brief Bumpy grid of k_grid_size x k_grid_size quads, with triangles in random order.
+     */
+    Mesh CreateShuffledGrid()
+    {
+        Mesh mesh;
+        for (uint32_t y = 0; y <= k_grid_size; ++y)
+        {
+            for (uint32_t x = 0; x <= k_grid_size; ++x)
+            {
+                float height = static_cast<float>((x * 7 + y * 3) % 5) * 0.1f;
+                mesh.vertices.insert(mesh.vertices.end(),
+                                     {static_cast<float>(x),
+                                      height,
+                                      static_cast<float>(y),
+                                      static_cast<float>(x) / k_grid_size,
+                                      static_cast<float>(y) / k_grid_size});
+            }
+        }
+
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (uint32_t y = 0; y < k_grid_size; ++y)
+        {
+            for (uint32_t x = 0; x < k_grid_size; ++x)
+            {
+                uint32_t v0 = y * (k_grid_size + 1) + x;
+                uint32_t v1 = v0 + 1;
+                uint32_t v2 = v0 + k_grid_size + 1;
+                uint32_t v3 = v2 + 1;
+                triangles.push_back({v0, v2, v1});
+                triangles.push_back({v1, v2, v3});
+            }
+        }
+
+        std::mt19937 engine(42);
+        std::shuffle(triangles.begin(), triangles.end(), engine);
+
+        for (const auto& triangle : triangles)
+            mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+
+        return mesh;
+    }
+
+    /**
+     * @brief Triangles as a sorted list, each rotated to start at its smallest index so that winding is kept.
+     */
+    std::vector<std::array<uint32_t, 3>> GetTriangleSet(const std::vector<uint32_t>& indices)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            std::array<uint32_t, 3> triangle = {indices[i], indices[i + 1], indices[i + 2]};
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            triangles.push_back(triangle);
+        }
+
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    void TestVertexCache()
+    {
+        Mesh   mesh         = CreateShuffledGrid();
+        size_t vertex_count = mesh.vertices.size() / k_vertex_stride;
+
+        std::vector<uint32_t> indices = mesh.indices;
+        OptimizeVertexCache(indices, vertex_count);
+
+        CHECK(GetTriangleSet(indices) == GetTriangleSet(mesh.indices));
+
+        float shuffled_acmr  = AnalyzeVertexCache(mesh.indices, vertex_count).acmr;
+        float optimized_acmr = AnalyzeVertexCache(indices, vertex_count).acmr;
+        std::printf("ACMR of a shuffled grid: %.3f, after OptimizeVertexCache: %.3f\n", shuffled_acmr, optimized_acmr);
+
+        // a shuffled grid misses on almost every vertex, a good order reuses most of them
+        CHECK(optimized_acmr < shuffled_acmr);
+        CHECK(optimized_acmr < 1.0f);
+
+        // too small to optimize is left alone
+        std::vector<uint32_t> empty;
+        OptimizeVertexCache(empty, vertex_count);
+        CHECK(empty.empty());
+    }
+
+    void TestOverdraw()
+    {
+        Mesh   mesh         = CreateShuffledGrid();
+        size_t vertex_count = mesh.vertices.size() / k_vertex_stride;
+
+        std::vector<uint32_t> indices = mesh.indices;
+        OptimizeVertexCache(indices, vertex_count);
+        float cache_acmr = AnalyzeVertexCache(indices, vertex_count).acmr;
+
+        float threshold = 1.05f;
+        OptimizeOverdraw(indices, mesh.vertices, k_vertex_stride, 0, threshold);
+
+        CHECK(GetTriangleSet(indices) == GetTriangleSet(mesh.indices));
+
+        // clusters are reordered as a whole, each one only pays for its first misses again
+        float overdraw_acmr = AnalyzeVertexCache(indices, vertex_count).acmr;
+        CHECK(overdraw_acmr < AnalyzeVertexCache(mesh.indices, vertex_count).acmr);
+        std::printf("ACMR after OptimizeVertexCache: %.3f, after OptimizeOverdraw: %.3f\n", cache_acmr, overdraw_acmr);
+
+        // positions outside the vertex are rejected without touching the indices
+        std::vector<uint32_t> unchanged = indices;
+        OptimizeOverdraw(unchanged, mesh.vertices, k_vertex_stride, k_vertex_stride - 2, threshold);
+        CHECK(unchanged == indices);
+    }
+
+    void TestVertexFetch()
+    {
+        // vertex i holds the values i * 10 + k, vertices 1 and 4 are used by no triangle
+        std::vector<float> vertices;
+        for (uint32_t i = 0; i < 6; ++i)
+        {
+            for (uint32_t k = 0; k < k_vertex_stride; ++k)
+                vertices.push_back(static_cast<float>(i * 10 + k));
+        }
+
+        std::vector<uint32_t> indices = {5, 3, 0, 0, 3, 2};
+
+        std::vector<float>    fetched_vertices = vertices;
+        std::vector<uint32_t> fetched_indices  = indices;
+        size_t                vertex_count = OptimizeVertexFetch(fetched_indices, fetched_vertices, k_vertex_stride);
+
+        CHECK(vertex_count == 4);
+        CHECK(fetched_vertices.size() == vertex_count * k_vertex_stride);
+
+        // renumbered in the order of first use
+        CHECK(fetched_indices == std::vector<uint32_t>({0, 1, 2, 2, 1, 3}));
+
+        // every corner still points at the same vertex data
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            for (uint32_t k = 0; k < k_vertex_stride; ++k)
+            {
+                CHECK(fetched_vertices[fetched_indices[i] * k_vertex_stride + k] ==
+                      vertices[indices[i] * k_vertex_stride + k]);
+            }
+        }
+    }
+} // namespace
+
+int main()
+{
+    TestVertexCache();
+    TestOverdraw();
+    TestVertexFetch();
+
+    if (g_failure_count > 0)
+    {
+        std::printf("%d checks failed\n", g_failure_count);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+    return 0;
+}
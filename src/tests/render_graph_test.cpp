@@ -0,0 +1,413 @@
+#include "function/render/render_graph/render_graph_schedule.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Meow;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++g_failure_count; \
+        } \
+    } while (false)
+
+namespace
+{
+    int g_failure_count = 0;
+
+    /**
+     * @brief Builds passes and resources the way RenderGraph does from the declared accesses.
+     */
+    struct GraphBuilder
+    {
+        uint32_t Image(uint32_t width = 1280, uint32_t height = 720)
+        {
+            resources.push_back({width, height, false, false});
+            return static_cast<uint32_t>(resources.size() - 1);
+        }
+
+        uint32_t Import(uint32_t width = 1280, uint32_t height = 720)
+        {
+            resources.push_back({width, height, true, false});
+            return static_cast<uint32_t>(resources.size() - 1);
+        }
+
+        uint32_t Pass()
+        {
+            passes.emplace_back();
+            return static_cast<uint32_t>(passes.size() - 1);
+        }
+
+        void WriteColor(uint32_t pass, uint32_t resource, bool clear = false)
+        {
+            passes[pass].usages.push_back({resource, true, true, clear});
+        }
+        void ReadInput(uint32_t pass, uint32_t resource)
+        {
+            passes[pass].usages.push_back({resource, false, true, false});
+        }
+        void ReadTexture(uint32_t pass, uint32_t resource)
+        {
+            passes[pass].usages.push_back({resource, false, false, false});
+        }
+        void WriteStorage(uint32_t pass, uint32_t resource)
+        {
+            passes[pass].usages.push_back({resource, true, false, false});
+        }
+
+        std::vector<RenderGraphSchedulePass>     passes;
+        std::vector<RenderGraphScheduleResource> resources;
+    };
+
+    void TestCulling()
+    {
+        GraphBuilder graph;
+        uint32_t     swapchain = graph.Import();
+        uint32_t     scene     = graph.Image();
+        uint32_t     unused    = graph.Image();
+        uint32_t     overdrawn = graph.Image();
+        uint32_t     readback  = graph.Image();
+
+        // scene is drawn, then composited into the swapchain
+        uint32_t draw      = graph.Pass();
+        uint32_t composite = graph.Pass();
+        graph.WriteColor(draw, scene, true);
+        graph.ReadTexture(composite, scene);
+        graph.WriteColor(composite, swapchain, true);
+
+        // nothing reads this
+        uint32_t debug = graph.Pass();
+        graph.WriteColor(debug, unused, true);
+
+        // the second clear throws away what the first pass wrote
+        uint32_t first_write  = graph.Pass();
+        uint32_t second_write = graph.Pass();
+        uint32_t present      = graph.Pass();
+        graph.WriteColor(first_write, overdrawn, true);
+        graph.WriteColor(second_write, overdrawn, true);
+        graph.ReadTexture(present, overdrawn);
+        graph.WriteColor(present, swapchain);
+
+        // writes buffers the graph doesn't track
+        uint32_t upload                   = graph.Pass();
+        graph.passes[upload].side_effects = true;
+
+        // read back after the frame
+        uint32_t capture = graph.Pass();
+        graph.WriteStorage(capture, readback);
+        graph.resources[readback].output = true;
+
+        std::vector<uint8_t> alive = CullRenderGraphPasses(graph.passes, graph.resources);
+        CHECK(alive[draw] && alive[composite]);
+        CHECK(!alive[debug]);
+        CHECK(!alive[first_write]);
+        CHECK(alive[second_write] && alive[present]);
+        CHECK(alive[upload]);
+        CHECK(alive[capture]);
+
+        // a load instead of a clear needs the earlier contents, so the first pass is kept
+        graph.passes[second_write].usages[0].overwrite = false;
+        alive                                          = CullRenderGraphPasses(graph.passes, graph.resources);
+        CHECK(alive[first_write]);
+    }
+
+    void TestCullingChain()
+    {
+        GraphBuilder graph;
+        uint32_t     swapchain = graph.Import();
+
+        // a chain of passes, each reading what the previous one wrote, culled as a whole if its end isn't used
+        std::vector<uint32_t> images;
+        std::vector<uint32_t> chain;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            images.push_back(graph.Image());
+            chain.push_back(graph.Pass());
+            if (i > 0)
+                graph.ReadTexture(chain[i], images[i - 1]);
+            graph.WriteColor(chain[i], images[i], true);
+        }
+
+        std::vector<uint8_t> alive = CullRenderGraphPasses(graph.passes, graph.resources);
+        CHECK(std::count(alive.begin(), alive.end(), 1) == 0);
+
+        uint32_t blit = graph.Pass();
+        graph.ReadTexture(blit, images.back());
+        graph.WriteColor(blit, swapchain);
+
+        alive = CullRenderGraphPasses(graph.passes, graph.resources);
+        CHECK(std::count(alive.begin(), alive.end(), 1) == static_cast<int>(graph.passes.size()));
+    }
+
+    void TestDeferredGrouping()
+    {
+        GraphBuilder graph;
+        uint32_t     swapchain = graph.Import();
+        uint32_t     albedo    = graph.Image();
+        uint32_t     normal    = graph.Image();
+        uint32_t     depth     = graph.Image();
+        uint32_t     shadow    = graph.Image(2048, 2048);
+        uint32_t     lit       = graph.Image();
+        uint32_t     luminance = graph.Image();
+
+        uint32_t shadow_pass = graph.Pass();
+        graph.WriteColor(shadow_pass, shadow, true);
+
+        // geometry and lighting share the g-buffer as attachments only, so they become subpasses
+        uint32_t geometry = graph.Pass();
+        graph.WriteColor(geometry, albedo, true);
+        graph.WriteColor(geometry, normal, true);
+        graph.WriteColor(geometry, depth, true);
+
+        uint32_t lighting = graph.Pass();
+        graph.ReadInput(lighting, albedo);
+        graph.ReadInput(lighting, normal);
+        graph.ReadInput(lighting, depth);
+        graph.ReadTexture(lighting, shadow);
+        graph.WriteColor(lighting, lit, true);
+
+        // compute passes never share a render pass
+        uint32_t exposure = graph.Pass();
+        graph.ReadTexture(exposure, lit);
+        graph.WriteStorage(exposure, luminance);
+
+        // samples what the lighting subpass wrote, which needs a barrier
+        uint32_t tonemap = graph.Pass();
+        graph.ReadTexture(tonemap, lit);
+        graph.ReadTexture(tonemap, luminance);
+        graph.WriteColor(tonemap, swapchain, true);
+
+        RenderGraphSchedule schedule = ScheduleRenderGraph(graph.passes, graph.resources);
+        CHECK(schedule.groups.size() == 4);
+        if (schedule.groups.size() != 4)
+            return;
+
+        CHECK(schedule.groups[0].passes == std::vector<uint32_t>({shadow_pass}));
+        CHECK(schedule.groups[0].width == 2048 && schedule.groups[0].height == 2048);
+
+        CHECK(schedule.groups[1].passes == std::vector<uint32_t>({geometry, lighting}));
+        CHECK(schedule.groups[1].attachments == std::vector<uint32_t>({albedo, normal, depth, lit}));
+        CHECK(schedule.groups[1].width == 1280 && schedule.groups[1].height == 720);
+        CHECK(schedule.pass_subpasses[geometry] == 0);
+        CHECK(schedule.pass_subpasses[lighting] == 1);
+
+        CHECK(schedule.groups[2].passes == std::vector<uint32_t>({exposure}));
+        CHECK(schedule.groups[2].attachments.empty());
+
+        CHECK(schedule.groups[3].passes == std::vector<uint32_t>({tonemap}));
+        CHECK(schedule.pass_groups[tonemap] == 3);
+
+        // lifetimes in groups, and which images are only touched as attachments
+        CHECK(schedule.first_groups[albedo] == 1 && schedule.last_groups[albedo] == 1);
+        CHECK(schedule.first_groups[shadow] == 0 && schedule.last_groups[shadow] == 1);
+        CHECK(schedule.first_groups[lit] == 1 && schedule.last_groups[lit] == 3);
+        CHECK(schedule.only_attachment[albedo] && schedule.only_attachment[swapchain]);
+        CHECK(!schedule.only_attachment[shadow] && !schedule.only_attachment[lit]);
+    }
+
+    void TestMergeRules()
+    {
+        GraphBuilder graph;
+        uint32_t     swapchain = graph.Import();
+        uint32_t     color     = graph.Image();
+        uint32_t     half      = graph.Image(640, 360);
+        uint32_t     other     = graph.Image();
+
+        uint32_t first = graph.Pass();
+        graph.WriteColor(first, color, true);
+
+        RenderGraphScheduleGroup group;
+        group.passes      = {first};
+        group.attachments = {color};
+        group.width       = 1280;
+        group.height      = 720;
+
+        // loading the same attachment again is fine
+        uint32_t load = graph.Pass();
+        graph.WriteColor(load, color);
+        CHECK(CanMergeRenderGraphPass(group, graph.passes[load], graph.passes, graph.resources));
+
+        // an attachment of another extent needs another framebuffer
+        uint32_t downsample = graph.Pass();
+        graph.WriteColor(downsample, half, true);
+        CHECK(!CanMergeRenderGraphPass(group, graph.passes[downsample], graph.passes, graph.resources));
+
+        // sampling an attachment of the group needs a barrier
+        uint32_t sample = graph.Pass();
+        graph.ReadTexture(sample, color);
+        graph.WriteColor(sample, other, true);
+        CHECK(!CanMergeRenderGraphPass(group, graph.passes[sample], graph.passes, graph.resources));
+
+        // unrelated attachments of the same extent are fine
+        uint32_t unrelated = graph.Pass();
+        graph.WriteColor(unrelated, other, true);
+        graph.WriteColor(unrelated, swapchain, true);
+        CHECK(CanMergeRenderGraphPass(group, graph.passes[unrelated], graph.passes, graph.resources));
+
+        // a group of a compute pass takes nothing
+        RenderGraphScheduleGroup compute_group;
+        compute_group.passes = {first};
+        CHECK(!CanMergeRenderGraphPass(compute_group, graph.passes[load], graph.passes, graph.resources));
+    }
+
+    void TestCulledPassesAreNotGrouped()
+    {
+        GraphBuilder graph;
+        uint32_t     swapchain = graph.Import();
+        uint32_t     unused    = graph.Image();
+
+        uint32_t a = graph.Pass();
+        graph.WriteColor(a, swapchain, true);
+        uint32_t culled = graph.Pass();
+        graph.WriteColor(culled, unused, true);
+        uint32_t b = graph.Pass();
+        graph.WriteColor(b, swapchain);
+
+        RenderGraphSchedule schedule = ScheduleRenderGraph(graph.passes, graph.resources);
+        CHECK(!schedule.pass_alive[culled]);
+        CHECK(schedule.pass_groups[culled] == k_render_graph_no_group);
+        CHECK(schedule.first_groups[unused] == k_render_graph_no_group);
+
+        // the culled pass in between doesn't split the render pass
+        CHECK(schedule.groups.size() == 1);
+        CHECK(schedule.pass_groups[a] == 0 && schedule.pass_groups[b] == 0);
+        CHECK(schedule.pass_subpasses[b] == 1);
+    }
+
+    void TestAliasingSequentialImages()
+    {
+        // images used one after another share the same memory
+        std::vector<RenderGraphAliasImage> images = {
+            {1024, 256, 0xff, 0, 0},
+            {1024, 256, 0xff, 1, 1},
+            {1024, 256, 0xff, 2, 2},
+        };
+
+        RenderGraphAliasPlacement placement = PlaceRenderGraphImages(images);
+        CHECK(placement.heap_size == 1024);
+        CHECK(placement.offsets == std::vector<uint64_t>({0, 0, 0}));
+        CHECK(placement.predecessors[0].empty());
+        CHECK(placement.predecessors[1] == std::vector<uint32_t>({0}));
+        CHECK(placement.predecessors[2] == std::vector<uint32_t>({0, 1}));
+
+        // images alive at the same time don't
+        images[1].first_group = 0;
+        placement             = PlaceRenderGraphImages(images);
+        CHECK(placement.heap_size == 2048);
+        CHECK(placement.offsets[0] != placement.offsets[1]);
+    }
+
+    void TestAliasingMemoryTypes()
+    {
+        std::vector<RenderGraphAliasImage> images = {
+            {4096, 256, 0x3, 0, 1},
+            {2048, 512, 0x2, 2, 3},
+            {1024, 256, 0x4, 0, 3},
+        };
+
+        // the last image suits none of the memory types left for the others
+        RenderGraphAliasPlacement placement = PlaceRenderGraphImages(images);
+        CHECK(!placement.dedicated[0] && !placement.dedicated[1]);
+        CHECK(placement.dedicated[2]);
+        CHECK(placement.memory_type_bits == 0x2);
+        CHECK(placement.heap_alignment == 512);
+        CHECK(placement.heap_size == 4096);
+    }
+
+    /**
+     * @brief Random images, checked for what the barriers in RenderGraph::BuildBarriers() rely on.
+     */
+    void TestAliasingRandom()
+    {
+        std::mt19937 engine(11);
+        for (uint32_t round = 0; round < 200; ++round)
+        {
+            constexpr uint32_t k_group_count = 12;
+
+            uint32_t                           image_count = std::uniform_int_distribution<uint32_t>(1, 24)(engine);
+            std::vector<RenderGraphAliasImage> images(image_count);
+
+            uint64_t unaliased_size = 0;
+            for (RenderGraphAliasImage& image : images)
+            {
+                image.size             = std::uniform_int_distribution<uint64_t>(1, 64)(engine) * 1024;
+                image.alignment        = uint64_t(1) << std::uniform_int_distribution<uint32_t>(8, 12)(engine);
+                image.memory_type_bits = std::uniform_int_distribution<uint32_t>(0, 7)(engine) == 0 ? 0x10 : 0x0f;
+                image.first_group      = std::uniform_int_distribution<uint32_t>(0, k_group_count - 1)(engine);
+                image.last_group =
+                    std::uniform_int_distribution<uint32_t>(image.first_group, k_group_count - 1)(engine);
+                unaliased_size += image.size;
+            }
+
+            RenderGraphAliasPlacement placement = PlaceRenderGraphImages(images);
+            CHECK(placement.offsets.size() == image_count);
+
+            for (uint32_t i = 0; i < image_count; ++i)
+            {
+                if (placement.dedicated[i])
+                    continue;
+
+                const RenderGraphAliasImage& image = images[i];
+                CHECK((placement.memory_type_bits & image.memory_type_bits) == placement.memory_type_bits);
+                CHECK(placement.offsets[i] % image.alignment == 0);
+                CHECK(placement.offsets[i] + image.size <= placement.heap_size);
+                CHECK(placement.heap_alignment % image.alignment == 0);
+
+                for (uint32_t j = i + 1; j < image_count; ++j)
+                {
+                    if (placement.dedicated[j])
+                        continue;
+
+                    const RenderGraphAliasImage& other = images[j];
+
+                    bool memory_overlaps = placement.offsets[i] < placement.offsets[j] + other.size &&
+                                           placement.offsets[j] < placement.offsets[i] + image.size;
+                    bool lifetimes_overlap =
+                        image.first_group <= other.last_group && other.first_group <= image.last_group;
+
+                    // images alive at the same time never share memory
+                    CHECK(!(memory_overlaps && lifetimes_overlap));
+
+                    // of two images sharing memory, the later one waits for the earlier one
+                    const auto& predecessors_i = placement.predecessors[i];
+                    const auto& predecessors_j = placement.predecessors[j];
+                    bool i_waits = std::find(predecessors_i.begin(), predecessors_i.end(), j) != predecessors_i.end();
+                    bool j_waits = std::find(predecessors_j.begin(), predecessors_j.end(), i) != predecessors_j.end();
+                    CHECK(i_waits == (memory_overlaps && other.last_group < image.first_group));
+                    CHECK(j_waits == (memory_overlaps && image.last_group < other.first_group));
+                }
+            }
+
+            // placed images never take more than placing them one after another
+            uint64_t aligned_unaliased_size = unaliased_size + image_count * 4096;
+            CHECK(placement.heap_size <= aligned_unaliased_size);
+        }
+    }
+} // namespace
+
+int main()
+{
+    TestCulling();
+    TestCullingChain();
+    TestDeferredGrouping();
+    TestMergeRules();
+    TestCulledPassesAreNotGrouped();
+    TestAliasingSequentialImages();
+    TestAliasingMemoryTypes();
+    TestAliasingRandom();
+
+    if (g_failure_count > 0)
+    {
+        std::printf("%d checks failed\n", g_failure_count);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+    return 0;
+}
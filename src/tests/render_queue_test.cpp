@@ -0,0 +1,152 @@
+#include "function/render/batch/render_queue.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Meow;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++g_failure_count; \
+        } \
+    } while (false)
+
+namespace
+{
+    int g_failure_count = 0;
+
+    constexpr uint32_t k_max_material = (1u << RenderQueue::k_material_bits) - 1;
+    constexpr uint32_t k_max_mesh     = (1u << RenderQueue::k_mesh_bits) - 1;
+    constexpr uint32_t k_max_depth    = (1u << RenderQueue::k_depth_bits) - 1;
+
+    void TestFrontToBackKey()
+    {
+        // layer | material | mesh | depth, from the most significant bits
+        CHECK(RenderQueue::MakeKey(SortOrder::FrontToBack, 1, 2, 3, 4) ==
+              ((1ull << 60) | (2ull << 44) | (3ull << 24) | 4));
+
+        // each field outweighs every field after it
+        CHECK(RenderQueue::MakeKey(SortOrder::FrontToBack, 1, 0, 0, 0) >
+              RenderQueue::MakeKey(SortOrder::FrontToBack, 0, k_max_material, k_max_mesh, k_max_depth));
+        CHECK(RenderQueue::MakeKey(SortOrder::FrontToBack, 0, 1, 0, 0) >
+              RenderQueue::MakeKey(SortOrder::FrontToBack, 0, 0, k_max_mesh, k_max_depth));
+        CHECK(RenderQueue::MakeKey(SortOrder::FrontToBack, 0, 0, 1, 0) >
+              RenderQueue::MakeKey(SortOrder::FrontToBack, 0, 0, 0, k_max_depth));
+
+        // nearer draws first
+        CHECK(RenderQueue::MakeKey(SortOrder::FrontToBack, 0, 5, 5, 10) <
+              RenderQueue::MakeKey(SortOrder::FrontToBack, 0, 5, 5, 11));
+
+        // values too wide for their field don't spill into the next one
+        CHECK(RenderQueue::MakeKey(SortOrder::FrontToBack, 0, 0, k_max_mesh + 1, 0) == 0);
+        CHECK(RenderQueue::MakeKey(SortOrder::FrontToBack, 0, 0, 0, k_max_depth + 1) == 0);
+
+        // draws with the same state only differ in depth
+        uint64_t near_key = RenderQueue::MakeKey(SortOrder::FrontToBack, 2, 7, 9, 0);
+        uint64_t far_key  = RenderQueue::MakeKey(SortOrder::FrontToBack, 2, 7, 9, k_max_depth);
+        CHECK(RenderQueue::GetStateBits(near_key) == RenderQueue::GetStateBits(far_key));
+        CHECK(RenderQueue::GetStateBits(near_key) !=
+              RenderQueue::GetStateBits(RenderQueue::MakeKey(SortOrder::FrontToBack, 2, 7, 8, 0)));
+    }
+
+    void TestBackToFrontKey()
+    {
+        // layer | inverted depth | material | mesh, from the most significant bits
+        CHECK(RenderQueue::MakeKey(SortOrder::BackToFront, 1, 2, 3, k_max_depth - 4) ==
+              ((1ull << 60) | (4ull << 36) | (2ull << 20) | 3));
+
+        // farther draws first, whatever their state
+        CHECK(RenderQueue::MakeKey(SortOrder::BackToFront, 0, k_max_material, k_max_mesh, 11) <
+              RenderQueue::MakeKey(SortOrder::BackToFront, 0, 0, 0, 10));
+
+        // layer still outweighs depth
+        CHECK(RenderQueue::MakeKey(SortOrder::BackToFront, 1, 0, 0, k_max_depth) >
+              RenderQueue::MakeKey(SortOrder::BackToFront, 0, k_max_material, k_max_mesh, 0));
+
+        // at equal depth, state decides
+        CHECK(RenderQueue::MakeKey(SortOrder::BackToFront, 0, 1, 0, 10) >
+              RenderQueue::MakeKey(SortOrder::BackToFront, 0, 0, k_max_mesh, 10));
+    }
+
+    void TestQuantizeDepth()
+    {
+        CHECK(RenderQueue::QuantizeDepth(0.0f, 100.0f) == 0);
+        CHECK(RenderQueue::QuantizeDepth(100.0f, 100.0f) == k_max_depth);
+        CHECK(RenderQueue::QuantizeDepth(-5.0f, 100.0f) == 0);
+        CHECK(RenderQueue::QuantizeDepth(500.0f, 100.0f) == k_max_depth);
+        CHECK(RenderQueue::QuantizeDepth(25.0f, 100.0f) < RenderQueue::QuantizeDepth(26.0f, 100.0f));
+        CHECK(RenderQueue::QuantizeDepth(25.0f, 0.0f) == 0);
+    }
+
+    void TestSort()
+    {
+        std::mt19937 engine(42);
+
+        // few distinct values per field, so many items share a key, and digits equal across the queue are skipped
+        std::uniform_int_distribution<uint32_t> small(0, 3);
+        std::uniform_int_distribution<uint32_t> depth(0, k_max_depth);
+
+        for (uint32_t item_count : {0u, 1u, 2u, 100u, 5000u})
+        {
+            RenderQueue queue;
+            for (uint32_t i = 0; i < item_count; ++i)
+            {
+                uint32_t item_depth = i % 2 == 0 ? small(engine) : depth(engine);
+                uint64_t key =
+                    RenderQueue::MakeKey(SortOrder::FrontToBack, 0, small(engine), small(engine), item_depth);
+                queue.Push(key, nullptr, i);
+            }
+
+            std::vector<RenderItem> expected = queue.GetItems();
+            std::stable_sort(expected.begin(), expected.end(), [](const RenderItem& lhs, const RenderItem& rhs) {
+                return lhs.sort_key < rhs.sort_key;
+            });
+
+            queue.Sort();
+
+            const std::vector<RenderItem>& items = queue.GetItems();
+            CHECK(items.size() == expected.size());
+
+            // items with equal keys keep the order they were pushed in
+            bool same_order = items.size() == expected.size();
+            for (size_t i = 0; same_order && i < items.size(); ++i)
+            {
+                same_order =
+                    items[i].sort_key == expected[i].sort_key && items[i].visible_index == expected[i].visible_index;
+            }
+            CHECK(same_order);
+        }
+
+        // a queue whose keys are all equal is left in push order
+        RenderQueue queue;
+        for (uint32_t i = 0; i < 10; ++i)
+            queue.Push(RenderQueue::MakeKey(SortOrder::BackToFront, 3, 1, 1, 1), nullptr, i);
+
+        queue.Sort();
+        for (uint32_t i = 0; i < 10; ++i)
+            CHECK(queue.GetItems()[i].visible_index == i);
+    }
+} // namespace
+
+int main()
+{
+    TestFrontToBackKey();
+    TestBackToFrontKey();
+    TestQuantizeDepth();
+    TestSort();
+
+    if (g_failure_count > 0)
+    {
+        std::printf("%d checks failed\n", g_failure_count);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include "function/render/material/shader_reflection.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace Meow;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++g_failure_count; \
+        } \
+    } while (false)
+
+namespace Meow
+{
+    // found by argument dependent lookup, also from the comparison of vectors
+    bool operator==(const ShaderResourceReflection& lhs, const ShaderResourceReflection& rhs)
+    {
+        return lhs.descriptor_type == rhs.descriptor_type && lhs.set == rhs.set && lhs.binding == rhs.binding &&
+               lhs.size == rhs.size && lhs.var_name == rhs.var_name && lhs.type_name == rhs.type_name;
+    }
+
+    bool operator==(const ShaderInputReflection& lhs, const ShaderInputReflection& rhs)
+    {
+        return lhs.location == rhs.location && lhs.vec_size == rhs.vec_size && lhs.var_name == rhs.var_name;
+    }
+
+    bool operator==(const ShaderReflection& lhs, const ShaderReflection& rhs)
+    {
+        return lhs.resources == rhs.resources && lhs.stage_inputs == rhs.stage_inputs;
+    }
+} // namespace Meow
+
+namespace
+{
+    int g_failure_count = 0;
+
+    std::vector<uint8_t> ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    ShaderReflection CreateReflection()
+    {
+        ShaderReflection reflection;
+        reflection.resources.push_back(
+            {vk::DescriptorType::eUniformBufferDynamic, 0, 1, 128, "per_object", "PerObjectDataDynamic"});
+        reflection.resources.push_back({vk::DescriptorType::eCombinedImageSampler, 2, 0, 0, "albedo_map", ""});
+        reflection.stage_inputs.push_back({0, 3, "in_pos"});
+        reflection.stage_inputs.push_back({2, 2, "in_uv0"});
+        return reflection;
+    }
+
+    void TestRoundTrip()
+    {
+        std::vector<uint8_t> spirv = {0x03, 0x02, 0x23, 0x07, 0x00, 0x00, 0x01, 0x00};
+        ShaderReflection     reflection = CreateReflection();
+
+        std::vector<uint8_t> file = SerializeShaderReflection(reflection, spirv.data(), spirv.size());
+
+        ShaderReflection result;
+        CHECK(DeserializeShaderReflection(file.data(), file.size(), spirv.data(), spirv.size(), result));
+        CHECK(result == reflection);
+
+        // no resources at all is still a valid reflection
+        ShaderReflection empty_result = reflection;
+        file = SerializeShaderReflection(ShaderReflection {}, spirv.data(), spirv.size());
+        CHECK(DeserializeShaderReflection(file.data(), file.size(), spirv.data(), spirv.size(), empty_result));
+        CHECK(empty_result == ShaderReflection {});
+    }
+
+    void TestStaleSpirv()
+    {
+        std::vector<uint8_t> spirv = {0x03, 0x02, 0x23, 0x07, 0x00, 0x00, 0x01, 0x00};
+        ShaderReflection     reflection = CreateReflection();
+
+        std::vector<uint8_t> file = SerializeShaderReflection(reflection, spirv.data(), spirv.size());
+
+        // a recompiled shader, of the same size or not, must not pick up the old reflection
+        std::vector<uint8_t> changed_spirv = spirv;
+        changed_spirv[5] ^= 1;
+        std::vector<uint8_t> longer_spirv = spirv;
+        longer_spirv.push_back(0);
+
+        ShaderReflection result;
+        CHECK(!DeserializeShaderReflection(
+            file.data(), file.size(), changed_spirv.data(), changed_spirv.size(), result));
+        CHECK(!DeserializeShaderReflection(file.data(), file.size(), longer_spirv.data(), longer_spirv.size(), result));
+        CHECK(result == ShaderReflection {});
+    }
+
+    void TestCorruptFile()
+    {
+        std::vector<uint8_t> spirv = {0x03, 0x02, 0x23, 0x07, 0x00, 0x00, 0x01, 0x00};
+        ShaderReflection     reflection = CreateReflection();
+
+        std::vector<uint8_t> file = SerializeShaderReflection(reflection, spirv.data(), spirv.size());
+
+        ShaderReflection result;
+        for (size_t size = 0; size < file.size(); ++size)
+        {
+            CHECK(!DeserializeShaderReflection(file.data(), size, spirv.data(), spirv.size(), result));
+        }
+        CHECK(result == ShaderReflection {});
+
+        std::vector<uint8_t> longer_file = file;
+        longer_file.push_back(0);
+        CHECK(!DeserializeShaderReflection(longer_file.data(), longer_file.size(), spirv.data(), spirv.size(), result));
+
+        // magic then version lead the file
+        std::vector<uint8_t> other_version = file;
+        other_version[4] ^= 1;
+        CHECK(!DeserializeShaderReflection(
+            other_version.data(), other_version.size(), spirv.data(), spirv.size(), result));
+        CHECK(result == ShaderReflection {});
+    }
+
+    /**
+     * @brief Every builtin shader reflects, and the reflection file the build wrote beside it matches SPIRV-Cross.
+     */
+    void TestBuiltinShaders()
+    {
+        size_t shader_count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(ENGINE_ROOT_DIR "/builtin/shaders"))
+        {
+            if (entry.path().extension() != ".spv")
+                continue;
+
+            std::vector<uint8_t> spirv = ReadFile(entry.path());
+            ShaderReflection     reflection =
+                ReflectSpirv(reinterpret_cast<const uint32_t*>(spirv.data()), spirv.size() / sizeof(uint32_t));
+
+            std::vector<uint8_t> file = SerializeShaderReflection(reflection, spirv.data(), spirv.size());
+            ShaderReflection     result;
+            CHECK(DeserializeShaderReflection(file.data(), file.size(), spirv.data(), spirv.size(), result));
+            CHECK(result == reflection);
+
+            std::filesystem::path reflection_path = GetShaderReflectionPath(entry.path().string());
+            if (std::filesystem::exists(reflection_path))
+            {
+                std::vector<uint8_t> sidecar = ReadFile(reflection_path);
+                ShaderReflection     sidecar_result;
+                bool                 is_valid = DeserializeShaderReflection(
+                    sidecar.data(), sidecar.size(), spirv.data(), spirv.size(), sidecar_result);
+                if (!is_valid || !(sidecar_result == reflection))
+                    std::printf("stale reflection file: %s\n", reflection_path.string().c_str());
+                CHECK(is_valid);
+                CHECK(sidecar_result == reflection);
+            }
+
+            ++shader_count;
+        }
+
+        CHECK(shader_count > 0);
+    }
+} // namespace
+
+int main()
+{
+    TestRoundTrip();
+    TestStaleSpirv();
+    TestCorruptFile();
+    TestBuiltinShaders();
+
+    if (g_failure_count > 0)
+    {
+        std::printf("%d checks failed\n", g_failure_count);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+    return 0;
+}
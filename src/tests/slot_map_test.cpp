@@ -0,0 +1,196 @@
+#include "core/base/slot_map.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Meow;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++g_failure_count; \
+        } \
+    } while (false)
+
+namespace
+{
+    int g_failure_count = 0;
+
+    void TestInsertAndGet()
+    {
+        SlotMap<std::string> map;
+        CHECK(map.Empty());
+
+        SlotHandle a = map.Insert("a");
+        SlotHandle b = map.Insert("b");
+
+        CHECK(a.IsValid() && b.IsValid());
+        CHECK(!(a == b));
+        CHECK(map.Size() == 2);
+        CHECK(map.Contains(a) && map.Contains(b));
+        CHECK(map.Get(a) && *map.Get(a) == "a");
+        CHECK(map.Get(b) && *map.Get(b) == "b");
+
+        // a default handle points at nothing
+        SlotHandle invalid;
+        CHECK(!invalid.IsValid());
+        CHECK(!map.Contains(invalid));
+        CHECK(map.Get(invalid) == nullptr);
+        CHECK(!map.Remove(invalid));
+    }
+
+    void TestReusedSlot()
+    {
+        SlotMap<int> map;
+
+        SlotHandle old_handle = map.Insert(1);
+        CHECK(map.Remove(old_handle));
+        CHECK(map.Empty());
+
+        // the freed slot is reused, with a new generation
+        SlotHandle new_handle = map.Insert(2);
+        CHECK(new_handle.index == old_handle.index);
+        CHECK(new_handle.generation != old_handle.generation);
+
+        // the stale handle doesn't see the new value
+        CHECK(!map.Contains(old_handle));
+        CHECK(map.Get(old_handle) == nullptr);
+        CHECK(!map.Remove(old_handle));
+        CHECK(map.Size() == 1);
+        CHECK(map.Get(new_handle) && *map.Get(new_handle) == 2);
+
+        // removing twice fails the second time
+        CHECK(map.Remove(new_handle));
+        CHECK(!map.Remove(new_handle));
+        CHECK(map.Empty());
+    }
+
+    void TestRemoveKeepsOtherHandles()
+    {
+        SlotMap<int> map;
+
+        std::vector<SlotHandle> handles;
+        for (int i = 0; i < 8; ++i)
+            handles.push_back(map.Insert(i));
+
+        // removing from the middle moves the last value into the hole
+        CHECK(map.Remove(handles[2]));
+        CHECK(map.Remove(handles[5]));
+
+        for (int i = 0; i < 8; ++i)
+        {
+            if (i == 2 || i == 5)
+                continue;
+            CHECK(map.Get(handles[i]) && *map.Get(handles[i]) == i);
+        }
+
+        // GetHandle of every dense index leads back to the same value
+        for (size_t dense_index = 0; dense_index < map.Size(); ++dense_index)
+        {
+            SlotHandle handle = map.GetHandle(dense_index);
+            CHECK(map.Get(handle) == &*(map.begin() + dense_index));
+        }
+    }
+
+    void TestClear()
+    {
+        SlotMap<int> map;
+
+        SlotHandle a = map.Insert(1);
+        SlotHandle b = map.Insert(2);
+        map.Clear();
+
+        CHECK(map.Empty());
+        CHECK(!map.Contains(a));
+        CHECK(!map.Contains(b));
+
+        // slots are reused after clearing, old handles still don't see the new values
+        SlotHandle c = map.Insert(3);
+        SlotHandle d = map.Insert(4);
+        CHECK(!map.Contains(a));
+        CHECK(!map.Contains(b));
+        CHECK(map.Get(c) && *map.Get(c) == 3);
+        CHECK(map.Get(d) && *map.Get(d) == 4);
+        CHECK(map.Size() == 2);
+    }
+
+    /**
+     * @brief Random inserts and removes, checked against a list of live and dead handles.
+     */
+    void TestRandomOperations()
+    {
+        SlotMap<int> map;
+
+        std::vector<std::pair<SlotHandle, int>> live;
+        std::vector<SlotHandle>                 dead;
+
+        std::mt19937 engine(3);
+        int          next_value = 0;
+        for (int step = 0; step < 20000; ++step)
+        {
+            if (live.empty() || std::uniform_int_distribution<int>(0, 2)(engine) != 0)
+            {
+                SlotHandle handle = map.Insert(next_value);
+                live.push_back({handle, next_value});
+                next_value++;
+            }
+            else
+            {
+                size_t i = std::uniform_int_distribution<size_t>(0, live.size() - 1)(engine);
+                CHECK(map.Remove(live[i].first));
+                dead.push_back(live[i].first);
+                live[i] = live.back();
+                live.pop_back();
+            }
+
+            // keep the map small so that slots are reused many times
+            if (live.size() > 64)
+            {
+                CHECK(map.Remove(live.front().first));
+                dead.push_back(live.front().first);
+                live.erase(live.begin());
+            }
+        }
+
+        CHECK(map.Size() == live.size());
+        for (const auto& [handle, value] : live)
+            CHECK(map.Get(handle) && *map.Get(handle) == value);
+
+        for (const SlotHandle& handle : dead)
+            CHECK(!map.Contains(handle));
+
+        // dense values are exactly the live values
+        std::vector<int> dense(map.begin(), map.end());
+        std::vector<int> expected;
+        for (const auto& [handle, value] : live)
+            expected.push_back(value);
+
+        std::sort(dense.begin(), dense.end());
+        std::sort(expected.begin(), expected.end());
+        CHECK(dense == expected);
+    }
+} // namespace
+
+int main()
+{
+    TestInsertAndGet();
+    TestReusedSlot();
+    TestRemoveKeepsOtherHandles();
+    TestClear();
+    TestRandomOperations();
+
+    if (g_failure_count > 0)
+    {
+        std::printf("%d checks failed\n", g_failure_count);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+    return 0;
+}
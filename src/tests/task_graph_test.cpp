@@ -0,0 +1,173 @@
+#include "core/job/task_graph.h"
+
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace Meow;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++g_failure_count; \
+        } \
+    } while (false)
+
+namespace
+{
+    int g_failure_count = 0;
+
+    /**
+     * @brief Start and finish times of every task, taken from one shared counter.
+     */
+    struct Timeline
+    {
+        explicit Timeline(size_t task_count)
+            : start_times(task_count)
+            , finish_times(task_count)
+            , run_counts(task_count)
+        {}
+
+        void Start(TaskID task_id) { start_times[task_id] = clock.fetch_add(1); }
+        void Finish(TaskID task_id)
+        {
+            finish_times[task_id] = clock.fetch_add(1);
+            run_counts[task_id]++;
+        }
+
+        std::atomic<uint32_t>              clock {0};
+        std::vector<std::atomic<uint32_t>> start_times;
+        std::vector<std::atomic<uint32_t>> finish_times;
+        std::vector<std::atomic<uint32_t>> run_counts;
+    };
+
+    /**
+     * @brief Some work of random length, so that tasks overlap differently on every run.
+     */
+    void Spin(uint32_t seed)
+    {
+        volatile uint32_t value = seed;
+        for (uint32_t i = 0; i < (seed % 7) * 200; ++i)
+            value = value * 1664525u + 1013904223u;
+    }
+
+    void TestDependencyOrder(uint32_t worker_count)
+    {
+        constexpr uint32_t k_task_count = 300;
+
+        JobSystem job_system(worker_count);
+        TaskGraph graph;
+        Timeline  timeline(k_task_count);
+
+        std::thread::id       main_thread_id = std::this_thread::get_id();
+        std::atomic<uint32_t> main_thread_misses {0};
+
+        std::mt19937 engine(worker_count);
+        for (TaskID i = 0; i < k_task_count; ++i)
+        {
+            // every fifth task must run on the thread calling Run
+            bool main_thread_only = i % 5 == 0;
+            graph.AddTask(
+                "Task",
+                [&, i, main_thread_only]() {
+                    timeline.Start(i);
+                    if (main_thread_only && std::this_thread::get_id() != main_thread_id)
+                        main_thread_misses++;
+                    Spin(i);
+                    timeline.Finish(i);
+                },
+                main_thread_only);
+        }
+
+        // edges only go from lower to higher ids, so the graph is acyclic
+        std::vector<std::pair<TaskID, TaskID>> edges;
+        for (TaskID after = 1; after < k_task_count; ++after)
+        {
+            uint32_t dependency_count = std::uniform_int_distribution<uint32_t>(0, 3)(engine);
+            for (uint32_t k = 0; k < dependency_count; ++k)
+            {
+                TaskID before = std::uniform_int_distribution<TaskID>(0, after - 1)(engine);
+                graph.AddDependency(before, after);
+                edges.push_back({before, after});
+            }
+        }
+
+        CHECK(graph.Compile());
+
+        // the graph is reused between runs, like the per frame graph of a level
+        for (uint32_t run = 1; run <= 3; ++run)
+        {
+            graph.Run(job_system);
+
+            for (TaskID i = 0; i < k_task_count; ++i)
+                CHECK(timeline.run_counts[i] == run);
+
+            for (const auto& [before, after] : edges)
+                CHECK(timeline.finish_times[before] < timeline.start_times[after]);
+        }
+
+        CHECK(main_thread_misses == 0);
+    }
+
+    void TestCycle()
+    {
+        JobSystem job_system(2);
+        TaskGraph graph;
+
+        std::atomic<uint32_t> run_count {0};
+        TaskID                a = graph.AddTask("A", [&]() { run_count++; });
+        TaskID                b = graph.AddTask("B", [&]() { run_count++; });
+        TaskID                c = graph.AddTask("C", [&]() { run_count++; });
+        graph.AddDependency(a, b);
+        graph.AddDependency(b, c);
+        graph.AddDependency(c, b);
+
+        // a cyclic graph is rejected and never runs
+        CHECK(!graph.Compile());
+        graph.Run(job_system);
+        CHECK(run_count == 0);
+
+        // after clearing, the graph can be built again
+        graph.Clear();
+        TaskID d = graph.AddTask("D", [&]() { run_count++; });
+        TaskID e = graph.AddTask("E", [&]() { run_count++; });
+        graph.AddDependency(d, e);
+        CHECK(graph.Compile());
+        graph.Run(job_system);
+        CHECK(run_count == 2);
+    }
+
+    void TestEmpty()
+    {
+        JobSystem job_system(1);
+        TaskGraph graph;
+
+        // returns immediately without any task
+        CHECK(graph.Compile());
+        graph.Run(job_system);
+    }
+} // namespace
+
+int main()
+{
+    // one worker racing the calling thread, then several
+    TestDependencyOrder(1);
+    TestDependencyOrder(4);
+    TestCycle();
+    TestEmpty();
+
+    if (g_failure_count > 0)
+    {
+        std::printf("%d checks failed\n", g_failure_count);
+        return 1;
+    }
+
+    std::printf("All checks passed\n");
+    return 0;
+}